@@ -0,0 +1,101 @@
+/**
+ * @file    App/Inc/crypto1.h
+ * @brief   MIFARE Classic Crypto1 Stream Cipher Header
+ * @details This file contains the Crypto1 cipher used by MIFARE Classic authentication and
+ *          the encrypted session that follows it: the 48-bit LFSR, the non-linear filter
+ *          function and the 16-bit nonce generator of the tag.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef INC_CRYPTO1_H
+#define INC_CRYPTO1_H
+
+/**
+ * @include necessary headers
+ */
+#include <cstdint>
+
+/**
+ * @namespace NFC
+ * @brief Contains NFC related functions and definitions.
+ */
+namespace NFC
+{
+    /**
+     * @class Crypto1
+     * @brief Crypto1 cipher state.
+     * @details The LFSR is kept as its odd and even bits in two words, so the 20 filter inputs
+     *          (odd bits 9 to 47) are five adjacent nibbles of one word and each filter stage
+     *          is a table lookup. Bytes go over the air LSB first, 32-bit values (nonces) with
+     *          the most significant byte first.
+     */
+    class Crypto1
+    {
+        public:
+            /**
+             * @brief Constructor (zero state)
+             */
+            Crypto1(void) : _odd(0), _even(0) {}
+
+            /**
+             * @brief Load a key into the LFSR
+             * @param key 48-bit key (first key byte in bits 47 to 40)
+             */
+            void Init(uint64_t key);
+
+            /**
+             * @brief Clock the cipher one bit
+             * @param in Bit shifted into the LFSR (0 or 1)
+             * @param encrypted true if in is encrypted with the keystream bit that is returned
+             * @return Keystream bit
+             */
+            uint8_t Bit(uint8_t in, bool encrypted);
+
+            /**
+             * @brief Clock the cipher one byte (LSB first)
+             * @param in Byte shifted into the LFSR
+             * @param encrypted true if in is encrypted with the keystream
+             * @return Keystream byte
+             */
+            uint8_t Byte(uint8_t in, bool encrypted);
+
+            /**
+             * @brief Clock the cipher 32 bits (most significant byte first, each byte LSB first)
+             * @param in Word shifted into the LFSR
+             * @param encrypted true if in is encrypted with the keystream
+             * @return Keystream word
+             */
+            uint32_t Word(uint32_t in, bool encrypted);
+
+            /**
+             * @brief Get the next keystream bit without clocking
+             * @details Encrypts the parity bit of the byte just processed.
+             * @return Keystream bit
+             */
+            uint8_t Peek(void) const;
+
+            /**
+             * @brief Advance the tag nonce generator
+             * @param nonce Nonce (as sent, most significant byte first)
+             * @param steps Number of generator steps
+             * @return Successor of the nonce
+             */
+            static uint32_t NonceSuccessor(uint32_t nonce, uint32_t steps);
+
+            /**
+             * @brief Odd parity bit of a byte (ISO14443A)
+             * @param value Byte
+             * @return Parity bit that makes the number of ones odd
+             */
+            static uint8_t OddParity(uint8_t value);
+
+        private:
+            uint32_t _odd;                      /**< LFSR bits 1, 3, ... 47 */
+            uint32_t _even;                     /**< LFSR bits 0, 2, ... 46 */
+    };
+
+} // namespace NFC
+
+#endif /* INC_CRYPTO1_H */
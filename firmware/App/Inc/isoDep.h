@@ -0,0 +1,185 @@
+/**
+ * @file    App/Inc/isoDep.h
+ * @brief   ISO14443-4 (ISO-DEP) Block Transmission Protocol Header
+ * @details This file contains the reader side of the ISO14443-4 half-duplex block protocol:
+ *          RATS/ATS activation for Type A, I/R/S block handling with chaining in both
+ *          directions, waiting time extensions, error recovery and the presence check.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef INC_ISO_DEP_H
+#define INC_ISO_DEP_H
+
+/**
+ * @include necessary headers
+ */
+#include "st25r3911b.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * @namespace NFC
+ * @brief Contains NFC related functions and definitions.
+ */
+namespace NFC
+{
+    /**
+     * @struct IsoDepParameters
+     * @brief Link parameters negotiated during activation.
+     */
+    struct IsoDepParameters
+    {
+        uint16_t fsc;                       /**< Maximum frame size of the card (PCB, INF and CRC) */
+        uint16_t fsd;                       /**< Maximum frame size of the reader */
+        uint8_t fwi;                        /**< Frame waiting time integer */
+        uint8_t sfgi;                       /**< Start-up frame guard time integer */
+    };
+
+    /**
+     * @struct IsoDepStatistics
+     * @brief Block level counters of the ISO-DEP link.
+     */
+    struct IsoDepStatistics
+    {
+        uint32_t exchanges;                 /**< APDU exchanges */
+        uint32_t blocksSent;                /**< Blocks sent (including retransmissions) */
+        uint32_t chainedBlocksSent;         /**< I-blocks sent with the chaining bit */
+        uint32_t chainedBlocksReceived;     /**< I-blocks received with the chaining bit */
+        uint32_t waitingTimeExtensions;     /**< S(WTX) requests answered */
+        uint32_t retransmissions;           /**< Blocks repeated after an error or timeout */
+    };
+
+    /**
+     * @class IsoDep
+     * @brief ISO14443-4 block protocol on top of an activated Type A or Type B card.
+     * @details No CID and no NAD are used. Frames always use the largest size both sides
+     *          accept (FSD 256, FSC from the ATS or ATQB), frames longer than the FIFO are
+     *          streamed by the controller driver.
+     */
+    class IsoDep
+    {
+        public:
+            /** @brief Maximum frame size of the reader (FSDI 8) */
+            static constexpr uint16_t FSD = 256;
+
+            /**
+             * @brief Constructor
+             * @param controller Pointer to ST25R3911B controller
+             */
+            IsoDep(ST25R3911B* controller);
+
+            /**
+             * @brief Activate a selected Type A card (RATS)
+             * @param ats Vector to store the ATS
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus ActivateA(std::vector<uint8_t>& ats);
+
+            /**
+             * @brief Take over a Type B card activated by ATTRIB
+             * @param tagInfo Tag information with the ATQB protocol info
+             * @return NFCStatus::UNSUPPORTED_TAG if the card is not ISO14443-4 compliant
+             */
+            NFCStatus ActivateB(const TagInfo& tagInfo);
+
+            /**
+             * @brief Exchange an APDU with the card
+             * @details Long commands and responses are chained, S(WTX) requests are answered and
+             *          lost or corrupted blocks are recovered with R-blocks.
+             * @param command Command APDU
+             * @param commandLength Command length
+             * @param response Buffer for the response APDU
+             * @param responseSize Size of the response buffer
+             * @param responseLength Length of the response APDU (bytes stored if it does not fit)
+             * @return NFCStatus::INVALID_PARAM if the response does not fit the buffer
+             */
+            NFCStatus Exchange(const uint8_t* command, size_t commandLength,
+                               uint8_t* response, size_t responseSize, size_t& responseLength);
+
+            /**
+             * @brief Check if the card is still in the field
+             * @details Sends R(NAK), which a present card answers with R(ACK) without leaving
+             *          the protocol state.
+             * @return NFCStatus::OK if the card answered
+             */
+            NFCStatus CheckPresence(void);
+
+            /**
+             * @brief Deselect the card (S(DESELECT))
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus Deselect(void);
+
+            /**
+             * @brief Forget the session (card removed or reactivated)
+             */
+            void Reset(void) { _active = false; }
+
+            /**
+             * @brief Check if a card is activated
+             * @return true between activation and deselection
+             */
+            bool IsActive(void) const { return _active; }
+
+            /**
+             * @brief Get negotiated link parameters
+             * @return Reference to parameters
+             */
+            const IsoDepParameters& GetParameters(void) const { return _params; }
+
+            /**
+             * @brief Get frame waiting time
+             * @return FWT in microseconds
+             */
+            uint32_t GetFrameWaitingTimeUs(void) const { return 302UL << _params.fwi; }
+
+            /**
+             * @brief Get block level counters
+             * @return Reference to counters
+             */
+            const IsoDepStatistics& GetStatistics(void) const { return _stats; }
+
+            /**
+             * @brief Reset block level counters
+             */
+            void ResetStatistics(void) { _stats = {}; }
+
+        private:
+            ST25R3911B* _controller;            /**< Pointer to ST25R3911B controller */
+            bool _active;                       /**< Card activated */
+            IsoDepParameters _params;           /**< Negotiated parameters */
+            uint8_t _blockNumber;               /**< Current block number of the reader */
+            std::vector<uint8_t> _txBlock;      /**< Last block sent */
+            std::vector<uint8_t> _rxBlock;      /**< Last block received */
+            IsoDepStatistics _stats;            /**< Block level counters */
+
+            /**
+             * @brief Set the link parameters
+             * @param fsci Maximum frame size code of the card
+             * @param fwi Frame waiting time integer
+             * @param sfgi Start-up frame guard time integer
+             */
+            void configure(uint8_t fsci, uint8_t fwi, uint8_t sfgi);
+
+            /**
+             * @brief Send _txBlock and receive the answer into _rxBlock
+             * @details Answers S(WTX) and recovers lost blocks. On success _rxBlock holds an
+             *          I-block or an R(ACK).
+             * @param piccChaining true while the card sends a chained response
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus transceiveBlock(bool piccChaining);
+
+            /**
+             * @brief Get the software timeout of a block
+             * @param multiplier FWT multiplier (WTXM)
+             * @return Timeout in milliseconds
+             */
+            uint32_t blockTimeoutMs(uint8_t multiplier) const;
+    };
+
+} // namespace NFC
+
+#endif /* INC_ISO_DEP_H */
@@ -0,0 +1,333 @@
+/**
+ * @file    App/Inc/mifareClassic.h
+ * @brief   MIFARE Classic Reader Protocol Header
+ * @details This file contains the reader side of the MIFARE Classic protocol: the three-pass
+ *          Crypto1 authentication (first and nested), and the encrypted READ, WRITE and HALT
+ *          commands. Encrypted frames carry encrypted parity bits, they are exchanged with the
+ *          parity generation of the controller switched off.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef INC_MIFARE_CLASSIC_H
+#define INC_MIFARE_CLASSIC_H
+
+/**
+ * @include necessary headers
+ */
+#include "st25r3911b.h"
+#include "crypto1.h"
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+/**
+ * @namespace NFC
+ * @brief Contains NFC related functions and definitions.
+ */
+namespace NFC
+{
+    /**
+     * @struct MifareKey
+     * @brief Sector key.
+     */
+    struct MifareKey
+    {
+        uint8_t bytes[6];                   /**< Key as stored in the sector trailer */
+        bool keyB;                          /**< true for key B, false for key A */
+    };
+
+    /**
+     * @struct MifareClassicStats
+     * @brief MIFARE Classic protocol counters.
+     */
+    struct MifareClassicStats
+    {
+        uint32_t authentications;           /**< First authentications (plain nonce) */
+        uint32_t nestedAuthentications;     /**< Authentications within a session (encrypted nonce) */
+        uint32_t authenticationFailures;    /**< Authentications rejected or not answered */
+        uint32_t reactivations;             /**< Card reselected after a failed session */
+        uint32_t blocksRead;                /**< Blocks read */
+        uint32_t blocksWritten;             /**< Blocks written */
+    };
+
+    /**
+     * @class MifareClassic
+     * @brief MIFARE Classic session on top of a selected Type A card.
+     * @details A session covers one sector: reads and writes authenticate when the sector (or
+     *          the key) changes, nested within the running session if there is one. A failed
+     *          command ends the session; the card is then reselected with the activation
+     *          function and authenticated once more.
+     */
+    class MifareClassic
+    {
+        public:
+            /** @brief Key lookup: tag, sector, key to use (preset to key A FF FF FF FF FF FF) */
+            using KeyFunction = std::function<void(const TagInfo&, uint8_t, MifareKey&)>;
+
+            /** @brief Card reselection (HLTA, WUPA, SELECT) after a failed session */
+            using ActivateFunction = std::function<NFCStatus(const TagInfo&)>;
+
+            /** @brief Block size in bytes */
+            static constexpr uint8_t BLOCK_SIZE = 16;
+
+            /**
+             * @brief Constructor
+             * @param controller Pointer to ST25R3911B controller
+             * @param activate Card reselection function
+             */
+            MifareClassic(ST25R3911B* controller, ActivateFunction activate);
+
+            /**
+             * @brief Authenticate a sector
+             * @details Nested if a session with the same card is running, first authentication
+             *          otherwise.
+             * @param tagInfo Selected card
+             * @param block Any block of the sector
+             * @param key Sector key
+             * @return NFCStatus::AUTH_ERROR if the card rejects the key
+             */
+            NFCStatus Authenticate(const TagInfo& tagInfo, uint8_t block, const MifareKey& key);
+
+            /**
+             * @brief Read a block
+             * @details Authenticates the sector first if needed, with the key of the key function.
+             * @param tagInfo Selected card
+             * @param block Block number
+             * @param data Vector to store the 16 bytes
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus ReadBlock(const TagInfo& tagInfo, uint8_t block, std::vector<uint8_t>& data);
+
+            /**
+             * @brief Write a data block
+             * @details Authenticates the sector first if needed, with the key of the key function.
+             * @param tagInfo Selected card
+             * @param block Block number (not block 0 or a sector trailer)
+             * @param data 16 bytes to write
+             * @return NFCStatus::INVALID_PARAM for block 0 or a sector trailer
+             */
+            NFCStatus WriteBlock(const TagInfo& tagInfo, uint8_t block, const uint8_t* data);
+
+            /**
+             * @brief Read consecutive blocks
+             * @details Each sector is authenticated once and its blocks are read in the same
+             *          session, the next sector is authenticated nested.
+             * @param tagInfo Selected card
+             * @param firstBlock First block number
+             * @param count Number of blocks
+             * @param data Vector to store the blocks (16 bytes each)
+             * @return NFCStatus indicating success or failure (data holds the blocks read before)
+             */
+            NFCStatus ReadBlocks(const TagInfo& tagInfo, uint8_t firstBlock, uint16_t count, std::vector<uint8_t>& data);
+
+            /**
+             * @brief Write consecutive data blocks
+             * @details Each sector is authenticated once and its blocks are written in the same
+             *          session, the next sector is authenticated nested. A range that contains
+             *          block 0 or a sector trailer is refused before anything is written.
+             * @param tagInfo Selected card
+             * @param firstBlock First block number
+             * @param data Blocks to write (16 bytes each)
+             * @param count Number of blocks
+             * @return NFCStatus::INVALID_PARAM if the range contains block 0 or a sector trailer
+             */
+            NFCStatus WriteBlocks(const TagInfo& tagInfo, uint8_t firstBlock, const uint8_t* data, uint16_t count);
+
+            /**
+             * @brief Write the trailer of a sector (keys and access conditions)
+             * @details The access bits are checked against their inverted copies first: a
+             *          trailer with inconsistent access bits would block the sector for good.
+             * @param tagInfo Selected card
+             * @param sector Sector number
+             * @param keyA New key A (6 bytes)
+             * @param access Access bytes 6 to 8 and the general purpose byte 9 (4 bytes)
+             * @param keyB New key B (6 bytes)
+             * @return NFCStatus::INVALID_PARAM if the access bits are inconsistent
+             */
+            NFCStatus WriteSectorTrailer(const TagInfo& tagInfo, uint8_t sector, const uint8_t* keyA,
+                                         const uint8_t* access, const uint8_t* keyB);
+
+            /**
+             * @brief Read all blocks of a sector (sector trailer included, key A reads as zeros)
+             * @param tagInfo Selected card
+             * @param sector Sector number
+             * @param data Vector to store the blocks
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus ReadSector(const TagInfo& tagInfo, uint8_t sector, std::vector<uint8_t>& data);
+
+            /**
+             * @brief Read the complete card
+             * @details The sector of a running session is read first, then the other sectors in
+             *          ascending order: one authentication per sector, nested while the session
+             *          lasts. A sector that cannot be read (wrong key) stays zero and the dump goes
+             *          on with the next one; a card that left the field ends the dump.
+             * @param tagInfo Selected card (dataSize selects Mini, 1K, 2K or 4K layout)
+             * @param memory Vector to store the memory image (16 bytes per block)
+             * @param sectorsRead Bit n set if sector n was read
+             * @return NFCStatus::OK if all sectors were read, otherwise the status of the first failure
+             */
+            NFCStatus Dump(const TagInfo& tagInfo, std::vector<uint8_t>& memory, uint64_t& sectorsRead);
+
+            /**
+             * @brief Halt the card (encrypted HLTA within a session)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus Halt(void);
+
+            /**
+             * @brief Forget the session (card removed or reselected)
+             */
+            void Reset(void) { _authenticated = false; _cardLost = false; }
+
+            /**
+             * @brief Check if a session is running
+             * @return true between authentication and the end of the session
+             */
+            bool IsAuthenticated(void) const { return _authenticated; }
+
+            /**
+             * @brief Set the key lookup
+             * @param keyFunction Key function (nullptr = key A FF FF FF FF FF FF for all sectors)
+             */
+            void SetKeyFunction(KeyFunction keyFunction) { _keyFunction = keyFunction; }
+
+            /**
+             * @brief Get the sector of a block
+             * @param block Block number
+             * @return Sector (4 blocks per sector below block 128, 16 blocks above)
+             */
+            static uint8_t SectorOf(uint8_t block) { return (block < 128) ? block / 4 : 32 + (block - 128) / 16; }
+
+            /**
+             * @brief Get the first block of a sector
+             * @param sector Sector number
+             * @return Block number
+             */
+            static uint8_t FirstBlock(uint8_t sector) { return (sector < 32) ? sector * 4 : 128 + (sector - 32) * 16; }
+
+            /**
+             * @brief Get the number of blocks of a sector
+             * @param sector Sector number
+             * @return 4 (sectors 0 to 31) or 16 (sectors 32 to 39)
+             */
+            static uint8_t BlocksInSector(uint8_t sector) { return (sector < 32) ? 4 : 16; }
+
+            /**
+             * @brief Check if a block is a sector trailer
+             * @param block Block number
+             * @return true for the last block of a sector
+             */
+            static bool IsSectorTrailer(uint8_t block) { return block == FirstBlock(SectorOf(block)) + BlocksInSector(SectorOf(block)) - 1; }
+
+            /**
+             * @brief Get the number of sectors of a card
+             * @param dataSize Memory size in bytes (320 Mini, 1024 1K, 2048 2K, 4096 4K)
+             * @return Sector count (16 if the size is unknown)
+             */
+            static uint8_t SectorCount(uint16_t dataSize);
+
+            /**
+             * @brief Get the number of blocks of a card
+             * @param dataSize Memory size in bytes (320 Mini, 1024 1K, 2048 2K, 4096 4K)
+             * @return Block count (64 if the size is unknown)
+             */
+            static uint16_t BlockCount(uint16_t dataSize);
+
+            /**
+             * @brief Get protocol counters
+             * @return Reference to counters
+             */
+            const MifareClassicStats& GetStatistics(void) const { return _stats; }
+
+            /**
+             * @brief Reset protocol counters
+             */
+            void ResetStatistics(void) { _stats = {}; }
+
+        private:
+            ST25R3911B* _controller;            /**< Pointer to ST25R3911B controller */
+            ActivateFunction _activate;         /**< Card reselection */
+            KeyFunction _keyFunction;           /**< Key lookup */
+            Crypto1 _crypto;                    /**< Cipher state of the session */
+            bool _authenticated;                /**< Session running */
+            bool _cardLost;                     /**< Card left in IDLE by a failed command, reselect first */
+            std::vector<uint8_t> _uid;          /**< Card of the session */
+            uint8_t _sector;                    /**< Authenticated sector */
+            bool _keyB;                         /**< Session authenticated with key B */
+            uint32_t _readerNonce;              /**< Reader nonce generator state */
+            MifareClassicStats _stats;          /**< Protocol counters */
+
+            /**
+             * @brief Make sure a session for the sector of a block is running
+             * @param tagInfo Selected card
+             * @param block Block number
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus openSector(const TagInfo& tagInfo, uint8_t block);
+
+            /**
+             * @brief Run the three-pass authentication
+             * @param tagInfo Selected card
+             * @param block Any block of the sector
+             * @param key Sector key
+             * @param nested true to authenticate within the running session
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus authenticate(const TagInfo& tagInfo, uint8_t block, const MifareKey& key, bool nested);
+
+            /**
+             * @brief Read a block within the running session
+             * @param block Block number
+             * @param data Vector the 16 bytes are appended to
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus readBlock(uint8_t block, std::vector<uint8_t>& data);
+
+            /**
+             * @brief Write a block within the running session (WRITE and data phase)
+             * @param block Block number
+             * @param data 16 bytes to write
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus writeBlock(uint8_t block, const uint8_t* data);
+
+            /**
+             * @brief Encrypt a command with its CRC and parity bits
+             * @param command Plain command
+             * @param data Vector to store the encrypted bytes
+             * @param parity Vector to store the encrypted parity bits
+             */
+            void encrypt(const std::vector<uint8_t>& command, std::vector<uint8_t>& data, std::vector<uint8_t>& parity);
+
+            /**
+             * @brief Decrypt an answer in place
+             * @param data Received bytes, a trailing fragment (4-bit ACK/NAK) is decrypted bit by bit
+             * @param bytes Number of complete bytes
+             */
+            void decrypt(std::vector<uint8_t>& data, size_t bytes);
+
+            /**
+             * @brief Send an encrypted command (CRC appended) and decrypt the answer
+             * @param command Plain command
+             * @param response Vector to store the plain answer (with CRC), or the 4-bit ACK/NAK
+             * @param timeoutMs Timeout in milliseconds
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus transceive(const std::vector<uint8_t>& command, std::vector<uint8_t>& response, uint32_t timeoutMs);
+
+            /**
+             * @brief Run block commands of one sector, reselecting and authenticating again once on failure
+             * @param tagInfo Selected card
+             * @param block Block number (selects the sector)
+             * @param command Block commands within an authenticated session
+             * @return NFCStatus of the last attempt, NFCStatus::NO_TAG_FOUND if the card cannot be reselected
+             */
+            NFCStatus withSession(const TagInfo& tagInfo, uint8_t block, const std::function<NFCStatus(void)>& command);
+    };
+
+} // namespace NFC
+
+#endif /* INC_MIFARE_CLASSIC_H */
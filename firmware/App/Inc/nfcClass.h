@@ -14,6 +14,9 @@
  * @include necessary headers
  */
 #include "st25r3911b.h"
+#include "isoDep.h"
+#include "mifareClassic.h"
+#include "tagMemoryCache.h"
 #include <vector>
 #include <string>
 #include <functional>
@@ -89,6 +92,233 @@ namespace NFC
         std::string errorMessage;  /**< Error description */
     };
 
+    /**
+     * @struct SignalStats
+     * @brief Rolling receive signal statistics of one tag.
+     */
+    struct SignalStats
+    {
+        std::vector<uint8_t> uid;           /**< Tag UID */
+        uint32_t frames;                    /**< Frames received from the tag */
+        uint32_t weakFrames;                /**< Frames with RSSI below the weak threshold */
+        uint32_t lostFrames;                /**< Expected responses that were not received */
+        uint32_t consecutiveLost;           /**< Expected responses lost since the last received frame */
+        uint8_t lastRssi;                   /**< RSSI of the last frame (max of AM/PM) */
+        uint8_t minRssi;                    /**< Lowest RSSI seen */
+        uint8_t maxRssi;                    /**< Highest RSSI seen */
+        uint16_t averageRssi;               /**< Moving average of the RSSI of received frames in 1/16 steps */
+        uint8_t lastGainReduction;          /**< Gain reduction of the last frame (max of AM/PM) */
+        uint32_t lastUpdate;                /**< Sequence number of the last update (for replacement) */
+    };
+
+    /**
+     * @struct SignalPolicy
+     * @brief Thresholds for the adaptive receiver gain.
+     * @details The receiver is boosted when the average RSSI of the active tag falls below
+     *          weakRssi or lostLimit expected responses in a row are lost, and restored when
+     *          the average rises to strongRssi (hysteresis).
+     */
+    struct SignalPolicy
+    {
+        bool adaptiveGain;                  /**< Enable adaptive receiver gain */
+        uint8_t weakRssi;                   /**< Average RSSI below which the receiver is boosted */
+        uint8_t strongRssi;                 /**< Average RSSI at which the boost is removed */
+        uint8_t minFrames;                  /**< Received or lost frames required before a decision is taken */
+        uint8_t lostLimit;                  /**< Consecutive lost frames after which the receiver is boosted */
+    };
+
+    /**
+     * @enum DiscoveryState
+     * @brief States of the tag discovery state machine.
+     */
+    enum class DiscoveryState
+    {
+        IDLE = 0,               /**< Detection not active */
+        FIELD_ON,               /**< Switch the RF field on and start a poll cycle */
+        POLL,                   /**< Send the poll command */
+        COLLISION_RESOLUTION,   /**< Resolve the UID */
+        ACTIVATION,             /**< Select the tag */
+        CALLBACK,               /**< Report the tag */
+        PRESENCE_CHECK,         /**< Periodically check that the tag is still in the field */
+        FIELD_OFF               /**< End of the poll cycle */
+    };
+
+    /**
+     * @struct DiscoveryConfig
+     * @brief Timing of the tag discovery state machine.
+     * @details With fieldOffBetweenPolls the field is only on for the guard time and the poll
+     *          cycle (and while a tag is activated). The off time is pollPeriodMs, stretched
+     *          up to maxPollPeriodMs so that the field is on for at most fieldDutyPercent of the
+     *          time. After a tag answered or left the field, cycles follow every
+     *          activePollPeriodMs for activityHoldMs.
+     */
+    struct DiscoveryConfig
+    {
+        uint32_t pollPeriodMs;              /**< Time between two poll cycles without tag */
+        uint32_t presencePeriodMs;          /**< Time between two presence checks */
+        uint8_t presenceRetries;            /**< Failed presence checks tolerated before removal */
+        uint32_t responseTimeoutUs;         /**< Minimum no-response timeout during poll and activation */
+        bool fieldOffBetweenPolls;          /**< Switch the field off between poll cycles */
+        uint8_t maxBackoffCycles;           /**< Most poll cycles a silent technology is skipped */
+        bool inventory;                     /**< Enumerate all NFC-A tags each cycle instead of tracking one */
+        uint8_t maxInventoryTags;           /**< Most tags resolved in one inventory cycle */
+        uint8_t fieldDutyPercent;           /**< Largest share of field on time between tags (100 = no limit) */
+        uint32_t maxPollPeriodMs;           /**< Longest time between two poll cycles (bounds the latency) */
+        uint32_t activePollPeriodMs;        /**< Time between two poll cycles after recent activity */
+        uint32_t activityHoldMs;            /**< Time after activity the active poll period applies */
+    };
+
+    /**
+     * @struct TechnologyStats
+     * @brief Poll statistics and back-off state of one RF technology.
+     */
+    struct TechnologyStats
+    {
+        uint32_t polls;                     /**< Poll commands sent */
+        uint32_t answers;                   /**< Poll commands answered */
+        uint32_t lastSeenTick;              /**< Tick of the last answer (valid if answers > 0) */
+        uint8_t skipCycles;                 /**< Cycles skipped after the last unanswered poll */
+        uint8_t skipRemaining;              /**< Cycles still to skip */
+    };
+
+    /**
+     * @struct DiscoveryStats
+     * @brief Statistics of the tag discovery state machine.
+     */
+    struct DiscoveryStats
+    {
+        uint32_t pollCycles;                /**< Poll cycles started */
+        uint32_t tagsDiscovered;            /**< Tags reported to the callback */
+        uint32_t tagsRemoved;               /**< Tags that left the field */
+        uint32_t presenceChecks;            /**< Presence checks run */
+        uint32_t lastLatencyMs;             /**< Poll cycle start to callback of the last tag */
+        uint32_t minLatencyMs;              /**< Lowest discovery latency */
+        uint32_t maxLatencyMs;              /**< Highest discovery latency */
+        uint32_t fieldOnTimeMs;             /**< Time the field was on for discovery */
+    };
+
+    /**
+     * @struct UidCacheConfig
+     * @brief De-duplication of tag detections.
+     * @details A tag reaches the detection callback when it is first seen and the removal
+     *          callback when it has not been seen for ttlMs. Sightings in between (re-detection
+     *          after a lost presence check, every inventory cycle) are filtered.
+     */
+    struct UidCacheConfig
+    {
+        bool enabled;                       /**< Filter repeated detections */
+        uint32_t ttlMs;                     /**< Time without sighting before a tag counts as removed */
+    };
+
+    /**
+     * @struct UidCacheEntry
+     * @brief Tag known to the de-duplication cache.
+     */
+    struct UidCacheEntry
+    {
+        TagInfo tag;                        /**< Tag as first reported */
+        uint32_t firstSeenTick;             /**< Tick of the first sighting */
+        uint32_t lastSeenTick;              /**< Tick of the last sighting */
+        uint32_t sightings;                 /**< Sightings since the tag was first seen */
+    };
+
+    /**
+     * @struct TagModelInfo
+     * @brief Identification result of a Type 2 tag.
+     */
+    struct TagModelInfo
+    {
+        std::vector<uint8_t> uid;           /**< Tag UID */
+        TagModel model;                     /**< Exact product */
+        uint16_t pageCount;                 /**< Total number of 4-byte pages */
+        uint16_t userSize;                  /**< User memory in bytes (from page 4) */
+        std::vector<uint8_t> version;       /**< GET_VERSION response (empty if not supported) */
+        std::vector<uint8_t> signature;     /**< READ_SIG originality signature (empty if not supported) */
+        uint32_t lastUse;                   /**< Sequence number of the last use (for replacement) */
+    };
+
+    /**
+     * @struct FelicaConfig
+     * @brief FeliCa polling parameters.
+     */
+    struct FelicaConfig
+    {
+        uint16_t systemCode;                /**< System code polled for (0xFFFF = any) */
+        uint8_t requestCode;                /**< Request code (0 = none, 1 = system code, 2 = communication performance) */
+        uint8_t timeSlots;                  /**< Time slots per SENSF_REQ (1, 2, 4, 8 or 16) */
+        NFCBitRate bitRate;                 /**< Bit rate (212 or 424 kbps) */
+    };
+
+    /**
+     * @struct InventoryStats
+     * @brief Statistics of the multi-tag inventory.
+     */
+    struct InventoryStats
+    {
+        uint32_t cycles;                    /**< Inventory cycles run */
+        uint32_t tagsIdentified;            /**< Tags resolved over all cycles */
+        uint32_t lastCycleTags;             /**< Tags resolved in the last cycle */
+        uint32_t lastCycleMs;               /**< Duration of the last cycle */
+        uint32_t tagsPerSecond;             /**< Tags identified per second in the last cycle */
+    };
+
+    /**
+     * @struct Type4CapabilityContainer
+     * @brief Capability container (CC file) of an NFC Forum Type 4 tag.
+     */
+    struct Type4CapabilityContainer
+    {
+        uint8_t mappingVersion;             /**< Mapping version (0x20 or 0x30) */
+        uint16_t maxReadSize;               /**< MLe: maximum data of one READ BINARY */
+        uint16_t maxWriteSize;              /**< MLc: maximum data of one UPDATE BINARY */
+        uint16_t ndefFileId;                /**< NDEF file identifier */
+        uint32_t ndefFileSize;              /**< Maximum NDEF file size (including the length field) */
+        uint8_t lengthFieldSize;            /**< Size of the NDEF length field (2, or 4 for ENDEF) */
+        uint8_t readAccess;                 /**< Read access condition (0x00 = granted) */
+        uint8_t writeAccess;                /**< Write access condition (0x00 = granted, 0xFF = read-only) */
+    };
+
+    /**
+     * @struct Type5CapabilityContainer
+     * @brief Capability container (start of block 0) of an NFC Forum Type 5 tag.
+     */
+    struct Type5CapabilityContainer
+    {
+        uint8_t size;                       /**< CC size in bytes (4, or 8 for memories above 2040 bytes) */
+        uint8_t version;                    /**< Mapping version (major in bits 7-6, minor in bits 5-4) */
+        uint8_t readAccess;                 /**< Read access condition (0 = granted) */
+        uint8_t writeAccess;                /**< Write access condition (0 = granted) */
+        uint32_t areaSize;                  /**< Size of the TLV area following the CC in bytes */
+        bool multipleBlockRead;             /**< READ MULTIPLE BLOCKS supported */
+        bool lockBlock;                     /**< LOCK BLOCK supported */
+        bool specialFrame;                  /**< Writes need the special frame (option flag) */
+    };
+
+    /**
+     * @struct WriteConfig
+     * @brief Page and block write options of Type 2 and Type 5 tags.
+     */
+    struct WriteConfig
+    {
+        bool differential;                  /**< Read the memory first and only write pages or blocks that change */
+        bool verify;                        /**< Read written pages or blocks back and write differing ones again */
+        uint8_t retries;                    /**< Repeated writes of a page or block that fails verification */
+        bool tearSafe;                      /**< Clear the NDEF length before the message is replaced (one extra write) */
+    };
+
+    /**
+     * @struct WriteStats
+     * @brief Page and block write counters of Type 2 and Type 5 tags.
+     */
+    struct WriteStats
+    {
+        uint32_t unitsWritten;              /**< Pages or blocks written */
+        uint32_t unitsSkipped;              /**< Pages or blocks that already held the data */
+        uint32_t unitsVerified;             /**< Pages or blocks read back correctly */
+        uint32_t unitsRetried;              /**< Writes repeated after a failed verification or an unacknowledged write */
+        uint32_t verifyErrors;              /**< Pages or blocks still wrong after the retries */
+    };
+
     // Forward declarations
     class TagReader;
     class TagWriter;
@@ -103,6 +333,11 @@ namespace NFC
      */
     using TagDetectionCallback = std::function<void(const TagInfo&)>;
 
+    /**
+     * @brief Callback function type for the tags found in one inventory cycle
+     */
+    using InventoryCallback = std::function<void(const std::vector<TagInfo>&)>;
+
     /**
      * @class NFCManager
      * @brief High-level NFC manager class for coordinating operations.
@@ -135,6 +370,8 @@ namespace NFC
 
             /**
              * @brief Start tag detection
+             * @details Discovery runs from RunDiscovery(); the field is switched on for each poll
+             *          cycle and duty cycled as set in DiscoveryConfig.
              * @param protocols Protocols to detect (bitmask)
              * @param callback Callback for tag detection
              * @return NFCStatus indicating success or failure
@@ -165,6 +402,33 @@ namespace NFC
              */
             TagWriter* GetTagWriter(void) { return _tagWriter; }
 
+            /**
+             * @brief Get ISO14443-4 link of the activated tag
+             * @details Active while an ISO-DEP tag (Type A with SAK bit 0x20 or Type B announcing
+             *          ISO14443-4) is activated by discovery.
+             * @return Pointer to the ISO-DEP link
+             */
+            IsoDep* GetIsoDep(void) { return _isoDep; }
+
+            /**
+             * @brief Get memory images of the tags in the field
+             * @details Shared by the tag reader and writer: Type 2 and Type 5 memory read or
+             *          written while a tag stays present is served without RF frames. An image is
+             *          dropped when its tag is removed, detection stops or the tag is missing from
+             *          RunInventory() or PollVicinity().
+             * @return Pointer to the memory image cache
+             */
+            TagMemoryCache* GetMemoryCache(void) { return _memoryCache; }
+
+            /**
+             * @brief Get the MIFARE Classic session of the activated card
+             * @details Shared by the tag reader and writer. Set the sector keys with
+             *          MifareClassic::SetKeyFunction(), the default is key A FF FF FF FF FF FF.
+             *          The session ends when the card is reselected or removed.
+             * @return Pointer to the MIFARE Classic protocol
+             */
+            MifareClassic* GetMifareClassic(void) { return _mifareClassic; }
+
             /**
              * @brief Set field state
              * @param field Field state
@@ -178,19 +442,475 @@ namespace NFC
              */
             NFCField GetField(void) const;
 
+            // ============================================================================
+            // Discovery
+            // ============================================================================
+
+            /**
+             * @brief Run one step of the discovery state machine
+             * @details Each call performs at most one state (one or a few RF exchanges) so that
+             *          other commands can run between the steps.
+             * @return Time in milliseconds until the next step is due
+             */
+            uint32_t RunDiscovery(void);
+
+            /**
+             * @brief Get current discovery state
+             * @return Discovery state
+             */
+            DiscoveryState GetDiscoveryState(void) const { return _discoveryState; }
+
+            /**
+             * @brief Set discovery timing
+             * @param config Discovery configuration
+             */
+            void SetDiscoveryConfig(const DiscoveryConfig& config) { _discoveryConfig = config; }
+
+            /**
+             * @brief Get discovery timing
+             * @return Discovery configuration
+             */
+            const DiscoveryConfig& GetDiscoveryConfig(void) const { return _discoveryConfig; }
+
+            /**
+             * @brief Get discovery statistics
+             * @return Discovery statistics
+             */
+            const DiscoveryStats& GetDiscoveryStats(void) const { return _discoveryStats; }
+
+            /**
+             * @brief Get poll statistics of a technology
+             * @param technology NFC_A, NFC_B, NFC_F or NFC_V
+             * @return Poll statistics
+             */
+            const TechnologyStats& GetTechnologyStats(NFCProtocol technology) const;
+
+            /**
+             * @brief Check if an activated tag is in the field
+             * @return true if a tag is present
+             */
+            bool HasCurrentTag(void) const { return _tagPresent; }
+
+            /**
+             * @brief Get the activated tag
+             * @return Tag information (valid if HasCurrentTag() is true)
+             */
+            const TagInfo& GetCurrentTag(void) const { return _currentTag; }
+
+            /**
+             * @brief Check that the activated tag is still in the field
+             * @details ISO-DEP tags answer R(NAK) with R(ACK), Type 2 tags answer a READ of page 0,
+             *          other NFC-A tags are re-activated, B/F tags are polled again and V tags answer
+             *          a single slot INVENTORY masked with their UID. A failed check is retried by
+             *          re-activating the tag; after DiscoveryConfig::presenceRetries failed retries the
+             *          tag is reported as removed.
+             * @return NFCStatus::OK if the tag is present, NO_TAG_FOUND if it left the field
+             */
+            NFCStatus CheckPresence(void);
+
+            /**
+             * @brief Set callback for tags leaving the field
+             * @param callback Callback function, called with the removed tag
+             */
+            void SetRemovalCallback(TagDetectionCallback callback) { _removalCallback = callback; }
+
+            /**
+             * @brief Set detection de-duplication
+             * @param config Cache configuration
+             */
+            void SetUidCacheConfig(const UidCacheConfig& config) { _uidCacheConfig = config; }
+
+            /**
+             * @brief Get detection de-duplication
+             * @return Cache configuration
+             */
+            const UidCacheConfig& GetUidCacheConfig(void) const { return _uidCacheConfig; }
+
+            /**
+             * @brief Get tags known to the de-duplication cache
+             * @return Cache entries
+             */
+            const std::vector<UidCacheEntry>& GetUidCache(void) const { return _uidCache; }
+
+            /**
+             * @brief Forget all known tags without removal events
+             */
+            void ClearUidCache(void) { _uidCache.clear(); }
+
+            /**
+             * @brief Get the identification result of a Type 2 tag
+             * @param uid Tag UID
+             * @param info Reference to store the result
+             * @return true if the tag has been identified, false otherwise
+             */
+            bool GetTagModel(const std::vector<uint8_t>& uid, TagModelInfo& info) const;
+
+            // ============================================================================
+            // Inventory
+            // ============================================================================
+
+            /**
+             * @brief Enumerate all ISO14443A tags in the field
+             * @details WUPA wakes all tags, then each tag is resolved, selected, handed to the
+             *          session callback while selected and halted; REQA reaches the next tag
+             *          until no tag answers. The RF field must be on.
+             * @param tags Vector to store the tags found
+             * @param session Called for each tag while it is selected (may be nullptr)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus RunInventory(std::vector<TagInfo>& tags, TagDetectionCallback session = nullptr);
+
+            /**
+             * @brief Set callback for the tag list of each discovery inventory cycle
+             * @param callback Callback function (used if DiscoveryConfig::inventory is set)
+             */
+            void SetInventoryCallback(InventoryCallback callback) { _inventoryCallback = callback; }
+
+            /**
+             * @brief Get tags found in the last inventory cycle
+             * @return Tag list
+             */
+            const std::vector<TagInfo>& GetInventory(void) const { return _inventory; }
+
+            /**
+             * @brief Get inventory statistics
+             * @return Inventory statistics
+             */
+            const InventoryStats& GetInventoryStats(void) const { return _inventoryStats; }
+
+            // ============================================================================
+            // FeliCa
+            // ============================================================================
+
+            /**
+             * @brief Collect all FeliCa cards answering one SENSF_REQ
+             * @details The cards answer in random time slots (FelicaConfig::timeSlots), all
+             *          responses are received. The RF field must be on.
+             * @param cards Vector to store the cards found (IDm in uid, PMm in appData)
+             * @return NFCStatus::OK if at least one card answered
+             */
+            NFCStatus PollFelica(std::vector<TagInfo>& cards);
+
+            /**
+             * @brief Set FeliCa polling parameters
+             * @param config FeliCa configuration
+             */
+            void SetFelicaConfig(const FelicaConfig& config) { _felicaConfig = config; }
+
+            /**
+             * @brief Get FeliCa polling parameters
+             * @return FeliCa configuration
+             */
+            const FelicaConfig& GetFelicaConfig(void) const { return _felicaConfig; }
+
+            // ============================================================================
+            // ISO15693
+            // ============================================================================
+
+            /**
+             * @brief Collect all ISO15693 tags in the field
+             * @details 16-slot INVENTORY rounds; a slot in which several tags collided is
+             *          inventoried again with the mask extended by the slot number. The RF field must be on.
+             * @param tags Vector to store the tags found (UID with 0xE0 first, DSFID in appData)
+             * @return NFCStatus::OK if at least one tag answered
+             */
+            NFCStatus PollVicinity(std::vector<TagInfo>& tags);
+
+            /**
+             * @brief Set tag that received frames are accounted to
+             * @param uid Tag UID (empty to stop accounting)
+             */
+            void SetActiveTag(const std::vector<uint8_t>& uid) { _activeUid = uid; }
+
+            /**
+             * @brief Get signal statistics of a tag
+             * @param uid Tag UID
+             * @param stats Reference to store statistics
+             * @return true if statistics exist for the tag, false otherwise
+             */
+            bool GetSignalStats(const std::vector<uint8_t>& uid, SignalStats& stats) const;
+
+            /**
+             * @brief Clear all signal statistics
+             */
+            void ResetSignalStats(void) { _signalStats.clear(); }
+
+            /**
+             * @brief Set adaptive receiver gain policy
+             * @param policy Policy to apply
+             */
+            void SetSignalPolicy(const SignalPolicy& policy) { _signalPolicy = policy; }
+
+            /**
+             * @brief Get adaptive receiver gain policy
+             * @return Current policy
+             */
+            const SignalPolicy& GetSignalPolicy(void) const { return _signalPolicy; }
+
         private:
+            static constexpr size_t MAX_SIGNAL_ENTRIES = 8; /**< Tags tracked in the signal statistics */
+            static constexpr size_t TECHNOLOGY_COUNT = 4;   /**< Polled technologies (A, B, F, V) */
+            static constexpr size_t MAX_UID_CACHE_ENTRIES = 8; /**< Tags tracked for de-duplication */
+            static constexpr size_t MAX_MODEL_ENTRIES = 16;     /**< Identified tags kept */
+            static constexpr size_t MAX_VICINITY_ROUNDS = 32;   /**< 16-slot INVENTORY rounds per ISO15693 inventory */
+
             ST25R3911B* _controller;        /**< NFC controller */
             TagReader* _tagReader;          /**< Tag reader instance */
             TagWriter* _tagWriter;          /**< Tag writer instance */
+            IsoDep* _isoDep;                /**< ISO14443-4 link of the activated tag */
+            TagMemoryCache* _memoryCache;   /**< Memory images of the tags in the field */
+            MifareClassic* _mifareClassic;  /**< MIFARE Classic session of the activated card */
             bool _initialized;              /**< Initialization status */
             bool _detectionActive;          /**< Detection active flag */
             TagDetectionCallback _detectionCallback; /**< Detection callback */
+            TagDetectionCallback _removalCallback; /**< Removal callback */
             uint32_t _detectionProtocols;   /**< Protocols to detect */
+            std::vector<uint8_t> _activeUid; /**< Tag that received frames are accounted to */
+            std::vector<SignalStats> _signalStats; /**< Per-tag signal statistics */
+            SignalPolicy _signalPolicy;     /**< Adaptive receiver gain policy */
+            uint32_t _signalSequence;       /**< Update counter for entry replacement */
+            DiscoveryState _discoveryState; /**< Discovery state */
+            DiscoveryConfig _discoveryConfig; /**< Discovery timing */
+            DiscoveryStats _discoveryStats; /**< Discovery statistics */
+            uint32_t _nextStepTick;         /**< Tick at which the next discovery step is due */
+            uint32_t _cycleStartTick;       /**< Tick at which the current poll cycle started */
+            uint8_t _presenceFailures;      /**< Consecutive failed presence checks */
+            TagInfo _pendingTag;            /**< Tag being activated */
+            TagInfo _currentTag;            /**< Activated tag */
+            bool _tagPresent;               /**< Activated tag in the field */
+            TechnologyStats _technologyStats[TECHNOLOGY_COUNT]; /**< Per-technology poll statistics */
+            std::vector<NFCProtocol> _pollSequence; /**< Technologies polled in the current cycle */
+            size_t _pollIndex;              /**< Technology being polled */
+            bool _pollConfigured;           /**< Controller configured for the technology being polled */
+            uint32_t _guardStartTick;       /**< Tick since which the field is unmodulated */
+            uint32_t _fieldOnTick;          /**< Tick at which discovery switched the field on */
+            uint32_t _activityUntilTick;    /**< Tick until which the active poll period applies */
+            InventoryCallback _inventoryCallback; /**< Inventory cycle callback */
+            std::vector<TagInfo> _inventory; /**< Tags found in the last inventory cycle */
+            InventoryStats _inventoryStats; /**< Inventory statistics */
+            std::vector<UidCacheEntry> _uidCache; /**< Recently seen tags */
+            UidCacheConfig _uidCacheConfig; /**< Detection de-duplication */
+            std::vector<TagModelInfo> _modelCache; /**< Identified Type 2 tags by UID */
+            uint32_t _modelSequence;        /**< Use counter for entry replacement */
+            FelicaConfig _felicaConfig;     /**< FeliCa polling parameters */
+            std::vector<TagInfo> _polledTags; /**< Tags that answered the last FeliCa or ISO15693 poll */
+
+            /**
+             * @brief Account signal quality of a received or lost frame to the active tag
+             * @param quality Signal quality of the frame
+             */
+            void handleSignalQuality(const SignalQuality& quality);
+
+            /**
+             * @brief Apply the adaptive gain policy for a tag
+             * @param stats Statistics of the active tag
+             */
+            void updateReceiverGain(const SignalStats& stats);
+
+            /**
+             * @brief Move the discovery to a new state
+             * @param state Next state
+             * @param delayMs Delay before the state runs
+             */
+            void enterState(DiscoveryState state, uint32_t delayMs);
+
+            /**
+             * @brief Get the time until the next poll cycle
+             * @param onTimeMs Time the field was on in the cycle that ended
+             * @return Off time from the poll period, duty cycle limit and recent activity
+             */
+            uint32_t pollOffTimeMs(uint32_t onTimeMs) const;
+
+            /**
+             * @brief Build the poll sequence of a cycle from the requested protocols
+             * @details Most recently seen technologies come first, technologies that did not
+             *          answer are skipped for an exponentially growing number of cycles.
+             */
+            void buildPollSequence(void);
+
+            /**
+             * @brief Send the poll command of a technology
+             * @param technology Technology to poll
+             * @param tagInfo Reference to store the poll response information
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus pollTechnology(NFCProtocol technology, TagInfo& tagInfo);
+
+            /**
+             * @brief Get the no-response timeout of a poll command
+             * @param technology Technology polled
+             * @return Timeout in microseconds (covers all FeliCa time slots)
+             */
+            uint32_t responseTimeUs(NFCProtocol technology) const;
+
+            /**
+             * @brief Poll for FeliCa cards (SENSF_REQ) and receive the answers of all time slots
+             * @param cards Vector to store the cards found
+             * @return NFCStatus::COLLISION_ERROR if only corrupted answers were received
+             */
+            NFCStatus pollTypeF(std::vector<TagInfo>& cards);
+
+            /**
+             * @brief Report the further tags of the last FeliCa or ISO15693 poll
+             */
+            void reportPolledTags(void);
+
+            /**
+             * @brief Send a single slot ISO15693 INVENTORY
+             * @param tagInfo Reference to store the tag found
+             * @param uid Only ask the tag with this UID (empty = all tags)
+             * @return NFCStatus::COLLISION_ERROR if several tags answered
+             */
+            NFCStatus pollTypeV(TagInfo& tagInfo, const std::vector<uint8_t>& uid = {});
+
+            /**
+             * @brief Inventory all ISO15693 tags with 16 slots and mask recursion
+             * @param tags Vector to store the tags found
+             * @return NFCStatus::COLLISION_ERROR if only corrupted answers were received
+             */
+            NFCStatus inventoryTypeV(std::vector<TagInfo>& tags);
+
+            /**
+             * @brief Parse an ISO15693 INVENTORY response
+             * @param response Received response (flags, DSFID, UID LSB first)
+             * @param tagInfo Reference to store UID and DSFID
+             * @return true if the response is valid
+             */
+            static bool parseInventoryV(const std::vector<uint8_t>& response, TagInfo& tagInfo);
+
+            /**
+             * @brief Read the memory layout of an ISO15693 tag (GET SYSTEM INFORMATION)
+             * @details Tags without the command keep an unknown layout. Tags reporting no memory
+             *          size or 256 blocks are asked again with EXTENDED GET SYSTEM INFORMATION.
+             * @param tagInfo Tag information, data size and block size are updated
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus readSystemInfoV(TagInfo& tagInfo);
+
+            /**
+             * @brief Open the ISO14443-4 link of a selected tag (RATS for Type A, ATQB parameters for Type B)
+             * @param tagInfo Tag information, the ATS of a Type A tag is stored as protocol info
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus activateIsoDep(TagInfo& tagInfo);
+
+            /**
+             * @brief Poll for ISO14443A tags (REQA or WUPA)
+             * @param tagInfo Reference to store the ATQA
+             * @param wakeUp Send WUPA to wake halted tags as well
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus pollTypeA(TagInfo& tagInfo, bool wakeUp = false);
+
+            /**
+             * @brief Wake and select the activated ISO14443A tag again (S(DESELECT) or HLTA, WUPA, SELECT)
+             * @param tagInfo Tag to re-activate
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus reactivateTypeA(const TagInfo& tagInfo);
+
+            /**
+             * @brief Poll for ISO14443B tags (REQB or WUPB)
+             * @param tagInfo Reference to store the ATQB information
+             * @param wakeUp Send WUPB to wake halted tags as well
+             * @param slotExponent Number of slots N = 2^slotExponent (0-4)
+             * @return NFCStatus::COLLISION_ERROR if several tags answered in the first slot
+             */
+            NFCStatus pollTypeB(TagInfo& tagInfo, bool wakeUp = false, uint8_t slotExponent = 0);
+
+            /**
+             * @brief Parse the ATQB received in a slot
+             * @param status Status of the exchange
+             * @param atqb Received ATQB
+             * @param tagInfo Reference to store PUPI, application data and protocol info
+             * @return NFCStatus::COLLISION_ERROR if the slot was corrupted by several tags
+             */
+            NFCStatus parseAtqb(NFCStatus status, const std::vector<uint8_t>& atqb, TagInfo& tagInfo);
+
+            /**
+             * @brief Resolve one ISO14443B tag with slotted anticollision
+             * @details Runs REQB with 4, 8 and 16 slots and Slot-MARKERs until a slot holds a single ATQB.
+             * @param tagInfo Tag information of the poll, filled with the resolved tag
+             * @param pupi Only accept this tag and wake it with WUPB (empty = first tag found)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus resolveTypeB(TagInfo& tagInfo, const std::vector<uint8_t>& pupi = {});
+
+            /**
+             * @brief Select a resolved ISO14443B tag (ATTRIB)
+             * @param tagInfo Resolved tag
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus activateTypeB(const TagInfo& tagInfo);
+
+            /**
+             * @brief Wake and select the activated ISO14443B tag again (S(DESELECT), WUPB, ATTRIB)
+             * @param tagInfo Tag to re-activate
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus reactivateTypeB(const TagInfo& tagInfo);
+
+            /**
+             * @brief Identify the exact product of a selected Type 2 tag
+             * @details Uses the per-UID cache, otherwise GET_VERSION and READ_SIG. Tags without
+             *          GET_VERSION are re-activated and identified as MIFARE Ultralight.
+             * @param tagInfo Tag information, model and data size are updated
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus identifyModel(TagInfo& tagInfo);
+
+            /**
+             * @brief Halt the selected ISO14443A tag (HLTA)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus haltTypeA(void);
+
+            /**
+             * @brief Resolve, serve and halt the tags in the field one by one
+             * @param tags Vector to store the tags found
+             * @param session Called for each tag while it is selected (may be nullptr)
+             * @param tagsReady Tags already answered a poll and wait for anticollision
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus runInventory(std::vector<TagInfo>& tags, TagDetectionCallback session, bool tagsReady);
+
+            /**
+             * @brief Resolve the tag type of a selected ISO14443A tag from its SAK
+             * @param tagInfo Tag information, protocol and data size are updated
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus resolveTypeA(TagInfo& tagInfo);
+
+            /**
+             * @brief Run one presence check on the activated tag
+             * @param reactivate Re-activate a Type 2 tag instead of reading page 0
+             * @return NFCStatus::OK if the tag answered
+             */
+            NFCStatus checkPresence(bool reactivate);
+
+            /**
+             * @brief Forget the activated tag and report its removal
+             */
+            void removeCurrentTag(void);
+
+            /**
+             * @brief Record a sighting of a tag in the de-duplication cache
+             * @param tag Tag seen
+             * @return true if the tag is new and has to be reported
+             */
+            bool recordSighting(const TagInfo& tag);
+
+            /**
+             * @brief Report tags that have not been seen for the TTL as removed
+             * @param now Current tick count
+             */
+            void expireSightings(uint32_t now);
 
             /**
-             * @brief Handle tag detection interrupt
+             * @brief Record the latency of a discovered tag
+             * @param latencyMs Poll cycle start to callback in milliseconds
              */
-            void handleTagDetection(void);
+            void recordLatency(uint32_t latencyMs);
 
             /**
              * @brief Identify tag type from response
@@ -211,8 +931,12 @@ namespace NFC
             /**
              * @brief Constructor
              * @param controller ST25R3911B controller instance
+             * @param isoDep ISO14443-4 link used for Type 4 tags (nullptr = no Type 4 support)
+             * @param memoryCache Memory images served instead of Type 2 and Type 5 reads (nullptr = none)
+             * @param mifareClassic MIFARE Classic protocol (nullptr = no MIFARE Classic support)
              */
-            TagReader(ST25R3911B* controller);
+            TagReader(ST25R3911B* controller, IsoDep* isoDep = nullptr, TagMemoryCache* memoryCache = nullptr,
+                      MifareClassic* mifareClassic = nullptr);
 
             /**
              * @brief Destructor
@@ -224,9 +948,26 @@ namespace NFC
              * @param tagInfo Tag information
              * @param uid Vector to store UID
              * @return NFCStatus indicating success or failure
+             * @note The tag must be in READY state (after REQA/WUPA); it is selected afterwards.
              */
             NFCStatus ReadUID(const TagInfo& tagInfo, std::vector<uint8_t>& uid);
 
+            /**
+             * @brief Run ISO14443A anticollision and select over all cascade levels
+             * @param tagInfo Tag information, UID (4, 7 or 10 bytes) and SAK are stored on success
+             * @return NFCStatus indicating success or failure
+             * @note The tag must be in READY state (after REQA/WUPA).
+             */
+            NFCStatus Anticollision(TagInfo& tagInfo);
+
+            /**
+             * @brief Select a tag with a known UID over all cascade levels
+             * @param uid Complete UID (4, 7 or 10 bytes)
+             * @param sak Reference to store the final SAK
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus Select(const std::vector<uint8_t>& uid, uint8_t& sak);
+
             /**
              * @brief Read raw data from tag
              * @param tagInfo Tag information
@@ -239,12 +980,34 @@ namespace NFC
 
             /**
              * @brief Read NDEF message from tag
+             * @details ISO-DEP tags are read as Type 4 tags (NDEF file of the NDEF Tag Application),
+             *          the ISO14443-4 link must be active. Other ISO14443A tags are read as Type 2
+             *          tags (CC in page 3, TLV area from page 4), ISO15693 tags as Type 5 tags (CC in
+             *          block 0 followed by the TLV area). Type 2 and Type 5 pages and blocks already
+             *          read or written while the tag stays present come from the memory image cache.
              * @param tagInfo Tag information
              * @param message Reference to store NDEF message
-             * @return NFCStatus indicating success or failure
+             * @return NFCStatus::INTERRUPTED_WRITE if a Type 2 or Type 5 update did not complete
              */
             NFCStatus ReadNDEF(const TagInfo& tagInfo, NDEFMessage& message);
 
+            /**
+             * @brief Read the capability container of a Type 4 tag
+             * @details Selects the NDEF Tag Application and reads the CC file; the NDEF file is
+             *          selected afterwards.
+             * @param cc Reference to store the capability container
+             * @return NFCStatus::UNSUPPORTED_TAG if the tag has no NDEF Tag Application
+             */
+            NFCStatus ReadType4Capability(Type4CapabilityContainer& cc);
+
+            /**
+             * @brief Read the capability container of a Type 5 tag
+             * @param tagInfo Tag information
+             * @param cc Reference to store the capability container
+             * @return NFCStatus::UNSUPPORTED_TAG if block 0 holds no Type 5 CC
+             */
+            NFCStatus ReadType5Capability(const TagInfo& tagInfo, Type5CapabilityContainer& cc);
+
             /**
              * @brief Read text record from tag
              * @param tagInfo Tag information
@@ -280,7 +1043,50 @@ namespace NFC
 
         private:
             ST25R3911B* _controller;        /**< NFC controller */
+            IsoDep* _isoDep;                /**< ISO14443-4 link (Type 4 tags) */
+            TagMemoryCache* _memoryCache;   /**< Memory images of the tags in the field */
+            MifareClassic* _mifareClassic;  /**< MIFARE Classic protocol */
             TagOperationCallback _callback; /**< Operation callback */
+            std::vector<uint8_t> _vicinityUid;  /**< ISO15693 tag the read size below belongs to */
+            uint16_t _vicinityBlocksPerRead;    /**< Blocks per READ MULTIPLE BLOCKS accepted by that tag */
+
+            /**
+             * @brief Read the NDEF message of a Type 4 tag (READ BINARY in MLe sized chunks)
+             * @param data Vector to store the NDEF message (without length field)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus readType4NDEF(std::vector<uint8_t>& data);
+
+            /**
+             * @brief Read the NDEF message of a Type 2 tag
+             * @details The TLVs are parsed as the pages arrive: the CC and the first TLV headers
+             *          come with one frame, Lock and Memory Control TLVs are skipped and reading
+             *          ends with the NDEF message or at the Terminator TLV.
+             * @param tagInfo Tag information (identified model)
+             * @param data Vector to store the NDEF message (value of the NDEF TLV)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus readType2NDEF(const TagInfo& tagInfo, std::vector<uint8_t>& data);
+
+            /**
+             * @brief Read the NDEF message of a Type 5 tag
+             * @details The CC, the TLV headers and the start of the message come with the first
+             *          READ MULTIPLE BLOCKS, the rest of the message with as few frames as the tag
+             *          accepts.
+             * @param tagInfo Tag to read (addressed by UID)
+             * @param data Vector to store the NDEF message (value of the NDEF TLV)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus readType5NDEF(const TagInfo& tagInfo, std::vector<uint8_t>& data);
+
+            /**
+             * @brief Get the READ MULTIPLE BLOCKS size for a tag
+             * @details Starts at a 256-byte response for a new UID and shrinks when the tag
+             *          rejects a frame size.
+             * @param tagInfo Tag to read
+             * @return Reference to the blocks per frame of this tag
+             */
+            uint16_t& vicinityBlocksPerRead(const TagInfo& tagInfo);
 
             /**
              * @brief Parse NDEF message from raw data
@@ -301,21 +1107,51 @@ namespace NFC
             NFCStatus parseNDEFRecord(const std::vector<uint8_t>& data, size_t offset, NDEFRecord& record, size_t& bytesRead);
 
             /**
-             * @brief Read from ISO14443A tag
-             * @param address Address to read from
+             * @brief Resolve the 5 bytes (UID part + BCC) of one cascade level
+             * @param selCode SEL code of the cascade level (0x93, 0x95 or 0x97)
+             * @param cl Array to store the cascade level bytes
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus resolveCascadeLevel(uint8_t selCode, uint8_t cl[5]);
+
+            /**
+             * @brief Select one cascade level
+             * @param selCode SEL code of the cascade level
+             * @param cl Cascade level bytes (UID part + BCC)
+             * @param sak Reference to store the SAK
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus selectCascadeLevel(uint8_t selCode, const uint8_t cl[5], uint8_t& sak);
+
+            /**
+             * @brief Read from Type 2 tag (FAST_READ page ranges, READ for tags without it)
+             * @param tagInfo Tag information (identified model)
+             * @param address Byte address to read from (page 0 at address 0)
              * @param length Number of bytes to read
              * @param data Vector to store read data
              * @return NFCStatus indicating success or failure
              */
-            NFCStatus readISO14443A(uint16_t address, uint16_t length, std::vector<uint8_t>& data);
+            NFCStatus readISO14443A(const TagInfo& tagInfo, uint16_t address, uint16_t length, std::vector<uint8_t>& data);
+
+            /**
+             * @brief Read from MIFARE Classic tag (one authentication per sector, key function keys)
+             * @param tagInfo Selected card
+             * @param block First block number to read
+             * @param length Number of bytes to read (whole blocks, at least one)
+             * @param data Vector to store read data
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus readMifareClassic(const TagInfo& tagInfo, uint8_t block, uint16_t length, std::vector<uint8_t>& data);
 
             /**
-             * @brief Read from MIFARE Classic tag
-             * @param block Block number to read
+             * @brief Read from ISO15693 tag (READ MULTIPLE BLOCKS, extended commands above block 255)
+             * @param tagInfo Tag to read (addressed by UID)
+             * @param address Byte address to read from
+             * @param length Number of bytes to read
              * @param data Vector to store read data
              * @return NFCStatus indicating success or failure
              */
-            NFCStatus readMifareClassic(uint8_t block, std::vector<uint8_t>& data);
+            NFCStatus readISO15693(const TagInfo& tagInfo, uint16_t address, uint16_t length, std::vector<uint8_t>& data);
     };
 
     /**
@@ -325,11 +1161,19 @@ namespace NFC
     class TagWriter
     {
         public:
+            /** @brief Tag reselection after a page or block write that was not acknowledged */
+            using ActivateFunction = std::function<NFCStatus(const TagInfo&)>;
+
             /**
              * @brief Constructor
              * @param controller ST25R3911B controller instance
+             * @param isoDep ISO14443-4 link used for Type 4 tags (nullptr = no Type 4 support)
+             * @param memoryCache Memory images updated by Type 2 and Type 5 writes (nullptr = none)
+             * @param mifareClassic MIFARE Classic protocol (nullptr = no MIFARE Classic support)
+             * @param activate Tag reselection used by verified writes (nullptr = none)
              */
-            TagWriter(ST25R3911B* controller);
+            TagWriter(ST25R3911B* controller, IsoDep* isoDep = nullptr, TagMemoryCache* memoryCache = nullptr,
+                      MifareClassic* mifareClassic = nullptr, ActivateFunction activate = nullptr);
 
             /**
              * @brief Destructor
@@ -347,6 +1191,9 @@ namespace NFC
 
             /**
              * @brief Write NDEF message to tag
+             * @details ISO-DEP tags are written as Type 4 tags (NDEF file of the NDEF Tag Application),
+             *          the ISO14443-4 link must be active. Other ISO14443A tags are written as Type 2
+             *          tags and need a CC in page 3, ISO15693 tags as Type 5 tags with a CC in block 0.
              * @param tagInfo Tag information
              * @param message NDEF message to write
              * @return NFCStatus indicating success or failure
@@ -408,6 +1255,9 @@ namespace NFC
 
             /**
              * @brief Format tag for NDEF
+             * @details Writes a capability container and an empty NDEF TLV: page 3 of Type 2 tags
+             *          (a valid CC is kept, it is one-time programmable), block 0 of Type 5 tags
+             *          (memory size from the system information).
              * @param tagInfo Tag information
              * @return NFCStatus indicating success or failure
              */
@@ -419,9 +1269,76 @@ namespace NFC
              */
             void SetCallback(TagOperationCallback callback) { _callback = callback; }
 
+            /**
+             * @brief Set page and block write options
+             * @details Differential writes cost a read of the written range (usually one frame,
+             *          NDEF writes reuse the bytes read to find the NDEF TLV) and save a WRITE of
+             *          several milliseconds for every page or block that does not change.
+             *          Verification reads the written range back with FAST_READ or READ MULTIPLE
+             *          BLOCKS (one frame per up to 256 bytes) and only repeats the failed writes;
+             *          a failure after the retries is reported as NFCStatus::VERIFY_ERROR.
+             * @param config Write configuration
+             */
+            void SetWriteConfig(const WriteConfig& config) { _writeConfig = config; }
+
+            /**
+             * @brief Get page and block write options
+             * @return Write configuration
+             */
+            const WriteConfig& GetWriteConfig(void) const { return _writeConfig; }
+
+            /**
+             * @brief Get page and block write counters
+             * @return Write counters
+             */
+            const WriteStats& GetWriteStats(void) const { return _writeStats; }
+
+            /**
+             * @brief Reset page and block write counters
+             */
+            void ResetWriteStats(void) { _writeStats = {}; }
+
         private:
             ST25R3911B* _controller;        /**< NFC controller */
+            IsoDep* _isoDep;                /**< ISO14443-4 link (Type 4 tags) */
+            TagMemoryCache* _memoryCache;   /**< Memory images of the tags in the field */
+            MifareClassic* _mifareClassic;  /**< MIFARE Classic protocol */
+            ActivateFunction _activate;     /**< Tag reselection after an unacknowledged write */
             TagOperationCallback _callback; /**< Operation callback */
+            WriteConfig _writeConfig;       /**< Page and block write options */
+            WriteStats _writeStats;         /**< Page and block write counters */
+
+            /**
+             * @brief Write the NDEF message of a Type 4 tag (UPDATE BINARY in MLc sized chunks)
+             * @details The length field is cleared with the first chunk and set after the message
+             *          is complete, as required by the Type 4 update procedure.
+             * @param data NDEF message (without length field)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus writeType4NDEF(const std::vector<uint8_t>& data);
+
+            /**
+             * @brief Write the NDEF message of a Type 2 tag
+             * @details Replaces the NDEF TLV (or adds one at the Terminator TLV) behind any Lock
+             *          and Memory Control TLVs and ends the message with a Terminator TLV if the
+             *          data area has room for it. The page with the TLV length is written last, a
+             *          tear-safe update clears it first.
+             * @param tagInfo Tag information (identified model)
+             * @param data NDEF message (value of the NDEF TLV)
+             * @return NFCStatus::INVALID_PARAM if the message does not fit the data area
+             */
+            NFCStatus writeType2NDEF(const TagInfo& tagInfo, const std::vector<uint8_t>& data);
+
+            /**
+             * @brief Write the NDEF message of a Type 5 tag
+             * @details Replaces the NDEF TLV (or adds one at the Terminator TLV) and ends the
+             *          message with a Terminator TLV if the area has room for it. The block with the
+             *          TLV length is written last, a tear-safe update clears it first.
+             * @param tagInfo Tag to write (addressed by UID)
+             * @param data NDEF message (value of the NDEF TLV)
+             * @return NFCStatus::INVALID_PARAM if the message does not fit the TLV area
+             */
+            NFCStatus writeType5NDEF(const TagInfo& tagInfo, const std::vector<uint8_t>& data);
 
             /**
              * @brief Create NDEF message from records
@@ -440,20 +1357,33 @@ namespace NFC
             NFCStatus createNDEFRecord(const NDEFRecord& record, std::vector<uint8_t>& data);
 
             /**
-             * @brief Write to ISO14443A tag
-             * @param address Address to write to
+             * @brief Write to Type 2 tag (WRITE per 4-byte page)
+             * @param tagInfo Tag information (identified model, for differential writes)
+             * @param address Byte address to write to (page 0 at address 0)
              * @param data Data to write
              * @return NFCStatus indicating success or failure
              */
-            NFCStatus writeISO14443A(uint16_t address, const std::vector<uint8_t>& data);
+            NFCStatus writeISO14443A(const TagInfo& tagInfo, uint16_t address, const std::vector<uint8_t>& data);
 
             /**
-             * @brief Write to MIFARE Classic tag
-             * @param block Block number to write
+             * @brief Write to ISO15693 tag (WRITE SINGLE BLOCK, partial blocks are read first)
+             * @details Blocks above 255 are written with EXTENDED WRITE SINGLE BLOCK.
+             * @param tagInfo Tag to write (addressed by UID)
+             * @param address Byte address to write to
              * @param data Data to write
              * @return NFCStatus indicating success or failure
              */
-            NFCStatus writeMifareClassic(uint8_t block, const std::vector<uint8_t>& data);
+            NFCStatus writeISO15693(const TagInfo& tagInfo, uint16_t address, const std::vector<uint8_t>& data);
+
+            /**
+             * @brief Write to MIFARE Classic tag (one authentication per sector, key function keys)
+             * @details Data blocks only: block 0 and sector trailers are refused.
+             * @param tagInfo Selected card
+             * @param block First block number to write
+             * @param data Data to write (whole blocks)
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus writeMifareClassic(const TagInfo& tagInfo, uint8_t block, const std::vector<uint8_t>& data);
 
             /**
              * @brief Get URI prefix code
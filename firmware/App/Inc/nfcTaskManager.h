@@ -248,6 +248,7 @@ namespace NFCTask
             // Statistics
             uint32_t _commandsProcessed;            /**< Commands processed counter */
             uint32_t _nextRequestId;                /**< Next request ID */
+            uint32_t _nextDiscoveryMs;              /**< Time until the next discovery step */
             
             // Detection callback
             std::function<void(const NFC::TagInfo&)> _detectionCallback;
@@ -263,6 +264,11 @@ namespace NFCTask
              */
             void taskMainLoop(void);
 
+            /**
+             * @brief Run the next discovery step if detection is active
+             */
+            void runDiscovery(void);
+
             /**
              * @brief Process NFC command
              * @param command Command to process
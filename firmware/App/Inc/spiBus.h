@@ -0,0 +1,86 @@
+/**
+ * @file    App/Inc/spiBus.h
+ * @brief   SPI bus interface header file.
+ * @details This file contains the hardware independent SPI bus interface used by device drivers.
+ *          It allows drivers to run on top of the STM32 SPI master or on top of a software model.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef INC_SPI_BUS_H
+#define INC_SPI_BUS_H
+
+/**
+ * @include necessary headers
+ */
+#include <vector>
+#include <cstdint>
+
+/**
+ * @namespace SPI
+ * @brief Contains SPI related functions and definitions.
+ */
+namespace SPI
+{
+    /**
+     * @enum SPIStatus
+     * @brief Return status codes for SPI operations.
+     */
+    enum class SPIStatus
+    {
+        OK = 0,
+        ERROR,
+        BUSY,
+        TIMEOUT,
+        INVALID_PARAM
+    };
+
+    /**
+     * @class SPIBus
+     * @brief Abstract SPI bus interface as seen by a device driver.
+     * @details A bus frame starts with SelectSlave() and ends with DeselectSlave().
+     */
+    class SPIBus
+    {
+        public:
+            /**
+             * @brief Destructor.
+             */
+            virtual ~SPIBus() = default;
+
+            /**
+             * @brief Check if the bus is ready for transfers
+             * @return true if initialized, false otherwise
+             */
+            virtual bool IsInitialized(void) const = 0;
+
+            /**
+             * @brief Select slave device (assert CS)
+             */
+            virtual void SelectSlave(void) = 0;
+
+            /**
+             * @brief Deselect slave device (deassert CS)
+             */
+            virtual void DeselectSlave(void) = 0;
+
+            /**
+             * @brief Transmit data over SPI
+             * @param data Vector containing data to transmit
+             * @return SPIStatus indicating success or failure
+             */
+            virtual SPIStatus Transmit(const std::vector<uint8_t> &data) = 0;
+
+            /**
+             * @brief Transmit and receive data simultaneously
+             * @param txData Vector containing data to transmit
+             * @param rxData Vector to store received data
+             * @return SPIStatus indicating success or failure
+             */
+            virtual SPIStatus TransmitReceive(const std::vector<uint8_t> &txData, std::vector<uint8_t> &rxData) = 0;
+    };
+
+} // namespace SPI
+
+#endif /* INC_SPI_BUS_H */
@@ -17,6 +17,7 @@
 #include "stm32l4xx_ll_spi.h"
 #include "stm32l4xx_ll_bus.h"
 #include "stm32l4xx_ll_gpio.h"
+#include "spiBus.h"
 #include <vector>
 #include <cstdint>
 
@@ -74,19 +75,6 @@ namespace SPI
         PRESCALER_256 = LL_SPI_BAUDRATEPRESCALER_DIV256
     };
 
-    /**
-     * @enum SPIStatus
-     * @brief Return status codes for SPI operations.
-     */
-    enum class SPIStatus
-    {
-        OK = 0,
-        ERROR,
-        BUSY,
-        TIMEOUT,
-        INVALID_PARAM
-    };
-
     /**
      * @struct SPIConfig
      * @brief Configuration structure for SPI interface.
@@ -195,7 +183,7 @@ namespace SPI
      * @class SPIMaster
      * @brief Class for SPI Master operations.
      */
-    class SPIMaster : public SPIBase
+    class SPIMaster : public SPIBase, public SPIBus
     {
         public:
             /**
@@ -215,22 +203,28 @@ namespace SPI
                 DeInit();
             }
 
+            /**
+             * @brief Check if SPI is initialized
+             * @return true if initialized, false otherwise
+             */
+            bool IsInitialized(void) const override { return SPIBase::IsInitialized(); }
+
             /**
              * @brief Select slave device (assert CS)
              */
-            void SelectSlave(void);
+            void SelectSlave(void) override;
 
             /**
              * @brief Deselect slave device (deassert CS)
              */
-            void DeselectSlave(void);
+            void DeselectSlave(void) override;
 
             /**
              * @brief Transmit data over SPI
              * @param data Vector containing data to transmit
              * @return SPIStatus indicating success or failure
              */
-            SPIStatus Transmit(const std::vector<uint8_t> &data);
+            SPIStatus Transmit(const std::vector<uint8_t> &data) override;
 
             /**
              * @brief Receive data over SPI
@@ -246,7 +240,7 @@ namespace SPI
              * @param rxData Vector to store received data
              * @return SPIStatus indicating success or failure
              */
-            SPIStatus TransmitReceive(const std::vector<uint8_t> &txData, std::vector<uint8_t> &rxData);
+            SPIStatus TransmitReceive(const std::vector<uint8_t> &txData, std::vector<uint8_t> &rxData) override;
 
             /**
              * @brief Transmit single byte
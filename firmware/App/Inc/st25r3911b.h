@@ -13,13 +13,17 @@
 /**
  * @include necessary headers
  */
-#include "spiClass.h"
-#include "gpioClass.h"
+#include "spiBus.h"
 #include "st25r3911b_registers.h"
 #include <vector>
 #include <cstdint>
 #include <functional>
 
+namespace GPIO
+{
+    class GPIOInterrupt;
+}
+
 /**
  * @namespace NFC
  * @brief Contains NFC related functions and definitions.
@@ -43,7 +47,13 @@ namespace NFC
         COLLISION_ERROR,        /**< Collision detected */
         NO_TAG_FOUND,           /**< No NFC tag found */
         UNSUPPORTED_TAG,        /**< Unsupported tag type */
-        COMMUNICATION_ERROR     /**< Communication error */
+        COMMUNICATION_ERROR,    /**< Communication error */
+        PARITY_ERROR,           /**< Parity error */
+        FRAMING_ERROR,          /**< Hard framing error (reception aborted) */
+        SOFT_FRAMING_ERROR,     /**< Soft framing error (frame received with framing errors) */
+        VERIFY_ERROR,           /**< Data read back differs from the data written */
+        INTERRUPTED_WRITE,      /**< NDEF update interrupted (empty NDEF TLV over message data) */
+        AUTH_ERROR              /**< Authentication failed (wrong key or card response invalid) */
     };
 
     /**
@@ -60,6 +70,35 @@ namespace NFC
         MIFARE_CLASSIC         /**< MIFARE Classic */
     };
 
+    /**
+     * @enum NFCBitRate
+     * @brief RF bit rate (same for both directions).
+     */
+    enum class NFCBitRate
+    {
+        BR_106 = 0,            /**< 106 kbps (ISO14443A/B) */
+        BR_212,                /**< 212 kbps (FeliCa) */
+        BR_424,                /**< 424 kbps (FeliCa) */
+        BR_848                 /**< 848 kbps */
+    };
+
+    /**
+     * @enum TagModel
+     * @brief Exact tag product (identified with GET_VERSION).
+     */
+    enum class TagModel
+    {
+        UNKNOWN = 0,           /**< Not identified */
+        ULTRALIGHT,            /**< MIFARE Ultralight / Ultralight C (no GET_VERSION) */
+        ULTRALIGHT_EV1_MF0UL11, /**< MIFARE Ultralight EV1, 48 bytes user memory */
+        ULTRALIGHT_EV1_MF0UL21, /**< MIFARE Ultralight EV1, 128 bytes user memory */
+        NTAG210,               /**< NTAG210, 48 bytes user memory */
+        NTAG212,               /**< NTAG212, 128 bytes user memory */
+        NTAG213,               /**< NTAG213, 144 bytes user memory */
+        NTAG215,               /**< NTAG215, 504 bytes user memory */
+        NTAG216                /**< NTAG216, 888 bytes user memory */
+    };
+
     /**
      * @enum NFCField
      * @brief NFC field state.
@@ -76,7 +115,7 @@ namespace NFC
      */
     struct NFCConfig
     {
-        SPI::SPIMaster* spiMaster;          /**< SPI master interface */
+        SPI::SPIBus* spiMaster;             /**< SPI bus interface (hardware master or emulator) */
         GPIO::GPIOInterrupt* irqPin;        /**< Interrupt pin interface */
         NFCProtocol defaultProtocol;        /**< Default protocol to use */
         uint32_t timeoutMs;                 /**< Default timeout in milliseconds */
@@ -95,10 +134,46 @@ namespace NFC
         std::vector<uint8_t> atqa;          /**< ATQA bytes (for Type A tags) */
         std::vector<uint8_t> pupi;          /**< PUPI (for Type B tags) */
         std::vector<uint8_t> appData;       /**< Application data */
-        uint16_t dataSize;                  /**< Available data size */
+        std::vector<uint8_t> protocolInfo;  /**< Protocol info (ATQB bytes 10-12 for Type B, ATS for ISO-DEP Type A, request data for FeliCa) */
+        uint16_t dataSize;                  /**< Available data size (user memory, 0 = unknown) */
+        uint8_t blockSize;                  /**< Memory block size in bytes (ISO15693 tags, 0 = unknown) */
+        TagModel model;                     /**< Exact product (Type 2 tags) */
         bool isReadOnly;                    /**< Read-only flag */
     };
 
+    /**
+     * @struct ErrorCounters
+     * @brief Receive error counters of the controller.
+     */
+    struct ErrorCounters
+    {
+        uint32_t crc;                       /**< CRC errors */
+        uint32_t parity;                    /**< Parity errors */
+        uint32_t hardFraming;               /**< Hard framing errors */
+        uint32_t softFraming;               /**< Soft framing errors */
+        uint32_t collision;                 /**< Bit collisions */
+        uint32_t fifoOverflow;              /**< FIFO overflows */
+        uint32_t timeout;                   /**< Responses not received in time */
+    };
+
+    /**
+     * @struct SignalQuality
+     * @brief Receiver state captured after a received frame.
+     */
+    struct SignalQuality
+    {
+        uint8_t rssiAm;                     /**< Peak RSSI of the AM channel (0-15) */
+        uint8_t rssiPm;                     /**< Peak RSSI of the PM channel (0-15) */
+        uint8_t gainReductionAm;            /**< AGC/squelch gain reduction of the AM channel (0-15) */
+        uint8_t gainReductionPm;            /**< AGC/squelch gain reduction of the PM channel (0-15) */
+        bool received;                      /**< false if the expected response was lost (all values 0) */
+    };
+
+    /**
+     * @brief Callback function type for per-frame signal quality
+     */
+    using SignalQualityCallback = std::function<void(const SignalQuality&)>;
+
     /**
      * @class ST25R3911B
      * @brief ST25R3911B NFC Controller Class
@@ -162,6 +237,12 @@ namespace NFC
              */
             NFCStatus GetField(NFCField& field);
 
+            /**
+             * @brief Check the last field state set through this driver (no SPI access)
+             * @return true if the field is on
+             */
+            bool IsFieldOn(void) const { return _fieldState == NFCField::ON; }
+
             /**
              * @brief Set NFC protocol mode
              * @param protocol Protocol to set
@@ -175,6 +256,14 @@ namespace NFC
              */
             NFCProtocol GetProtocol(void) const { return _currentProtocol; }
 
+            /**
+             * @brief Set transmit and receive bit rate
+             * @details SetProtocol() selects the default rate of the protocol (FeliCa: 212 kbps).
+             * @param bitRate Bit rate
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus SetBitRate(NFCBitRate bitRate);
+
             // ============================================================================
             // Low-Level Register Operations
             // ============================================================================
@@ -303,6 +392,8 @@ namespace NFC
 
             /**
              * @brief Transmit data
+             * @details Frames longer than the FIFO are completed on the water level interrupt. In ISO15693
+             *          mode the frame is 1-of-4 coded and the CRC is calculated by the driver.
              * @param data Data to transmit
              * @param crc Enable CRC calculation
              * @return NFCStatus indicating success or failure
@@ -311,20 +402,135 @@ namespace NFC
 
             /**
              * @brief Receive data
+             * @details Frames longer than the FIFO are drained on the water level interrupt. In ISO15693
+             *          mode the subcarrier stream is decoded and the CRC checked and removed by the driver.
              * @param data Vector to store received data
              * @param timeoutMs Timeout in milliseconds
              * @return NFCStatus indicating success or failure
              */
             NFCStatus Receive(std::vector<uint8_t>& data, uint32_t timeoutMs = 0);
 
+            /**
+             * @brief Receive the answer in the first time slot of a polling or inventory command
+             * @details An empty slot is normal and, unlike in Receive(), not reported as a lost response.
+             * @param data Vector to store received data
+             * @param timeoutMs Timeout in milliseconds
+             * @return NFCStatus::TIMEOUT if no tag answered in the slot
+             */
+            NFCStatus ReceiveSlot(std::vector<uint8_t>& data, uint32_t timeoutMs = 0);
+
+            /**
+             * @brief Receive a further response to the last transmitted frame
+             * @details Used when several tags answer one command in consecutive time slots
+             *          (FeliCa polling). The receiver stays enabled and is unmasked for the next frame.
+             * @param data Vector to store received data
+             * @param timeoutMs Timeout in milliseconds
+             * @return NFCStatus::TIMEOUT if no further response arrived
+             */
+            NFCStatus ReceiveNext(std::vector<uint8_t>& data, uint32_t timeoutMs = 0);
+
+            /**
+             * @brief Close the current ISO15693 inventory slot and receive the answers of the next one
+             * @details Sends an EOF only, as required between the 16 slots of an INVENTORY request.
+             * @param data Vector to store received data
+             * @param timeoutMs Timeout in milliseconds
+             * @return NFCStatus::TIMEOUT if no tag answered in the next slot
+             */
+            NFCStatus NextInventorySlot(std::vector<uint8_t>& data, uint32_t timeoutMs = 0);
+
             /**
              * @brief Transmit and receive data
              * @param txData Data to transmit
              * @param rxData Vector to store received data
              * @param timeoutMs Timeout in milliseconds
+             * @param crc Enable CRC calculation
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus TransmitReceive(const std::vector<uint8_t>& txData, std::vector<uint8_t>& rxData, uint32_t timeoutMs = 0, bool crc = true);
+
+            /**
+             * @brief Exchange a bit-oriented ISO14443A anticollision frame
+             * @param txData Frame to transmit (no CRC), the last byte may be incomplete
+             * @param txLastBits Valid bits in the last transmitted byte (0 = complete byte)
+             * @param rxData Vector to store received data, aligned to the split byte of the request
+             * @param collisionBit Bit position of the first collision in rxData (valid on COLLISION_ERROR)
+             * @param timeoutMs Timeout in milliseconds
+             * @return NFCStatus indicating success, COLLISION_ERROR with the received bits, or failure
+             */
+            NFCStatus TransceiveAnticollision(const std::vector<uint8_t>& txData, uint8_t txLastBits,
+                                              std::vector<uint8_t>& rxData, uint16_t& collisionBit, uint32_t timeoutMs = 0);
+
+            /**
+             * @brief Exchange an ISO14443A frame with parity bits supplied by the caller
+             * @details Parity generation and checking and the receive CRC check are disabled for
+             *          the exchange, bytes and parity bits go to the FIFO as one bit stream
+             *          (MIFARE Classic encrypted framing). CRC bytes are part of the data.
+             * @param txData Bytes to transmit
+             * @param txParity Parity bit of each transmitted byte (0 or 1)
+             * @param rxData Vector to store received bytes; a trailing fragment shorter than a
+             *        byte and its parity (4-bit ACK/NAK) is stored as an extra byte
+             * @param rxParity Vector to store the parity bit of each complete received byte
+             * @param timeoutMs Timeout in milliseconds
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus TransceiveWithParity(const std::vector<uint8_t>& txData, const std::vector<uint8_t>& txParity,
+                                           std::vector<uint8_t>& rxData, std::vector<uint8_t>& rxParity, uint32_t timeoutMs = 0);
+
+            /**
+             * @brief Set the no-response timer started at the end of each transmission
+             * @param timeoutUs Time the tag has to start its answer in microseconds (0 = disabled)
+             * @return NFCStatus indicating success or failure
+             * @note The timer runs in 64/fc steps (4.72 us), longer values are clipped to ~309 ms.
+             */
+            NFCStatus SetNoResponseTimer(uint32_t timeoutUs);
+
+            /**
+             * @brief Get receive error counters
+             * @return Reference to error counters
+             */
+            const ErrorCounters& GetErrorCounters(void) const { return _errorCounters; }
+
+            /**
+             * @brief Reset receive error counters
+             */
+            void ResetErrorCounters(void) { _errorCounters = ErrorCounters{}; }
+
+            // ============================================================================
+            // Signal Quality Operations
+            // ============================================================================
+
+            /**
+             * @brief Enable or disable signal quality capture after each received frame
+             * @param enable true to read RSSI and gain reduction state after each frame
+             * @note Capture costs one 4-byte SPI frame per received frame.
+             */
+            void EnableSignalCapture(bool enable) { _signalCapture = enable; }
+
+            /**
+             * @brief Set callback invoked with the signal quality of each received or lost frame
+             * @param callback Callback function (nullptr to remove)
+             */
+            void SetSignalCallback(SignalQualityCallback callback) { _signalCallback = callback; }
+
+            /**
+             * @brief Get signal quality of the last received frame
+             * @return Reference to last captured signal quality
+             */
+            const SignalQuality& GetLastSignalQuality(void) const { return _lastSignal; }
+
+            /**
+             * @brief Switch the receiver between configured and maximum gain
+             * @param enable true for maximum first stage gain without gain reduction,
+             *               false to restore the previous receiver configuration
              * @return NFCStatus indicating success or failure
              */
-            NFCStatus TransmitReceive(const std::vector<uint8_t>& txData, std::vector<uint8_t>& rxData, uint32_t timeoutMs = 0);
+            NFCStatus SetReceiverBoost(bool enable);
+
+            /**
+             * @brief Check if the receiver gain boost is active
+             * @return true if boosted, false otherwise
+             */
+            bool IsReceiverBoosted(void) const { return _receiverBoosted; }
 
         private:
             NFCConfig _config;                  /**< Controller configuration */
@@ -332,6 +538,13 @@ namespace NFC
             NFCProtocol _currentProtocol;       /**< Current protocol */
             NFCField _fieldState;               /**< Current field state */
             bool _interruptPending;             /**< Interrupt pending flag */
+            ErrorCounters _errorCounters;       /**< Receive error counters */
+            bool _signalCapture;                /**< Capture signal quality after each frame */
+            SignalQuality _lastSignal;          /**< Signal quality of the last received frame */
+            SignalQualityCallback _signalCallback; /**< Per-frame signal quality callback */
+            bool _receiverBoosted;              /**< Receiver gain boost active */
+            uint8_t _savedRxConf3;              /**< RX_CONF3 value before boost */
+            uint8_t _savedRxConf4;              /**< RX_CONF4 value before boost */
 
             /**
              * @brief Configure default registers
@@ -346,12 +559,88 @@ namespace NFC
              */
             NFCStatus configureProtocol(NFCProtocol protocol);
 
+            /**
+             * @brief Load a frame into the FIFO and start the transmission
+             * @param data Data to transmit
+             * @param lastBits Valid bits in the last byte (0 = complete byte)
+             * @param crc Append CRC
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus transmitFrame(const std::vector<uint8_t>& data, uint8_t lastBits, bool crc);
+
+            /**
+             * @brief Feed the rest of a frame longer than the FIFO while it is being sent
+             * @param data Complete frame
+             * @param loaded Bytes already in the FIFO
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus streamFifo(const std::vector<uint8_t>& data, size_t loaded);
+
+            /**
+             * @brief Wait for the end of a reception and read the FIFO
+             * @param data Vector to store received data
+             * @param timeoutMs Timeout in milliseconds (0 = default)
+             * @param collisionBit Collision position output, nullptr to fail on the first collision
+             * @param expected Exactly one answer is expected: a timeout is reported as a lost response
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus receiveFrame(std::vector<uint8_t>& data, uint32_t timeoutMs, uint16_t* collisionBit, bool expected = true);
+
+            /**
+             * @brief Append the FIFO content to a frame being received
+             * @param data Vector the received bytes are appended to
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus drainFifo(std::vector<uint8_t>& data);
+
+            /**
+             * @brief Code an ISO15693 request for stream mode (SOF, 1-of-4 pulse positions, EOF)
+             * @param data Request payload
+             * @param crc Append CRC
+             * @param stream Vector to store the coded stream
+             */
+            static void encodeIso15693(const std::vector<uint8_t>& data, bool crc, std::vector<uint8_t>& stream);
+
+            /**
+             * @brief Decode a received ISO15693 subcarrier stream in place, check and remove the CRC
+             * @param data Received stream, replaced by the decoded payload
+             * @return NFCStatus::OK, COLLISION_ERROR, FRAMING_ERROR or CRC_ERROR
+             */
+            NFCStatus decodeIso15693(std::vector<uint8_t>& data);
+
+            /**
+             * @brief Calculate the ISO15693 CRC (ISO/IEC 13239)
+             * @param data Data to protect
+             * @param length Number of bytes
+             * @return CRC (sent LSB first)
+             */
+            static uint16_t crcIso15693(const uint8_t* data, size_t length);
+
             /**
              * @brief Wait for interrupt or timeout
-             * @param timeoutMs Timeout in milliseconds
+             * @param startTick Tick count at which the wait started
+             * @param timeoutTicks Timeout in ticks counted from startTick
              * @return NFCStatus indicating success or timeout
              */
-            NFCStatus waitForInterrupt(uint32_t timeoutMs);
+            NFCStatus waitForInterrupt(uint32_t startTick, uint32_t timeoutTicks);
+
+            /**
+             * @brief Count receive errors and map them to a status
+             * @param errorIrq Error/wake-up interrupt flags
+             * @return Status of the most severe error
+             */
+            NFCStatus classifyReceiveError(uint8_t errorIrq);
+
+            /**
+             * @brief Read RSSI and gain reduction state of the last reception
+             * @return NFCStatus indicating success or failure
+             */
+            NFCStatus captureSignalQuality(void);
+
+            /**
+             * @brief Report a lost response to the signal quality callback
+             */
+            void reportSignalLoss(void);
 
             /**
              * @brief Convert SPI status to NFC status
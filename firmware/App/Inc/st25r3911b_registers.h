@@ -288,7 +288,95 @@ namespace ST25R3911B
     static constexpr uint8_t OP_CONTROL_EFD_EN      = 0x02;
     /** @brief Oscillator Enable */
     static constexpr uint8_t OP_CONTROL_EN          = 0x01;
-    
+
+    // ============================================================================
+    // Bit Definitions - ISO14443A and NFC 106 kbps Settings Register (0x05)
+    // ============================================================================
+
+    /** @brief Transmit Without Parity */
+    static constexpr uint8_t ISO14443A_NO_TX_PAR    = 0x80;
+    /** @brief Receive Without Parity */
+    static constexpr uint8_t ISO14443A_NO_RX_PAR    = 0x40;
+    /** @brief NFC-A Start Byte (NFCIP-1 106 kbps) */
+    static constexpr uint8_t ISO14443A_NFC_F0       = 0x20;
+    /** @brief Modulation Pulse Width Mask */
+    static constexpr uint8_t ISO14443A_P_LEN_MASK   = 0x1E;
+    /** @brief Anticollision Frame (bit-oriented, collision detection in split byte) */
+    static constexpr uint8_t ISO14443A_ANTCL        = 0x01;
+
+    // ============================================================================
+    // Bit Definitions - ISO14443B Settings Register (0x06)
+    // ============================================================================
+
+    /** @brief Extra Guard Time Mask (in etu) */
+    static constexpr uint8_t ISO14443B_EGT_MASK     = 0xE0;
+    /** @brief SOF Low Phase 11 etu (0 = 10 etu) */
+    static constexpr uint8_t ISO14443B_SOF_0        = 0x10;
+    /** @brief SOF High Phase 3 etu (0 = 2 etu) */
+    static constexpr uint8_t ISO14443B_SOF_1        = 0x08;
+    /** @brief EOF 11 etu (0 = 10 etu) */
+    static constexpr uint8_t ISO14443B_EOF          = 0x04;
+    /** @brief Half Duplex Stop Bit (Type B prime) */
+    static constexpr uint8_t ISO14443B_HALF         = 0x02;
+    /** @brief Receive Start Without SOF Check */
+    static constexpr uint8_t ISO14443B_RX_ST_OM     = 0x01;
+
+    // ============================================================================
+    // Bit Definitions - Stream Mode Definition Register (0x07)
+    // ============================================================================
+
+    /** @brief Subcarrier Frequency Mask */
+    static constexpr uint8_t STREAM_SCF_MASK        = 0x60;
+    /** @brief Subcarrier Frequency fc/32 (424 kHz, ISO15693) */
+    static constexpr uint8_t STREAM_SCF_SC424       = 0x20;
+    /** @brief Subcarrier Frequency fc/16 (848 kHz) */
+    static constexpr uint8_t STREAM_SCF_SC848       = 0x40;
+    /** @brief Subcarrier Pulses per Report Period Mask */
+    static constexpr uint8_t STREAM_SCP_MASK        = 0x18;
+    /** @brief 4 Subcarrier Pulses per Report Period */
+    static constexpr uint8_t STREAM_SCP_4PULSES     = 0x10;
+    /** @brief 8 Subcarrier Pulses per Report Period (one ISO15693 half bit) */
+    static constexpr uint8_t STREAM_SCP_8PULSES     = 0x18;
+    /** @brief Transmit Time Period Mask */
+    static constexpr uint8_t STREAM_STX_MASK        = 0x07;
+    /** @brief Transmit Time Period 128/fc (one 1-of-4 pulse slot per bit) */
+    static constexpr uint8_t STREAM_STX_106         = 0x00;
+
+    // ============================================================================
+    // Bit Definitions - Auxiliary Definition Register (0x08)
+    // ============================================================================
+
+    /** @brief Receive Without CRC Check (CRC bytes kept in the FIFO) */
+    static constexpr uint8_t AUX_NO_CRC_RX          = 0x80;
+
+    // ============================================================================
+    // Bit Definitions - Receiver Gain and Signal Registers
+    // ============================================================================
+
+    // Receiver Configuration Register 3 (0x0B)
+    /** @brief First Stage Gain Setting (AM and PM channel) Mask */
+    static constexpr uint8_t RX_CONF3_RG1_MASK      = 0xFC;
+    /** @brief First Stage Gain Setting - Maximum Gain */
+    static constexpr uint8_t RX_CONF3_RG1_MAX       = 0xFC;
+
+    // Receiver Configuration Register 4 (0x0C)
+    /** @brief Gain Reduction (AM and PM channel) - No Reduction */
+    static constexpr uint8_t RX_CONF4_RG2_NONE      = 0x00;
+
+    // RSSI Display Registers (0x1D, 0x1E)
+    /** @brief RSSI Value Mask (peak value of the last reception) */
+    static constexpr uint8_t RSSI_MASK              = 0x0F;
+    /** @brief Maximum RSSI Value */
+    static constexpr uint8_t RSSI_MAX               = 0x0F;
+
+    // Gain Reduction State Register (0x1F)
+    /** @brief Gain Reduction State AM Channel Mask */
+    static constexpr uint8_t GAIN_RED_AM_MASK       = 0xF0;
+    /** @brief Gain Reduction State AM Channel Shift */
+    static constexpr uint8_t GAIN_RED_AM_SHIFT      = 4;
+    /** @brief Gain Reduction State PM Channel Mask */
+    static constexpr uint8_t GAIN_RED_PM_MASK       = 0x0F;
+
     // ============================================================================
     // Bit Definitions - Interrupt Registers
     // ============================================================================
@@ -329,6 +417,26 @@ namespace ST25R3911B
     /** @brief Wake Up Amplitude Interrupt */
     static constexpr uint8_t IRQ_TIMER_WUA          = 0x01;
 
+    // Error and Wake-up Interrupt Register (0x38)
+    /** @brief CRC Error Interrupt */
+    static constexpr uint8_t IRQ_ERR_CRC            = 0x80;
+    /** @brief Parity Error Interrupt */
+    static constexpr uint8_t IRQ_ERR_PAR            = 0x40;
+    /** @brief Soft Framing Error Interrupt (frame received, errors in framing) */
+    static constexpr uint8_t IRQ_ERR_ERR2           = 0x20;
+    /** @brief Hard Framing Error Interrupt (reception aborted) */
+    static constexpr uint8_t IRQ_ERR_ERR1           = 0x10;
+    /** @brief Wake-up Timer Interrupt */
+    static constexpr uint8_t IRQ_WUP_WT             = 0x08;
+    /** @brief Wake-up Amplitude Measurement Interrupt */
+    static constexpr uint8_t IRQ_WUP_WAM            = 0x04;
+    /** @brief Wake-up Phase Measurement Interrupt */
+    static constexpr uint8_t IRQ_WUP_WPH            = 0x02;
+    /** @brief Wake-up Capacitance Measurement Interrupt */
+    static constexpr uint8_t IRQ_WUP_WCAP           = 0x01;
+    /** @brief All Receive Error Interrupts */
+    static constexpr uint8_t IRQ_ERR_MASK           = 0xF0;
+
     // ============================================================================
     // FIFO Constants
     // ============================================================================
@@ -337,6 +445,36 @@ namespace ST25R3911B
     static constexpr uint8_t FIFO_SIZE              = 96;
     /** @brief FIFO Water Level */
     static constexpr uint8_t FIFO_WATER_LEVEL       = 64;
+    /** @brief FIFO Water Level during transmission (free space = FIFO_SIZE - level) */
+    static constexpr uint8_t FIFO_TX_WATER_LEVEL    = 32;
+
+    // FIFO RX Status Register 2 (0x29)
+    /** @brief FIFO Byte Count Bit 7 */
+    static constexpr uint8_t FIFO_STATUS2_B7        = 0x80;
+    /** @brief FIFO Underflow Flag */
+    static constexpr uint8_t FIFO_STATUS2_UNF       = 0x20;
+    /** @brief FIFO Overflow Flag */
+    static constexpr uint8_t FIFO_STATUS2_OVR       = 0x10;
+    /** @brief Number of Valid Bits in Last Incomplete Byte Mask */
+    static constexpr uint8_t FIFO_STATUS2_LB_MASK   = 0x0E;
+    /** @brief Last Incomplete Byte Bit Count Shift */
+    static constexpr uint8_t FIFO_STATUS2_LB_SHIFT  = 1;
+
+    // Number of Transmitted Bytes Registers (0x2B, 0x2C)
+    /** @brief Number of Valid Bits in Last Transmitted Byte Mask (0 = complete byte) */
+    static constexpr uint8_t NUM_TX_BYTES2_NBTX_MASK = 0x07;
+    /** @brief Low Byte Count Shift in NUM_TX_BYTES2 */
+    static constexpr uint8_t NUM_TX_BYTES2_SHIFT    = 3;
+
+    // Collision Display Register (0x2A)
+    /** @brief Collision Byte Index Mask */
+    static constexpr uint8_t COLL_BYTE_MASK         = 0xF0;
+    /** @brief Collision Byte Index Shift */
+    static constexpr uint8_t COLL_BYTE_SHIFT        = 4;
+    /** @brief Collision Bit Index Mask */
+    static constexpr uint8_t COLL_BIT_MASK          = 0x0E;
+    /** @brief Collision Bit Index Shift */
+    static constexpr uint8_t COLL_BIT_SHIFT         = 1;
     
     // ============================================================================
     // SPI Communication Constants
@@ -0,0 +1,193 @@
+/**
+ * @file    App/Inc/tagMemoryCache.h
+ * @brief   Tag Memory Image Cache Header
+ * @details This file contains the memory images of the tags in the field: Type 2 pages and
+ *          Type 5 blocks read or written over RF, keyed by UID, with per-unit valid and dirty
+ *          bitmaps. Reads of cached units take no RF frames, writes go through to the tag.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef INC_TAG_MEMORY_CACHE_H
+#define INC_TAG_MEMORY_CACHE_H
+
+/**
+ * @include necessary headers
+ */
+#include "st25r3911b.h"
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+/**
+ * @namespace NFC
+ * @brief Contains NFC related functions and definitions.
+ */
+namespace NFC
+{
+    /**
+     * @struct TagMemoryImage
+     * @brief Memory image of one tag.
+     * @details Bit n of the bitmaps belongs to the page or block at byte address n * unitSize.
+     *          Valid units hold the tag content. Dirty units hold data written to the tag that
+     *          has not been confirmed yet (write pending verification or failed); they are read
+     *          from the tag again.
+     */
+    struct TagMemoryImage
+    {
+        std::vector<uint8_t> uid;           /**< Tag UID */
+        NFCProtocol protocol;               /**< NFC_A (Type 2 pages) or NFC_V (Type 5 blocks) */
+        uint16_t unitSize;                  /**< Page or block size in bytes */
+        std::vector<uint8_t> bytes;         /**< Memory from address 0 */
+        std::vector<uint32_t> valid;        /**< Units holding the tag content */
+        std::vector<uint32_t> dirty;        /**< Units written but not confirmed */
+        uint32_t lastUse;                   /**< Sequence number of the last use (for replacement) */
+    };
+
+    /**
+     * @struct TagMemoryConfig
+     * @brief Memory image cache options.
+     */
+    struct TagMemoryConfig
+    {
+        bool enabled;                       /**< Serve reads from the images */
+        uint8_t maxTags;                    /**< Images kept (least recently used is replaced) */
+        uint16_t maxImageSize;              /**< Bytes cached per tag, memory above is always read over RF */
+    };
+
+    /**
+     * @struct TagMemoryStats
+     * @brief Memory image cache counters.
+     */
+    struct TagMemoryStats
+    {
+        uint32_t readsServed;               /**< Reads served from an image without RF frames */
+        uint32_t readsFetched;              /**< Reads that needed the tag */
+        uint32_t bytesServed;               /**< Bytes served from images */
+        uint32_t bytesFetched;              /**< Bytes read over RF into images */
+        uint32_t unitsWritten;              /**< Pages or blocks written through to the tag */
+        uint32_t imagesDropped;             /**< Images dropped (tag removed or replaced) */
+    };
+
+    /**
+     * @class TagMemoryCache
+     * @brief Memory images of the Type 2 and Type 5 tags in the field.
+     * @details Images live while their tag is present: the NFC manager drops an image when the
+     *          tag leaves, detection stops or the tag is missing from an inventory. Reads fetch
+     *          the missing units of a range with one call of the tag read function; writes store
+     *          the data once the tag has acknowledged it.
+     */
+    class TagMemoryCache
+    {
+        public:
+            /** @brief Read function of the tag: byte address, length, data read */
+            using FetchFunction = std::function<NFCStatus(uint32_t, uint32_t, std::vector<uint8_t>&)>;
+
+            /**
+             * @brief Constructor
+             */
+            TagMemoryCache(void);
+
+            /**
+             * @brief Read a range of tag memory
+             * @details Cached units are copied, the units from the first to the last missing one
+             *          are fetched from the tag and stored. Disabled caching, ranges above
+             *          maxImageSize and other tags than Type 2 and Type 5 go to the tag directly.
+             * @param tagInfo Tag to read
+             * @param unitSize Page or block size of the tag
+             * @param address Byte address
+             * @param length Number of bytes
+             * @param fetch Read function of the tag
+             * @param data Vector to store the bytes read
+             * @return NFCStatus of the fetch, NFCStatus::OK if the range was cached
+             */
+            NFCStatus Read(const TagInfo& tagInfo, uint16_t unitSize, uint32_t address, uint32_t length,
+                           const FetchFunction& fetch, std::vector<uint8_t>& data);
+
+            /**
+             * @brief Record a page or block write
+             * @param tagInfo Tag written
+             * @param unitSize Page or block size of the tag
+             * @param address Byte address of the unit
+             * @param bytes Unit data
+             * @param confirmed true if the tag acknowledged the write and no verification follows,
+             *        false to keep the unit dirty (read again from the tag)
+             */
+            void Write(const TagInfo& tagInfo, uint16_t unitSize, uint32_t address, const uint8_t* bytes, bool confirmed);
+
+            /**
+             * @brief Drop the image of a tag
+             * @param uid Tag UID
+             */
+            void Remove(const std::vector<uint8_t>& uid);
+
+            /**
+             * @brief Drop the images of one technology whose tags are missing from a poll
+             * @param protocol Technology polled
+             * @param tags Tags that answered
+             */
+            void Retain(NFCProtocol protocol, const std::vector<TagInfo>& tags);
+
+            /**
+             * @brief Drop all images
+             */
+            void Clear(void);
+
+            /**
+             * @brief Get the image of a tag
+             * @param uid Tag UID
+             * @return Pointer to the image, nullptr if the tag has none
+             */
+            const TagMemoryImage* Find(const std::vector<uint8_t>& uid) const;
+
+            /**
+             * @brief Check if a unit is served from the image
+             * @param image Tag image
+             * @param address Byte address of the unit
+             * @return true if the unit is valid and not dirty
+             */
+            static bool IsCached(const TagMemoryImage& image, uint32_t address);
+
+            /**
+             * @brief Set cache options
+             * @details Disabling the cache drops all images.
+             * @param config Cache configuration
+             */
+            void SetConfig(const TagMemoryConfig& config);
+
+            /**
+             * @brief Get cache options
+             * @return Reference to configuration
+             */
+            const TagMemoryConfig& GetConfig(void) const { return _config; }
+
+            /**
+             * @brief Get cache counters
+             * @return Reference to counters
+             */
+            const TagMemoryStats& GetStatistics(void) const { return _stats; }
+
+            /**
+             * @brief Reset cache counters
+             */
+            void ResetStatistics(void) { _stats = {}; }
+
+        private:
+            std::vector<TagMemoryImage> _images; /**< Images of the tags in the field */
+            TagMemoryConfig _config;            /**< Cache options */
+            TagMemoryStats _stats;              /**< Cache counters */
+            uint32_t _sequence;                 /**< Use counter for image replacement */
+
+            /**
+             * @brief Get the image of a tag, created if needed
+             * @param tagInfo Tag
+             * @param unitSize Page or block size (an image with another size is reset)
+             * @return Pointer to the image, nullptr if the tag is not cached
+             */
+            TagMemoryImage* acquire(const TagInfo& tagInfo, uint16_t unitSize);
+    };
+
+} // namespace NFC
+
+#endif /* INC_TAG_MEMORY_CACHE_H */
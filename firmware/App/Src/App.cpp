@@ -128,6 +128,17 @@ void buttonCallback(void)
 	ledextOutput->Toggle();
 }
 
+/**
+ * @brief NFC IRQ pin callback (called from interrupt)
+ */
+void nfcIrqPinCallback(void)
+{
+    // The driver flags the pending interrupt and forwards to nfcIrqCallback
+    if (nfcController) {
+        nfcController->HandleInterrupt();
+    }
+}
+
 /**
  * @brief NFC interrupt callback function (called from interrupt)
  */
@@ -190,7 +201,7 @@ void App_init( void )
     
     // Initialize NFC SPI Interface
     nfcSpiMaster = new SPI::SPIMaster(nfcSpiConfig);
-    nfcIrqInterrupt = new GPIO::GPIOInterrupt(nfcIrqConfig, nfcIrqCallback);
+    nfcIrqInterrupt = new GPIO::GPIOInterrupt(nfcIrqConfig, nfcIrqPinCallback);
     
     // Initialize NFC Controller and Manager
     NFC::NFCConfig nfcConfig;
@@ -201,15 +212,14 @@ void App_init( void )
     nfcConfig.irqCallback = nfcIrqCallback;
     
     nfcController = new NFC::ST25R3911B(nfcConfig);
+    nfcManager = new NFC::NFCManager(nfcController);
     
-    // Initialize the NFC controller hardware
-    NFC::NFCStatus initStatus = nfcController->Initialize();
+    // Initialize the NFC controller hardware through the manager
+    NFC::NFCStatus initStatus = nfcManager->Initialize();
     if (initStatus != NFC::NFCStatus::OK) {
         printf("Warning: NFC controller initialization failed with status: %d", static_cast<int>(initStatus));
     }
     
-    nfcManager = new NFC::NFCManager(nfcController);
-    
     // Initialize NFC Task Manager
     nfcTaskManager = new NFCTask::NFCTaskManager();
     NFCTask::NFCTaskConfig taskConfig = NFCTask::GetDefaultConfig();
@@ -0,0 +1,147 @@
+/**
+ * @file    App/Src/crypto1.cpp
+ * @brief   MIFARE Classic Crypto1 Stream Cipher Implementation
+ * @details This file contains the implementation of the Crypto1 cipher.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "crypto1.h"
+
+namespace NFC
+{
+    // ============================================================================
+    // Cipher Tables
+    // ============================================================================
+
+    /** @brief Feedback taps in the odd half of the LFSR */
+    static constexpr uint32_t LFSR_TAPS_ODD = 0x29CE5C;
+    /** @brief Feedback taps in the even half of the LFSR */
+    static constexpr uint32_t LFSR_TAPS_EVEN = 0x870804;
+
+    /**
+     * @brief First filter layer: five 4-input functions (fa, fb, fb, fa, fb) as 16-entry tables,
+     *        each already shifted to its bit position in the index of the second layer
+     */
+    static constexpr uint32_t FILTER_LAYER1[5] = { 0xF22C0, 0x6C9C0, 0x3C8B0, 0x1E458, 0x0D938 };
+    /** @brief Second filter layer: 5-input function fc as a 32-entry table */
+    static constexpr uint32_t FILTER_LAYER2 = 0xEC57E80A;
+
+    /** @brief Even parity of a byte (1 if the number of ones is odd) */
+    static const uint8_t PARITY[256] = {
+        0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+        1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+        1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+        0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+        1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+        0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+        0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+        1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0
+    };
+
+    /**
+     * @brief Filter function of the odd LFSR half
+     * @param odd Odd LFSR bits
+     * @return Keystream bit
+     */
+    static inline uint8_t filter(uint32_t odd)
+    {
+        uint32_t index = (FILTER_LAYER1[0] >> (odd & 0xF)) & 16;
+        index |= (FILTER_LAYER1[1] >> ((odd >> 4) & 0xF)) & 8;
+        index |= (FILTER_LAYER1[2] >> ((odd >> 8) & 0xF)) & 4;
+        index |= (FILTER_LAYER1[3] >> ((odd >> 12) & 0xF)) & 2;
+        index |= (FILTER_LAYER1[4] >> ((odd >> 16) & 0xF)) & 1;
+        return static_cast<uint8_t>((FILTER_LAYER2 >> index) & 0x01);
+    }
+
+    /**
+     * @brief Parity of a 24-bit value
+     * @param value Value
+     * @return 1 if the number of ones is odd
+     */
+    static inline uint8_t parity24(uint32_t value)
+    {
+        return PARITY[(value ^ (value >> 8) ^ (value >> 16)) & 0xFF];
+    }
+
+    /**
+     * @brief Reverse the byte order of a word
+     * @param value Word
+     * @return Byte-swapped word
+     */
+    static inline uint32_t swapBytes(uint32_t value)
+    {
+        return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+    }
+
+    // ============================================================================
+    // Crypto1 Implementation
+    // ============================================================================
+
+    void Crypto1::Init(uint64_t key)
+    {
+        // Key bit 0 of each byte enters first: odd and even LFSR bits from the key interleaved
+        _odd = 0;
+        _even = 0;
+        for (int i = 47; i > 0; i -= 2) {
+            _odd = (_odd << 1) | static_cast<uint32_t>((key >> ((i - 1) ^ 7)) & 0x01);
+            _even = (_even << 1) | static_cast<uint32_t>((key >> (i ^ 7)) & 0x01);
+        }
+    }
+
+    uint8_t Crypto1::Bit(uint8_t in, bool encrypted)
+    {
+        uint8_t keystream = filter(_odd);
+        uint32_t feedback = (encrypted ? keystream : 0) ^ (in & 0x01);
+        feedback ^= parity24((_odd & LFSR_TAPS_ODD) ^ (_even & LFSR_TAPS_EVEN));
+
+        // Shift: the new bit becomes the lowest even bit, odd and even halves swap roles
+        uint32_t even = ((_even << 1) | (feedback & 0x01)) & 0xFFFFFF;
+        _even = _odd;
+        _odd = even;
+        return keystream;
+    }
+
+    uint8_t Crypto1::Byte(uint8_t in, bool encrypted)
+    {
+        uint8_t keystream = 0;
+        for (uint8_t i = 0; i < 8; ++i) {
+            keystream |= static_cast<uint8_t>(Bit((in >> i) & 0x01, encrypted) << i);
+        }
+        return keystream;
+    }
+
+    uint32_t Crypto1::Word(uint32_t in, bool encrypted)
+    {
+        uint32_t keystream = 0;
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            keystream |= static_cast<uint32_t>(Byte(static_cast<uint8_t>(in >> shift), encrypted)) << shift;
+        }
+        return keystream;
+    }
+
+    uint8_t Crypto1::Peek(void) const
+    {
+        return filter(_odd);
+    }
+
+    uint32_t Crypto1::NonceSuccessor(uint32_t nonce, uint32_t steps)
+    {
+        // 16-bit LFSR x^16 + x^14 + x^13 + x^11 + 1 over the nonce bits in air order
+        uint32_t x = swapBytes(nonce);
+        while (steps--) {
+            x = (x >> 1) | (((x >> 16) ^ (x >> 18) ^ (x >> 19) ^ (x >> 21)) << 31);
+        }
+        return swapBytes(x);
+    }
+
+    uint8_t Crypto1::OddParity(uint8_t value)
+    {
+        return static_cast<uint8_t>(PARITY[value] ^ 0x01);
+    }
+
+} // namespace NFC
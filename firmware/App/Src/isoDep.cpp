@@ -0,0 +1,329 @@
+/**
+ * @file    App/Src/isoDep.cpp
+ * @brief   ISO14443-4 (ISO-DEP) Block Transmission Protocol Implementation
+ * @details This file contains the implementation of the reader side ISO14443-4 block protocol.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "isoDep.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <algorithm>
+#include <cstring>
+
+namespace NFC
+{
+    // ============================================================================
+    // Protocol Constants
+    // ============================================================================
+
+    /** @brief RATS command byte */
+    static constexpr uint8_t RATS_CMD = 0xE0;
+    /** @brief FSDI announced in RATS (256 bytes) */
+    static constexpr uint8_t RATS_FSDI = 8;
+    /** @brief Activation frame waiting time (65536/fc) in microseconds */
+    static constexpr uint32_t ATS_TIMEOUT_US = 4833;
+
+    /** @brief I-block PCB (block number in bit 0) */
+    static constexpr uint8_t PCB_I_BLOCK = 0x02;
+    /** @brief R(ACK) PCB */
+    static constexpr uint8_t PCB_R_ACK = 0xA2;
+    /** @brief R(NAK) PCB */
+    static constexpr uint8_t PCB_R_NAK = 0xB2;
+    /** @brief S(DESELECT) PCB */
+    static constexpr uint8_t PCB_S_DESELECT = 0xC2;
+    /** @brief S(WTX) PCB */
+    static constexpr uint8_t PCB_S_WTX = 0xF2;
+    /** @brief Chaining bit of an I-block */
+    static constexpr uint8_t PCB_CHAINING = 0x10;
+    /** @brief NAK bit of an R-block */
+    static constexpr uint8_t PCB_NAK = 0x10;
+    /** @brief Block number bit */
+    static constexpr uint8_t PCB_BLOCK_NUMBER = 0x01;
+
+    /** @brief Block retries after a timeout or a corrupted block */
+    static constexpr uint8_t MAX_BLOCK_RETRIES = 2;
+    /** @brief Margin added to the frame waiting time in milliseconds */
+    static constexpr uint32_t FWT_MARGIN_MS = 10;
+
+    /** @brief Frame sizes indexed by FSDI / FSCI (codes above 8 mean 256) */
+    static const uint16_t FRAME_SIZES[] = { 16, 24, 32, 40, 48, 64, 96, 128, 256 };
+
+    /**
+     * @brief Check for an I-block
+     * @param pcb Protocol control byte
+     * @return true if the block is an I-block
+     */
+    static bool isIBlock(uint8_t pcb)
+    {
+        return (pcb & 0xE2) == 0x02;
+    }
+
+    /**
+     * @brief Check for an R-block
+     * @param pcb Protocol control byte
+     * @return true if the block is an R(ACK) or R(NAK)
+     */
+    static bool isRBlock(uint8_t pcb)
+    {
+        return (pcb & 0xE6) == 0xA2;
+    }
+
+    // ============================================================================
+    // IsoDep Implementation
+    // ============================================================================
+
+    IsoDep::IsoDep(ST25R3911B* controller)
+        : _controller(controller)
+        , _active(false)
+        , _params{ FRAME_SIZES[2], FSD, 4, 0 }
+        , _blockNumber(0)
+        , _stats{}
+    {
+        _txBlock.reserve(FSD);
+        _rxBlock.reserve(FSD);
+    }
+
+    NFCStatus IsoDep::ActivateA(std::vector<uint8_t>& ats)
+    {
+        _active = false;
+        if (!_controller) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+
+        // RATS: FSDI and CID 0, the ATS may take up to the activation frame waiting time
+        _controller->SetNoResponseTimer(ATS_TIMEOUT_US);
+        NFCStatus status = _controller->TransmitReceive({ RATS_CMD, static_cast<uint8_t>(RATS_FSDI << 4) },
+                                                       ats, ATS_TIMEOUT_US / 1000 + FWT_MARGIN_MS);
+        _controller->SetNoResponseTimer(0);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (ats.empty() || ats[0] != ats.size()) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+
+        // Defaults if the interface bytes are absent: FSCI 2, FWI 4, SFGI 0
+        uint8_t fsci = 2;
+        uint8_t fwi = 4;
+        uint8_t sfgi = 0;
+        if (ats.size() > 1) {
+            uint8_t t0 = ats[1];
+            size_t index = 2;
+            fsci = t0 & 0x0F;
+            if (t0 & 0x10) {
+                index++;                    // TA: divisors (106 kbps is kept)
+            }
+            if (t0 & 0x20) {
+                if (index >= ats.size()) {
+                    return NFCStatus::COMMUNICATION_ERROR;
+                }
+                fwi = ats[index] >> 4;
+                sfgi = ats[index] & 0x0F;
+            }
+            // TC: NAD and CID are not used
+        }
+        configure(fsci, fwi, sfgi);
+
+        // The card may need the start-up frame guard time before the first block
+        if (_params.sfgi > 0) {
+            vTaskDelay(pdMS_TO_TICKS((302UL << _params.sfgi) / 1000 + 1));
+        }
+
+        _active = true;
+        return NFCStatus::OK;
+    }
+
+    NFCStatus IsoDep::ActivateB(const TagInfo& tagInfo)
+    {
+        _active = false;
+        if (!_controller) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+
+        // ATQB protocol info: bit rates, FSCI / protocol type, FWI / ADC / FO
+        if (tagInfo.protocol != NFCProtocol::NFC_B || tagInfo.protocolInfo.size() < 3 ||
+            !(tagInfo.protocolInfo[1] & 0x01)) {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
+        configure(tagInfo.protocolInfo[1] >> 4, tagInfo.protocolInfo[2] >> 4, 0);
+
+        _active = true;
+        return NFCStatus::OK;
+    }
+
+    NFCStatus IsoDep::Exchange(const uint8_t* command, size_t commandLength,
+                               uint8_t* response, size_t responseSize, size_t& responseLength)
+    {
+        responseLength = 0;
+        if (!_active) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+        if ((!command && commandLength > 0) || (!response && responseSize > 0)) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        _stats.exchanges++;
+
+        // Reader chaining: every I-block but the last one is acknowledged with R(ACK)
+        size_t maxInf = _params.fsc - 3;
+        size_t offset = 0;
+        NFCStatus status;
+        while (true) {
+            size_t chunk = std::min(maxInf, commandLength - offset);
+            bool chaining = (offset + chunk) < commandLength;
+
+            _txBlock.assign(1, static_cast<uint8_t>(PCB_I_BLOCK | _blockNumber | (chaining ? PCB_CHAINING : 0x00)));
+            _txBlock.insert(_txBlock.end(), command + offset, command + offset + chunk);
+            status = transceiveBlock(false);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            if (!chaining) {
+                break;
+            }
+
+            if (!isRBlock(_rxBlock[0]) || (_rxBlock[0] & PCB_NAK) || (_rxBlock[0] & PCB_BLOCK_NUMBER) != _blockNumber) {
+                return NFCStatus::COMMUNICATION_ERROR;
+            }
+            _stats.chainedBlocksSent++;
+            _blockNumber ^= PCB_BLOCK_NUMBER;
+            offset += chunk;
+        }
+
+        // Card chaining: acknowledge every chained I-block to get the next one. A response that
+        // does not fit is still received completely to keep the block numbers in step.
+        bool overflow = false;
+        while (true) {
+            if (!isIBlock(_rxBlock[0]) || (_rxBlock[0] & PCB_BLOCK_NUMBER) != _blockNumber) {
+                return NFCStatus::COMMUNICATION_ERROR;
+            }
+            _blockNumber ^= PCB_BLOCK_NUMBER;
+
+            size_t inf = std::min(_rxBlock.size() - 1, responseSize - responseLength);
+            overflow |= (inf < _rxBlock.size() - 1);
+            if (inf > 0) {
+                std::memcpy(response + responseLength, _rxBlock.data() + 1, inf);
+                responseLength += inf;
+            }
+
+            if (!(_rxBlock[0] & PCB_CHAINING)) {
+                return overflow ? NFCStatus::INVALID_PARAM : NFCStatus::OK;
+            }
+            _stats.chainedBlocksReceived++;
+
+            _txBlock.assign(1, static_cast<uint8_t>(PCB_R_ACK | _blockNumber));
+            status = transceiveBlock(true);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+        }
+    }
+
+    NFCStatus IsoDep::CheckPresence(void)
+    {
+        if (!_active) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+
+        // R(NAK) with the current block number: a present card answers R(ACK) and keeps its state
+        _txBlock.assign(1, static_cast<uint8_t>(PCB_R_NAK | _blockNumber));
+        _stats.blocksSent++;
+        NFCStatus status = _controller->TransmitReceive(_txBlock, _rxBlock, blockTimeoutMs(1));
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        if (_rxBlock.size() != 1 || !isRBlock(_rxBlock[0]) || (_rxBlock[0] & PCB_NAK)) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+        return NFCStatus::OK;
+    }
+
+    NFCStatus IsoDep::Deselect(void)
+    {
+        if (!_active) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+        _active = false;
+
+        _txBlock.assign(1, PCB_S_DESELECT);
+        _stats.blocksSent++;
+        NFCStatus status = _controller->TransmitReceive(_txBlock, _rxBlock, blockTimeoutMs(1));
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        return (_rxBlock.size() == 1 && _rxBlock[0] == PCB_S_DESELECT) ? NFCStatus::OK : NFCStatus::COMMUNICATION_ERROR;
+    }
+
+    // ============================================================================
+    // Private Helpers
+    // ============================================================================
+
+    void IsoDep::configure(uint8_t fsci, uint8_t fwi, uint8_t sfgi)
+    {
+        // FWI and SFGI 15 are RFU and mean the default
+        _params.fsc = FRAME_SIZES[std::min<uint8_t>(fsci, 8)];
+        _params.fsd = FSD;
+        _params.fwi = (fwi > 14) ? 4 : fwi;
+        _params.sfgi = (sfgi > 14) ? 0 : sfgi;
+        _blockNumber = 0;
+    }
+
+    NFCStatus IsoDep::transceiveBlock(bool piccChaining)
+    {
+        uint8_t retries = 0;
+        _stats.blocksSent++;
+        NFCStatus status = _controller->TransmitReceive(_txBlock, _rxBlock, blockTimeoutMs(1));
+
+        while (true) {
+            bool valid = (status == NFCStatus::OK) && !_rxBlock.empty();
+
+            // S(WTX): confirm the multiplier and wait that many frame waiting times
+            if (valid && _rxBlock.size() == 2 && _rxBlock[0] == PCB_S_WTX) {
+                uint8_t wtxm = std::max<uint8_t>(1, std::min<uint8_t>(_rxBlock[1] & 0x3F, 59));
+                _stats.waitingTimeExtensions++;
+                _stats.blocksSent++;
+                status = _controller->TransmitReceive({ PCB_S_WTX, wtxm }, _rxBlock, blockTimeoutMs(wtxm));
+                continue;
+            }
+
+            // R(ACK) with the other block number: the card missed the last I-block
+            if (valid && !piccChaining && isRBlock(_rxBlock[0]) && !(_rxBlock[0] & PCB_NAK) &&
+                (_rxBlock[0] & PCB_BLOCK_NUMBER) != _blockNumber) {
+                if (retries++ >= MAX_BLOCK_RETRIES) {
+                    return NFCStatus::COMMUNICATION_ERROR;
+                }
+                _stats.retransmissions++;
+                _stats.blocksSent++;
+                status = _controller->TransmitReceive(_txBlock, _rxBlock, blockTimeoutMs(1));
+                continue;
+            }
+
+            if (valid && (isIBlock(_rxBlock[0]) || (isRBlock(_rxBlock[0]) && !(_rxBlock[0] & PCB_NAK)))) {
+                return NFCStatus::OK;
+            }
+
+            // Timeout or corrupted block: ask for the answer again (R(ACK) while the card chains)
+            if (retries++ >= MAX_BLOCK_RETRIES) {
+                return (status != NFCStatus::OK) ? status : NFCStatus::COMMUNICATION_ERROR;
+            }
+            _stats.retransmissions++;
+            _stats.blocksSent++;
+            status = _controller->TransmitReceive({ static_cast<uint8_t>((piccChaining ? PCB_R_ACK : PCB_R_NAK) | _blockNumber) },
+                                                  _rxBlock, blockTimeoutMs(1));
+        }
+    }
+
+    uint32_t IsoDep::blockTimeoutMs(uint8_t multiplier) const
+    {
+        return (GetFrameWaitingTimeUs() * multiplier) / 1000 + FWT_MARGIN_MS;
+    }
+
+} // namespace NFC
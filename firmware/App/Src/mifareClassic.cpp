@@ -0,0 +1,513 @@
+/**
+ * @file    App/Src/mifareClassic.cpp
+ * @brief   MIFARE Classic Reader Protocol Implementation
+ * @details This file contains the implementation of the reader side MIFARE Classic protocol.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "mifareClassic.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <algorithm>
+
+namespace NFC
+{
+    // ============================================================================
+    // Protocol Constants
+    // ============================================================================
+
+    /** @brief AUTH with key A */
+    static constexpr uint8_t CMD_AUTH_A = 0x60;
+    /** @brief AUTH with key B */
+    static constexpr uint8_t CMD_AUTH_B = 0x61;
+    /** @brief READ (one block) */
+    static constexpr uint8_t CMD_READ = 0x30;
+    /** @brief WRITE (one block, two phases) */
+    static constexpr uint8_t CMD_WRITE = 0xA0;
+    /** @brief HALT */
+    static constexpr uint8_t CMD_HALT = 0x50;
+    /** @brief 4-bit ACK */
+    static constexpr uint8_t ACK = 0x0A;
+
+    /** @brief Timeout of AUTH, READ and the first WRITE phase in milliseconds */
+    static constexpr uint32_t COMMAND_TIMEOUT_MS = 10;
+    /** @brief Timeout of the WRITE data phase (EEPROM programming) in milliseconds */
+    static constexpr uint32_t WRITE_TIMEOUT_MS = 20;
+
+    /**
+     * @brief Calculate the ISO14443A CRC (CRC_A)
+     * @param data Data to protect
+     * @param length Number of bytes
+     * @return CRC (sent LSB first)
+     */
+    static uint16_t crcIso14443A(const uint8_t* data, size_t length)
+    {
+        uint16_t crc = 0x6363;
+        for (size_t i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0x8408) : static_cast<uint16_t>(crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief Append the CRC_A to a frame
+     * @param frame Frame
+     */
+    static void appendCrc(std::vector<uint8_t>& frame)
+    {
+        uint16_t crc = crcIso14443A(frame.data(), frame.size());
+        frame.push_back(static_cast<uint8_t>(crc & 0xFF));
+        frame.push_back(static_cast<uint8_t>(crc >> 8));
+    }
+
+    /**
+     * @brief Get the UID word used by the cipher
+     * @param uid Card UID
+     * @return Last four UID bytes (cascade level of a 7-byte UID: the last four as well)
+     */
+    static uint32_t cipherUid(const std::vector<uint8_t>& uid)
+    {
+        uint32_t value = 0;
+        for (size_t i = (uid.size() > 4) ? uid.size() - 4 : 0; i < uid.size(); ++i) {
+            value = (value << 8) | uid[i];
+        }
+        return value;
+    }
+
+    /**
+     * @brief Get a byte of a word in transmission order
+     * @param value Word
+     * @param index Byte index (0 = most significant byte)
+     * @return Byte
+     */
+    static inline uint8_t wordByte(uint32_t value, int index)
+    {
+        return static_cast<uint8_t>(value >> (24 - 8 * index));
+    }
+
+    /**
+     * @brief Check the access bits of a sector trailer
+     * @details Bytes 6 to 8 hold each access bit C1, C2 and C3 of the four blocks twice, once
+     *          inverted. A trailer with mismatching copies blocks the sector permanently.
+     * @param access Trailer bytes 6 to 8
+     * @return true if every bit matches its inverted copy
+     */
+    static bool accessBitsValid(const uint8_t* access)
+    {
+        uint8_t c1 = access[1] >> 4;
+        uint8_t c2 = access[2] & 0x0F;
+        uint8_t c3 = access[2] >> 4;
+        return (access[0] & 0x0F) == (~c1 & 0x0F) &&
+               (access[0] >> 4) == (~c2 & 0x0F) &&
+               (access[1] & 0x0F) == (~c3 & 0x0F);
+    }
+
+    // ============================================================================
+    // MifareClassic Implementation
+    // ============================================================================
+
+    MifareClassic::MifareClassic(ST25R3911B* controller, ActivateFunction activate)
+        : _controller(controller)
+        , _activate(activate)
+        , _keyFunction(nullptr)
+        , _authenticated(false)
+        , _cardLost(false)
+        , _sector(0)
+        , _keyB(false)
+        , _readerNonce(0x2545F491)
+        , _stats{}
+    {
+    }
+
+    NFCStatus MifareClassic::Authenticate(const TagInfo& tagInfo, uint8_t block, const MifareKey& key)
+    {
+        return authenticate(tagInfo, block, key, _authenticated && _uid == tagInfo.uid);
+    }
+
+    NFCStatus MifareClassic::ReadBlock(const TagInfo& tagInfo, uint8_t block, std::vector<uint8_t>& data)
+    {
+        return ReadBlocks(tagInfo, block, 1, data);
+    }
+
+    NFCStatus MifareClassic::WriteBlock(const TagInfo& tagInfo, uint8_t block, const uint8_t* data)
+    {
+        return WriteBlocks(tagInfo, block, data, 1);
+    }
+
+    NFCStatus MifareClassic::ReadBlocks(const TagInfo& tagInfo, uint8_t firstBlock, uint16_t count, std::vector<uint8_t>& data)
+    {
+        data.clear();
+        uint16_t end = static_cast<uint16_t>(firstBlock + count);
+        if (count == 0 || end > 256) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        // One session per sector: authenticate, then stream its blocks
+        for (uint16_t block = firstBlock; block < end;) {
+            uint8_t sector = SectorOf(static_cast<uint8_t>(block));
+            uint16_t sectorEnd = std::min<uint16_t>(end, static_cast<uint16_t>(FirstBlock(sector) + BlocksInSector(sector)));
+            size_t start = data.size();
+            NFCStatus status = withSession(tagInfo, static_cast<uint8_t>(block), [this, &data, start, block, sectorEnd]() {
+                data.resize(start);
+                for (uint16_t b = block; b < sectorEnd; ++b) {
+                    NFCStatus result = readBlock(static_cast<uint8_t>(b), data);
+                    if (result != NFCStatus::OK) {
+                        return result;
+                    }
+                }
+                return NFCStatus::OK;
+            });
+            if (status != NFCStatus::OK) {
+                data.resize(start);
+                return status;
+            }
+            block = sectorEnd;
+        }
+        return NFCStatus::OK;
+    }
+
+    NFCStatus MifareClassic::WriteBlocks(const TagInfo& tagInfo, uint8_t firstBlock, const uint8_t* data, uint16_t count)
+    {
+        uint16_t end = static_cast<uint16_t>(firstBlock + count);
+        if (!data || count == 0 || end > 256) {
+            return NFCStatus::INVALID_PARAM;
+        }
+        // Data blocks only: the manufacturer block is read-only and a trailer needs WriteSectorTrailer()
+        for (uint16_t block = firstBlock; block < end; ++block) {
+            if (block == 0 || IsSectorTrailer(static_cast<uint8_t>(block))) {
+                return NFCStatus::INVALID_PARAM;
+            }
+        }
+
+        for (uint16_t block = firstBlock; block < end;) {
+            uint8_t sector = SectorOf(static_cast<uint8_t>(block));
+            uint16_t sectorEnd = std::min<uint16_t>(end, static_cast<uint16_t>(FirstBlock(sector) + BlocksInSector(sector)));
+            NFCStatus status = withSession(tagInfo, static_cast<uint8_t>(block), [this, data, firstBlock, block, sectorEnd]() {
+                for (uint16_t b = block; b < sectorEnd; ++b) {
+                    NFCStatus result = writeBlock(static_cast<uint8_t>(b), data + (b - firstBlock) * BLOCK_SIZE);
+                    if (result != NFCStatus::OK) {
+                        return result;
+                    }
+                }
+                return NFCStatus::OK;
+            });
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            block = sectorEnd;
+        }
+        return NFCStatus::OK;
+    }
+
+    NFCStatus MifareClassic::WriteSectorTrailer(const TagInfo& tagInfo, uint8_t sector, const uint8_t* keyA,
+                                                const uint8_t* access, const uint8_t* keyB)
+    {
+        if (!keyA || !access || !keyB || sector >= 40 || !accessBitsValid(access)) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        uint8_t trailer[BLOCK_SIZE];
+        std::copy(keyA, keyA + 6, trailer);
+        std::copy(access, access + 4, trailer + 6);
+        std::copy(keyB, keyB + 6, trailer + 10);
+        uint8_t block = static_cast<uint8_t>(FirstBlock(sector) + BlocksInSector(sector) - 1);
+        return withSession(tagInfo, block, [this, block, &trailer]() {
+            return writeBlock(block, trailer);
+        });
+    }
+
+    NFCStatus MifareClassic::ReadSector(const TagInfo& tagInfo, uint8_t sector, std::vector<uint8_t>& data)
+    {
+        if (sector >= 40) {
+            return NFCStatus::INVALID_PARAM;
+        }
+        return ReadBlocks(tagInfo, FirstBlock(sector), BlocksInSector(sector), data);
+    }
+
+    NFCStatus MifareClassic::Dump(const TagInfo& tagInfo, std::vector<uint8_t>& memory, uint64_t& sectorsRead)
+    {
+        uint8_t sectors = SectorCount(tagInfo.dataSize);
+        memory.assign(static_cast<size_t>(BlockCount(tagInfo.dataSize)) * BLOCK_SIZE, 0x00);
+        sectorsRead = 0;
+
+        // The sector of the running session needs no authentication: read it first
+        uint8_t first = (_authenticated && _uid == tagInfo.uid && _sector < sectors) ? _sector : 0;
+        NFCStatus result = NFCStatus::OK;
+        std::vector<uint8_t> data;
+        for (uint8_t i = 0; i < sectors; ++i) {
+            uint8_t sector = (i == 0) ? first : ((i - 1 < first) ? i - 1 : i);
+            NFCStatus status = ReadSector(tagInfo, sector, data);
+            if (status == NFCStatus::OK) {
+                std::copy(data.begin(), data.end(), memory.begin() + static_cast<size_t>(FirstBlock(sector)) * BLOCK_SIZE);
+                sectorsRead |= 1ULL << sector;
+                continue;
+            }
+            if (result == NFCStatus::OK) {
+                result = status;
+            }
+            if (status == NFCStatus::NO_TAG_FOUND) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    NFCStatus MifareClassic::Halt(void)
+    {
+        if (!_authenticated) {
+            return NFCStatus::OK;
+        }
+
+        // The card does not answer HALT
+        std::vector<uint8_t> response;
+        NFCStatus status = transceive({ CMD_HALT, 0x00 }, response, COMMAND_TIMEOUT_MS);
+        _authenticated = false;
+        return (status == NFCStatus::TIMEOUT) ? NFCStatus::OK : NFCStatus::COMMUNICATION_ERROR;
+    }
+
+    uint8_t MifareClassic::SectorCount(uint16_t dataSize)
+    {
+        switch (dataSize) {
+            case 320:
+                return 5;
+            case 2048:
+                return 32;
+            case 4096:
+                return 40;
+            default:
+                return 16;
+        }
+    }
+
+    uint16_t MifareClassic::BlockCount(uint16_t dataSize)
+    {
+        uint8_t last = static_cast<uint8_t>(SectorCount(dataSize) - 1);
+        return static_cast<uint16_t>(FirstBlock(last) + BlocksInSector(last));
+    }
+
+    NFCStatus MifareClassic::openSector(const TagInfo& tagInfo, uint8_t block)
+    {
+        uint8_t sector = SectorOf(block);
+        MifareKey key = { { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, false };
+        if (_keyFunction) {
+            _keyFunction(tagInfo, sector, key);
+        }
+
+        bool session = _authenticated && _uid == tagInfo.uid;
+        if (session && _sector == sector && _keyB == key.keyB) {
+            return NFCStatus::OK;
+        }
+        return authenticate(tagInfo, block, key, session);
+    }
+
+    NFCStatus MifareClassic::authenticate(const TagInfo& tagInfo, uint8_t block, const MifareKey& key, bool nested)
+    {
+        if (!_controller || tagInfo.uid.size() < 4) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        uint64_t keyValue = 0;
+        for (const uint8_t byte : key.bytes) {
+            keyValue = (keyValue << 8) | byte;
+        }
+        uint32_t uid = cipherUid(tagInfo.uid);
+        uint8_t cmd = key.keyB ? CMD_AUTH_B : CMD_AUTH_A;
+
+        // Pass 1: AUTH, the card answers with its nonce nt
+        std::vector<uint8_t> data, parity, response, responseParity;
+        NFCStatus status;
+        if (nested) {
+            // Command encrypted with the running session, nonce encrypted with the new key
+            encrypt({ cmd, block }, data, parity);
+            status = _controller->TransceiveWithParity(data, parity, response, responseParity, COMMAND_TIMEOUT_MS);
+        } else {
+            // Plain frame, but the 4-byte nonce comes without CRC: exchanged with the receive CRC check off
+            data = { cmd, block };
+            appendCrc(data);
+            for (const uint8_t byte : data) {
+                parity.push_back(Crypto1::OddParity(byte));
+            }
+            status = _controller->TransceiveWithParity(data, parity, response, responseParity, COMMAND_TIMEOUT_MS);
+        }
+        _authenticated = false;
+        if (status == NFCStatus::OK && response.size() != 4) {
+            status = NFCStatus::COMMUNICATION_ERROR;
+        }
+        if (status != NFCStatus::OK) {
+            _stats.authenticationFailures++;
+            return status;
+        }
+
+        _crypto.Init(keyValue);
+        uint32_t nonce = 0;
+        for (int i = 0; i < 4; ++i) {
+            uint8_t nonceByte = nested ? static_cast<uint8_t>(response[i] ^ _crypto.Byte(wordByte(uid, i) ^ response[i], true))
+                                       : response[i];
+            if (!nested) {
+                _crypto.Byte(wordByte(uid, i) ^ nonceByte, false);
+            }
+            nonce = (nonce << 8) | nonceByte;
+        }
+
+        // Pass 2: reader nonce nr and answer ar = suc64(nt), encrypted with encrypted parity
+        _readerNonce ^= xTaskGetTickCount();
+        _readerNonce ^= _readerNonce << 13;
+        _readerNonce ^= _readerNonce >> 17;
+        _readerNonce ^= _readerNonce << 5;
+        uint32_t answer = Crypto1::NonceSuccessor(nonce, 64);
+        data.clear();
+        parity.clear();
+        for (int i = 0; i < 4; ++i) {
+            uint8_t nonceByte = wordByte(_readerNonce, i);
+            data.push_back(static_cast<uint8_t>(nonceByte ^ _crypto.Byte(nonceByte, false)));
+            parity.push_back(_crypto.Peek() ^ Crypto1::OddParity(nonceByte));
+        }
+        for (int i = 0; i < 4; ++i) {
+            uint8_t answerByte = wordByte(answer, i);
+            data.push_back(static_cast<uint8_t>(answerByte ^ _crypto.Byte(0x00, false)));
+            parity.push_back(_crypto.Peek() ^ Crypto1::OddParity(answerByte));
+        }
+
+        // Pass 3: the card answers at = suc96(nt); a wrong key leaves it silent
+        status = _controller->TransceiveWithParity(data, parity, response, responseParity, COMMAND_TIMEOUT_MS);
+        if (status == NFCStatus::OK && response.size() == 4) {
+            decrypt(response, 4);
+            uint32_t tagAnswer = (static_cast<uint32_t>(response[0]) << 24) | (static_cast<uint32_t>(response[1]) << 16) |
+                                 (static_cast<uint32_t>(response[2]) << 8) | response[3];
+            status = (tagAnswer == Crypto1::NonceSuccessor(nonce, 96)) ? NFCStatus::OK : NFCStatus::AUTH_ERROR;
+        } else if (status == NFCStatus::OK || status == NFCStatus::TIMEOUT) {
+            status = NFCStatus::AUTH_ERROR;
+        }
+        if (status != NFCStatus::OK) {
+            _stats.authenticationFailures++;
+            return status;
+        }
+
+        _authenticated = true;
+        _uid = tagInfo.uid;
+        _sector = SectorOf(block);
+        _keyB = key.keyB;
+        if (nested) {
+            _stats.nestedAuthentications++;
+        } else {
+            _stats.authentications++;
+        }
+        return NFCStatus::OK;
+    }
+
+    NFCStatus MifareClassic::readBlock(uint8_t block, std::vector<uint8_t>& data)
+    {
+        std::vector<uint8_t> response;
+        NFCStatus status = transceive({ CMD_READ, block }, response, COMMAND_TIMEOUT_MS);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (response.size() != BLOCK_SIZE + 2) {
+            // 4-bit NAK: no access
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+        if (crcIso14443A(response.data(), BLOCK_SIZE) != static_cast<uint16_t>(response[BLOCK_SIZE] | (response[BLOCK_SIZE + 1] << 8))) {
+            return NFCStatus::CRC_ERROR;
+        }
+        data.insert(data.end(), response.begin(), response.begin() + BLOCK_SIZE);
+        _stats.blocksRead++;
+        return NFCStatus::OK;
+    }
+
+    NFCStatus MifareClassic::writeBlock(uint8_t block, const uint8_t* data)
+    {
+        std::vector<uint8_t> response;
+        NFCStatus status = transceive({ CMD_WRITE, block }, response, COMMAND_TIMEOUT_MS);
+        if (status == NFCStatus::OK && (response.size() != 1 || response[0] != ACK)) {
+            status = NFCStatus::COMMUNICATION_ERROR;
+        }
+        if (status == NFCStatus::OK) {
+            status = transceive(std::vector<uint8_t>(data, data + BLOCK_SIZE), response, WRITE_TIMEOUT_MS);
+        }
+        if (status == NFCStatus::OK && (response.size() != 1 || response[0] != ACK)) {
+            status = NFCStatus::COMMUNICATION_ERROR;
+        }
+        if (status == NFCStatus::OK) {
+            _stats.blocksWritten++;
+        }
+        return status;
+    }
+
+    void MifareClassic::encrypt(const std::vector<uint8_t>& command, std::vector<uint8_t>& data, std::vector<uint8_t>& parity)
+    {
+        std::vector<uint8_t> frame = command;
+        appendCrc(frame);
+
+        data.clear();
+        parity.clear();
+        for (const uint8_t byte : frame) {
+            data.push_back(static_cast<uint8_t>(byte ^ _crypto.Byte(0x00, false)));
+            parity.push_back(_crypto.Peek() ^ Crypto1::OddParity(byte));
+        }
+    }
+
+    void MifareClassic::decrypt(std::vector<uint8_t>& data, size_t bytes)
+    {
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (i < bytes) {
+                data[i] ^= _crypto.Byte(0x00, false);
+            } else {
+                // 4-bit ACK/NAK
+                for (uint8_t bit = 0; bit < 4; ++bit) {
+                    data[i] ^= static_cast<uint8_t>(_crypto.Bit(0, false) << bit);
+                }
+            }
+        }
+    }
+
+    NFCStatus MifareClassic::transceive(const std::vector<uint8_t>& command, std::vector<uint8_t>& response, uint32_t timeoutMs)
+    {
+        std::vector<uint8_t> data, parity, responseParity;
+        encrypt(command, data, parity);
+        NFCStatus status = _controller->TransceiveWithParity(data, parity, response, responseParity, timeoutMs);
+        if (status == NFCStatus::OK) {
+            decrypt(response, responseParity.size());
+        }
+        return status;
+    }
+
+    NFCStatus MifareClassic::withSession(const TagInfo& tagInfo, uint8_t block, const std::function<NFCStatus(void)>& command)
+    {
+        // A card left in IDLE by the last failure does not answer before it is reselected
+        NFCStatus status = _cardLost ? NFCStatus::NO_TAG_FOUND : openSector(tagInfo, block);
+        if (status == NFCStatus::OK) {
+            status = command();
+        }
+        if (status == NFCStatus::OK) {
+            return status;
+        }
+
+        // The card left the session (NAK, wrong key or transmission error): reselect it and start over once
+        _authenticated = false;
+        if (!_activate || _activate(tagInfo) != NFCStatus::OK) {
+            _cardLost = true;
+            return NFCStatus::NO_TAG_FOUND;
+        }
+        _cardLost = false;
+        _stats.reactivations++;
+
+        status = openSector(tagInfo, block);
+        if (status == NFCStatus::OK) {
+            status = command();
+        }
+        if (status != NFCStatus::OK) {
+            _authenticated = false;
+            _cardLost = true;
+        }
+        return status;
+    }
+
+} // namespace NFC
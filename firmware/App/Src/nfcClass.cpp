@@ -19,251 +19,2959 @@
 namespace NFC
 {
     // ============================================================================
-    // NFCManager Implementation
+    // Poll Timing
     // ============================================================================
 
-    NFCManager::NFCManager(ST25R3911B* controller)
-        : _controller(controller)
-        , _tagReader(nullptr)
-        , _tagWriter(nullptr)
-        , _initialized(false)
-        , _detectionActive(false)
-        , _detectionProtocols(0)
+    /**
+     * @struct PollTiming
+     * @brief Guard time and poll response time of a technology.
+     */
+    struct PollTiming
     {
-        if (_controller) {
-            _tagReader = new TagReader(_controller);
-            _tagWriter = new TagWriter(_controller);
+        uint32_t guardTimeMs;               /**< Unmodulated field before the first poll command */
+        uint32_t responseTimeUs;            /**< Time until the poll response has started */
+    };
+
+    /** @brief Poll timing of NFC_A, NFC_B, NFC_F and NFC_V (NFC Forum Activity) */
+    static const PollTiming pollTiming[] = {
+        { 5, 1000 },                        // NFC-A: GT 5 ms, ATQA after ~90 us
+        { 5, 1000 },                        // NFC-B: GT 5 ms, ATQB within ~600 us
+        { 20, 4000 },                       // NFC-F: GT 20 ms, SENSF_RES slot 0 at ~2.4 ms
+        { 5, 1000 }                         // NFC-V: GT 5 ms, INVENTORY response after ~320 us
+    };
+
+    // ============================================================================
+    // NDEF TLV Area
+    // ============================================================================
+
+    /** @brief TLV types of the TLV area of Type 2 and Type 5 tags (others are skipped) */
+    static constexpr uint8_t TLV_NULL = 0x00;
+    static constexpr uint8_t TLV_NDEF = 0x03;
+    static constexpr uint8_t TLV_TERMINATOR = 0xFE;
+    /** @brief Largest TLV length (0xFF and a 2-byte length) */
+    static constexpr uint32_t TLV_MAX_LENGTH = 0xFFFE;
+
+    /** @brief Reads bytes of a tag: byte address, number of bytes, vector to store them */
+    using MemoryReadFunction = std::function<NFCStatus(uint32_t, uint32_t, std::vector<uint8_t>&)>;
+
+    /**
+     * @struct TlvArea
+     * @brief Location of a TLV area and the granularity it is accessed with.
+     */
+    struct TlvArea
+    {
+        uint32_t start;                     /**< Byte address of the first TLV (after the CC) */
+        uint32_t end;                       /**< Byte address after the TLV area */
+        uint16_t unitSize;                  /**< Page or block size */
+        uint32_t readAhead;                 /**< Bytes read beyond a TLV header */
+    };
+
+    /**
+     * @struct NdefTlv
+     * @brief Position of the NDEF TLV in the TLV area.
+     */
+    struct NdefTlv
+    {
+        bool present;                       /**< NDEF TLV found */
+        uint32_t offset;                    /**< Byte address of the NDEF TLV (or where a new one goes) */
+        uint8_t headerSize;                 /**< Type and length bytes (2, or 4 for 3-byte lengths) */
+        uint32_t length;                    /**< NDEF message length */
+    };
+
+    /**
+     * @struct TlvWindow
+     * @brief Consecutive bytes read from a TLV area.
+     */
+    struct TlvWindow
+    {
+        uint32_t address;                   /**< Byte address of the first byte (unit aligned) */
+        std::vector<uint8_t> bytes;         /**< Bytes read */
+    };
+
+    /**
+     * @brief Make sure a byte range of a TLV area has been read
+     * @details Continues the window with at least readAhead more bytes (within the TLV area) so
+     *          that a run of short TLVs does not cost a frame each. A range behind a skipped TLV
+     *          value starts a new window instead of reading the value.
+     * @param read Read function of the tag
+     * @param area TLV area
+     * @param window Bytes read so far, updated in place
+     * @param start First byte address needed
+     * @param end Byte address after the last byte needed
+     * @return NFCStatus::COMMUNICATION_ERROR if the range lies outside the TLV area
+     */
+    static NFCStatus tlvFetch(const MemoryReadFunction& read, const TlvArea& area, TlvWindow& window, uint32_t start, uint32_t end)
+    {
+        if (start >= window.address && end <= window.address + window.bytes.size()) {
+            return NFCStatus::OK;
+        }
+        if (end > area.end) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+        if (start < window.address || start > window.address + window.bytes.size()) {
+            window.address = start - start % area.unitSize;
+            window.bytes.clear();
+        }
+
+        uint32_t from = window.address + window.bytes.size();
+        uint32_t to = std::max<uint32_t>(end, std::min<uint32_t>(area.end, from + area.readAhead));
+        std::vector<uint8_t> data;
+        NFCStatus status = read(from, to - from, data);
+        if (status != NFCStatus::OK) {
+            return status;
         }
+        window.bytes.insert(window.bytes.end(), data.begin(), data.end());
+        return NFCStatus::OK;
     }
 
-    NFCManager::~NFCManager()
+    /**
+     * @brief Walk the TLV area up to the NDEF TLV
+     * @details Parses the TLVs in the bytes already read and only reads further when a header
+     *          lies beyond them. NULL TLVs are stepped over, Lock Control, Memory Control and
+     *          proprietary TLVs are skipped without reading their values, the walk ends at the
+     *          NDEF TLV or the Terminator TLV.
+     * @param read Read function of the tag
+     * @param area TLV area
+     * @param window Bytes read so far (may be empty), ends with the NDEF TLV header if present
+     * @param tlv Reference to store the NDEF TLV position
+     * @return NFCStatus::COMMUNICATION_ERROR if a TLV overruns the area
+     */
+    static NFCStatus findNdefTlv(const MemoryReadFunction& read, const TlvArea& area, TlvWindow& window, NdefTlv& tlv)
     {
-        Deinitialize();
-        delete _tagReader;
-        delete _tagWriter;
+        tlv = {};
+
+        // TLVs: NULL (1 byte), Terminator (1 byte), others with a 1-byte or 0xFF + 2-byte length
+        uint32_t offset = area.start;
+        while (offset < area.end) {
+            NFCStatus status = tlvFetch(read, area, window, offset, offset + 1);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            const uint8_t* header = window.bytes.data() + (offset - window.address);
+            if (header[0] == TLV_NULL) {
+                offset++;
+                continue;
+            }
+            if (header[0] == TLV_TERMINATOR) {
+                break;
+            }
+
+            uint8_t type = header[0];
+            uint8_t headerSize = 2;
+            status = tlvFetch(read, area, window, offset, offset + 2);
+            if (status == NFCStatus::OK && window.bytes[offset - window.address + 1] == 0xFF) {
+                headerSize = 4;
+                status = tlvFetch(read, area, window, offset, offset + 4);
+            }
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            header = window.bytes.data() + (offset - window.address);
+            uint32_t length = (headerSize == 2) ? header[1] : static_cast<uint32_t>((header[2] << 8) | header[3]);
+            if (offset + headerSize + length > area.end) {
+                return NFCStatus::COMMUNICATION_ERROR;
+            }
+
+            if (type == TLV_NDEF) {
+                tlv.present = true;
+                tlv.headerSize = headerSize;
+                tlv.length = length;
+                break;
+            }
+            // Lock Control, Memory Control or proprietary TLV
+            offset += headerSize + length;
+        }
+
+        tlv.offset = offset;
+        return NFCStatus::OK;
     }
 
-    NFCStatus NFCManager::Initialize(void)
+    /**
+     * @brief Read the value of the NDEF TLV
+     * @details The bytes read with the header are used, the rest of the message is read in one
+     *          go and nothing behind its end.
+     * @param read Read function of the tag
+     * @param tlv NDEF TLV found by findNdefTlv
+     * @param window Bytes read by findNdefTlv
+     * @param data Vector to store the NDEF message
+     * @return NFCStatus indicating success or failure
+     */
+    static NFCStatus readNdefTlvValue(const MemoryReadFunction& read, const NdefTlv& tlv, TlvWindow& window, std::vector<uint8_t>& data)
     {
-        if (_initialized || !_controller) {
-            return NFCStatus::ERROR;
+        uint32_t start = tlv.offset + tlv.headerSize;
+        uint32_t end = start + tlv.length;
+        uint32_t windowEnd = window.address + window.bytes.size();
+        if (windowEnd < end) {
+            std::vector<uint8_t> rest;
+            NFCStatus status = read(windowEnd, end - windowEnd, rest);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            window.bytes.insert(window.bytes.end(), rest.begin(), rest.end());
         }
 
-        NFCStatus status = _controller->Initialize();
+        data.assign(window.bytes.begin() + (start - window.address), window.bytes.begin() + (end - window.address));
+        return NFCStatus::OK;
+    }
+
+    /**
+     * @brief Check an empty NDEF TLV for an interrupted update
+     * @details A tear-safe update clears the length before the message is written and commits
+     *          it last. An empty NDEF TLV followed by a record header (MB set) instead of the
+     *          Terminator TLV is what an update that did not complete leaves behind.
+     * @param read Read function of the tag
+     * @param area TLV area
+     * @param window Bytes read by findNdefTlv
+     * @param tlv Empty NDEF TLV found by findNdefTlv
+     * @return NFCStatus::INTERRUPTED_WRITE if message data follows the empty NDEF TLV
+     */
+    static NFCStatus checkEmptyNdefTlv(const MemoryReadFunction& read, const TlvArea& area, TlvWindow& window, const NdefTlv& tlv)
+    {
+        uint32_t next = tlv.offset + tlv.headerSize;
+        if (next >= area.end) {
+            return NFCStatus::OK;
+        }
+        NFCStatus status = tlvFetch(read, area, window, next, next + 1);
         if (status != NFCStatus::OK) {
             return status;
         }
+        uint8_t recordHeader = window.bytes[next - window.address];
+        return ((recordHeader & 0x80) && recordHeader != TLV_TERMINATOR) ? NFCStatus::INTERRUPTED_WRITE : NFCStatus::OK;
+    }
 
-        _initialized = true;
+    /**
+     * @brief Build the bytes that replace the NDEF TLV
+     * @details NDEF TLV with a 1-byte or 0xFF + 2-byte length (moved by NULL TLVs so that the
+     *          length lies in one unit), then a Terminator TLV if the area has room for it. The
+     *          bytes before the TLV in its first unit, and after it in its last unit if they were
+     *          read, are taken from the window so that the image can be written in whole pages
+     *          or blocks.
+     * @param area TLV area
+     * @param window Bytes read by findNdefTlv (holds the byte at the TLV offset)
+     * @param tlv NDEF TLV found by findNdefTlv
+     * @param message NDEF message
+     * @param address Reference to store the byte address of the image (unit aligned)
+     * @param image Vector to store the bytes to write
+     * @return NFCStatus::INVALID_PARAM if the message does not fit the TLV area
+     */
+    static NFCStatus buildNdefTlv(const TlvArea& area, const TlvWindow& window, const NdefTlv& tlv,
+                                  const std::vector<uint8_t>& message, uint32_t& address, std::vector<uint8_t>& image)
+    {
+        if (message.size() > TLV_MAX_LENGTH) {
+            return NFCStatus::INVALID_PARAM;
+        }
+        std::vector<uint8_t> tlvData = { TLV_NDEF };
+        if (message.size() < 0xFF) {
+            tlvData.push_back(static_cast<uint8_t>(message.size()));
+        } else {
+            tlvData.push_back(0xFF);
+            tlvData.push_back(static_cast<uint8_t>(message.size() >> 8));
+            tlvData.push_back(static_cast<uint8_t>(message.size()));
+        }
+        tlvData.insert(tlvData.end(), message.begin(), message.end());
+
+        // A 3-byte length must lie in one unit to be committed with one write: NULL TLVs move it
+        uint32_t pad = 0;
+        while (tlvData[1] == 0xFF && (tlv.offset + pad + 1) % area.unitSize + 3 > area.unitSize && pad < area.unitSize) {
+            pad++;
+        }
+        tlvData.insert(tlvData.begin(), pad, TLV_NULL);
+        if (tlv.offset + tlvData.size() > area.end) {
+            return NFCStatus::INVALID_PARAM;
+        }
+        if (tlv.offset + tlvData.size() < area.end) {
+            tlvData.push_back(TLV_TERMINATOR);
+        }
+
+        // (the window starts at a unit boundary and holds the byte at the TLV offset)
+        address = tlv.offset - tlv.offset % area.unitSize;
+        auto windowAt = [&window](uint32_t byteAddress) { return window.bytes.begin() + (byteAddress - window.address); };
+        image.assign(windowAt(address), windowAt(tlv.offset));
+        image.insert(image.end(), tlvData.begin(), tlvData.end());
+        uint32_t end = address + image.size();
+        uint32_t unitEnd = (end + area.unitSize - 1) / area.unitSize * area.unitSize;
+        if (unitEnd <= window.address + window.bytes.size()) {
+            image.insert(image.end(), windowAt(end), windowAt(unitEnd));
+        }
         return NFCStatus::OK;
     }
 
-    NFCStatus NFCManager::Deinitialize(void)
+    /** @brief Unwritten bytes between two written units that verification reads through */
+    static constexpr uint32_t TAG_VERIFY_GAP = 16;
+
+    /** @brief Writes one page or block of a tag: byte address (unit aligned), unit data */
+    using UnitWriteFunction = std::function<NFCStatus(uint32_t, const uint8_t*)>;
+
+    /** @brief Reselects the tag written to after a write that was not acknowledged */
+    using UnitActivateFunction = std::function<NFCStatus(void)>;
+
+    /**
+     * @brief Serve a read function of a tag from its memory image
+     * @param cache Memory image cache (nullptr: read the tag)
+     * @param tagInfo Tag to read (referenced by the returned function)
+     * @param unitSize Page or block size
+     * @param fetch Read function of the tag
+     * @return Read function that only fetches the units not in the image
+     */
+    static MemoryReadFunction cachedRead(TagMemoryCache* cache, const TagInfo& tagInfo, uint16_t unitSize, MemoryReadFunction fetch)
     {
-        if (!_initialized) {
+        if (!cache) {
+            return fetch;
+        }
+        return [cache, &tagInfo, unitSize, fetch](uint32_t address, uint32_t length, std::vector<uint8_t>& bytes) {
+            return cache->Read(tagInfo, unitSize, address, length, fetch, bytes);
+        };
+    }
+
+    /**
+     * @brief Write a tag through its memory image
+     * @details A unit acknowledged by the tag is stored as valid. Units to be verified and units
+     *          whose write failed are stored dirty, the next read fetches them from the tag.
+     * @param cache Memory image cache (nullptr: write the tag only)
+     * @param tagInfo Tag to write (referenced by the returned function)
+     * @param unitSize Page or block size
+     * @param verify true if the written units are read back
+     * @param write Write function of the tag
+     * @return Write function that updates the image
+     */
+    static UnitWriteFunction cachedWrite(TagMemoryCache* cache, const TagInfo& tagInfo, uint16_t unitSize, bool verify, UnitWriteFunction write)
+    {
+        if (!cache) {
+            return write;
+        }
+        return [cache, &tagInfo, unitSize, verify, write](uint32_t address, const uint8_t* bytes) {
+            NFCStatus status = write(address, bytes);
+            cache->Write(tagInfo, unitSize, address, bytes, status == NFCStatus::OK && !verify);
+            return status;
+        };
+    }
+
+    /**
+     * @brief Bind the reselection function of a writer to a tag
+     * @param activate Reselection function (empty: none)
+     * @param tagInfo Tag to reselect (referenced by the returned function)
+     * @return Reselection function of the tag, empty if there is none
+     */
+    static UnitActivateFunction boundActivate(const TagWriter::ActivateFunction& activate, const TagInfo& tagInfo)
+    {
+        if (!activate) {
+            return nullptr;
+        }
+        return [activate, &tagInfo]() {
+            return activate(tagInfo);
+        };
+    }
+
+    /**
+     * @brief Write the units of an image within a byte range
+     * @details Units equal to current are left alone. With verification the written units are
+     *          read back in runs (gaps of up to TAG_VERIFY_GAP bytes are read through) and the
+     *          units that differ, or whose write was not acknowledged (NAK, error flag, no or
+     *          corrupted answer: the write may have been interrupted), are written again up to
+     *          config.retries times. The tag is reselected after each unacknowledged write, as a
+     *          NAK sends a Type 2 tag back to IDLE. A failed write ends the write at once without
+     *          verification, as does a NAK without reselection function.
+     * @param read Read function of the tag (verification)
+     * @param write Write function of the tag
+     * @param activate Reselection function of the tag (empty: none)
+     * @param config Write options
+     * @param unitSize Page or block size
+     * @param address Byte address of the image (unit aligned)
+     * @param image Bytes to write (whole units)
+     * @param current Bytes on the tag at the image addresses (empty: write every unit)
+     * @param start Byte address of the first unit to write (unit aligned)
+     * @param end Byte address after the last unit to write
+     * @param stats Write counters
+     * @return NFCStatus::VERIFY_ERROR if a unit still differs after the retries
+     */
+    static NFCStatus writeUnits(const MemoryReadFunction& read, const UnitWriteFunction& write, const UnitActivateFunction& activate,
+                                const WriteConfig& config, uint16_t unitSize, uint32_t address, const std::vector<uint8_t>& image,
+                                const std::vector<uint8_t>& current, uint32_t start, uint32_t end, WriteStats& stats)
+    {
+        std::vector<uint32_t> pending;
+        for (uint32_t unit = start; unit < end; unit += unitSize) {
+            size_t offset = unit - address;
+            if (!current.empty() && std::equal(image.begin() + offset, image.begin() + offset + unitSize, current.begin() + offset)) {
+                stats.unitsSkipped++;
+                continue;
+            }
+            pending.push_back(unit);
+        }
+
+        for (uint8_t attempt = 0; !pending.empty(); ++attempt) {
+            std::vector<bool> acknowledged(pending.size(), true);
+            for (size_t i = 0; i < pending.size(); ++i) {
+                NFCStatus status = write(pending[i], image.data() + (pending[i] - address));
+                if (attempt > 0) {
+                    stats.unitsRetried++;
+                }
+                if (status == NFCStatus::OK) {
+                    stats.unitsWritten++;
+                    continue;
+                }
+                if (!config.verify || (!activate && status == NFCStatus::ERROR)) {
+                    return status;
+                }
+                acknowledged[i] = false;
+                status = activate ? activate() : NFCStatus::OK;
+                if (status != NFCStatus::OK) {
+                    return status;
+                }
+            }
+            if (!config.verify) {
+                break;
+            }
+
+            // Read back runs of written units, a FAST_READ or READ MULTIPLE BLOCKS frame covers many
+            std::vector<uint32_t> failed;
+            for (size_t first = 0; first < pending.size(); ) {
+                size_t last = first;
+                while (last + 1 < pending.size() && pending[last + 1] - pending[last] - unitSize <= TAG_VERIFY_GAP) {
+                    last++;
+                }
+                uint32_t from = pending[first];
+                std::vector<uint8_t> data;
+                NFCStatus status = read(from, pending[last] + unitSize - from, data);
+                if (status != NFCStatus::OK) {
+                    return status;
+                }
+                for (size_t i = first; i <= last; ++i) {
+                    auto expected = image.begin() + (pending[i] - address);
+                    size_t offset = pending[i] - from;
+                    if (acknowledged[i] && offset + unitSize <= data.size() &&
+                        std::equal(expected, expected + unitSize, data.begin() + offset)) {
+                        stats.unitsVerified++;
+                    } else {
+                        failed.push_back(pending[i]);
+                    }
+                }
+                first = last + 1;
+            }
+            if (!failed.empty() && attempt >= config.retries) {
+                stats.verifyErrors += static_cast<uint32_t>(failed.size());
+                return NFCStatus::VERIFY_ERROR;
+            }
+            pending.swap(failed);
+        }
+        return NFCStatus::OK;
+    }
+
+    /**
+     * @brief Write the NDEF TLV image built by buildNdefTlv
+     * @details The image is completed to whole units (zeros behind the Terminator TLV, else the
+     *          bytes on the tag). The unit holding the TLV length is written last, so that the
+     *          length only changes once the message is in place. Tear-safe writes replace a
+     *          message on the tag by an empty one first if other units change (NFC Forum update
+     *          procedure: one extra write), a torn update then leaves an empty NDEF TLV rather
+     *          than a length over a partial message. Differential writes read the rest of the
+     *          range, compare and leave the units that already hold the data.
+     * @param read Read function of the tag
+     * @param write Write function of the tag
+     * @param activate Reselection function of the tag (empty: none)
+     * @param area TLV area
+     * @param window Bytes read by findNdefTlv, extended in place
+     * @param tlv NDEF TLV found by findNdefTlv
+     * @param address Byte address of the image
+     * @param image Image built by buildNdefTlv, completed in place
+     * @param config Write options
+     * @param stats Write counters
+     * @return NFCStatus indicating success or failure
+     */
+    static NFCStatus writeNdefTlv(const MemoryReadFunction& read, const UnitWriteFunction& write, const UnitActivateFunction& activate,
+                                  const TlvArea& area, TlvWindow& window, const NdefTlv& tlv, uint32_t address, std::vector<uint8_t>& image,
+                                  const WriteConfig& config, WriteStats& stats)
+    {
+        // NDEF TLV (behind aligning NULL TLVs): type, then a 1-byte or 0xFF + 2-byte length
+        uint32_t offset = tlv.offset;
+        while (image[offset - address] == TLV_NULL) {
+            offset++;
+        }
+        const uint8_t* header = image.data() + (offset - address);
+        uint32_t headerSize = (header[1] == 0xFF) ? 4 : 2;
+        uint32_t length = (headerSize == 2) ? header[1] : static_cast<uint32_t>((header[2] << 8) | header[3]);
+        bool terminated = offset + headerSize + length < area.end;
+
+        uint32_t end = (address + image.size() + area.unitSize - 1) / area.unitSize * area.unitSize;
+        uint32_t windowEnd = window.address + window.bytes.size();
+        std::vector<uint8_t> current;
+        if (config.differential) {
+            if (windowEnd < end) {
+                std::vector<uint8_t> rest;
+                NFCStatus status = read(windowEnd, end - windowEnd, rest);
+                if (status != NFCStatus::OK) {
+                    return status;
+                }
+                window.bytes.insert(window.bytes.end(), rest.begin(), rest.end());
+            }
+            current.assign(window.bytes.begin() + (address - window.address), window.bytes.begin() + (end - window.address));
+            image.insert(image.end(), current.begin() + image.size(), current.end());
+        } else if (terminated) {
+            // The rest of the last unit follows the Terminator TLV
+            image.resize(end - address, 0x00);
+        } else if (address + image.size() < end) {
+            std::vector<uint8_t> unit;
+            NFCStatus status = read(end - area.unitSize, area.unitSize, unit);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            image.insert(image.end(), unit.begin() + (address + image.size() - (end - area.unitSize)), unit.end());
+        }
+
+        // Unit with the length field
+        uint32_t lengthStart = (offset + 1) / area.unitSize * area.unitSize;
+        uint32_t lengthEnd = std::min<uint32_t>(end, (offset + headerSize + area.unitSize - 1) / area.unitSize * area.unitSize);
+        auto changes = [&](uint32_t from, uint32_t to) {
+            uint32_t units = 0;
+            for (uint32_t unit = from; unit < to; unit += area.unitSize) {
+                auto bytes = image.begin() + (unit - address);
+                if (current.empty() || !std::equal(bytes, bytes + area.unitSize, current.begin() + (unit - address))) {
+                    units++;
+                }
+            }
+            return units;
+        };
+
+        // A single changed unit is replaced by one write and needs no empty NDEF TLV
+        uint32_t bodyUnits = changes(address, lengthStart) + changes(lengthEnd, end);
+        NFCStatus status;
+        if (config.tearSafe && tlv.present && tlv.length > 0 && bodyUnits > 0 && bodyUnits + changes(lengthStart, lengthEnd) > 1) {
+            // Empty NDEF TLV first (the units up to the length field get their final content)
+            std::vector<uint8_t> cleared(image.begin(), image.begin() + (lengthEnd - address));
+            cleared[offset + 1 - address] = 0x00;
+            status = writeUnits(read, write, activate, config, area.unitSize, address, cleared, current, address, lengthEnd, stats);
+            if (!current.empty()) {
+                std::copy(cleared.begin(), cleared.end(), current.begin());
+            }
+        } else {
+            status = writeUnits(read, write, activate, config, area.unitSize, address, image, current, address, lengthStart, stats);
+        }
+        if (status == NFCStatus::OK) {
+            status = writeUnits(read, write, activate, config, area.unitSize, address, image, current, lengthEnd, end, stats);
+        }
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        return writeUnits(read, write, activate, config, area.unitSize, address, image, current, lengthStart, lengthEnd, stats);
+    }
+
+    // ============================================================================
+    // Type 2 Tags
+    // ============================================================================
+
+    /**
+     * @struct Type2Product
+     * @brief Memory layout of a Type 2 product identified by GET_VERSION.
+     */
+    struct Type2Product
+    {
+        uint8_t productType;                /**< GET_VERSION product type (byte 2) */
+        uint8_t storageSize;                /**< GET_VERSION storage size (byte 6) */
+        TagModel model;                     /**< Product */
+        uint16_t pageCount;                 /**< Total number of pages */
+        uint16_t userSize;                  /**< User memory in bytes */
+    };
+
+    /** @brief NXP Type 2 products (vendor 0x04) */
+    static const Type2Product type2Products[] = {
+        { 0x03, 0x0B, TagModel::ULTRALIGHT_EV1_MF0UL11, 20, 48 },
+        { 0x03, 0x0E, TagModel::ULTRALIGHT_EV1_MF0UL21, 41, 128 },
+        { 0x04, 0x0B, TagModel::NTAG210, 20, 48 },
+        { 0x04, 0x0E, TagModel::NTAG212, 41, 128 },
+        { 0x04, 0x0F, TagModel::NTAG213, 45, 144 },
+        { 0x04, 0x11, TagModel::NTAG215, 135, 504 },
+        { 0x04, 0x13, TagModel::NTAG216, 231, 888 }
+    };
+
+    /** @brief Pages per FAST_READ (256 bytes, the driver drains the FIFO at its water level) */
+    static constexpr uint8_t TYPE2_FAST_READ_PAGES = 64;
+    /** @brief Pages returned by READ */
+    static constexpr uint8_t TYPE2_READ_PAGES = 4;
+
+    /**
+     * @brief Check if a Type 2 tag implements FAST_READ
+     * @param model Identified product
+     * @return true for the products identified by GET_VERSION (NTAG21x, Ultralight EV1)
+     */
+    static bool type2SupportsFastRead(TagModel model)
+    {
+        return model != TagModel::UNKNOWN && model != TagModel::ULTRALIGHT;
+    }
+
+    /** @brief Byte address of the capability container (page 3) */
+    static constexpr uint8_t TYPE2_CC_ADDRESS = 12;
+    /** @brief Byte address of the data area (page 4) */
+    static constexpr uint8_t TYPE2_DATA_AREA = 16;
+    /** @brief Capability container magic */
+    static constexpr uint8_t TYPE2_CC_MAGIC = 0xE1;
+    /** @brief Bytes read ahead with the CC and TLV headers (one READ, covers Lock Control TLVs) */
+    static constexpr uint8_t TYPE2_READ_AHEAD = 16;
+
+    /**
+     * @struct Type2CapabilityContainer
+     * @brief Capability container of a Type 2 tag (page 3).
+     */
+    struct Type2CapabilityContainer
+    {
+        uint8_t version;                    /**< Mapping version (major in the upper nibble) */
+        uint32_t areaSize;                  /**< Data area size in bytes */
+        uint8_t readAccess;                 /**< 0x0: granted */
+        uint8_t writeAccess;                /**< 0x0: granted, 0xF: read-only */
+    };
+
+    /**
+     * @brief Read bytes of a Type 2 tag
+     * @details FAST_READ page ranges for products known to implement it, READ (4 pages) otherwise:
+     *          an unsupported command would send the tag back to IDLE.
+     * @param controller NFC controller
+     * @param tagInfo Tag information (identified model)
+     * @param address Byte address to read from (page 0 at address 0)
+     * @param length Number of bytes to read
+     * @param data Vector to store read data
+     * @return NFCStatus::INVALID_PARAM if the range goes beyond page 255
+     */
+    static NFCStatus readType2Data(ST25R3911B* controller, const TagInfo& tagInfo, uint32_t address, uint32_t length,
+                                   std::vector<uint8_t>& data)
+    {
+        data.clear();
+        if (length == 0) {
             return NFCStatus::OK;
         }
 
-        StopTagDetection();
-        
-        if (_controller) {
-            _controller->Deinitialize();
+        // Byte address from page 0, 4-byte pages
+        uint32_t firstPage = address / 4;
+        uint32_t lastPage = (address + length - 1) / 4;
+        if (lastPage > 0xFF) {
+            return NFCStatus::INVALID_PARAM;
         }
 
-        _initialized = false;
+        bool fastRead = type2SupportsFastRead(tagInfo.model);
+        std::vector<uint8_t> pages;
+        pages.reserve(static_cast<size_t>(lastPage - firstPage + 1) * 4);
+
+        for (uint32_t page = firstPage; page <= lastPage; ) {
+            uint32_t count = std::min<uint32_t>(fastRead ? TYPE2_FAST_READ_PAGES : TYPE2_READ_PAGES, lastPage - page + 1);
+            std::vector<uint8_t> readCmd;
+            if (fastRead) {
+                // FAST_READ: start page, end page
+                readCmd = { 0x3A, static_cast<uint8_t>(page), static_cast<uint8_t>(page + count - 1) };
+            } else {
+                readCmd = { 0x30, static_cast<uint8_t>(page) };
+            }
+
+            std::vector<uint8_t> response;
+            NFCStatus status = controller->TransmitReceive(readCmd, response, 100);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            // A NAK is a 4-bit answer
+            size_t expected = static_cast<size_t>(fastRead ? count : TYPE2_READ_PAGES) * 4;
+            if (response.size() != expected) {
+                return NFCStatus::ERROR;
+            }
+
+            pages.insert(pages.end(), response.begin(), response.begin() + count * 4);
+            page += count;
+        }
+
+        size_t offset = address - firstPage * 4;
+        data.assign(pages.begin() + offset, pages.begin() + offset + length);
         return NFCStatus::OK;
     }
 
-    NFCStatus NFCManager::StartTagDetection(uint32_t protocols, TagDetectionCallback callback)
+    /**
+     * @brief Write one page of a Type 2 tag
+     * @param controller NFC controller
+     * @param address Byte address of the page
+     * @param bytes The 4 page bytes
+     * @return NFCStatus indicating success or failure
+     */
+    static NFCStatus type2WritePage(ST25R3911B* controller, uint32_t address, const uint8_t* bytes)
     {
-        if (!_initialized || _detectionActive) {
+        // WRITE: page, 4 data bytes
+        std::vector<uint8_t> writeCmd = { 0xA2, static_cast<uint8_t>(address / 4) };
+        writeCmd.insert(writeCmd.end(), bytes, bytes + 4);
+
+        // ACK: 4-bit 0xA, anything else is a NAK (the tag is back in IDLE)
+        std::vector<uint8_t> response;
+        NFCStatus status = controller->TransmitReceive(writeCmd, response, 100);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (response.size() != 1 || (response[0] & 0x0F) != 0x0A) {
             return NFCStatus::ERROR;
         }
+        return NFCStatus::OK;
+    }
+
+    /**
+     * @brief Parse the capability container of a Type 2 tag
+     * @param data The 4 CC bytes
+     * @param cc Reference to store the capability container
+     * @return NFCStatus::UNSUPPORTED_TAG if there is no CC of mapping version 1.x
+     */
+    static NFCStatus type2ParseCapability(const uint8_t* data, Type2CapabilityContainer& cc)
+    {
+        // CC: magic, version, data area size / 8, read and write access
+        if (data[0] != TYPE2_CC_MAGIC || (data[1] >> 4) != 0x01) {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
+        cc.version = data[1];
+        cc.areaSize = static_cast<uint32_t>(data[2]) * 8;
+        cc.readAccess = data[3] >> 4;
+        cc.writeAccess = data[3] & 0x0F;
+        return NFCStatus::OK;
+    }
 
-        _detectionCallback = callback;
-        _detectionProtocols = protocols;
-        _detectionActive = true;
+    /**
+     * @brief Read the CC of a Type 2 tag and find the NDEF TLV
+     * @details The CC comes with the start of the data area in one frame, further bytes are only
+     *          read when a TLV header lies beyond what was read.
+     * @param read Read function of the tag
+     * @param tagInfo Tag information (identified model)
+     * @param cc Reference to store the capability container
+     * @param area Reference to store the TLV area
+     * @param window Bytes read last, including the NDEF TLV header if present
+     * @param tlv Reference to store the NDEF TLV position
+     * @return NFCStatus::UNSUPPORTED_TAG if there is no CC or reading is not granted
+     */
+    static NFCStatus type2FindNdefTlv(const MemoryReadFunction& read, const TagInfo& tagInfo, Type2CapabilityContainer& cc,
+                                      TlvArea& area, TlvWindow& window, NdefTlv& tlv)
+    {
+        // One READ returns 4 pages anyway
+        uint32_t firstRead = type2SupportsFastRead(tagInfo.model) ? 4 + TYPE2_READ_AHEAD : TYPE2_READ_PAGES * 4;
+        window.address = TYPE2_CC_ADDRESS;
+        NFCStatus status = read(TYPE2_CC_ADDRESS, firstRead, window.bytes);
+        if (status == NFCStatus::OK) {
+            status = type2ParseCapability(window.bytes.data(), cc);
+        }
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (cc.readAccess != 0x0) {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
+
+        // Identified products: never beyond user memory, READ and FAST_READ reach page 255
+        area.start = TYPE2_DATA_AREA;
+        area.end = std::min<uint32_t>(TYPE2_DATA_AREA + cc.areaSize, 0x100 * 4);
+        if (tagInfo.model != TagModel::UNKNOWN && tagInfo.dataSize) {
+            area.end = std::min<uint32_t>(area.end, TYPE2_DATA_AREA + tagInfo.dataSize);
+        }
+        area.unitSize = 4;
+        area.readAhead = TYPE2_READ_AHEAD;
+        return findNdefTlv(read, area, window, tlv);
+    }
+
+    // ============================================================================
+    // Type 4 Tags
+    // ============================================================================
+
+    /** @brief SELECT of the NDEF Tag Application (mapping version 2.0 and later) */
+    static const uint8_t type4SelectApplication[] = { 0x00, 0xA4, 0x04, 0x00, 0x07, 0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01, 0x00 };
+    /** @brief Capability container file identifier */
+    static constexpr uint16_t TYPE4_CC_FILE_ID = 0xE103;
+    /** @brief Capability container bytes up to the end of the NDEF File Control TLV */
+    static constexpr uint8_t TYPE4_CC_SIZE = 15;
+    /** @brief Extended NDEF File Control TLV is 2 bytes longer */
+    static constexpr uint8_t TYPE4_ENDEF_EXTRA = 2;
+    /** @brief Largest Le of a short READ BINARY (Le = 0x00) */
+    static constexpr uint16_t TYPE4_MAX_SHORT_LE = 256;
+    /** @brief Largest Lc of a short UPDATE BINARY */
+    static constexpr uint16_t TYPE4_MAX_SHORT_LC = 255;
+    /** @brief Largest offset of READ BINARY / UPDATE BINARY with offset in P1-P2 */
+    static constexpr uint32_t TYPE4_MAX_OFFSET = 0x7FFF;
+
+    /**
+     * @brief Check if a tag supports ISO14443-4
+     * @param tagInfo Tag information (SAK for Type A, protocol info for Type B)
+     * @return true for ISO-DEP tags
+     */
+    static bool supportsIsoDep(const TagInfo& tagInfo)
+    {
+        if (tagInfo.protocol == NFCProtocol::NFC_B) {
+            // Protocol type bit 0 of protocol info byte 2: ISO14443-4 compliant
+            return tagInfo.protocolInfo.size() > 1 && (tagInfo.protocolInfo[1] & 0x01);
+        }
+        return tagInfo.protocol == NFCProtocol::NFC_A && (tagInfo.sak & 0x20);
+    }
 
-        // Enable field
-        NFCStatus status = _controller->SetField(NFCField::ON);
+    /**
+     * @brief Send a command APDU and check the status word
+     * @param isoDep ISO14443-4 link
+     * @param command Command APDU
+     * @param length Command length
+     * @param response Vector to store the response data (without status word)
+     * @param maxData Largest response data expected
+     * @return NFCStatus::ERROR if the status word is not 90 00
+     */
+    static NFCStatus type4Command(IsoDep* isoDep, const uint8_t* command, size_t length,
+                                  std::vector<uint8_t>& response, size_t maxData)
+    {
+        size_t responseLength = 0;
+        response.resize(maxData + 2);
+        NFCStatus status = isoDep->Exchange(command, length, response.data(), response.size(), responseLength);
         if (status != NFCStatus::OK) {
-            _detectionActive = false;
             return status;
         }
+        if (responseLength < 2) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+
+        bool success = (response[responseLength - 2] == 0x90 && response[responseLength - 1] == 0x00);
+        response.resize(responseLength - 2);
+        return success ? NFCStatus::OK : NFCStatus::ERROR;
+    }
+
+    /**
+     * @brief Select an elementary file of the NDEF Tag Application
+     * @param isoDep ISO14443-4 link
+     * @param fileId File identifier
+     * @return NFCStatus indicating success or failure
+     */
+    static NFCStatus type4SelectFile(IsoDep* isoDep, uint16_t fileId)
+    {
+        // SELECT by file identifier, first or only occurrence, no response data
+        const uint8_t select[] = { 0x00, 0xA4, 0x00, 0x0C, 0x02, static_cast<uint8_t>(fileId >> 8), static_cast<uint8_t>(fileId) };
+        std::vector<uint8_t> response;
+        return type4Command(isoDep, select, sizeof(select), response, 0);
+    }
 
-        // Start with ISO14443A detection (most common)
-        status = _controller->SetProtocol(NFCProtocol::NFC_A);
+    /**
+     * @brief Read from the selected file
+     * @param isoDep ISO14443-4 link
+     * @param offset File offset (at most 0x7FFF)
+     * @param length Number of bytes (at most 256)
+     * @param data Vector the bytes are appended to
+     * @return NFCStatus indicating success or failure
+     */
+    static NFCStatus type4ReadBinary(IsoDep* isoDep, uint16_t offset, uint16_t length, std::vector<uint8_t>& data)
+    {
+        // Le 0x00 requests 256 bytes
+        const uint8_t read[] = { 0x00, 0xB0, static_cast<uint8_t>(offset >> 8), static_cast<uint8_t>(offset), static_cast<uint8_t>(length) };
+        std::vector<uint8_t> response;
+        NFCStatus status = type4Command(isoDep, read, sizeof(read), response, length);
         if (status != NFCStatus::OK) {
-            _detectionActive = false;
             return status;
         }
+        if (response.empty()) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
 
+        data.insert(data.end(), response.begin(), response.end());
         return NFCStatus::OK;
     }
 
-    NFCStatus NFCManager::StopTagDetection(void)
+    /**
+     * @brief Write to the selected file
+     * @param isoDep ISO14443-4 link
+     * @param offset File offset (at most 0x7FFF)
+     * @param data Data to write (at most 255 bytes)
+     * @param length Number of bytes
+     * @return NFCStatus indicating success or failure
+     */
+    static NFCStatus type4UpdateBinary(IsoDep* isoDep, uint16_t offset, const uint8_t* data, size_t length)
     {
-        if (!_detectionActive) {
+        std::vector<uint8_t> update = { 0x00, 0xD6, static_cast<uint8_t>(offset >> 8), static_cast<uint8_t>(offset), static_cast<uint8_t>(length) };
+        update.insert(update.end(), data, data + length);
+        std::vector<uint8_t> response;
+        return type4Command(isoDep, update.data(), update.size(), response, 0);
+    }
+
+    /**
+     * @brief Select the NDEF Tag Application, read the CC file and select the NDEF file
+     * @param isoDep ISO14443-4 link
+     * @param cc Reference to store the capability container
+     * @return NFCStatus::UNSUPPORTED_TAG if the tag has no NDEF Tag Application
+     */
+    static NFCStatus type4SelectNdefFile(IsoDep* isoDep, Type4CapabilityContainer& cc)
+    {
+        if (!isoDep || !isoDep->IsActive()) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+
+        std::vector<uint8_t> response;
+        NFCStatus status = type4Command(isoDep, type4SelectApplication, sizeof(type4SelectApplication), response, TYPE4_MAX_SHORT_LE);
+        if (status != NFCStatus::OK) {
+            return (status == NFCStatus::ERROR) ? NFCStatus::UNSUPPORTED_TAG : status;
+        }
+
+        // CC: CCLEN, mapping version, MLe, MLc, NDEF File Control TLV (T 0x04, or 0x06 for ENDEF)
+        std::vector<uint8_t> data;
+        status = type4SelectFile(isoDep, TYPE4_CC_FILE_ID);
+        if (status == NFCStatus::OK) {
+            status = type4ReadBinary(isoDep, 0, TYPE4_CC_SIZE, data);
+        }
+        if (status == NFCStatus::OK && data.size() == TYPE4_CC_SIZE && data[7] == 0x06) {
+            status = type4ReadBinary(isoDep, TYPE4_CC_SIZE, TYPE4_ENDEF_EXTRA, data);
+        }
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (data.size() < TYPE4_CC_SIZE) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+
+        cc.mappingVersion = data[2];
+        cc.maxReadSize = static_cast<uint16_t>((data[3] << 8) | data[4]);
+        cc.maxWriteSize = static_cast<uint16_t>((data[5] << 8) | data[6]);
+        cc.ndefFileId = static_cast<uint16_t>((data[9] << 8) | data[10]);
+        if (data[7] == 0x04 && data[8] >= 6) {
+            cc.ndefFileSize = static_cast<uint32_t>((data[11] << 8) | data[12]);
+            cc.lengthFieldSize = 2;
+            cc.readAccess = data[13];
+            cc.writeAccess = data[14];
+        } else if (data[7] == 0x06 && data[8] >= 8 && data.size() >= TYPE4_CC_SIZE + TYPE4_ENDEF_EXTRA) {
+            cc.ndefFileSize = (static_cast<uint32_t>(data[11]) << 24) | (static_cast<uint32_t>(data[12]) << 16) |
+                              (static_cast<uint32_t>(data[13]) << 8) | data[14];
+            cc.lengthFieldSize = 4;
+            cc.readAccess = data[15];
+            cc.writeAccess = data[16];
+        } else {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+
+        // MLe is at least 15, MLc at least 1
+        if (cc.maxReadSize < 0x000F || cc.maxWriteSize < 0x0001 || cc.ndefFileSize <= cc.lengthFieldSize) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+
+        return type4SelectFile(isoDep, cc.ndefFileId);
+    }
+
+    // ============================================================================
+    // Type 5 Tags
+    // ============================================================================
+
+    /** @brief Largest READ MULTIPLE BLOCKS response requested */
+    static constexpr uint16_t TYPE5_MAX_READ_SIZE = 256;
+    /** @brief Bytes read ahead with the CC and TLV headers (covers short messages) */
+    static constexpr uint16_t TYPE5_READ_AHEAD = 64;
+    /** @brief Largest capability container */
+    static constexpr uint8_t TYPE5_MAX_CC_SIZE = 8;
+    /** @brief Capability container magic, 1-byte (0xE1) or 2-byte (0xE2) addressing */
+    static constexpr uint8_t TYPE5_CC_MAGIC = 0xE1;
+    static constexpr uint8_t TYPE5_CC_MAGIC_EXTENDED = 0xE2;
+    /**
+     * @brief Get the default READ MULTIPLE BLOCKS size
+     * @param tagInfo Tag information (block size)
+     * @return Blocks of a 256-byte response
+     */
+    static uint16_t vicinityDefaultBlocksPerRead(const TagInfo& tagInfo)
+    {
+        uint16_t blockSize = tagInfo.blockSize ? tagInfo.blockSize : 4;
+        return std::max<uint16_t>(1, static_cast<uint16_t>(TYPE5_MAX_READ_SIZE / blockSize));
+    }
+
+    /**
+     * @brief Read bytes of an ISO15693 tag
+     * @details Addressed READ MULTIPLE BLOCKS with at most blocksPerRead blocks per frame, the
+     *          extended commands (2-byte block numbers) reach blocks above 255. A tag that
+     *          rejects the frame size is asked for half as many blocks, one without READ MULTIPLE
+     *          BLOCKS is read with READ SINGLE BLOCK; blocksPerRead keeps what the tag accepted.
+     * @param controller NFC controller
+     * @param tagInfo Tag to read (addressed by UID)
+     * @param address Byte address to read from
+     * @param length Number of bytes to read
+     * @param data Vector to store read data
+     * @param blocksPerRead Blocks per READ MULTIPLE BLOCKS, updated when the tag rejects it
+     * @return NFCStatus indicating success or failure
+     */
+    static NFCStatus readVicinityData(ST25R3911B* controller, const TagInfo& tagInfo, uint32_t address, uint32_t length,
+                                      std::vector<uint8_t>& data, uint16_t& blocksPerRead)
+    {
+        data.clear();
+        if (length == 0) {
             return NFCStatus::OK;
         }
 
-        _detectionActive = false;
-        _detectionCallback = nullptr;
+        // Unknown layout: 4-byte blocks (most ISO15693 tags)
+        uint16_t blockSize = tagInfo.blockSize ? tagInfo.blockSize : 4;
+        uint32_t firstBlock = address / blockSize;
+        uint32_t endBlock = (address + length - 1) / blockSize + 1;
+        if (endBlock > 0x10000) {
+            return NFCStatus::INVALID_PARAM;
+        }
 
-        // Turn off field
-        return _controller->SetField(NFCField::OFF);
+        std::vector<uint8_t> blocks;
+        blocks.reserve(static_cast<size_t>(endBlock - firstBlock) * blockSize);
+
+        for (uint32_t block = firstBlock; block < endBlock; ) {
+            uint32_t count = std::min<uint32_t>(std::max<uint16_t>(blocksPerRead, 1), endBlock - block);
+            bool extended = (block + count - 1) > 0xFF;
+
+            // Addressed READ SINGLE BLOCK (0x20 / 0x30) or READ MULTIPLE BLOCKS (0x23 / 0x33):
+            // flags, command, UID (LSB first), first block, blocks - 1 (LSB first if extended)
+            uint8_t command = static_cast<uint8_t>((count > 1 ? 0x23 : 0x20) | (extended ? 0x10 : 0x00));
+            std::vector<uint8_t> readCmd = { 0x22, command };
+            readCmd.insert(readCmd.end(), tagInfo.uid.rbegin(), tagInfo.uid.rend());
+            readCmd.push_back(static_cast<uint8_t>(block));
+            if (extended) {
+                readCmd.push_back(static_cast<uint8_t>(block >> 8));
+            }
+            if (count > 1) {
+                readCmd.push_back(static_cast<uint8_t>(count - 1));
+                if (extended) {
+                    readCmd.push_back(static_cast<uint8_t>((count - 1) >> 8));
+                }
+            }
+
+            std::vector<uint8_t> response;
+            NFCStatus status = controller->TransmitReceive(readCmd, response, 100);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            // Response: flags, block data (error: flags, error code)
+            if (count > 1 && !response.empty() && (response[0] & 0x01)) {
+                // Error code 0x01: command not supported, otherwise too many blocks for the tag
+                bool unsupported = response.size() > 1 && response[1] == 0x01;
+                blocksPerRead = unsupported ? 1 : static_cast<uint16_t>(count / 2);
+                continue;
+            }
+            if (response.empty() || (response[0] & 0x01) || response.size() != 1 + static_cast<size_t>(count) * blockSize) {
+                return NFCStatus::ERROR;
+            }
+            blocks.insert(blocks.end(), response.begin() + 1, response.end());
+            block += count;
+        }
+
+        size_t offset = address - firstBlock * blockSize;
+        data.assign(blocks.begin() + offset, blocks.begin() + offset + length);
+        return NFCStatus::OK;
+    }
+
+    /**
+     * @brief Write one block of an ISO15693 tag
+     * @param controller NFC controller
+     * @param tagInfo Tag to write (addressed by UID)
+     * @param address Byte address of the block
+     * @param bytes Block data (block size bytes)
+     * @return NFCStatus indicating success or failure
+     */
+    static NFCStatus vicinityWriteBlock(ST25R3911B* controller, const TagInfo& tagInfo, uint32_t address, const uint8_t* bytes)
+    {
+        uint16_t blockSize = tagInfo.blockSize ? tagInfo.blockSize : 4;
+        uint32_t block = address / blockSize;
+
+        // Addressed WRITE SINGLE BLOCK (0x21, or 0x31 with a 2-byte block number above 255):
+        // flags, command, UID (LSB first), block, data
+        bool extended = block > 0xFF;
+        std::vector<uint8_t> writeCmd = { 0x22, static_cast<uint8_t>(extended ? 0x31 : 0x21) };
+        writeCmd.insert(writeCmd.end(), tagInfo.uid.rbegin(), tagInfo.uid.rend());
+        writeCmd.push_back(static_cast<uint8_t>(block));
+        if (extended) {
+            writeCmd.push_back(static_cast<uint8_t>(block >> 8));
+        }
+        writeCmd.insert(writeCmd.end(), bytes, bytes + blockSize);
+
+        std::vector<uint8_t> response;
+        NFCStatus status = controller->TransmitReceive(writeCmd, response, 100);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (response.empty() || (response[0] & 0x01)) {
+            return NFCStatus::ERROR;
+        }
+        return NFCStatus::OK;
+    }
+
+    /**
+     * @brief Parse the capability container of a Type 5 tag
+     * @param data Bytes from address 0 (at least the CC)
+     * @param cc Reference to store the capability container
+     * @return NFCStatus::UNSUPPORTED_TAG if there is no CC of mapping version 1.x
+     */
+    static NFCStatus type5ParseCapability(const std::vector<uint8_t>& data, Type5CapabilityContainer& cc)
+    {
+        // CC: magic, version and access, MLEN (area size / 8), feature flags
+        //     8-byte CC: MLEN 0, then 2 RFU bytes and the 16-bit MLEN
+        if (data.size() < 4 || (data[0] != TYPE5_CC_MAGIC && data[0] != TYPE5_CC_MAGIC_EXTENDED) || (data[1] >> 6) != 0x01) {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
+
+        cc.version = data[1] & 0xF0;
+        cc.readAccess = (data[1] >> 2) & 0x03;
+        cc.writeAccess = data[1] & 0x03;
+        cc.multipleBlockRead = (data[3] & 0x01) != 0;
+        cc.lockBlock = (data[3] & 0x08) != 0;
+        cc.specialFrame = (data[3] & 0x10) != 0;
+        if (data[2] != 0x00) {
+            cc.size = 4;
+            cc.areaSize = static_cast<uint32_t>(data[2]) * 8;
+        } else {
+            if (data.size() < 8) {
+                return NFCStatus::UNSUPPORTED_TAG;
+            }
+            cc.size = 8;
+            cc.areaSize = static_cast<uint32_t>((data[6] << 8) | data[7]) * 8;
+        }
+        return NFCStatus::OK;
+    }
+
+    /**
+     * @brief Read the CC of a Type 5 tag and find the NDEF TLV
+     * @details The CC comes with the start of the TLV area in one frame, further bytes are only
+     *          read when a TLV header lies beyond what was read.
+     * @param read Read function of the tag (READ MULTIPLE BLOCKS of blocksPerRead blocks)
+     * @param tagInfo Tag to read (block size, memory size)
+     * @param blocksPerRead Blocks per READ MULTIPLE BLOCKS (1 if the CC rules it out)
+     * @param cc Reference to store the capability container
+     * @param area Reference to store the TLV area
+     * @param window Bytes read last, including the NDEF TLV header if present
+     * @param tlv Reference to store the NDEF TLV position
+     * @return NFCStatus::UNSUPPORTED_TAG if there is no CC or reading is not granted
+     */
+    static NFCStatus type5FindNdefTlv(const MemoryReadFunction& read, const TagInfo& tagInfo, uint16_t& blocksPerRead,
+                                      Type5CapabilityContainer& cc, TlvArea& area, TlvWindow& window, NdefTlv& tlv)
+    {
+        uint32_t firstRead = (blocksPerRead > 1) ? TYPE5_READ_AHEAD : TYPE5_MAX_CC_SIZE;
+        if (tagInfo.dataSize) {
+            firstRead = std::min<uint32_t>(firstRead, tagInfo.dataSize);
+        }
+        window.address = 0;
+        NFCStatus status = read(0, firstRead, window.bytes);
+        if (status == NFCStatus::OK) {
+            status = type5ParseCapability(window.bytes, cc);
+        }
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (cc.readAccess != 0) {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
+        if (!cc.multipleBlockRead) {
+            blocksPerRead = 1;
+        }
+
+        area.start = cc.size;
+        area.end = cc.size + cc.areaSize;
+        if (tagInfo.dataSize) {
+            area.end = std::min<uint32_t>(area.end, tagInfo.dataSize);
+        }
+        area.unitSize = tagInfo.blockSize ? tagInfo.blockSize : 4;
+        // A single block if the tag reads one block per frame
+        area.readAhead = (blocksPerRead > 1) ? TYPE5_READ_AHEAD : 1;
+        return findNdefTlv(read, area, window, tlv);
+    }
+
+    // ============================================================================
+    // NFCManager Implementation
+    // ============================================================================
+
+    NFCManager::NFCManager(ST25R3911B* controller)
+        : _controller(controller)
+        , _tagReader(nullptr)
+        , _tagWriter(nullptr)
+        , _isoDep(nullptr)
+        , _memoryCache(nullptr)
+        , _mifareClassic(nullptr)
+        , _initialized(false)
+        , _detectionActive(false)
+        , _detectionProtocols(0)
+        , _signalPolicy{true, 3, 7, 4, 3}
+        , _signalSequence(0)
+        , _discoveryState(DiscoveryState::IDLE)
+        , _discoveryConfig{100, 200, 2, 1000, true, 3, false, 8, 25, 500, 30, 2000}
+        , _discoveryStats{}
+        , _nextStepTick(0)
+        , _cycleStartTick(0)
+        , _presenceFailures(0)
+        , _pendingTag{}
+        , _currentTag{}
+        , _tagPresent(false)
+        , _technologyStats{}
+        , _pollIndex(0)
+        , _pollConfigured(false)
+        , _guardStartTick(0)
+        , _fieldOnTick(0)
+        , _activityUntilTick(0)
+        , _inventoryCallback(nullptr)
+        , _inventoryStats{}
+        , _uidCacheConfig{true, 1000}
+        , _modelSequence(0)
+        , _felicaConfig{0xFFFF, 0x00, 4, NFCBitRate::BR_212}
+    {
+        if (_controller) {
+            _isoDep = new IsoDep(_controller);
+            _memoryCache = new TagMemoryCache();
+            _mifareClassic = new MifareClassic(_controller, [this](const TagInfo& tagInfo) {
+                return reactivateTypeA(tagInfo);
+            });
+            _tagReader = new TagReader(_controller, _isoDep, _memoryCache, _mifareClassic);
+            _tagWriter = new TagWriter(_controller, _isoDep, _memoryCache, _mifareClassic, [this](const TagInfo& tagInfo) {
+                // A NAK sends a Type 2 tag back to IDLE, a Type 5 tag keeps its state after an error flag
+                return (tagInfo.protocol == NFCProtocol::NFC_A) ? reactivateTypeA(tagInfo) : NFCStatus::OK;
+            });
+        }
+    }
+
+    NFCManager::~NFCManager()
+    {
+        Deinitialize();
+        delete _tagReader;
+        delete _tagWriter;
+        delete _isoDep;
+        delete _memoryCache;
+        delete _mifareClassic;
+    }
+
+    NFCStatus NFCManager::Initialize(void)
+    {
+        if (_initialized || !_controller) {
+            return NFCStatus::ERROR;
+        }
+
+        NFCStatus status = _controller->Initialize();
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        // Collect per-frame signal quality
+        _controller->SetSignalCallback([this](const SignalQuality& quality) {
+            handleSignalQuality(quality);
+        });
+
+        _initialized = true;
+        return NFCStatus::OK;
+    }
+
+    NFCStatus NFCManager::Deinitialize(void)
+    {
+        if (!_initialized) {
+            return NFCStatus::OK;
+        }
+
+        StopTagDetection();
+        
+        if (_controller) {
+            _controller->SetSignalCallback(nullptr);
+            _controller->Deinitialize();
+        }
+
+        _initialized = false;
+        return NFCStatus::OK;
+    }
+
+    NFCStatus NFCManager::StartTagDetection(uint32_t protocols, TagDetectionCallback callback)
+    {
+        if (!_initialized || _detectionActive) {
+            return NFCStatus::ERROR;
+        }
+
+        _detectionCallback = callback;
+        _detectionProtocols = protocols;
+        _detectionActive = true;
+        _tagPresent = false;
+
+        // The first poll cycle starts with the next RunDiscovery() call
+        enterState(DiscoveryState::FIELD_ON, 0);
+        return NFCStatus::OK;
+    }
+
+    NFCStatus NFCManager::StopTagDetection(void)
+    {
+        if (!_detectionActive) {
+            return NFCStatus::OK;
+        }
+
+        _detectionActive = false;
+        _detectionCallback = nullptr;
+        _discoveryState = DiscoveryState::IDLE;
+        _tagPresent = false;
+        _activeUid.clear();
+        _uidCache.clear();
+        _memoryCache->Clear();
+
+        // Turn off field
+        if (_controller->IsFieldOn()) {
+            _discoveryStats.fieldOnTimeMs += (xTaskGetTickCount() - _fieldOnTick) * portTICK_PERIOD_MS;
+        }
+        return _controller->SetField(NFCField::OFF);
+    }
+
+    NFCStatus NFCManager::SetField(NFCField field)
+    {
+        if (!_initialized) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+
+        return _controller->SetField(field);
+    }
+
+    NFCField NFCManager::GetField(void) const
+    {
+        if (!_initialized) {
+            return NFCField::OFF;
+        }
+
+        NFCField field;
+        _controller->GetField(field);
+        return field;
+    }
+
+    // ============================================================================
+    // Discovery State Machine
+    // ============================================================================
+
+    uint32_t NFCManager::RunDiscovery(void)
+    {
+        if (!_initialized || !_detectionActive) {
+            return _discoveryConfig.pollPeriodMs;
+        }
+
+        uint32_t now = xTaskGetTickCount();
+        expireSightings(now);
+
+        int32_t remaining = static_cast<int32_t>(_nextStepTick - now);
+        if (remaining > 0) {
+            return static_cast<uint32_t>(remaining) * portTICK_PERIOD_MS;
+        }
+
+        NFCStatus status;
+
+        switch (_discoveryState) {
+            case DiscoveryState::FIELD_ON:
+                buildPollSequence();
+                if (_pollSequence.empty()) {
+                    // Every requested technology is backed off for this cycle
+                    enterState(DiscoveryState::FIELD_OFF, 0);
+                    break;
+                }
+                _cycleStartTick = now;
+                _pollIndex = 0;
+                _pollConfigured = false;
+                _discoveryStats.pollCycles++;
+                status = NFCStatus::OK;
+                if (!_controller->IsFieldOn()) {
+                    // Guard time runs from field on
+                    _guardStartTick = now;
+                    _fieldOnTick = now;
+                    status = _controller->SetField(NFCField::ON);
+                }
+                enterState((status == NFCStatus::OK) ? DiscoveryState::POLL : DiscoveryState::FIELD_OFF, 0);
+                break;
+
+            case DiscoveryState::POLL: {
+                if (_pollIndex >= _pollSequence.size()) {
+                    enterState(DiscoveryState::FIELD_OFF, 0);
+                    break;
+                }
+
+                NFCProtocol technology = _pollSequence[_pollIndex];
+                const PollTiming& timing = pollTiming[static_cast<size_t>(technology)];
+
+                if (!_pollConfigured) {
+                    // Changing the modulation restarts the guard time
+                    if (_controller->GetProtocol() != technology) {
+                        _guardStartTick = now;
+                    }
+                    status = _controller->SetProtocol(technology);
+                    if (status == NFCStatus::OK && technology == NFCProtocol::NFC_F) {
+                        status = _controller->SetBitRate(_felicaConfig.bitRate);
+                    }
+                    if (status == NFCStatus::OK) {
+                        // Short no-response timeout: an empty field must not cost the full timeout
+                        status = _controller->SetNoResponseTimer(responseTimeUs(technology));
+                    }
+                    if (status != NFCStatus::OK) {
+                        enterState(DiscoveryState::FIELD_OFF, 0);
+                        break;
+                    }
+                    _pollConfigured = true;
+
+                    uint32_t elapsedMs = (xTaskGetTickCount() - _guardStartTick) * portTICK_PERIOD_MS;
+                    if (elapsedMs < timing.guardTimeMs) {
+                        enterState(DiscoveryState::POLL, timing.guardTimeMs - elapsedMs);
+                        break;
+                    }
+                }
+
+                TechnologyStats& stats = _technologyStats[static_cast<size_t>(technology)];
+                stats.polls++;
+
+                _pendingTag = TagInfo{};
+                status = pollTechnology(technology, _pendingTag);
+
+                // A collision in the poll response still means at least one tag answered
+                if (status == NFCStatus::OK || status == NFCStatus::COLLISION_ERROR) {
+                    stats.answers++;
+                    stats.lastSeenTick = now;
+                    _activityUntilTick = now + pdMS_TO_TICKS(_discoveryConfig.activityHoldMs);
+                    stats.skipCycles = 0;
+                    stats.skipRemaining = 0;
+                    // FeliCa answers arrive in separate time slots, the other technologies
+                    // need collision resolution before the callback
+                    enterState((technology != NFCProtocol::NFC_F)
+                                   ? DiscoveryState::COLLISION_RESOLUTION : DiscoveryState::CALLBACK, 0);
+                } else {
+                    // Back off: skip 1, 3, 7, ... cycles up to the configured maximum
+                    uint16_t skip = static_cast<uint16_t>(stats.skipCycles) * 2 + 1;
+                    stats.skipCycles = static_cast<uint8_t>(std::min<uint16_t>(skip, _discoveryConfig.maxBackoffCycles));
+                    stats.skipRemaining = stats.skipCycles;
+                    _pollIndex++;
+                    _pollConfigured = false;
+                    enterState(DiscoveryState::POLL, 0);
+                }
+                break;
+            }
+
+            case DiscoveryState::COLLISION_RESOLUTION:
+                if (_pendingTag.protocol == NFCProtocol::NFC_V) {
+                    // A clean single slot answer means a single tag, otherwise inventory all of them
+                    if (_pendingTag.uid.empty()) {
+                        status = inventoryTypeV(_polledTags);
+                        if (status == NFCStatus::OK) {
+                            _pendingTag = _polledTags.front();
+                        }
+                    } else {
+                        _polledTags.assign(1, _pendingTag);
+                        status = NFCStatus::OK;
+                    }
+                    enterState((status == NFCStatus::OK) ? DiscoveryState::ACTIVATION : DiscoveryState::FIELD_OFF, 0);
+                    break;
+                }
+                if (_pendingTag.protocol == NFCProtocol::NFC_B) {
+                    status = resolveTypeB(_pendingTag);
+                    enterState((status == NFCStatus::OK) ? DiscoveryState::ACTIVATION : DiscoveryState::FIELD_OFF, 0);
+                    break;
+                }
+                if (_discoveryConfig.inventory) {
+                    // The tags answered the poll: serve all of them, then start the next cycle.
+                    // Only tags seen for the first time get a session.
+                    runInventory(_inventory, [this, now](const TagInfo& tag) {
+                        if (recordSighting(tag)) {
+                            _discoveryStats.tagsDiscovered++;
+                            recordLatency((now - _cycleStartTick) * portTICK_PERIOD_MS);
+                            if (_detectionCallback) {
+                                _detectionCallback(tag);
+                            }
+                        }
+                    }, true);
+                    _controller->SetNoResponseTimer(0);
+                    if (!_inventory.empty() && _inventoryCallback) {
+                        _inventoryCallback(_inventory);
+                    }
+                    enterState(DiscoveryState::FIELD_OFF, 0);
+                    break;
+                }
+                status = _tagReader->Anticollision(_pendingTag);
+                enterState((status == NFCStatus::OK) ? DiscoveryState::ACTIVATION : DiscoveryState::FIELD_OFF, 0);
+                break;
+
+            case DiscoveryState::ACTIVATION:
+                _isoDep->Reset();
+                if (_pendingTag.protocol == NFCProtocol::NFC_B) {
+                    status = activateTypeB(_pendingTag);
+                } else if (_pendingTag.protocol == NFCProtocol::NFC_V) {
+                    // ISO15693 tags need no selection: addressed commands carry the UID
+                    status = readSystemInfoV(_pendingTag);
+                } else {
+                    status = resolveTypeA(_pendingTag);
+                    if (status == NFCStatus::OK && _pendingTag.protocol == NFCProtocol::NFC_A && _pendingTag.sak == 0x00) {
+                        status = identifyModel(_pendingTag);
+                    }
+                }
+                if (status == NFCStatus::OK && supportsIsoDep(_pendingTag)) {
+                    status = activateIsoDep(_pendingTag);
+                }
+                enterState((status == NFCStatus::OK) ? DiscoveryState::CALLBACK : DiscoveryState::FIELD_OFF, 0);
+                break;
+
+            case DiscoveryState::CALLBACK:
+                // Commands use the driver default timeout while a tag is activated
+                _controller->SetNoResponseTimer(0);
+                _currentTag = _pendingTag;
+                _tagPresent = true;
+                _presenceFailures = 0;
+                SetActiveTag(_currentTag.uid);
+                // A tag that was lost only briefly is not reported again
+                if (recordSighting(_currentTag)) {
+                    _discoveryStats.tagsDiscovered++;
+                    recordLatency((now - _cycleStartTick) * portTICK_PERIOD_MS);
+                    if (_detectionCallback) {
+                        _detectionCallback(_currentTag);
+                    }
+                }
+                if (_currentTag.protocol == NFCProtocol::NFC_F || _currentTag.protocol == NFCProtocol::NFC_V) {
+                    // Further tags answered the same SENSF_REQ or INVENTORY
+                    reportPolledTags();
+                }
+                enterState(DiscoveryState::PRESENCE_CHECK, _discoveryConfig.presencePeriodMs);
+                break;
+
+            case DiscoveryState::PRESENCE_CHECK:
+                // Checks only the known tag: no anticollision or identification while it stays
+                if (CheckPresence() == NFCStatus::OK) {
+                    enterState(DiscoveryState::PRESENCE_CHECK, _discoveryConfig.presencePeriodMs);
+                }
+                break;
+
+            case DiscoveryState::FIELD_OFF: {
+                uint32_t onTimeMs = 0;
+                if (_discoveryConfig.fieldOffBetweenPolls && _controller->IsFieldOn()) {
+                    onTimeMs = (now - _fieldOnTick) * portTICK_PERIOD_MS;
+                    _discoveryStats.fieldOnTimeMs += onTimeMs;
+                    _controller->SetField(NFCField::OFF);
+                }
+                enterState(DiscoveryState::FIELD_ON, pollOffTimeMs(onTimeMs));
+                break;
+            }
+
+            case DiscoveryState::IDLE:
+            default:
+                break;
+        }
+
+        remaining = static_cast<int32_t>(_nextStepTick - xTaskGetTickCount());
+        return (remaining > 0) ? static_cast<uint32_t>(remaining) * portTICK_PERIOD_MS : 0;
+    }
+
+    const TechnologyStats& NFCManager::GetTechnologyStats(NFCProtocol technology) const
+    {
+        size_t index = static_cast<size_t>(technology);
+        return _technologyStats[(index < TECHNOLOGY_COUNT) ? index : 0];
+    }
+
+    void NFCManager::buildPollSequence(void)
+    {
+        std::vector<NFCProtocol> requested;
+        for (size_t index = 0; index < TECHNOLOGY_COUNT; ++index) {
+            // MIFARE Classic is polled as NFC-A
+            bool enabled = (_detectionProtocols & (1UL << index)) != 0;
+            if (index == static_cast<size_t>(NFCProtocol::NFC_A)) {
+                enabled = enabled || (_detectionProtocols & (1UL << static_cast<uint32_t>(NFCProtocol::MIFARE_CLASSIC))) != 0;
+            }
+            if (enabled) {
+                requested.push_back(static_cast<NFCProtocol>(index));
+            }
+        }
+
+        _pollSequence.clear();
+        uint32_t now = xTaskGetTickCount();
+        for (NFCProtocol technology : requested) {
+            // Backing off the only technology, or one that answered shortly before, would just
+            // add detection latency
+            TechnologyStats& stats = _technologyStats[static_cast<size_t>(technology)];
+            bool recentlySeen = stats.answers > 0 &&
+                                (now - stats.lastSeenTick) < pdMS_TO_TICKS(_discoveryConfig.activityHoldMs);
+            if (stats.skipRemaining > 0 && requested.size() > 1 && !recentlySeen) {
+                stats.skipRemaining--;
+                continue;
+            }
+            stats.skipRemaining = 0;
+            _pollSequence.push_back(technology);
+        }
+
+        // Most recently seen first, never seen last (in A, B, F, V order)
+        std::stable_sort(_pollSequence.begin(), _pollSequence.end(), [this](NFCProtocol a, NFCProtocol b) {
+            const TechnologyStats& statsA = _technologyStats[static_cast<size_t>(a)];
+            const TechnologyStats& statsB = _technologyStats[static_cast<size_t>(b)];
+            if ((statsA.answers > 0) != (statsB.answers > 0)) {
+                return statsA.answers > 0;
+            }
+            return (statsA.answers > 0) &&
+                   static_cast<int32_t>(statsA.lastSeenTick - statsB.lastSeenTick) > 0;
+        });
+    }
+
+    NFCStatus NFCManager::pollTechnology(NFCProtocol technology, TagInfo& tagInfo)
+    {
+        if (technology == NFCProtocol::NFC_A) {
+            // Inventory halts every tag it served: wake them again in the next cycle
+            return pollTypeA(tagInfo, _discoveryConfig.inventory);
+        }
+        if (technology == NFCProtocol::NFC_B) {
+            return pollTypeB(tagInfo);
+        }
+        if (technology == NFCProtocol::NFC_F) {
+            // The first card is activated, the others are reported alongside
+            NFCStatus status = pollTypeF(_polledTags);
+            if (status == NFCStatus::OK) {
+                tagInfo = _polledTags.front();
+            }
+            return status;
+        }
+        if (technology == NFCProtocol::NFC_V) {
+            return pollTypeV(tagInfo);
+        }
+        return NFCStatus::INVALID_PARAM;
+    }
+
+    uint32_t NFCManager::responseTimeUs(NFCProtocol technology) const
+    {
+        uint32_t responseUs = pollTiming[static_cast<size_t>(technology)].responseTimeUs;
+        if (technology == NFCProtocol::NFC_F && _felicaConfig.timeSlots > 1) {
+            // Every further time slot adds 1.2 ms
+            responseUs += (static_cast<uint32_t>(std::min<uint8_t>(_felicaConfig.timeSlots, 16)) - 1) * 1208;
+        }
+        return std::max(_discoveryConfig.responseTimeoutUs, responseUs);
+    }
+
+    void NFCManager::enterState(DiscoveryState state, uint32_t delayMs)
+    {
+        _discoveryState = state;
+        _nextStepTick = xTaskGetTickCount() + pdMS_TO_TICKS(delayMs);
+    }
+
+    uint32_t NFCManager::pollOffTimeMs(uint32_t onTimeMs) const
+    {
+        // Shortly after a tag answered or left: poll fast, the duty cycle limit is lifted
+        if (static_cast<int32_t>(_activityUntilTick - xTaskGetTickCount()) > 0) {
+            return _discoveryConfig.activePollPeriodMs;
+        }
+
+        // Off time so that on / (on + off) stays within the duty cycle, bounded for the latency
+        uint32_t offTimeMs = _discoveryConfig.pollPeriodMs;
+        uint8_t duty = _discoveryConfig.fieldDutyPercent;
+        if (_discoveryConfig.fieldOffBetweenPolls && duty > 0 && duty < 100) {
+            uint32_t dutyOffTimeMs = onTimeMs * (100 - duty) / duty;
+            offTimeMs = std::max(offTimeMs, std::min(dutyOffTimeMs, _discoveryConfig.maxPollPeriodMs));
+        }
+        return offTimeMs;
+    }
+
+    NFCStatus NFCManager::pollTypeF(std::vector<TagInfo>& cards)
+    {
+        cards.clear();
+
+        // SENSF_REQ: length, 0x00, system code, request code, TSN (time slots - 1)
+        uint8_t slots = std::max<uint8_t>(1, std::min<uint8_t>(_felicaConfig.timeSlots, 16));
+        std::vector<uint8_t> request = { 0x06, 0x00,
+                                         static_cast<uint8_t>(_felicaConfig.systemCode >> 8),
+                                         static_cast<uint8_t>(_felicaConfig.systemCode & 0xFF),
+                                         _felicaConfig.requestCode,
+                                         static_cast<uint8_t>(slots - 1) };
+
+        // Each card answers in a random time slot: receive until the slots are over
+        std::vector<uint8_t> response;
+        NFCStatus status = _controller->Transmit(request);
+        if (status == NFCStatus::OK) {
+            status = _controller->ReceiveSlot(response, 10);
+        }
+        bool corrupted = false;
+        for (uint8_t frame = 0; status != NFCStatus::TIMEOUT; ) {
+            // SENSF_RES: length, 0x01, IDm, PMm, request data (optional)
+            if (status == NFCStatus::OK && (response.size() == 18 || response.size() == 20) &&
+                response[0] == response.size() && response[1] == 0x01) {
+                TagInfo card{};
+                card.protocol = NFCProtocol::NFC_F;
+                card.uid.assign(response.begin() + 2, response.begin() + 10);
+                card.appData.assign(response.begin() + 10, response.begin() + 18);
+                card.protocolInfo.assign(response.begin() + 18, response.end());
+                card.isReadOnly = false;
+                card.dataSize = 0;
+                card.model = TagModel::UNKNOWN;
+                if (std::none_of(cards.begin(), cards.end(), [&card](const TagInfo& known) { return known.uid == card.uid; })) {
+                    cards.push_back(card);
+                }
+            } else {
+                // Two cards in the same slot
+                corrupted = true;
+            }
+
+            if (++frame >= slots) {
+                break;
+            }
+            status = _controller->ReceiveNext(response, 10);
+        }
+
+        if (!cards.empty()) {
+            return NFCStatus::OK;
+        }
+        return corrupted ? NFCStatus::COLLISION_ERROR : NFCStatus::TIMEOUT;
+    }
+
+    NFCStatus NFCManager::PollFelica(std::vector<TagInfo>& cards)
+    {
+        if (!_initialized) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+        if (!_controller->IsFieldOn()) {
+            return NFCStatus::ERROR;
+        }
+
+        NFCStatus status = NFCStatus::OK;
+        if (_controller->GetProtocol() != NFCProtocol::NFC_F) {
+            status = _controller->SetProtocol(NFCProtocol::NFC_F);
+        }
+        if (status == NFCStatus::OK) {
+            status = _controller->SetBitRate(_felicaConfig.bitRate);
+        }
+        if (status == NFCStatus::OK) {
+            status = _controller->SetNoResponseTimer(responseTimeUs(NFCProtocol::NFC_F));
+        }
+        if (status == NFCStatus::OK) {
+            status = pollTypeF(cards);
+        }
+
+        _controller->SetNoResponseTimer(0);
+        return status;
+    }
+
+    void NFCManager::reportPolledTags(void)
+    {
+        for (const TagInfo& tag : _polledTags) {
+            if (tag.uid != _currentTag.uid && recordSighting(tag)) {
+                _discoveryStats.tagsDiscovered++;
+                if (_detectionCallback) {
+                    _detectionCallback(tag);
+                }
+            }
+        }
+    }
+
+    NFCStatus NFCManager::pollTypeV(TagInfo& tagInfo, const std::vector<uint8_t>& uid)
+    {
+        tagInfo.protocol = NFCProtocol::NFC_V;
+        tagInfo.isReadOnly = false;
+
+        // INVENTORY: high data rate, 1 slot, mask length and mask (the UID LSB first)
+        std::vector<uint8_t> request = { 0x26, 0x01, static_cast<uint8_t>(uid.size() * 8) };
+        request.insert(request.end(), uid.rbegin(), uid.rend());
+
+        std::vector<uint8_t> response;
+        NFCStatus status = _controller->TransmitReceive(request, response, 10);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (!parseInventoryV(response, tagInfo) || (!uid.empty() && tagInfo.uid != uid)) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+        return NFCStatus::OK;
+    }
+
+    NFCStatus NFCManager::inventoryTypeV(std::vector<TagInfo>& tags)
+    {
+        tags.clear();
+
+        // Masks still to inventory (length in bits, value LSB first), starting without a mask
+        std::vector<std::pair<uint8_t, uint64_t>> masks = { { 0, 0 } };
+        bool corrupted = false;
+        for (size_t round = 0; round < MAX_VICINITY_ROUNDS && !masks.empty(); ++round) {
+            uint8_t maskLength = masks.back().first;
+            uint64_t mask = masks.back().second;
+            masks.pop_back();
+
+            // INVENTORY: high data rate, 16 slots; each tag answers in the slot given by
+            // the 4 UID bits following the mask
+            std::vector<uint8_t> request = { 0x06, 0x01, maskLength };
+            for (uint8_t i = 0; i < (maskLength + 7) / 8; ++i) {
+                request.push_back(static_cast<uint8_t>(mask >> (8 * i)));
+            }
+
+            std::vector<uint8_t> response;
+            NFCStatus status = _controller->Transmit(request);
+            if (status == NFCStatus::OK) {
+                status = _controller->ReceiveSlot(response, 10);
+            }
+            for (uint8_t slot = 0; slot < 16; ++slot) {
+                if (slot > 0) {
+                    status = _controller->NextInventorySlot(response, 10);
+                }
+
+                TagInfo tag{};
+                tag.protocol = NFCProtocol::NFC_V;
+                tag.isReadOnly = false;
+                if (status == NFCStatus::OK && parseInventoryV(response, tag)) {
+                    if (std::none_of(tags.begin(), tags.end(), [&tag](const TagInfo& known) { return known.uid == tag.uid; })) {
+                        tags.push_back(tag);
+                    }
+                } else if (status != NFCStatus::TIMEOUT) {
+                    // Several tags in this slot: split it with 4 more mask bits
+                    if (maskLength + 4 <= 60) {
+                        masks.push_back({ static_cast<uint8_t>(maskLength + 4), mask | (static_cast<uint64_t>(slot) << maskLength) });
+                    } else {
+                        corrupted = true;
+                    }
+                }
+            }
+        }
+
+        if (!tags.empty()) {
+            return NFCStatus::OK;
+        }
+        return (corrupted || !masks.empty()) ? NFCStatus::COLLISION_ERROR : NFCStatus::TIMEOUT;
+    }
+
+    bool NFCManager::parseInventoryV(const std::vector<uint8_t>& response, TagInfo& tagInfo)
+    {
+        // INVENTORY response: flags, DSFID, UID (LSB first)
+        if (response.size() != 10 || (response[0] & 0x01)) {
+            return false;
+        }
+        tagInfo.uid.assign(response.rbegin(), response.rbegin() + 8);
+        tagInfo.appData = { response[1] };
+        return true;
+    }
+
+    NFCStatus NFCManager::readSystemInfoV(TagInfo& tagInfo)
+    {
+        // GET SYSTEM INFORMATION, addressed: flags, 0x2B, UID (LSB first)
+        std::vector<uint8_t> request = { 0x22, 0x2B };
+        request.insert(request.end(), tagInfo.uid.rbegin(), tagInfo.uid.rend());
+
+        std::vector<uint8_t> response;
+        NFCStatus status = _controller->TransmitReceive(request, response, 10);
+        if (status == NFCStatus::TIMEOUT || (status == NFCStatus::OK && !response.empty() && (response[0] & 0x01))) {
+            // Optional command: the tag is usable without it
+            return NFCStatus::OK;
+        }
+        if (status != NFCStatus::OK || response.size() < 10) {
+            return (status != NFCStatus::OK) ? status : NFCStatus::COMMUNICATION_ERROR;
+        }
+
+        // Response: flags, info flags, UID, then DSFID, AFI, memory size, IC reference if flagged
+        uint8_t info = response[1];
+        size_t index = 10;
+        if (info & 0x01) {
+            tagInfo.appData = { response[index++] };
+        }
+        if (info & 0x02) {
+            index++;
+        }
+        if ((info & 0x04) && response.size() >= index + 2) {
+            uint16_t blocks = static_cast<uint16_t>(response[index] + 1);
+            tagInfo.blockSize = static_cast<uint8_t>((response[index + 1] & 0x1F) + 1);
+            tagInfo.dataSize = static_cast<uint16_t>(blocks * tagInfo.blockSize);
+            if (blocks < 256) {
+                return NFCStatus::OK;
+            }
+        }
+
+        // No memory size or 256 blocks: larger memories report their size with
+        // EXTENDED GET SYSTEM INFORMATION (DSFID and memory size requested)
+        request = { 0x22, 0x3B, 0x05 };
+        request.insert(request.end(), tagInfo.uid.rbegin(), tagInfo.uid.rend());
+        status = _controller->TransmitReceive(request, response, 10);
+        if (status == NFCStatus::TIMEOUT || (status == NFCStatus::OK && !response.empty() && (response[0] & 0x01))) {
+            return NFCStatus::OK;
+        }
+        if (status != NFCStatus::OK || response.size() < 10) {
+            return (status != NFCStatus::OK) ? status : NFCStatus::COMMUNICATION_ERROR;
+        }
+
+        // Response: flags, info flags, UID, DSFID, memory size (blocks - 1 LSB first, block size - 1)
+        info = response[1];
+        index = 10;
+        if (info & 0x01) {
+            tagInfo.appData = { response[index++] };
+        }
+        if ((info & 0x04) && response.size() >= index + 3) {
+            uint32_t blocks = static_cast<uint32_t>(response[index] | (response[index + 1] << 8)) + 1;
+            tagInfo.blockSize = static_cast<uint8_t>(response[index + 2] + 1);
+            tagInfo.dataSize = static_cast<uint16_t>(std::min<uint32_t>(blocks * tagInfo.blockSize, 0xFFFF));
+        }
+        return NFCStatus::OK;
+    }
+
+    NFCStatus NFCManager::PollVicinity(std::vector<TagInfo>& tags)
+    {
+        if (!_initialized) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+        if (!_controller->IsFieldOn()) {
+            return NFCStatus::ERROR;
+        }
+
+        NFCStatus status = NFCStatus::OK;
+        if (_controller->GetProtocol() != NFCProtocol::NFC_V) {
+            status = _controller->SetProtocol(NFCProtocol::NFC_V);
+        }
+        if (status == NFCStatus::OK) {
+            status = _controller->SetNoResponseTimer(responseTimeUs(NFCProtocol::NFC_V));
+        }
+        if (status == NFCStatus::OK) {
+            status = inventoryTypeV(tags);
+        }
+        // TIMEOUT: no tag answered
+        if (status == NFCStatus::OK || status == NFCStatus::TIMEOUT) {
+            _memoryCache->Retain(NFCProtocol::NFC_V, tags);
+        }
+
+        _controller->SetNoResponseTimer(0);
+        return status;
+    }
+
+    NFCStatus NFCManager::pollTypeA(TagInfo& tagInfo, bool wakeUp)
+    {
+        // REQA/WUPA are 7-bit short frames sent by dedicated direct commands
+        NFCStatus status = _controller->ClearFifo();
+        if (status == NFCStatus::OK) {
+            status = _controller->ExecuteCommand(wakeUp ? ::ST25R3911B::CMD_TRANSMIT_WUPA : ::ST25R3911B::CMD_TRANSMIT_REQA);
+        }
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        std::vector<uint8_t> atqa;
+        status = _controller->Receive(atqa, 10);
+        if (status != NFCStatus::OK && status != NFCStatus::COLLISION_ERROR) {
+            return status;
+        }
+
+        if (status == NFCStatus::OK) {
+            identifyTag(atqa, tagInfo);
+        } else {
+            tagInfo.protocol = NFCProtocol::NFC_A;
+        }
+        return status;
+    }
+
+    NFCStatus NFCManager::haltTypeA(void)
+    {
+        // A halted tag does not answer: the no-response timer ends the exchange
+        std::vector<uint8_t> activeUid;
+        activeUid.swap(_activeUid);
+
+        std::vector<uint8_t> response;
+        NFCStatus status = _controller->TransmitReceive({ 0x50, 0x00 }, response, 10);
+
+        _activeUid.swap(activeUid);
+        return (status == NFCStatus::TIMEOUT) ? NFCStatus::OK : NFCStatus::COMMUNICATION_ERROR;
+    }
+
+    NFCStatus NFCManager::reactivateTypeA(const TagInfo& tagInfo)
+    {
+        // HLTA (no answer if the tag is still selected), WUPA, SELECT. An ISO-DEP tag ignores
+        // HLTA once activated: S(DESELECT) halts it instead. A MIFARE Classic session ends here.
+        _mifareClassic->Reset();
+        if (supportsIsoDep(tagInfo)) {
+            std::vector<uint8_t> response;
+            _controller->TransmitReceive({ 0xC2 }, response, 10);
+        } else {
+            haltTypeA();
+        }
+
+        NFCStatus status = _controller->ClearFifo();
+        if (status == NFCStatus::OK) {
+            status = _controller->ExecuteCommand(::ST25R3911B::CMD_TRANSMIT_WUPA);
+        }
+
+        std::vector<uint8_t> atqa;
+        if (status == NFCStatus::OK) {
+            status = _controller->Receive(atqa, 10);
+        }
+        if (status == NFCStatus::OK) {
+            uint8_t sak;
+            status = _tagReader->Select(tagInfo.uid, sak);
+        }
+        return status;
+    }
+
+    NFCStatus NFCManager::pollTypeB(TagInfo& tagInfo, bool wakeUp, uint8_t slotExponent)
+    {
+        // REQB/WUPB: APf, AFI 0x00 (all families), PARAM (WUPB flag, N = 2^slotExponent slots)
+        uint8_t param = static_cast<uint8_t>((wakeUp ? 0x08 : 0x00) | (slotExponent & 0x07));
+        std::vector<uint8_t> atqb;
+        NFCStatus status = _controller->TransmitReceive({ 0x05, 0x00, param }, atqb, 10);
+        return parseAtqb(status, atqb, tagInfo);
+    }
+
+    NFCStatus NFCManager::parseAtqb(NFCStatus status, const std::vector<uint8_t>& atqb, TagInfo& tagInfo)
+    {
+        tagInfo.protocol = NFCProtocol::NFC_B;
+
+        // Type B has no bit collision detection: overlapping ATQBs end in a CRC or framing error
+        if (status == NFCStatus::CRC_ERROR || status == NFCStatus::FRAMING_ERROR ||
+            status == NFCStatus::SOFT_FRAMING_ERROR || status == NFCStatus::COLLISION_ERROR) {
+            return NFCStatus::COLLISION_ERROR;
+        }
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        // ATQB: 0x50, PUPI, application data, protocol info (3 bytes, 4 in the extended ATQB)
+        if ((atqb.size() != 12 && atqb.size() != 13) || atqb[0] != 0x50) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+        tagInfo.pupi.assign(atqb.begin() + 1, atqb.begin() + 5);
+        tagInfo.appData.assign(atqb.begin() + 5, atqb.begin() + 9);
+        tagInfo.protocolInfo.assign(atqb.begin() + 9, atqb.end());
+        tagInfo.uid = tagInfo.pupi;
+        tagInfo.isReadOnly = false;
+        tagInfo.dataSize = 0;
+        tagInfo.model = TagModel::UNKNOWN;
+        return NFCStatus::OK;
+    }
+
+    NFCStatus NFCManager::resolveTypeB(TagInfo& tagInfo, const std::vector<uint8_t>& pupi)
+    {
+        // A single ATQB in the poll: nothing to resolve
+        if (pupi.empty() && !tagInfo.pupi.empty()) {
+            return NFCStatus::OK;
+        }
+
+        // Each tag answers in a random slot: take the first slot with a single (matching) ATQB.
+        // A halted tag is searched for with WUPB.
+        for (uint8_t slotExponent = 2; slotExponent <= 4; ++slotExponent) {
+            uint8_t slots = static_cast<uint8_t>(1 << slotExponent);
+            bool collided = false;
+
+            for (uint8_t slot = 1; slot <= slots; ++slot) {
+                TagInfo candidate{};
+                NFCStatus status;
+                if (slot == 1) {
+                    status = pollTypeB(candidate, !pupi.empty(), slotExponent);
+                } else {
+                    // Slot-MARKER: APn = (slot - 1) << 4 | 0x05
+                    std::vector<uint8_t> atqb;
+                    status = _controller->Transmit({ static_cast<uint8_t>(((slot - 1) << 4) | 0x05) });
+                    if (status == NFCStatus::OK) {
+                        status = _controller->ReceiveSlot(atqb, 10);
+                    }
+                    status = parseAtqb(status, atqb, candidate);
+                }
+
+                if (status == NFCStatus::OK && (pupi.empty() || candidate.pupi == pupi)) {
+                    tagInfo = candidate;
+                    return NFCStatus::OK;
+                }
+                collided = collided || (status != NFCStatus::OK && status != NFCStatus::TIMEOUT);
+            }
+
+            // No collision left: the tag is not in the field
+            if (!collided) {
+                return NFCStatus::NO_TAG_FOUND;
+            }
+        }
+        return NFCStatus::COLLISION_ERROR;
+    }
+
+    NFCStatus NFCManager::activateTypeB(const TagInfo& tagInfo)
+    {
+        if (tagInfo.pupi.size() != 4) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        // Protocol type (low nibble of protocol info byte 2) and FWI (high nibble of byte 3, 15 is RFU)
+        uint8_t protocolType = (tagInfo.protocolInfo.size() > 1) ? (tagInfo.protocolInfo[1] & 0x0F) : 0x00;
+        uint8_t fwi = (tagInfo.protocolInfo.size() > 2) ? (tagInfo.protocolInfo[2] >> 4) : 4;
+        if (fwi == 15) {
+            fwi = 4;
+        }
+
+        // ATTRIB: PUPI, Param 1 (default TR0/TR1, SOF and EOF), Param 2 (106 kbps, FSD 256),
+        // Param 3 (confirmed protocol type), Param 4 (CID 0)
+        std::vector<uint8_t> attrib = { 0x1D };
+        attrib.insert(attrib.end(), tagInfo.pupi.begin(), tagInfo.pupi.end());
+        attrib.insert(attrib.end(), { 0x00, 0x08, protocolType, 0x00 });
+
+        // The answer comes within the frame waiting time FWT = 302 us * 2^FWI
+        uint32_t fwtUs = 302UL << fwi;
+        NFCStatus status = _controller->SetNoResponseTimer(std::max(_discoveryConfig.responseTimeoutUs, fwtUs));
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        std::vector<uint8_t> response;
+        status = _controller->TransmitReceive(attrib, response, fwtUs / 1000 + 10);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        // Answer to ATTRIB: MBLI and the CID that was assigned
+        return (!response.empty() && (response[0] & 0x0F) == 0x00) ? NFCStatus::OK : NFCStatus::COMMUNICATION_ERROR;
+    }
+
+    NFCStatus NFCManager::reactivateTypeB(const TagInfo& tagInfo)
+    {
+        // S(DESELECT) halts an ISO-DEP tag (no answer if it is no longer selected)
+        if (tagInfo.protocolInfo.size() > 1 && (tagInfo.protocolInfo[1] & 0x01)) {
+            std::vector<uint8_t> response;
+            _controller->TransmitReceive({ 0xC2 }, response, 10);
+        }
+
+        // WUPB wakes it again, the PUPI tells if it is still the same tag
+        TagInfo woken{};
+        NFCStatus status = pollTypeB(woken, true);
+        if (status == NFCStatus::COLLISION_ERROR || (status == NFCStatus::OK && woken.pupi != tagInfo.pupi)) {
+            // Other tags in the field answer WUPB as well
+            woken = TagInfo{};
+            status = resolveTypeB(woken, tagInfo.pupi);
+        }
+        if (status == NFCStatus::OK) {
+            status = activateTypeB(woken);
+        }
+        return status;
+    }
+
+    NFCStatus NFCManager::activateIsoDep(TagInfo& tagInfo)
+    {
+        if (tagInfo.protocol == NFCProtocol::NFC_B) {
+            // ATTRIB already negotiated the frame sizes
+            return _isoDep->ActivateB(tagInfo);
+        }
+        return _isoDep->ActivateA(tagInfo.protocolInfo);
+    }
+
+    NFCStatus NFCManager::identifyModel(TagInfo& tagInfo)
+    {
+        // Known tag: no RF exchange
+        for (TagModelInfo& entry : _modelCache) {
+            if (entry.uid == tagInfo.uid) {
+                entry.lastUse = ++_modelSequence;
+                tagInfo.model = entry.model;
+                if (entry.userSize) {
+                    tagInfo.dataSize = entry.userSize;
+                }
+                return NFCStatus::OK;
+            }
+        }
+
+        TagModelInfo info{};
+        info.uid = tagInfo.uid;
+
+        NFCStatus status = _controller->TransmitReceive({ 0x60 }, info.version, 10);
+        if (status == NFCStatus::OK && info.version.size() == 8) {
+            if (info.version[1] == 0x04) {
+                for (const Type2Product& product : type2Products) {
+                    if (product.productType == info.version[2] && product.storageSize == info.version[6]) {
+                        info.model = product.model;
+                        info.pageCount = product.pageCount;
+                        info.userSize = product.userSize;
+                        break;
+                    }
+                }
+
+                // Originality signature (EV1 and NTAG21x)
+                status = _controller->TransmitReceive({ 0x3C, 0x00 }, info.signature, 10);
+                if (status != NFCStatus::OK || info.signature.size() != 32) {
+                    info.signature.clear();
+                    status = reactivateTypeA(tagInfo);
+                }
+            }
+        } else {
+            // No GET_VERSION (Ultralight, Ultralight C): the NAK or timeout left the tag IDLE
+            info.version.clear();
+            info.model = TagModel::ULTRALIGHT;
+            info.pageCount = 16;
+            info.userSize = 48;
+            status = reactivateTypeA(tagInfo);
+        }
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        tagInfo.model = info.model;
+        if (info.userSize) {
+            tagInfo.dataSize = info.userSize;
+        }
+
+        // Keep the result, replace the least recently used entry if full
+        info.lastUse = ++_modelSequence;
+        if (_modelCache.size() < MAX_MODEL_ENTRIES) {
+            _modelCache.push_back(info);
+        } else {
+            *std::min_element(_modelCache.begin(), _modelCache.end(),
+                [](const TagModelInfo& a, const TagModelInfo& b) { return a.lastUse < b.lastUse; }) = info;
+        }
+        return NFCStatus::OK;
+    }
+
+    bool NFCManager::GetTagModel(const std::vector<uint8_t>& uid, TagModelInfo& info) const
+    {
+        for (const TagModelInfo& entry : _modelCache) {
+            if (entry.uid == uid) {
+                info = entry;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    NFCStatus NFCManager::RunInventory(std::vector<TagInfo>& tags, TagDetectionCallback session)
+    {
+        if (!_initialized) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+        if (!_controller->IsFieldOn()) {
+            return NFCStatus::ERROR;
+        }
+
+        NFCStatus status = NFCStatus::OK;
+        if (_controller->GetProtocol() != NFCProtocol::NFC_A) {
+            status = _controller->SetProtocol(NFCProtocol::NFC_A);
+        }
+        if (status == NFCStatus::OK) {
+            status = _controller->SetNoResponseTimer(responseTimeUs(NFCProtocol::NFC_A));
+        }
+        if (status == NFCStatus::OK) {
+            status = runInventory(tags, session, false);
+        }
+        if (status == NFCStatus::OK) {
+            _memoryCache->Retain(NFCProtocol::NFC_A, tags);
+        }
+
+        _controller->SetNoResponseTimer(0);
+        return status;
+    }
+
+    NFCStatus NFCManager::runInventory(std::vector<TagInfo>& tags, TagDetectionCallback session, bool tagsReady)
+    {
+        uint32_t startTick = xTaskGetTickCount();
+        NFCStatus status = NFCStatus::OK;
+        tags.clear();
+
+        // WUPA once to include halted tags, then REQA: halted tags stay silent
+        bool wakeUp = true;
+        uint16_t attempts = static_cast<uint16_t>(_discoveryConfig.maxInventoryTags) * 2;
+        while (tags.size() < _discoveryConfig.maxInventoryTags && attempts-- > 0) {
+            TagInfo tag{};
+            if (!tagsReady) {
+                status = pollTypeA(tag, wakeUp);
+                wakeUp = false;
+                if (status == NFCStatus::TIMEOUT) {
+                    // No tag left
+                    status = NFCStatus::OK;
+                    break;
+                }
+                if (status != NFCStatus::OK && status != NFCStatus::COLLISION_ERROR) {
+                    break;
+                }
+            } else {
+                tag = _pendingTag;
+                tagsReady = false;
+                wakeUp = false;
+            }
+
+            status = _tagReader->Anticollision(tag);
+            if (status == NFCStatus::OK &&
+                std::any_of(tags.begin(), tags.end(), [&tag](const TagInfo& known) { return known.uid == tag.uid; })) {
+                // Woken again by the WUPA of a re-activation: served already, halt it again
+                status = haltTypeA();
+                if (status != NFCStatus::OK) {
+                    break;
+                }
+                continue;
+            }
+            if (status == NFCStatus::OK) {
+                status = resolveTypeA(tag);
+            }
+            if (status == NFCStatus::OK && tag.protocol == NFCProtocol::NFC_A && tag.sak == 0x00) {
+                status = identifyModel(tag);
+            }
+            if (status != NFCStatus::OK) {
+                break;
+            }
+
+            SetActiveTag(tag.uid);
+            if (session) {
+                session(tag);
+            }
+            tags.push_back(tag);
+
+            status = haltTypeA();
+            SetActiveTag({});
+            if (status != NFCStatus::OK) {
+                break;
+            }
+        }
+
+        // Throughput of this cycle
+        uint32_t elapsedMs = (xTaskGetTickCount() - startTick) * portTICK_PERIOD_MS;
+        _inventoryStats.cycles++;
+        _inventoryStats.tagsIdentified += static_cast<uint32_t>(tags.size());
+        _inventoryStats.lastCycleTags = static_cast<uint32_t>(tags.size());
+        _inventoryStats.lastCycleMs = elapsedMs;
+        _inventoryStats.tagsPerSecond = static_cast<uint32_t>(tags.size() * 1000 / std::max<uint32_t>(elapsedMs, 1));
+
+        return status;
+    }
+
+    NFCStatus NFCManager::resolveTypeA(TagInfo& tagInfo)
+    {
+        // Cascade bit still set: the UID is not complete
+        if (tagInfo.sak & 0x04) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+
+        // SAK coding per NXP AN10833, it overrides the guess made from the ATQA
+        switch (tagInfo.sak) {
+            case 0x09:
+                tagInfo.protocol = NFCProtocol::MIFARE_CLASSIC;
+                tagInfo.dataSize = 320;     // MIFARE Mini
+                break;
+            case 0x01:
+            case 0x08:
+            case 0x28:
+                tagInfo.protocol = NFCProtocol::MIFARE_CLASSIC;
+                tagInfo.dataSize = 1024;    // MIFARE Classic 1K
+                break;
+            case 0x10:
+                tagInfo.protocol = NFCProtocol::MIFARE_CLASSIC;
+                tagInfo.dataSize = 2048;    // MIFARE Plus 2K (SL2)
+                break;
+            case 0x11:
+            case 0x18:
+            case 0x38:
+                tagInfo.protocol = NFCProtocol::MIFARE_CLASSIC;
+                tagInfo.dataSize = 4096;    // MIFARE Classic 4K
+                break;
+            default:
+                // Type 2 (SAK 0x00) or ISO-DEP (bit 6) tag, NFC-DEP (bit 7) target
+                tagInfo.protocol = (tagInfo.sak & 0x40) ? NFCProtocol::NFC_P2P : NFCProtocol::NFC_A;
+                break;
+        }
+        return NFCStatus::OK;
+    }
+
+    NFCStatus NFCManager::CheckPresence(void)
+    {
+        if (!_initialized || !_tagPresent) {
+            return NFCStatus::NO_TAG_FOUND;
+        }
+
+        _discoveryStats.presenceChecks++;
+        NFCStatus status = checkPresence(false);
+        for (_presenceFailures = 0; status != NFCStatus::OK && _presenceFailures < _discoveryConfig.presenceRetries; ++_presenceFailures) {
+            // A failed exchange leaves the tag IDLE: re-activate instead of repeating the check
+            status = checkPresence(true);
+        }
+
+        if (status != NFCStatus::OK) {
+            removeCurrentTag();
+            return NFCStatus::NO_TAG_FOUND;
+        }
+
+        recordSighting(_currentTag);
+        return NFCStatus::OK;
+    }
+
+    NFCStatus NFCManager::checkPresence(bool reactivate)
+    {
+        NFCProtocol technology = (_currentTag.protocol == NFCProtocol::MIFARE_CLASSIC) ? NFCProtocol::NFC_A : _currentTag.protocol;
+        _controller->SetNoResponseTimer(responseTimeUs(technology));
+
+        NFCStatus status;
+        std::vector<uint8_t> response;
+
+        if (!reactivate && _isoDep->IsActive()) {
+            // ISO-DEP: R(NAK) is answered with R(ACK) within the frame waiting time, the tag stays activated
+            _controller->SetNoResponseTimer(std::max(responseTimeUs(technology), _isoDep->GetFrameWaitingTimeUs()));
+            status = _isoDep->CheckPresence();
+        } else if (technology == NFCProtocol::NFC_B) {
+            // A tag selected by ATTRIB no longer answers REQB
+            _isoDep->Reset();
+            status = reactivateTypeB(_currentTag);
+            if (status == NFCStatus::OK && supportsIsoDep(_currentTag)) {
+                status = activateIsoDep(_currentTag);
+            }
+        } else if (technology == NFCProtocol::NFC_F) {
+            // All cards answer the same SENSF_REQ: look for the activated one among them
+            TagInfo tagInfo;
+            status = pollTechnology(technology, tagInfo);
+            if (status == NFCStatus::OK &&
+                std::none_of(_polledTags.begin(), _polledTags.end(), [this](const TagInfo& card) { return card.uid == _currentTag.uid; })) {
+                status = NFCStatus::NO_TAG_FOUND;
+            }
+            if (status == NFCStatus::OK && _uidCacheConfig.enabled) {
+                reportPolledTags();
+            }
+        } else if (technology == NFCProtocol::NFC_V) {
+            // INVENTORY masked with the complete UID: only the activated tag answers, in a single
+            // slot. The other tags in the UID cache are refreshed by the poll cycles.
+            TagInfo tagInfo{};
+            status = pollTypeV(tagInfo, _currentTag.uid);
+        } else if (!reactivate && _currentTag.protocol == NFCProtocol::NFC_A && _currentTag.sak == 0x00) {
+            // Type 2: READ page 0 (UID0-2, BCC0) keeps the tag selected and detects a swapped tag
+            status = _controller->TransmitReceive({ 0x30, 0x00 }, response, 10);
+            if (status == NFCStatus::OK &&
+                (response.size() != 16 ||
+                 (_currentTag.uid.size() == 7 && !std::equal(_currentTag.uid.begin(), _currentTag.uid.begin() + 3, response.begin())))) {
+                status = NFCStatus::NO_TAG_FOUND;
+            }
+        } else {
+            _isoDep->Reset();
+            status = reactivateTypeA(_currentTag);
+            if (status == NFCStatus::OK && supportsIsoDep(_currentTag)) {
+                status = activateIsoDep(_currentTag);
+            }
+        }
+
+        _controller->SetNoResponseTimer(0);
+        return status;
+    }
+
+    void NFCManager::removeCurrentTag(void)
+    {
+        _tagPresent = false;
+        _activityUntilTick = xTaskGetTickCount() + pdMS_TO_TICKS(_discoveryConfig.activityHoldMs);
+        _activeUid.clear();
+        _isoDep->Reset();
+        _mifareClassic->Reset();
+        _memoryCache->Remove(_currentTag.uid);
+        // With de-duplication the removal is reported when the cache entry expires
+        if (!_uidCacheConfig.enabled) {
+            _discoveryStats.tagsRemoved++;
+            if (_removalCallback) {
+                _removalCallback(_currentTag);
+            }
+        }
+
+        // Resume polling for the next tag
+        if (_detectionActive) {
+            enterState(DiscoveryState::FIELD_OFF, 0);
+        }
+    }
+
+    bool NFCManager::recordSighting(const TagInfo& tag)
+    {
+        if (!_uidCacheConfig.enabled) {
+            return true;
+        }
+
+        uint32_t now = xTaskGetTickCount();
+        for (UidCacheEntry& entry : _uidCache) {
+            if (entry.tag.uid == tag.uid) {
+                entry.lastSeenTick = now;
+                entry.sightings++;
+                return false;
+            }
+        }
+
+        if (_uidCache.size() >= MAX_UID_CACHE_ENTRIES) {
+            // Evict the least recently seen tag, it is reported as removed
+            auto oldest = std::min_element(_uidCache.begin(), _uidCache.end(),
+                [now](const UidCacheEntry& a, const UidCacheEntry& b) { return (now - a.lastSeenTick) > (now - b.lastSeenTick); });
+            TagInfo evicted = oldest->tag;
+            _uidCache.erase(oldest);
+            _discoveryStats.tagsRemoved++;
+            if (_removalCallback) {
+                _removalCallback(evicted);
+            }
+        }
+
+        _uidCache.push_back(UidCacheEntry{ tag, now, now, 1 });
+        return true;
+    }
+
+    void NFCManager::expireSightings(uint32_t now)
+    {
+        uint32_t ttlTicks = pdMS_TO_TICKS(_uidCacheConfig.ttlMs);
+
+        for (size_t i = 0; i < _uidCache.size(); ) {
+            UidCacheEntry& entry = _uidCache[i];
+            // The activated tag is kept alive by the presence check
+            bool active = _tagPresent && entry.tag.uid == _currentTag.uid;
+            if (active || (now - entry.lastSeenTick) < ttlTicks) {
+                ++i;
+                continue;
+            }
+
+            TagInfo removed = entry.tag;
+            _uidCache.erase(_uidCache.begin() + i);
+            _discoveryStats.tagsRemoved++;
+            if (_removalCallback) {
+                _removalCallback(removed);
+            }
+        }
+    }
+
+    void NFCManager::recordLatency(uint32_t latencyMs)
+    {
+        _discoveryStats.lastLatencyMs = latencyMs;
+        if (_discoveryStats.tagsDiscovered == 1 || latencyMs < _discoveryStats.minLatencyMs) {
+            _discoveryStats.minLatencyMs = latencyMs;
+        }
+        if (latencyMs > _discoveryStats.maxLatencyMs) {
+            _discoveryStats.maxLatencyMs = latencyMs;
+        }
+    }
+
+    NFCStatus NFCManager::identifyTag(const std::vector<uint8_t>& response, TagInfo& tagInfo)
+    {
+        if (response.size() < 2) {
+            return NFCStatus::ERROR;
+        }
+
+        // Initialize tag info
+        tagInfo.protocol = NFCProtocol::NFC_A;
+        tagInfo.atqa = response;
+        tagInfo.isReadOnly = false;
+        tagInfo.model = TagModel::UNKNOWN;
+
+        // Determine tag type based on ATQA
+        uint16_t atqa = (response[1] << 8) | response[0];
+        
+        switch (atqa) {
+            case 0x0004:
+                tagInfo.protocol = NFCProtocol::MIFARE_CLASSIC;
+                tagInfo.dataSize = 1024; // MIFARE Classic 1K
+                break;
+            case 0x0044:
+                tagInfo.protocol = NFCProtocol::NFC_A;
+                tagInfo.dataSize = 0;    // Type 2: resolved with GET_VERSION
+                break;
+            default:
+                tagInfo.protocol = NFCProtocol::NFC_A;
+                tagInfo.dataSize = 0;    // Unknown
+                break;
+        }
+
+        return NFCStatus::OK;
+    }
+
+    bool NFCManager::GetSignalStats(const std::vector<uint8_t>& uid, SignalStats& stats) const
+    {
+        for (const SignalStats& entry : _signalStats) {
+            if (entry.uid == uid) {
+                stats = entry;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void NFCManager::handleSignalQuality(const SignalQuality& quality)
+    {
+        if (_activeUid.empty()) {
+            return;
+        }
+
+        // Find the entry of the active tag, replace the least recently updated one if full
+        SignalStats* stats = nullptr;
+        for (SignalStats& entry : _signalStats) {
+            if (entry.uid == _activeUid) {
+                stats = &entry;
+                break;
+            }
+        }
+
+        if (!stats) {
+            if (_signalStats.size() < MAX_SIGNAL_ENTRIES) {
+                _signalStats.emplace_back();
+                stats = &_signalStats.back();
+            } else {
+                stats = &*std::min_element(_signalStats.begin(), _signalStats.end(),
+                    [](const SignalStats& a, const SignalStats& b) { return a.lastUpdate < b.lastUpdate; });
+            }
+            *stats = SignalStats{};
+            stats->uid = _activeUid;
+        }
+
+        if (quality.received) {
+            uint8_t rssi = std::max(quality.rssiAm, quality.rssiPm);
+
+            // A run of lost frames means the coupling changed: restart the average
+            if (stats->frames == 0 || stats->consecutiveLost >= _signalPolicy.lostLimit) {
+                stats->averageRssi = static_cast<uint16_t>(rssi << 4);
+            } else {
+                // Moving average with weight 1/4 for the new sample
+                int32_t delta = (static_cast<int32_t>(rssi) << 4) - stats->averageRssi;
+                stats->averageRssi = static_cast<uint16_t>(stats->averageRssi + delta / 4);
+            }
+
+            if (stats->frames == 0) {
+                stats->minRssi = rssi;
+                stats->maxRssi = rssi;
+            } else {
+                stats->minRssi = std::min(stats->minRssi, rssi);
+                stats->maxRssi = std::max(stats->maxRssi, rssi);
+            }
+            stats->frames++;
+            if (rssi < _signalPolicy.weakRssi) {
+                stats->weakFrames++;
+            }
+            stats->lastRssi = rssi;
+            stats->lastGainReduction = std::max(quality.gainReductionAm, quality.gainReductionPm);
+            stats->consecutiveLost = 0;
+        } else {
+            // Lost frames carry no RSSI: counted apart, they do not enter the average
+            stats->lostFrames++;
+            stats->consecutiveLost++;
+        }
+        stats->lastUpdate = ++_signalSequence;
+
+        updateReceiverGain(*stats);
+    }
+
+    void NFCManager::updateReceiverGain(const SignalStats& stats)
+    {
+        if (!_signalPolicy.adaptiveGain || stats.frames + stats.lostFrames < _signalPolicy.minFrames) {
+            return;
+        }
+
+        uint8_t average = static_cast<uint8_t>(stats.averageRssi >> 4);
+        bool lost = stats.consecutiveLost >= _signalPolicy.lostLimit;
+
+        if (!_controller->IsReceiverBoosted() && (average < _signalPolicy.weakRssi || lost)) {
+            _controller->SetReceiverBoost(true);
+        } else if (_controller->IsReceiverBoosted() && average >= _signalPolicy.strongRssi) {
+            _controller->SetReceiverBoost(false);
+        }
+    }
+
+    // ============================================================================
+    // TagReader Implementation
+    // ============================================================================
+
+    TagReader::TagReader(ST25R3911B* controller, IsoDep* isoDep, TagMemoryCache* memoryCache, MifareClassic* mifareClassic)
+        : _controller(controller)
+        , _isoDep(isoDep)
+        , _memoryCache(memoryCache)
+        , _mifareClassic(mifareClassic)
+        , _callback(nullptr)
+        , _vicinityBlocksPerRead(1)
+    {
+    }
+
+    NFCStatus TagReader::ReadUID(const TagInfo& tagInfo, std::vector<uint8_t>& uid)
+    {
+        TagInfo resolved = tagInfo;
+        NFCStatus status = Anticollision(resolved);
+        if (status == NFCStatus::OK) {
+            uid = resolved.uid;
+        }
+        return status;
+    }
+
+    NFCStatus TagReader::Anticollision(TagInfo& tagInfo)
+    {
+        if (!_controller || !_controller->IsInitialized()) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+
+        static const uint8_t selCodes[3] = { 0x93, 0x95, 0x97 };
+        std::vector<uint8_t> uid;
+
+        for (uint8_t level = 0; level < 3; ++level) {
+            uint8_t cl[5] = { 0 };
+            NFCStatus status = resolveCascadeLevel(selCodes[level], cl);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            uint8_t sak;
+            status = selectCascadeLevel(selCodes[level], cl, sak);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            if (sak & 0x04) {
+                // UID not complete: cascade tag followed by 3 UID bytes
+                if (cl[0] != 0x88) {
+                    return NFCStatus::COMMUNICATION_ERROR;
+                }
+                uid.insert(uid.end(), cl + 1, cl + 4);
+                continue;
+            }
+
+            uid.insert(uid.end(), cl, cl + 4);
+            tagInfo.uid = uid;
+            tagInfo.sak = sak;
+            return NFCStatus::OK;
+        }
+
+        // Cascade bit set after the third level
+        return NFCStatus::COMMUNICATION_ERROR;
+    }
+
+    NFCStatus TagReader::Select(const std::vector<uint8_t>& uid, uint8_t& sak)
+    {
+        if (!_controller || !_controller->IsInitialized()) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+        if (uid.size() != 4 && uid.size() != 7 && uid.size() != 10) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        static const uint8_t selCodes[3] = { 0x93, 0x95, 0x97 };
+        uint8_t levels = static_cast<uint8_t>((uid.size() - 1) / 3);
+
+        for (uint8_t level = 0; level < levels; ++level) {
+            uint8_t cl[5];
+            size_t offset = static_cast<size_t>(level) * 3;
+            if (level + 1 < levels) {
+                cl[0] = 0x88;
+                std::copy(uid.begin() + offset, uid.begin() + offset + 3, cl + 1);
+            } else {
+                std::copy(uid.begin() + offset, uid.begin() + offset + 4, cl);
+            }
+            cl[4] = cl[0] ^ cl[1] ^ cl[2] ^ cl[3];
+
+            NFCStatus status = selectCascadeLevel(selCodes[level], cl, sak);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            // The cascade bit must be set exactly on the incomplete levels
+            if (((sak & 0x04) != 0) != (level + 1 < levels)) {
+                return NFCStatus::COMMUNICATION_ERROR;
+            }
+        }
+
+        return NFCStatus::OK;
+    }
+
+    NFCStatus TagReader::resolveCascadeLevel(uint8_t selCode, uint8_t cl[5])
+    {
+        // Valid bits of the cascade level known to the reader; each collision adds at least one
+        uint8_t knownBits = 0;
+
+        while (knownBits < 32) {
+            uint8_t knownBytes = knownBits / 8;
+            uint8_t splitBits = knownBits % 8;
+
+            // ANTICOLLISION: NVB = number of valid bytes (high nibble) and bits (low nibble)
+            std::vector<uint8_t> request = { selCode, static_cast<uint8_t>(((2 + knownBytes) << 4) | splitBits) };
+            request.insert(request.end(), cl, cl + knownBytes + (splitBits ? 1 : 0));
+            if (splitBits) {
+                request.back() &= static_cast<uint8_t>((1 << splitBits) - 1);
+            }
+
+            std::vector<uint8_t> response;
+            uint16_t collisionBit = 0;
+            NFCStatus status = _controller->TransceiveAnticollision(request, splitBits, response, collisionBit, 10);
+            if (status != NFCStatus::OK && status != NFCStatus::COLLISION_ERROR) {
+                return status;
+            }
+            if (response.empty() || response.size() > static_cast<size_t>(5 - knownBytes)) {
+                return NFCStatus::COMMUNICATION_ERROR;
+            }
+
+            // Merge the answer, the split byte keeps the bits sent by the reader
+            uint8_t splitMask = static_cast<uint8_t>((1 << splitBits) - 1);
+            for (size_t i = 0; i < response.size(); ++i) {
+                uint8_t value = response[i];
+                if (i == 0) {
+                    value = static_cast<uint8_t>((cl[knownBytes] & splitMask) | (value & ~splitMask));
+                }
+                cl[knownBytes + i] = value;
+            }
+
+            if (status == NFCStatus::OK) {
+                if (response.size() != static_cast<size_t>(5 - knownBytes)) {
+                    return NFCStatus::COMMUNICATION_ERROR;
+                }
+                // BCC check
+                if (cl[4] != (cl[0] ^ cl[1] ^ cl[2] ^ cl[3])) {
+                    return NFCStatus::COMMUNICATION_ERROR;
+                }
+                return NFCStatus::OK;
+            }
+
+            // Collision: follow the tags with a 1 at the first differing bit
+            uint16_t position = static_cast<uint16_t>(knownBytes * 8 + collisionBit);
+            if (position < knownBits || position >= 32) {
+                return NFCStatus::COMMUNICATION_ERROR;
+            }
+            cl[position / 8] &= static_cast<uint8_t>((1 << (position % 8)) - 1);
+            cl[position / 8] |= static_cast<uint8_t>(1 << (position % 8));
+            knownBits = static_cast<uint8_t>(position + 1);
+        }
+
+        // All UID bits known (collision in the last UID bit): the BCC follows from them
+        cl[4] = cl[0] ^ cl[1] ^ cl[2] ^ cl[3];
+        return NFCStatus::OK;
     }
 
-    NFCStatus NFCManager::SetField(NFCField field)
+    NFCStatus TagReader::selectCascadeLevel(uint8_t selCode, const uint8_t cl[5], uint8_t& sak)
     {
-        if (!_initialized) {
-            return NFCStatus::NOT_INITIALIZED;
+        // SELECT: NVB = 0x70 with the complete cascade level and CRC
+        std::vector<uint8_t> select = { selCode, 0x70 };
+        select.insert(select.end(), cl, cl + 5);
+
+        std::vector<uint8_t> response;
+        NFCStatus status = _controller->TransmitReceive(select, response, 10);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (response.size() != 1) {
+            return NFCStatus::COMMUNICATION_ERROR;
         }
 
-        return _controller->SetField(field);
+        sak = response[0];
+        return NFCStatus::OK;
     }
 
-    NFCField NFCManager::GetField(void) const
+    NFCStatus TagReader::ReadRawData(const TagInfo& tagInfo, uint16_t address, uint16_t length, std::vector<uint8_t>& data)
     {
-        if (!_initialized) {
-            return NFCField::OFF;
+        if (!_controller || !_controller->IsInitialized()) {
+            return NFCStatus::NOT_INITIALIZED;
         }
 
-        NFCField field;
-        _controller->GetField(field);
-        return field;
+        switch (tagInfo.protocol) {
+            case NFCProtocol::NFC_A:
+                // Identified tags: stay within pages 0 to the end of user memory
+                if (tagInfo.model != TagModel::UNKNOWN && tagInfo.dataSize) {
+                    uint16_t limit = static_cast<uint16_t>(16 + tagInfo.dataSize);
+                    if (address >= limit) {
+                        return NFCStatus::INVALID_PARAM;
+                    }
+                    length = std::min<uint16_t>(length, static_cast<uint16_t>(limit - address));
+                }
+                return readISO14443A(tagInfo, address, length, data);
+            case NFCProtocol::MIFARE_CLASSIC:
+                // Address is a block number: stay within the card
+                if (address >= MifareClassic::BlockCount(tagInfo.dataSize)) {
+                    return NFCStatus::INVALID_PARAM;
+                }
+                return readMifareClassic(tagInfo, static_cast<uint8_t>(address), length, data);
+            case NFCProtocol::NFC_V:
+                // Known memory size: stay within the tag
+                if (tagInfo.dataSize) {
+                    if (address >= tagInfo.dataSize) {
+                        return NFCStatus::INVALID_PARAM;
+                    }
+                    length = std::min<uint16_t>(length, static_cast<uint16_t>(tagInfo.dataSize - address));
+                }
+                return readISO15693(tagInfo, address, length, data);
+            default:
+                return NFCStatus::UNSUPPORTED_TAG;
+        }
     }
 
-    void NFCManager::handleTagDetection(void)
+    NFCStatus TagReader::ReadNDEF(const TagInfo& tagInfo, NDEFMessage& message)
     {
-        if (!_detectionActive || !_detectionCallback) {
-            return;
+        // Type 4: NDEF file of the NDEF Tag Application, Type 2 and Type 5: NDEF TLV after the CC
+        std::vector<uint8_t> ndefData;
+        NFCStatus status;
+        if (supportsIsoDep(tagInfo)) {
+            status = readType4NDEF(ndefData);
+        } else if (tagInfo.protocol == NFCProtocol::NFC_A) {
+            status = readType2NDEF(tagInfo, ndefData);
+        } else if (tagInfo.protocol == NFCProtocol::NFC_V) {
+            status = readType5NDEF(tagInfo, ndefData);
+        } else {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
+        if (status != NFCStatus::OK) {
+            return status;
         }
 
-        // Send REQA command to detect ISO14443A tags
-        std::vector<uint8_t> reqa = {0x26}; // REQA command
-        std::vector<uint8_t> response;
-
-        NFCStatus status = _controller->TransmitReceive(reqa, response, 100);
-        if (status == NFCStatus::OK && response.size() >= 2) {
-            TagInfo tagInfo;
-            if (identifyTag(response, tagInfo) == NFCStatus::OK) {
-                _detectionCallback(tagInfo);
-            }
+        if (ndefData.empty()) {
+            message.records.clear();
+            message.totalSize = 0;
+            return NFCStatus::OK;
         }
+        return parseNDEFMessage(ndefData, message);
     }
 
-    NFCStatus NFCManager::identifyTag(const std::vector<uint8_t>& response, TagInfo& tagInfo)
+    NFCStatus TagReader::readType2NDEF(const TagInfo& tagInfo, std::vector<uint8_t>& data)
     {
-        if (response.size() < 2) {
-            return NFCStatus::ERROR;
+        if (!_controller || !_controller->IsInitialized()) {
+            return NFCStatus::NOT_INITIALIZED;
         }
 
-        // Initialize tag info
-        tagInfo.protocol = NFCProtocol::NFC_A;
-        tagInfo.atqa = response;
-        tagInfo.isReadOnly = false;
-
-        // Determine tag type based on ATQA
-        uint16_t atqa = (response[1] << 8) | response[0];
-        
-        switch (atqa) {
-            case 0x0004:
-                tagInfo.protocol = NFCProtocol::MIFARE_CLASSIC;
-                tagInfo.dataSize = 1024; // MIFARE Classic 1K
-                break;
-            case 0x0044:
-                tagInfo.protocol = NFCProtocol::NFC_A;
-                tagInfo.dataSize = 8192; // NTAG213/215/216
-                break;
-            default:
-                tagInfo.protocol = NFCProtocol::NFC_A;
-                tagInfo.dataSize = 2048; // Default size
-                break;
+        MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, 4, [this, &tagInfo](uint32_t address, uint32_t length, std::vector<uint8_t>& bytes) {
+            return readType2Data(_controller, tagInfo, address, length, bytes);
+        });
+        Type2CapabilityContainer cc{};
+        TlvArea area{};
+        NdefTlv tlv{};
+        TlvWindow window{};
+        NFCStatus status = type2FindNdefTlv(read, tagInfo, cc, area, window, tlv);
+        if (status != NFCStatus::OK) {
+            return status;
         }
 
-        return NFCStatus::OK;
+        data.clear();
+        if (!tlv.present) {
+            return NFCStatus::OK;
+        }
+        if (tlv.length == 0) {
+            return checkEmptyNdefTlv(read, area, window, tlv);
+        }
+        return readNdefTlvValue(read, tlv, window, data);
     }
 
-    // ============================================================================
-    // TagReader Implementation
-    // ============================================================================
-
-    TagReader::TagReader(ST25R3911B* controller)
-        : _controller(controller)
-        , _callback(nullptr)
+    NFCStatus TagReader::ReadType4Capability(Type4CapabilityContainer& cc)
     {
+        return type4SelectNdefFile(_isoDep, cc);
     }
 
-    NFCStatus TagReader::ReadUID(const TagInfo& tagInfo, std::vector<uint8_t>& uid)
+    NFCStatus TagReader::readType4NDEF(std::vector<uint8_t>& data)
     {
-        if (!_controller || !_controller->IsInitialized()) {
-            return NFCStatus::NOT_INITIALIZED;
+        Type4CapabilityContainer cc{};
+        NFCStatus status = type4SelectNdefFile(_isoDep, cc);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (cc.readAccess != 0x00) {
+            return NFCStatus::UNSUPPORTED_TAG;
         }
 
-        // Send anticollision command
-        std::vector<uint8_t> anticol = {0x93, 0x20}; // SELECT CL1
-        std::vector<uint8_t> response;
-
-        NFCStatus status = _controller->TransmitReceive(anticol, response, 100);
+        // The first READ BINARY returns the length field together with the start of the message
+        uint16_t chunk = std::min(cc.maxReadSize, TYPE4_MAX_SHORT_LE);
+        std::vector<uint8_t> file;
+        status = type4ReadBinary(_isoDep, 0, static_cast<uint16_t>(std::min<uint32_t>(chunk, cc.ndefFileSize)), file);
         if (status != NFCStatus::OK) {
             return status;
         }
+        if (file.size() < cc.lengthFieldSize) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
 
-        if (response.size() >= 5) {
-            uid.assign(response.begin(), response.begin() + 4);
-            return NFCStatus::OK;
+        uint32_t length = 0;
+        for (uint8_t i = 0; i < cc.lengthFieldSize; ++i) {
+            length = (length << 8) | file[i];
+        }
+        uint32_t total = cc.lengthFieldSize + length;
+        if (total > cc.ndefFileSize) {
+            return NFCStatus::COMMUNICATION_ERROR;
+        }
+        if (total > TYPE4_MAX_OFFSET + 1) {
+            // Offsets above 0x7FFF need READ BINARY with an offset data object
+            return NFCStatus::UNSUPPORTED_TAG;
         }
 
-        return NFCStatus::ERROR;
+        file.resize(std::min<size_t>(file.size(), total));
+        while (file.size() < total) {
+            uint16_t count = static_cast<uint16_t>(std::min<uint32_t>(chunk, total - file.size()));
+            status = type4ReadBinary(_isoDep, static_cast<uint16_t>(file.size()), count, file);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+        }
+
+        data.assign(file.begin() + cc.lengthFieldSize, file.begin() + total);
+        return NFCStatus::OK;
     }
 
-    NFCStatus TagReader::ReadRawData(const TagInfo& tagInfo, uint16_t address, uint16_t length, std::vector<uint8_t>& data)
+    NFCStatus TagReader::ReadType5Capability(const TagInfo& tagInfo, Type5CapabilityContainer& cc)
     {
         if (!_controller || !_controller->IsInitialized()) {
             return NFCStatus::NOT_INITIALIZED;
         }
 
-        switch (tagInfo.protocol) {
-            case NFCProtocol::NFC_A:
-                return readISO14443A(address, length, data);
-            case NFCProtocol::MIFARE_CLASSIC:
-                return readMifareClassic(static_cast<uint8_t>(address), data);
-            default:
-                return NFCStatus::UNSUPPORTED_TAG;
+        // The CC is 4 or 8 bytes at address 0
+        std::vector<uint8_t> data;
+        NFCStatus status = readVicinityData(_controller, tagInfo, 0, TYPE5_MAX_CC_SIZE, data, vicinityBlocksPerRead(tagInfo));
+        if (status != NFCStatus::OK) {
+            return status;
         }
+        return type5ParseCapability(data, cc);
     }
 
-    NFCStatus TagReader::ReadNDEF(const TagInfo& tagInfo, NDEFMessage& message)
+    NFCStatus TagReader::readType5NDEF(const TagInfo& tagInfo, std::vector<uint8_t>& data)
     {
-        // Read NDEF header first
-        std::vector<uint8_t> header;
-        NFCStatus status = ReadRawData(tagInfo, 0, 16, header);
-        if (status != NFCStatus::OK) {
-            return status;
+        if (!_controller || !_controller->IsInitialized()) {
+            return NFCStatus::NOT_INITIALIZED;
         }
 
-        // Check for NDEF capability container
-        if (header.size() < 16 || header[0] != 0xE1) {
-            return NFCStatus::ERROR;
+        uint16_t& blocksPerRead = vicinityBlocksPerRead(tagInfo);
+        uint16_t blockSize = tagInfo.blockSize ? tagInfo.blockSize : 4;
+        MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, blockSize, [this, &tagInfo, &blocksPerRead](uint32_t address, uint32_t length, std::vector<uint8_t>& bytes) {
+            return readVicinityData(_controller, tagInfo, address, length, bytes, blocksPerRead);
+        });
+        Type5CapabilityContainer cc{};
+        TlvArea area{};
+        NdefTlv tlv{};
+        TlvWindow window{};
+        NFCStatus status = type5FindNdefTlv(read, tagInfo, blocksPerRead, cc, area, window, tlv);
+        if (status != NFCStatus::OK) {
+            return status;
         }
 
-        // Get NDEF message length
-        uint16_t ndefLength = (header[14] << 8) | header[15];
-        if (ndefLength == 0) {
-            message.records.clear();
-            message.totalSize = 0;
+        data.clear();
+        if (!tlv.present) {
             return NFCStatus::OK;
         }
-
-        // Read NDEF message
-        std::vector<uint8_t> ndefData;
-        status = ReadRawData(tagInfo, 16, ndefLength, ndefData);
-        if (status != NFCStatus::OK) {
-            return status;
+        if (tlv.length == 0) {
+            return checkEmptyNdefTlv(read, area, window, tlv);
         }
-
-        return parseNDEFMessage(ndefData, message);
+        return readNdefTlvValue(read, tlv, window, data);
     }
 
     NFCStatus TagReader::ReadText(const TagInfo& tagInfo, std::string& text, std::string& language)
@@ -372,8 +3080,16 @@ namespace NFC
         uint8_t typeLength = data[pos++];
         bytesRead++;
 
-        uint8_t payloadLength = data[pos++];
-        bytesRead++;
+        // Short record: 1-byte payload length, 4 bytes otherwise
+        size_t lengthBytes = (flags & 0x10) ? 1 : 4;
+        if (pos + lengthBytes > data.size()) {
+            return NFCStatus::ERROR;
+        }
+        size_t payloadLength = 0;
+        for (size_t i = 0; i < lengthBytes; ++i) {
+            payloadLength = (payloadLength << 8) | data[pos++];
+        }
+        bytesRead += lengthBytes;
 
         // Skip ID length if present
         if (flags & 0x08) { // IL flag
@@ -394,6 +3110,9 @@ namespace NFC
         }
 
         // Read payload
+        if (pos + payloadLength > data.size()) {
+            return NFCStatus::ERROR;
+        }
         record.rawData.assign(data.begin() + pos, data.begin() + pos + payloadLength);
         pos += payloadLength;
         bytesRead += payloadLength;
@@ -442,73 +3161,60 @@ namespace NFC
         return NFCStatus::OK;
     }
 
-    NFCStatus TagReader::readISO14443A(uint16_t address, uint16_t length, std::vector<uint8_t>& data)
+    NFCStatus TagReader::readISO14443A(const TagInfo& tagInfo, uint16_t address, uint16_t length, std::vector<uint8_t>& data)
     {
-        data.clear();
-        data.reserve(length);
-
-        // Read in 16-byte blocks (typical for NTAG)
-        uint16_t bytesRead = 0;
-        uint8_t blockSize = 16;
-
-        while (bytesRead < length) {
-            uint8_t currentBlock = static_cast<uint8_t>((address + bytesRead) / blockSize);
-            std::vector<uint8_t> readCmd = {0x30, currentBlock}; // READ command
-            std::vector<uint8_t> response;
-
-            NFCStatus status = _controller->TransmitReceive(readCmd, response, 100);
-            if (status != NFCStatus::OK) {
-                return status;
-            }
-
-            if (response.size() < blockSize) {
-                return NFCStatus::ERROR;
-            }
-
-            // Add data to result
-            uint16_t remainingBytes = length - bytesRead;
-            uint16_t bytesToCopy = std::min(static_cast<uint16_t>(blockSize), remainingBytes);
-            
-            data.insert(data.end(), response.begin(), response.begin() + bytesToCopy);
-            bytesRead += bytesToCopy;
-        }
-
-        return NFCStatus::OK;
+        MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, 4, [this, &tagInfo](uint32_t from, uint32_t count, std::vector<uint8_t>& bytes) {
+            return readType2Data(_controller, tagInfo, from, count, bytes);
+        });
+        return read(address, length, data);
     }
 
-    NFCStatus TagReader::readMifareClassic(uint8_t block, std::vector<uint8_t>& data)
+    NFCStatus TagReader::readISO15693(const TagInfo& tagInfo, uint16_t address, uint16_t length, std::vector<uint8_t>& data)
     {
-        // MIFARE Classic requires authentication first
-        std::vector<uint8_t> authCmd = {0x60, block, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}; // AUTH_A with default key
-        std::vector<uint8_t> response;
+        uint16_t& blocksPerRead = vicinityBlocksPerRead(tagInfo);
+        uint16_t blockSize = tagInfo.blockSize ? tagInfo.blockSize : 4;
+        MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, blockSize, [this, &tagInfo, &blocksPerRead](uint32_t from, uint32_t count, std::vector<uint8_t>& bytes) {
+            return readVicinityData(_controller, tagInfo, from, count, bytes, blocksPerRead);
+        });
+        return read(address, length, data);
+    }
 
-        NFCStatus status = _controller->TransmitReceive(authCmd, response, 100);
-        if (status != NFCStatus::OK) {
-            return status;
+    uint16_t& TagReader::vicinityBlocksPerRead(const TagInfo& tagInfo)
+    {
+        if (tagInfo.uid != _vicinityUid) {
+            _vicinityUid = tagInfo.uid;
+            _vicinityBlocksPerRead = vicinityDefaultBlocksPerRead(tagInfo);
         }
+        return _vicinityBlocksPerRead;
+    }
 
-        // Read block
-        std::vector<uint8_t> readCmd = {0x30, block};
-        status = _controller->TransmitReceive(readCmd, response, 100);
-        if (status != NFCStatus::OK) {
-            return status;
+    NFCStatus TagReader::readMifareClassic(const TagInfo& tagInfo, uint8_t block, uint16_t length, std::vector<uint8_t>& data)
+    {
+        if (!_mifareClassic) {
+            return NFCStatus::UNSUPPORTED_TAG;
         }
 
-        if (response.size() >= 16) {
-            data.assign(response.begin(), response.begin() + 16);
-            return NFCStatus::OK;
-        }
+        uint16_t count = std::max<uint16_t>(1, static_cast<uint16_t>((length + MifareClassic::BLOCK_SIZE - 1) / MifareClassic::BLOCK_SIZE));
+        count = std::min<uint16_t>(count, static_cast<uint16_t>(MifareClassic::BlockCount(tagInfo.dataSize) - block));
 
-        return NFCStatus::ERROR;
+        // One Crypto1 session per sector, its blocks streamed within it
+        return _mifareClassic->ReadBlocks(tagInfo, block, count, data);
     }
 
     // ============================================================================
     // TagWriter Implementation  
     // ============================================================================
 
-    TagWriter::TagWriter(ST25R3911B* controller)
+    TagWriter::TagWriter(ST25R3911B* controller, IsoDep* isoDep, TagMemoryCache* memoryCache, MifareClassic* mifareClassic,
+                         ActivateFunction activate)
         : _controller(controller)
+        , _isoDep(isoDep)
+        , _memoryCache(memoryCache)
+        , _mifareClassic(mifareClassic)
+        , _activate(activate)
         , _callback(nullptr)
+        , _writeConfig{false, false, 2, true}
+        , _writeStats{}
     {
     }
 
@@ -524,12 +3230,22 @@ namespace NFC
 
         switch (tagInfo.protocol) {
             case NFCProtocol::NFC_A:
-                return writeISO14443A(address, data);
+                // Identified tags: never write past user memory into the configuration pages
+                if (tagInfo.model != TagModel::UNKNOWN && tagInfo.dataSize &&
+                    address + data.size() > static_cast<size_t>(16 + tagInfo.dataSize)) {
+                    return NFCStatus::INVALID_PARAM;
+                }
+                return writeISO14443A(tagInfo, address, data);
             case NFCProtocol::MIFARE_CLASSIC:
-                if (data.size() != 16) {
+                if (address + data.size() / MifareClassic::BLOCK_SIZE > MifareClassic::BlockCount(tagInfo.dataSize)) {
+                    return NFCStatus::INVALID_PARAM;
+                }
+                return writeMifareClassic(tagInfo, static_cast<uint8_t>(address), data);
+            case NFCProtocol::NFC_V:
+                if (tagInfo.dataSize && address + data.size() > tagInfo.dataSize) {
                     return NFCStatus::INVALID_PARAM;
                 }
-                return writeMifareClassic(static_cast<uint8_t>(address), data);
+                return writeISO15693(tagInfo, address, data);
             default:
                 return NFCStatus::UNSUPPORTED_TAG;
         }
@@ -544,19 +3260,130 @@ namespace NFC
             return status;
         }
 
-        // Write NDEF length header
-        std::vector<uint8_t> lengthHeader = {
-            static_cast<uint8_t>((ndefData.size() >> 8) & 0xFF),
-            static_cast<uint8_t>(ndefData.size() & 0xFF)
-        };
+        // Type 4: NDEF file of the NDEF Tag Application
+        if (supportsIsoDep(tagInfo)) {
+            return writeType4NDEF(ndefData);
+        }
+
+        // Type 2 and Type 5: NDEF TLV after the CC
+        if (tagInfo.protocol == NFCProtocol::NFC_A) {
+            return writeType2NDEF(tagInfo, ndefData);
+        }
+        if (tagInfo.protocol == NFCProtocol::NFC_V) {
+            return writeType5NDEF(tagInfo, ndefData);
+        }
+        return NFCStatus::UNSUPPORTED_TAG;
+    }
+
+    NFCStatus TagWriter::writeType2NDEF(const TagInfo& tagInfo, const std::vector<uint8_t>& data)
+    {
+        if (!_controller || !_controller->IsInitialized()) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+        if (tagInfo.isReadOnly) {
+            return NFCStatus::ERROR;
+        }
+
+        MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, 4, [this, &tagInfo](uint32_t address, uint32_t length, std::vector<uint8_t>& bytes) {
+            return readType2Data(_controller, tagInfo, address, length, bytes);
+        });
+        Type2CapabilityContainer cc{};
+        TlvArea area{};
+        NdefTlv tlv{};
+        TlvWindow window{};
+        NFCStatus status = type2FindNdefTlv(read, tagInfo, cc, area, window, tlv);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (cc.writeAccess != 0x0) {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
+
+        uint32_t address = 0;
+        std::vector<uint8_t> image;
+        status = buildNdefTlv(area, window, tlv, data, address, image);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        UnitWriteFunction write = cachedWrite(_memoryCache, tagInfo, 4, _writeConfig.verify, [this](uint32_t page, const uint8_t* bytes) {
+            return type2WritePage(_controller, page, bytes);
+        });
+        return writeNdefTlv(read, write, boundActivate(_activate, tagInfo), area, window, tlv, address, image, _writeConfig, _writeStats);
+    }
+
+    NFCStatus TagWriter::writeType4NDEF(const std::vector<uint8_t>& data)
+    {
+        Type4CapabilityContainer cc{};
+        NFCStatus status = type4SelectNdefFile(_isoDep, cc);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        if (cc.writeAccess != 0x00) {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
+
+        // File image: length field (0 until the message is complete) followed by the message
+        uint32_t total = cc.lengthFieldSize + data.size();
+        if (total > cc.ndefFileSize || total > TYPE4_MAX_OFFSET + 1) {
+            return NFCStatus::INVALID_PARAM;
+        }
+        std::vector<uint8_t> file(cc.lengthFieldSize, 0x00);
+        file.insert(file.end(), data.begin(), data.end());
+
+        // The first UPDATE BINARY clears the length field together with the start of the message
+        size_t chunk = std::min(cc.maxWriteSize, TYPE4_MAX_SHORT_LC);
+        for (size_t offset = 0; offset < file.size(); ) {
+            size_t length = std::min(chunk, file.size() - offset);
+            status = type4UpdateBinary(_isoDep, static_cast<uint16_t>(offset), file.data() + offset, length);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            offset += length;
+        }
+
+        // Commit the message length
+        for (uint8_t i = 0; i < cc.lengthFieldSize; ++i) {
+            file[i] = static_cast<uint8_t>(data.size() >> (8 * (cc.lengthFieldSize - 1 - i)));
+        }
+        return type4UpdateBinary(_isoDep, 0, file.data(), cc.lengthFieldSize);
+    }
+
+    NFCStatus TagWriter::writeType5NDEF(const TagInfo& tagInfo, const std::vector<uint8_t>& data)
+    {
+        if (!_controller || !_controller->IsInitialized()) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+        if (tagInfo.isReadOnly) {
+            return NFCStatus::ERROR;
+        }
 
-        status = WriteRawData(tagInfo, 14, lengthHeader);
+        uint16_t blocksPerRead = vicinityDefaultBlocksPerRead(tagInfo);
+        uint16_t blockSize = tagInfo.blockSize ? tagInfo.blockSize : 4;
+        MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, blockSize, [this, &tagInfo, &blocksPerRead](uint32_t address, uint32_t length, std::vector<uint8_t>& bytes) {
+            return readVicinityData(_controller, tagInfo, address, length, bytes, blocksPerRead);
+        });
+        Type5CapabilityContainer cc{};
+        TlvArea area{};
+        NdefTlv tlv{};
+        TlvWindow window{};
+        NFCStatus status = type5FindNdefTlv(read, tagInfo, blocksPerRead, cc, area, window, tlv);
         if (status != NFCStatus::OK) {
             return status;
         }
+        if (cc.writeAccess != 0) {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
 
-        // Write NDEF message
-        return WriteRawData(tagInfo, 16, ndefData);
+        uint32_t address = 0;
+        std::vector<uint8_t> image;
+        status = buildNdefTlv(area, window, tlv, data, address, image);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        UnitWriteFunction write = cachedWrite(_memoryCache, tagInfo, blockSize, _writeConfig.verify, [this, &tagInfo](uint32_t block, const uint8_t* bytes) {
+            return vicinityWriteBlock(_controller, tagInfo, block, bytes);
+        });
+        return writeNdefTlv(read, write, boundActivate(_activate, tagInfo), area, window, tlv, address, image, _writeConfig, _writeStats);
     }
 
     NFCStatus TagWriter::WriteText(const TagInfo& tagInfo, const std::string& text, const std::string& language)
@@ -634,17 +3461,53 @@ namespace NFC
 
     NFCStatus TagWriter::FormatTag(const TagInfo& tagInfo)
     {
-        // Write NDEF capability container
-        std::vector<uint8_t> cc = {
-            0xE1, 0x10, // NDEF Magic Number and Version
-            0x3F, 0x00, // Data Size (approximate)
-            0x00, 0x00, 0x00, 0x00, // Reserved
-            0x00, 0x00, 0x00, 0x00, // Reserved
-            0x00, 0x00, // Reserved
-            0x00, 0x00  // NDEF Length (empty)
-        };
+        if (!_controller || !_controller->IsInitialized()) {
+            return NFCStatus::NOT_INITIALIZED;
+        }
+
+        // Capability container followed by an empty NDEF TLV and a Terminator TLV
+        std::vector<uint8_t> layout;
+        uint16_t address = 0;
+        if (tagInfo.protocol == NFCProtocol::NFC_A && !supportsIsoDep(tagInfo)) {
+            // Type 2: the CC in page 3 is one-time programmable, a valid one is kept. Otherwise
+            // unidentified tags get the 48-byte data area of the smallest products.
+            std::vector<uint8_t> page;
+            Type2CapabilityContainer cc{};
+            MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, 4, [this, &tagInfo](uint32_t from, uint32_t length, std::vector<uint8_t>& bytes) {
+                return readType2Data(_controller, tagInfo, from, length, bytes);
+            });
+            NFCStatus status = read(TYPE2_CC_ADDRESS, 4, page);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            if (type2ParseCapability(page.data(), cc) == NFCStatus::OK) {
+                address = TYPE2_DATA_AREA;
+            } else {
+                uint32_t areaSize = (tagInfo.model != TagModel::UNKNOWN && tagInfo.dataSize) ? tagInfo.dataSize : 48;
+                address = TYPE2_CC_ADDRESS;
+                layout = { TYPE2_CC_MAGIC, 0x10, static_cast<uint8_t>(std::min<uint32_t>(areaSize / 8, 0xFF)), 0x00 };
+            }
+            layout.insert(layout.end(), { TLV_NDEF, 0x00, TLV_TERMINATOR, 0x00 });
+        } else if (tagInfo.protocol == NFCProtocol::NFC_V) {
+            // Type 5: CC in block 0, MLEN counts the area after the CC (8-byte CC above 255 * 8 bytes).
+            // READ MULTIPLE BLOCKS is announced, the reader falls back to single blocks without it.
+            if (tagInfo.dataSize < TYPE5_MAX_CC_SIZE + 8) {
+                return NFCStatus::INVALID_PARAM;
+            }
+            uint32_t areaSize = (tagInfo.dataSize - 4) / 8;
+            if (areaSize <= 0xFF) {
+                layout = { TYPE5_CC_MAGIC, 0x40, static_cast<uint8_t>(areaSize), 0x01 };
+            } else {
+                areaSize = std::min<uint32_t>((tagInfo.dataSize - TYPE5_MAX_CC_SIZE) / 8, 0xFFFF);
+                layout = { TYPE5_CC_MAGIC_EXTENDED, 0x40, 0x00, 0x01, 0x00, 0x00,
+                           static_cast<uint8_t>(areaSize >> 8), static_cast<uint8_t>(areaSize) };
+            }
+            layout.insert(layout.end(), { TLV_NDEF, 0x00, TLV_TERMINATOR });
+        } else {
+            return NFCStatus::UNSUPPORTED_TAG;
+        }
 
-        return WriteRawData(tagInfo, 0, cc);
+        return WriteRawData(tagInfo, address, layout);
     }
 
     NFCStatus TagWriter::createNDEFMessage(const std::vector<NDEFRecord>& records, std::vector<uint8_t>& data)
@@ -748,69 +3611,104 @@ namespace NFC
                 return NFCStatus::INVALID_PARAM;
         }
 
-        // Build record
-        data.push_back(tnf); // TNF and flags (flags set by caller)
+        // Build record: short record (SR) if the payload length fits one byte
+        bool shortRecord = (payload.size() <= 0xFF);
+        data.push_back(static_cast<uint8_t>(tnf | (shortRecord ? 0x10 : 0x00))); // TNF and SR (MB/ME set by caller)
         data.push_back(static_cast<uint8_t>(type.length()));
-        data.push_back(static_cast<uint8_t>(payload.size()));
+        if (shortRecord) {
+            data.push_back(static_cast<uint8_t>(payload.size()));
+        } else {
+            uint32_t length = static_cast<uint32_t>(payload.size());
+            data.insert(data.end(), { static_cast<uint8_t>(length >> 24), static_cast<uint8_t>(length >> 16),
+                                      static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length) });
+        }
         data.insert(data.end(), type.begin(), type.end());
         data.insert(data.end(), payload.begin(), payload.end());
 
         return NFCStatus::OK;
     }
 
-    NFCStatus TagWriter::writeISO14443A(uint16_t address, const std::vector<uint8_t>& data)
+    NFCStatus TagWriter::writeISO14443A(const TagInfo& tagInfo, uint16_t address, const std::vector<uint8_t>& data)
     {
-        // Write in 4-byte chunks (typical for NTAG)
-        size_t bytesWritten = 0;
-        uint8_t pageSize = 4;
-
-        while (bytesWritten < data.size()) {
-            uint8_t currentPage = static_cast<uint8_t>((address + bytesWritten) / pageSize);
-            std::vector<uint8_t> writeCmd = {0xA2, currentPage}; // WRITE command
-
-            // Add 4 bytes of data
-            size_t remainingBytes = data.size() - bytesWritten;
-            size_t bytesToWrite = std::min(static_cast<size_t>(pageSize), remainingBytes);
-            
-            writeCmd.insert(writeCmd.end(), data.begin() + bytesWritten, data.begin() + bytesWritten + bytesToWrite);
-            
-            // Pad to 4 bytes if necessary
-            while (writeCmd.size() < 6) {
-                writeCmd.push_back(0x00);
+        // Whole pages: differential writes read the pages and compare, otherwise a partial page
+        // is padded with zeros
+        MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, 4, [this, &tagInfo](uint32_t from, uint32_t length, std::vector<uint8_t>& bytes) {
+            return readType2Data(_controller, tagInfo, from, length, bytes);
+        });
+        uint32_t start = address - address % 4;
+        uint32_t end = (address + data.size() + 3) / 4 * 4;
+        std::vector<uint8_t> current;
+        if (_writeConfig.differential) {
+            NFCStatus status = read(start, end - start, current);
+            if (status != NFCStatus::OK) {
+                return status;
             }
+        }
+        std::vector<uint8_t> image = current.empty() ? std::vector<uint8_t>(end - start, 0x00) : current;
+        std::copy(data.begin(), data.end(), image.begin() + (address - start));
 
-            std::vector<uint8_t> response;
-            NFCStatus status = _controller->TransmitReceive(writeCmd, response, 100);
+        UnitWriteFunction write = cachedWrite(_memoryCache, tagInfo, 4, _writeConfig.verify, [this](uint32_t page, const uint8_t* bytes) {
+            return type2WritePage(_controller, page, bytes);
+        });
+        return writeUnits(read, write, boundActivate(_activate, tagInfo), _writeConfig, 4, start, image, current, start, end, _writeStats);
+    }
+
+    NFCStatus TagWriter::writeISO15693(const TagInfo& tagInfo, uint16_t address, const std::vector<uint8_t>& data)
+    {
+        uint16_t blockSize = tagInfo.blockSize ? tagInfo.blockSize : 4;
+        uint32_t start = address - address % blockSize;
+        uint32_t end = (address + data.size() + blockSize - 1) / blockSize * blockSize;
+        std::vector<uint8_t> current;
+        std::vector<uint8_t> image(end - start, 0x00);
+
+        uint16_t blocksPerRead = vicinityDefaultBlocksPerRead(tagInfo);
+        MemoryReadFunction read = cachedRead(_memoryCache, tagInfo, blockSize, [this, &tagInfo, &blocksPerRead](uint32_t from, uint32_t length, std::vector<uint8_t>& bytes) {
+            return readVicinityData(_controller, tagInfo, from, length, bytes, blocksPerRead);
+        });
+
+        if (_writeConfig.differential) {
+            NFCStatus status = read(start, end - start, current);
             if (status != NFCStatus::OK) {
                 return status;
             }
-
-            bytesWritten += bytesToWrite;
+            image = current;
+        } else if (!data.empty()) {
+            // Partial blocks: keep the bytes around the written range (READ SINGLE BLOCK)
+            std::vector<uint32_t> partial;
+            if (address != start) {
+                partial.push_back(start);
+            }
+            if (address + data.size() != end && (partial.empty() || end - blockSize != start)) {
+                partial.push_back(end - blockSize);
+            }
+            for (uint32_t block : partial) {
+                std::vector<uint8_t> blockData;
+                NFCStatus status = read(block, blockSize, blockData);
+                if (status != NFCStatus::OK) {
+                    return status;
+                }
+                std::copy(blockData.begin(), blockData.end(), image.begin() + (block - start));
+            }
         }
+        std::copy(data.begin(), data.end(), image.begin() + (address - start));
 
-        return NFCStatus::OK;
+        UnitWriteFunction write = cachedWrite(_memoryCache, tagInfo, blockSize, _writeConfig.verify, [this, &tagInfo](uint32_t block, const uint8_t* bytes) {
+            return vicinityWriteBlock(_controller, tagInfo, block, bytes);
+        });
+        return writeUnits(read, write, boundActivate(_activate, tagInfo), _writeConfig, blockSize, start, image, current, start, end, _writeStats);
     }
 
-    NFCStatus TagWriter::writeMifareClassic(uint8_t block, const std::vector<uint8_t>& data)
+    NFCStatus TagWriter::writeMifareClassic(const TagInfo& tagInfo, uint8_t block, const std::vector<uint8_t>& data)
     {
-        if (data.size() != 16) {
+        if (data.empty() || data.size() % MifareClassic::BLOCK_SIZE) {
             return NFCStatus::INVALID_PARAM;
         }
-
-        // Authenticate first
-        std::vector<uint8_t> authCmd = {0x60, block, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}; // AUTH_A with default key
-        std::vector<uint8_t> response;
-
-        NFCStatus status = _controller->TransmitReceive(authCmd, response, 100);
-        if (status != NFCStatus::OK) {
-            return status;
+        if (!_mifareClassic) {
+            return NFCStatus::UNSUPPORTED_TAG;
         }
 
-        // Write block
-        std::vector<uint8_t> writeCmd = {0xA0, block};
-        writeCmd.insert(writeCmd.end(), data.begin(), data.end());
-
-        return _controller->TransmitReceive(writeCmd, response, 100);
+        // One Crypto1 session per sector, its blocks written within it
+        return _mifareClassic->WriteBlocks(tagInfo, block, data.data(), static_cast<uint16_t>(data.size() / MifareClassic::BLOCK_SIZE));
     }
 
     uint8_t TagWriter::getURIPrefix(const std::string& uri)
@@ -28,6 +28,7 @@ namespace NFCTask
         , _nfcMutex(nullptr)
         , _commandsProcessed(0)
         , _nextRequestId(1)
+        , _nextDiscoveryMs(0)
     {
     }
 
@@ -283,8 +284,13 @@ namespace NFCTask
         const TickType_t maxBlockTime = pdMS_TO_TICKS(100);
 
         while (true) {
-            // Wait for command or notification
-            if (xQueueReceive(_commandQueue, &command, maxBlockTime) == pdPASS) {
+            // Wait for command, but not beyond the next discovery step
+            TickType_t blockTime = maxBlockTime;
+            if (_nfcManager->IsDetectionActive() && pdMS_TO_TICKS(_nextDiscoveryMs) < blockTime) {
+                blockTime = pdMS_TO_TICKS(_nextDiscoveryMs);
+            }
+
+            if (xQueueReceive(_commandQueue, &command, blockTime) == pdPASS) {
                 // Process command
                 NFC::OperationResult result = processCommand(command);
                 
@@ -294,19 +300,33 @@ namespace NFCTask
                 _commandsProcessed++;
             }
 
-            // Handle task notifications (interrupts)
-            if (ulTaskNotifyTake(pdFALSE, 0) > 0) {
-                // NFC interrupt occurred - let the NFC manager handle it
-                if (_nfcManager) {
-                    // This would typically trigger tag detection callbacks
-                }
-            }
+            // Interrupts raised while the task was blocked are consumed by the
+            // next discovery step; the driver tracks the pending flag itself
+            ulTaskNotifyTake(pdTRUE, 0);
+
+            // One discovery step between commands
+            runDiscovery();
 
             // Yield to other tasks
             taskYIELD();
         }
     }
 
+    void NFCTaskManager::runDiscovery(void)
+    {
+        if (!_nfcManager->IsDetectionActive()) {
+            return;
+        }
+
+        if (xSemaphoreTake(_nfcMutex, pdMS_TO_TICKS(_config.taskTimeoutMs)) != pdPASS) {
+            return;
+        }
+
+        _nextDiscoveryMs = _nfcManager->RunDiscovery();
+
+        xSemaphoreGive(_nfcMutex);
+    }
+
     NFC::OperationResult NFCTaskManager::processCommand(const NFCCommandData& command)
     {
         NFC::OperationResult result;
@@ -343,11 +363,12 @@ namespace NFCTask
 
             case NFCCommand::READ_TEXT:
                 result.operation = NFC::TagOperation::READ;
-                if (_nfcManager->GetTagReader()) {
+                if (!_nfcManager->HasCurrentTag()) {
+                    result.status = NFC::NFCStatus::NO_TAG_FOUND;
+                } else if (_nfcManager->GetTagReader()) {
                     std::string text, language;
-                    // This would need the current tag info - simplified for example
-                    NFC::TagInfo dummyTag; // In real implementation, store current tag
-                    result.status = _nfcManager->GetTagReader()->ReadText(dummyTag, text, language);
+                    result.tagInfo = _nfcManager->GetCurrentTag();
+                    result.status = _nfcManager->GetTagReader()->ReadText(result.tagInfo, text, language);
                     if (result.status == NFC::NFCStatus::OK) {
                         NFC::NDEFRecord record;
                         record.type = NFC::NDEFRecordType::TEXT;
@@ -362,9 +383,12 @@ namespace NFCTask
 
             case NFCCommand::WRITE_TEXT:
                 result.operation = NFC::TagOperation::WRITE;
-                if (_nfcManager->GetTagWriter()) {
-                    NFC::TagInfo dummyTag; // In real implementation, use current tag
-                    result.status = _nfcManager->GetTagWriter()->WriteText(dummyTag, command.textData, command.languageCode);
+                // Do not start a multi-page write on a tag that already left the field
+                if (_nfcManager->CheckPresence() != NFC::NFCStatus::OK) {
+                    result.status = NFC::NFCStatus::NO_TAG_FOUND;
+                } else if (_nfcManager->GetTagWriter()) {
+                    result.tagInfo = _nfcManager->GetCurrentTag();
+                    result.status = _nfcManager->GetTagWriter()->WriteText(result.tagInfo, command.textData, command.languageCode);
                 } else {
                     result.status = NFC::NFCStatus::NOT_INITIALIZED;
                 }
@@ -372,9 +396,11 @@ namespace NFCTask
 
             case NFCCommand::WRITE_URL:
                 result.operation = NFC::TagOperation::WRITE;
-                if (_nfcManager->GetTagWriter()) {
-                    NFC::TagInfo dummyTag; // In real implementation, use current tag
-                    result.status = _nfcManager->GetTagWriter()->WriteURL(dummyTag, command.uriData);
+                if (_nfcManager->CheckPresence() != NFC::NFCStatus::OK) {
+                    result.status = NFC::NFCStatus::NO_TAG_FOUND;
+                } else if (_nfcManager->GetTagWriter()) {
+                    result.tagInfo = _nfcManager->GetCurrentTag();
+                    result.status = _nfcManager->GetTagWriter()->WriteURL(result.tagInfo, command.uriData);
                 } else {
                     result.status = NFC::NFCStatus::NOT_INITIALIZED;
                 }
@@ -382,9 +408,11 @@ namespace NFCTask
 
             case NFCCommand::WRITE_WIFI:
                 result.operation = NFC::TagOperation::WRITE;
-                if (_nfcManager->GetTagWriter()) {
-                    NFC::TagInfo dummyTag; // In real implementation, use current tag
-                    result.status = _nfcManager->GetTagWriter()->WriteWiFi(dummyTag, command.wifiSSID, command.wifiPassword, command.wifiSecurity);
+                if (_nfcManager->CheckPresence() != NFC::NFCStatus::OK) {
+                    result.status = NFC::NFCStatus::NO_TAG_FOUND;
+                } else if (_nfcManager->GetTagWriter()) {
+                    result.tagInfo = _nfcManager->GetCurrentTag();
+                    result.status = _nfcManager->GetTagWriter()->WriteWiFi(result.tagInfo, command.wifiSSID, command.wifiPassword, command.wifiSecurity);
                 } else {
                     result.status = NFC::NFCStatus::NOT_INITIALIZED;
                 }
@@ -397,9 +425,11 @@ namespace NFCTask
 
             case NFCCommand::FORMAT_TAG:
                 result.operation = NFC::TagOperation::FORMAT;
-                if (_nfcManager->GetTagWriter()) {
-                    NFC::TagInfo dummyTag; // In real implementation, use current tag
-                    result.status = _nfcManager->GetTagWriter()->FormatTag(dummyTag);
+                if (_nfcManager->CheckPresence() != NFC::NFCStatus::OK) {
+                    result.status = NFC::NFCStatus::NO_TAG_FOUND;
+                } else if (_nfcManager->GetTagWriter()) {
+                    result.tagInfo = _nfcManager->GetCurrentTag();
+                    result.status = _nfcManager->GetTagWriter()->FormatTag(result.tagInfo);
                 } else {
                     result.status = NFC::NFCStatus::NOT_INITIALIZED;
                 }
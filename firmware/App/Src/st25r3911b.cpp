@@ -13,6 +13,7 @@
 #include "st25r3911b.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include <algorithm>
 
 namespace NFC
 {
@@ -41,6 +42,15 @@ namespace NFC
         }
     }
     
+    /** @brief ISO15693 start of frame, 1-of-4 coding (pulse in the 2nd and 6th position) */
+    static constexpr uint8_t ISO15693_SOF_1OF4 = 0x21;
+    /** @brief ISO15693 end of frame (pulse in the 3rd position) */
+    static constexpr uint8_t ISO15693_EOF_1OF4 = 0x04;
+    /** @brief ISO15693 tag start of frame in the subcarrier stream (5 half bits, LSB first) */
+    static constexpr uint8_t ISO15693_SOF_RX = 0x17;
+    /** @brief ISO15693 tag end of frame in the subcarrier stream (5 half bits, LSB first) */
+    static constexpr uint8_t ISO15693_EOF_RX = 0x1D;
+
     // ============================================================================
     // Constructor and Destructor
     // ============================================================================
@@ -51,6 +61,12 @@ namespace NFC
         , _currentProtocol(NFCProtocol::NFC_A)
         , _fieldState(NFCField::OFF)
         , _interruptPending(false)
+        , _errorCounters{}
+        , _signalCapture(true)
+        , _lastSignal{0, 0, 0, 0, false}
+        , _receiverBoosted(false)
+        , _savedRxConf3(0)
+        , _savedRxConf4(0)
     {
         // Set interrupt callback if GPIO interrupt is available
         // Note: Lambda callbacks not supported with function pointers - callback will be set externally
@@ -135,6 +151,9 @@ namespace NFC
             return status;
         }
 
+        // Receiver configuration is back at its defaults
+        _receiverBoosted = false;
+
         // Wait for oscillator to stabilize
         SafeDelay(10);
 
@@ -221,6 +240,13 @@ namespace NFC
         return status;
     }
 
+    NFCStatus ST25R3911B::SetBitRate(NFCBitRate bitRate)
+    {
+        // Transmit rate in the high nibble, receive rate in the low nibble
+        uint8_t rate = static_cast<uint8_t>(bitRate);
+        return WriteRegister(::ST25R3911B::REG_BIT_RATE, static_cast<uint8_t>((rate << 4) | rate));
+    }
+
     // ============================================================================
     // Low-Level Register Operations
     // ============================================================================
@@ -263,39 +289,46 @@ namespace NFC
 
     NFCStatus ST25R3911B::ReadRegisters(uint8_t startReg, std::vector<uint8_t>& data, uint8_t length)
     {
-        if (!_config.spiMaster || !isValidRegister(startReg) || length == 0) {
+        if (!_config.spiMaster || !isValidRegister(startReg) || length == 0 ||
+            !isValidRegister(static_cast<uint8_t>(startReg + length - 1))) {
             return NFCStatus::INVALID_PARAM;
         }
 
-        data.clear();
-        data.reserve(length);
+        // Single frame, the address auto-increments after each data byte
+        std::vector<uint8_t> txData(length + 1, 0x00);
+        txData[0] = static_cast<uint8_t>(startReg | ::ST25R3911B::SPI_CMD_READ);
+        std::vector<uint8_t> rxData;
 
-        for (uint8_t i = 0; i < length; ++i) {
-            uint8_t value;
-            NFCStatus status = ReadRegister(startReg + i, value);
-            if (status != NFCStatus::OK) {
-                return status;
-            }
-            data.push_back(value);
+        _config.spiMaster->SelectSlave();
+        SPI::SPIStatus spiStatus = _config.spiMaster->TransmitReceive(txData, rxData);
+        _config.spiMaster->DeselectSlave();
+
+        if (spiStatus != SPI::SPIStatus::OK || rxData.size() < txData.size()) {
+            return convertSpiStatus(spiStatus);
         }
 
+        data.assign(rxData.begin() + 1, rxData.end());
         return NFCStatus::OK;
     }
 
     NFCStatus ST25R3911B::WriteRegisters(uint8_t startReg, const std::vector<uint8_t>& data)
     {
-        if (!_config.spiMaster || !isValidRegister(startReg) || data.empty()) {
+        if (!_config.spiMaster || !isValidRegister(startReg) || data.empty() ||
+            !isValidRegister(static_cast<uint8_t>(startReg + data.size() - 1))) {
             return NFCStatus::INVALID_PARAM;
         }
 
-        for (size_t i = 0; i < data.size(); ++i) {
-            NFCStatus status = WriteRegister(startReg + static_cast<uint8_t>(i), data[i]);
-            if (status != NFCStatus::OK) {
-                return status;
-            }
-        }
+        // Single frame, the address auto-increments after each data byte
+        std::vector<uint8_t> txData;
+        txData.reserve(data.size() + 1);
+        txData.push_back(static_cast<uint8_t>(startReg | ::ST25R3911B::SPI_CMD_WRITE));
+        txData.insert(txData.end(), data.begin(), data.end());
 
-        return NFCStatus::OK;
+        _config.spiMaster->SelectSlave();
+        SPI::SPIStatus spiStatus = _config.spiMaster->Transmit(txData);
+        _config.spiMaster->DeselectSlave();
+
+        return convertSpiStatus(spiStatus);
     }
 
     NFCStatus ST25R3911B::ExecuteCommand(uint8_t cmd)
@@ -331,17 +364,14 @@ namespace NFC
 
     NFCStatus ST25R3911B::GetFifoStatus(uint8_t& bytesInFifo, bool& fifoFull)
     {
-        uint8_t status1, status2;
-        NFCStatus result = ReadRegister(::ST25R3911B::REG_FIFO_RX_STATUS1, status1);
-        if (result != NFCStatus::OK) {
-            return result;
-        }
-
-        result = ReadRegister(::ST25R3911B::REG_FIFO_RX_STATUS2, status2);
+        std::vector<uint8_t> fifoStatus;
+        NFCStatus result = ReadRegisters(::ST25R3911B::REG_FIFO_RX_STATUS1, fifoStatus, 2);
         if (result != NFCStatus::OK) {
             return result;
         }
 
+        uint8_t status1 = fifoStatus[0];
+        uint8_t status2 = fifoStatus[1];
         bytesInFifo = (status2 & 0x80) ? ((status1 & 0x7F) | 0x80) : (status1 & 0x7F);
         fifoFull = (bytesInFifo >= ::ST25R3911B::FIFO_SIZE);
 
@@ -396,32 +426,22 @@ namespace NFC
 
     NFCStatus ST25R3911B::GetInterruptStatus(uint8_t& mainIrq, uint8_t& timerNfcIrq, uint8_t& errorWupIrq)
     {
-        NFCStatus status = ReadRegister(::ST25R3911B::REG_IRQ_MAIN, mainIrq);
+        // The three interrupt registers are adjacent: one burst read
+        std::vector<uint8_t> irq;
+        NFCStatus status = ReadRegisters(::ST25R3911B::REG_IRQ_MAIN, irq, 3);
         if (status != NFCStatus::OK) {
             return status;
         }
 
-        status = ReadRegister(::ST25R3911B::REG_IRQ_TIMER_NFC, timerNfcIrq);
-        if (status != NFCStatus::OK) {
-            return status;
-        }
-
-        return ReadRegister(::ST25R3911B::REG_IRQ_ERROR_WUP, errorWupIrq);
+        mainIrq = irq[0];
+        timerNfcIrq = irq[1];
+        errorWupIrq = irq[2];
+        return NFCStatus::OK;
     }
 
     NFCStatus ST25R3911B::ClearInterrupts(uint8_t mainIrq, uint8_t timerNfcIrq, uint8_t errorWupIrq)
     {
-        NFCStatus status = WriteRegister(::ST25R3911B::REG_IRQ_MAIN, mainIrq);
-        if (status != NFCStatus::OK) {
-            return status;
-        }
-
-        status = WriteRegister(::ST25R3911B::REG_IRQ_TIMER_NFC, timerNfcIrq);
-        if (status != NFCStatus::OK) {
-            return status;
-        }
-
-        return WriteRegister(::ST25R3911B::REG_IRQ_ERROR_WUP, errorWupIrq);
+        return WriteRegisters(::ST25R3911B::REG_IRQ_MAIN, { mainIrq, timerNfcIrq, errorWupIrq });
     }
 
     NFCStatus ST25R3911B::SetInterruptMasks(uint8_t mainMask, uint8_t timerNfcMask, uint8_t errorWupMask)
@@ -454,6 +474,150 @@ namespace NFC
     // ============================================================================
 
     NFCStatus ST25R3911B::Transmit(const std::vector<uint8_t>& data, bool crc)
+    {
+        if (_currentProtocol == NFCProtocol::NFC_V) {
+            // Stream mode: the driver codes the frame, the chip only modulates
+            std::vector<uint8_t> stream;
+            encodeIso15693(data, crc, stream);
+            return transmitFrame(stream, 0, false);
+        }
+        return transmitFrame(data, 0, crc);
+    }
+
+    NFCStatus ST25R3911B::Receive(std::vector<uint8_t>& data, uint32_t timeoutMs)
+    {
+        return receiveFrame(data, timeoutMs, nullptr);
+    }
+
+    NFCStatus ST25R3911B::ReceiveSlot(std::vector<uint8_t>& data, uint32_t timeoutMs)
+    {
+        return receiveFrame(data, timeoutMs, nullptr, false);
+    }
+
+    NFCStatus ST25R3911B::ReceiveNext(std::vector<uint8_t>& data, uint32_t timeoutMs)
+    {
+        NFCStatus status = ExecuteCommand(::ST25R3911B::CMD_UNMASK_RECEIVE_DATA);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        return receiveFrame(data, timeoutMs, nullptr, false);
+    }
+
+    NFCStatus ST25R3911B::NextInventorySlot(std::vector<uint8_t>& data, uint32_t timeoutMs)
+    {
+        if (_currentProtocol != NFCProtocol::NFC_V) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        NFCStatus status = transmitFrame({ ISO15693_EOF_1OF4 }, 0, false);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+        return receiveFrame(data, timeoutMs, nullptr, false);
+    }
+
+    NFCStatus ST25R3911B::TransmitReceive(const std::vector<uint8_t>& txData, std::vector<uint8_t>& rxData, uint32_t timeoutMs, bool crc)
+    {
+        NFCStatus status = Transmit(txData, crc);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        return Receive(rxData, timeoutMs);
+    }
+
+    NFCStatus ST25R3911B::TransceiveAnticollision(const std::vector<uint8_t>& txData, uint8_t txLastBits,
+                                                  std::vector<uint8_t>& rxData, uint16_t& collisionBit, uint32_t timeoutMs)
+    {
+        if (txLastBits > 7) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        // Anticollision frames: the receiver continues after a collision and aligns the split byte
+        NFCStatus status = ModifyRegister(::ST25R3911B::REG_ISO14443A_NFC, ::ST25R3911B::ISO14443A_ANTCL, ::ST25R3911B::ISO14443A_ANTCL);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        status = transmitFrame(txData, txLastBits, false);
+        if (status == NFCStatus::OK) {
+            status = receiveFrame(rxData, timeoutMs, &collisionBit, false);
+        }
+
+        ModifyRegister(::ST25R3911B::REG_ISO14443A_NFC, ::ST25R3911B::ISO14443A_ANTCL, 0);
+        return status;
+    }
+
+    NFCStatus ST25R3911B::TransceiveWithParity(const std::vector<uint8_t>& txData, const std::vector<uint8_t>& txParity,
+                                               std::vector<uint8_t>& rxData, std::vector<uint8_t>& rxParity, uint32_t timeoutMs)
+    {
+        if (txData.empty() || txParity.size() != txData.size() || _currentProtocol == NFCProtocol::NFC_V) {
+            return NFCStatus::INVALID_PARAM;
+        }
+
+        // Bit stream: 8 data bits LSB first, then the parity bit of the byte
+        std::vector<uint8_t> stream((txData.size() * 9 + 7) / 8, 0x00);
+        size_t position = 0;
+        for (size_t i = 0; i < txData.size(); ++i) {
+            uint16_t bits = static_cast<uint16_t>(txData[i] | ((txParity[i] & 0x01) << 8));
+            for (uint8_t bit = 0; bit < 9; ++bit, ++position) {
+                stream[position / 8] |= static_cast<uint8_t>(((bits >> bit) & 0x01) << (position % 8));
+            }
+        }
+
+        uint8_t noParity = ::ST25R3911B::ISO14443A_NO_TX_PAR | ::ST25R3911B::ISO14443A_NO_RX_PAR;
+        NFCStatus status = ModifyRegister(::ST25R3911B::REG_ISO14443A_NFC, noParity, noParity);
+        if (status == NFCStatus::OK) {
+            status = ModifyRegister(::ST25R3911B::REG_AUX, ::ST25R3911B::AUX_NO_CRC_RX, ::ST25R3911B::AUX_NO_CRC_RX);
+        }
+
+        std::vector<uint8_t> raw;
+        uint8_t fifoStatus2 = 0;
+        if (status == NFCStatus::OK) {
+            status = transmitFrame(stream, static_cast<uint8_t>(position % 8), false);
+        }
+        if (status == NFCStatus::OK) {
+            status = receiveFrame(raw, timeoutMs, nullptr);
+        }
+        if (status == NFCStatus::OK) {
+            status = ReadRegister(::ST25R3911B::REG_FIFO_RX_STATUS2, fifoStatus2);
+        }
+
+        ModifyRegister(::ST25R3911B::REG_AUX, ::ST25R3911B::AUX_NO_CRC_RX, 0);
+        ModifyRegister(::ST25R3911B::REG_ISO14443A_NFC, noParity, 0);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        // Split the received bit stream into bytes and parity bits
+        size_t receivedBits = raw.size() * 8;
+        uint8_t lastBits = (fifoStatus2 & ::ST25R3911B::FIFO_STATUS2_LB_MASK) >> ::ST25R3911B::FIFO_STATUS2_LB_SHIFT;
+        if (lastBits && receivedBits) {
+            receivedBits -= 8 - lastBits;
+        }
+        auto bitAt = [&raw](size_t index) { return static_cast<uint8_t>((raw[index / 8] >> (index % 8)) & 0x01); };
+
+        rxData.clear();
+        rxParity.clear();
+        for (position = 0; position + 9 <= receivedBits; position += 9) {
+            uint8_t value = 0;
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                value |= static_cast<uint8_t>(bitAt(position + bit) << bit);
+            }
+            rxData.push_back(value);
+            rxParity.push_back(bitAt(position + 8));
+        }
+        if (position < receivedBits) {
+            uint8_t value = 0;
+            for (uint8_t bit = 0; position + bit < receivedBits && bit < 8; ++bit) {
+                value |= static_cast<uint8_t>(bitAt(position + bit) << bit);
+            }
+            rxData.push_back(value);
+        }
+        return NFCStatus::OK;
+    }
+
+    NFCStatus ST25R3911B::transmitFrame(const std::vector<uint8_t>& data, uint8_t lastBits, bool crc)
     {
         if (!_config.spiMaster || data.empty()) {
             return NFCStatus::INVALID_PARAM;
@@ -465,18 +629,75 @@ namespace NFC
             return status;
         }
 
-        // Write data to FIFO
-        status = WriteFifo(data);
+        // Frame length: complete bytes and valid bits of the last byte
+        uint16_t fullBytes = static_cast<uint16_t>(data.size() - (lastBits ? 1 : 0));
+        status = WriteRegisters(::ST25R3911B::REG_NUM_TX_BYTES1,
+                                { static_cast<uint8_t>(fullBytes >> 5),
+                                  static_cast<uint8_t>(((fullBytes & 0x1F) << ::ST25R3911B::NUM_TX_BYTES2_SHIFT) |
+                                                       (lastBits & ::ST25R3911B::NUM_TX_BYTES2_NBTX_MASK)) });
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        // Write data to FIFO: a frame longer than the FIFO is completed while it is sent
+        size_t loaded = std::min(data.size(), static_cast<size_t>(::ST25R3911B::FIFO_SIZE));
+        status = WriteFifo(loaded == data.size() ? data : std::vector<uint8_t>(data.begin(), data.begin() + loaded));
         if (status != NFCStatus::OK) {
             return status;
         }
 
         // Execute transmit command
         uint8_t cmd = crc ? ::ST25R3911B::CMD_TRANSMIT_WITH_CRC : ::ST25R3911B::CMD_TRANSMIT_WITHOUT_CRC;
-        return ExecuteCommand(cmd);
+        status = ExecuteCommand(cmd);
+        if (status != NFCStatus::OK || loaded == data.size()) {
+            return status;
+        }
+
+        return streamFifo(data, loaded);
     }
 
-    NFCStatus ST25R3911B::Receive(std::vector<uint8_t>& data, uint32_t timeoutMs)
+    NFCStatus ST25R3911B::streamFifo(const std::vector<uint8_t>& data, size_t loaded)
+    {
+        uint32_t startTime = xTaskGetTickCount();
+        uint32_t timeoutTicks = pdMS_TO_TICKS(_config.timeoutMs);
+        uint8_t mainIrq, timerNfcIrq, errorWupIrq;
+
+        // Refill on every water level interrupt, one free FIFO portion at a time
+        while (loaded < data.size()) {
+            NFCStatus status = waitForInterrupt(startTime, timeoutTicks);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            status = GetInterruptStatus(mainIrq, timerNfcIrq, errorWupIrq);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            if (!(mainIrq & ::ST25R3911B::IRQ_MAIN_FWL)) {
+                // Transmission ended before the frame was complete
+                return NFCStatus::COMMUNICATION_ERROR;
+            }
+            ClearInterrupts(::ST25R3911B::IRQ_MAIN_FWL, 0, 0);
+
+            // Other events belong to the reception that follows: leave them to receiveFrame()
+            if ((mainIrq & ~::ST25R3911B::IRQ_MAIN_FWL) || timerNfcIrq || errorWupIrq) {
+                _interruptPending = true;
+            }
+
+            size_t chunk = std::min(data.size() - loaded,
+                                    static_cast<size_t>(::ST25R3911B::FIFO_SIZE - ::ST25R3911B::FIFO_TX_WATER_LEVEL));
+            status = WriteFifo(std::vector<uint8_t>(data.begin() + loaded, data.begin() + loaded + chunk));
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            loaded += chunk;
+        }
+
+        return NFCStatus::OK;
+    }
+
+    NFCStatus ST25R3911B::receiveFrame(std::vector<uint8_t>& data, uint32_t timeoutMs, uint16_t* collisionBit, bool expected)
     {
         if (!_config.spiMaster) {
             return NFCStatus::INVALID_PARAM;
@@ -486,55 +707,293 @@ namespace NFC
             timeoutMs = _config.timeoutMs;
         }
 
-        // Wait for receive complete interrupt
-        NFCStatus status = waitForInterrupt(timeoutMs);
-        if (status != NFCStatus::OK) {
-            return status;
+        uint32_t startTime = xTaskGetTickCount();
+        uint32_t timeoutTicks = pdMS_TO_TICKS(timeoutMs);
+        uint8_t mainIrq, timerNfcIrq, errorWupIrq;
+        bool collision = false;
+        bool receiving = false;
+        NFCStatus status;
+
+        data.clear();
+
+        // TXE and RXS only report progress: wait until the reception ends or fails
+        while (true) {
+            status = waitForInterrupt(startTime, timeoutTicks);
+            if (status == NFCStatus::TIMEOUT) {
+                _errorCounters.timeout++;
+                if (expected) {
+                    reportSignalLoss();
+                }
+            }
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            status = GetInterruptStatus(mainIrq, timerNfcIrq, errorWupIrq);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+
+            // Acknowledge, so that the next event raises the IRQ line again
+            ClearInterrupts(mainIrq, timerNfcIrq, errorWupIrq);
+
+            // Fail fast on a corrupted frame instead of waiting for the timeout
+            if (errorWupIrq & ::ST25R3911B::IRQ_ERR_MASK) {
+                return classifyReceiveError(errorWupIrq);
+            }
+
+            if (mainIrq & ::ST25R3911B::IRQ_MAIN_COL) {
+                _errorCounters.collision++;
+                if (!collisionBit) {
+                    return NFCStatus::COLLISION_ERROR;
+                }
+
+                // Anticollision: remember where the collision is and receive the rest
+                uint8_t display;
+                status = ReadRegister(::ST25R3911B::REG_COLLISION_DISPLAY, display);
+                if (status != NFCStatus::OK) {
+                    return status;
+                }
+                *collisionBit = static_cast<uint16_t>(((display & ::ST25R3911B::COLL_BYTE_MASK) >> ::ST25R3911B::COLL_BYTE_SHIFT) * 8 +
+                                                      ((display & ::ST25R3911B::COLL_BIT_MASK) >> ::ST25R3911B::COLL_BIT_SHIFT));
+                collision = true;
+            }
+
+            if (mainIrq & ::ST25R3911B::IRQ_MAIN_RXE) {
+                break;
+            }
+
+            // Frames longer than the FIFO: drain it while the reception continues
+            // (before RXS the water level interrupt belongs to the transmission)
+            receiving = receiving || (mainIrq & ::ST25R3911B::IRQ_MAIN_RXS);
+            if (receiving && (mainIrq & ::ST25R3911B::IRQ_MAIN_FWL)) {
+                status = drainFifo(data);
+                if (status != NFCStatus::OK) {
+                    return status;
+                }
+            }
+
+            // No-response timer expired: the tag did not answer
+            if (timerNfcIrq & ::ST25R3911B::IRQ_TIMER_NRT) {
+                _errorCounters.timeout++;
+                if (expected) {
+                    reportSignalLoss();
+                }
+                return NFCStatus::TIMEOUT;
+            }
         }
 
-        // Check interrupt status
-        uint8_t mainIrq, timerNfcIrq, errorWupIrq;
-        status = GetInterruptStatus(mainIrq, timerNfcIrq, errorWupIrq);
+        // Read the rest of the frame
+        status = drainFifo(data);
+
+        // Capture receiver state of this frame
+        if (status == NFCStatus::OK && _signalCapture) {
+            captureSignalQuality();
+        }
+
+        if (status == NFCStatus::OK && collision) {
+            return NFCStatus::COLLISION_ERROR;
+        }
+        if (status == NFCStatus::OK && _currentProtocol == NFCProtocol::NFC_V) {
+            status = decodeIso15693(data);
+        }
+        return status;
+    }
+
+    NFCStatus ST25R3911B::drainFifo(std::vector<uint8_t>& data)
+    {
+        // Get FIFO status
+        std::vector<uint8_t> fifoStatus;
+        NFCStatus status = ReadRegisters(::ST25R3911B::REG_FIFO_RX_STATUS1, fifoStatus, 2);
         if (status != NFCStatus::OK) {
             return status;
         }
 
-        // Check for errors
-        if (mainIrq & ::ST25R3911B::IRQ_MAIN_COL) {
-            return NFCStatus::COLLISION_ERROR;
+        if (fifoStatus[1] & ::ST25R3911B::FIFO_STATUS2_OVR) {
+            _errorCounters.fifoOverflow++;
+            return NFCStatus::FIFO_OVERFLOW;
         }
 
-        // Check for receive complete
-        if (mainIrq & ::ST25R3911B::IRQ_MAIN_RXE) {
-            // Get FIFO status
-            uint8_t bytesInFifo;
-            bool fifoFull;
-            status = GetFifoStatus(bytesInFifo, fifoFull);
-            if (status != NFCStatus::OK) {
-                return status;
+        uint8_t bytesInFifo = (fifoStatus[1] & ::ST25R3911B::FIFO_STATUS2_B7) ?
+                              ((fifoStatus[0] & 0x7F) | 0x80) : (fifoStatus[0] & 0x7F);
+        if (bytesInFifo == 0) {
+            return NFCStatus::OK;
+        }
+
+        std::vector<uint8_t> chunk;
+        status = ReadFifo(chunk, bytesInFifo);
+        if (status == NFCStatus::OK) {
+            data.insert(data.end(), chunk.begin(), chunk.end());
+        }
+        return status;
+    }
+
+    // ============================================================================
+    // ISO15693 Stream Coding
+    // ============================================================================
+
+    void ST25R3911B::encodeIso15693(const std::vector<uint8_t>& data, bool crc, std::vector<uint8_t>& stream)
+    {
+        std::vector<uint8_t> frame = data;
+        if (crc) {
+            uint16_t value = crcIso15693(frame.data(), frame.size());
+            frame.push_back(static_cast<uint8_t>(value & 0xFF));
+            frame.push_back(static_cast<uint8_t>(value >> 8));
+        }
+
+        // One stream byte per bit pair: the pulse sits in the odd position 2 * value + 1
+        stream.clear();
+        stream.reserve(frame.size() * 4 + 2);
+        stream.push_back(ISO15693_SOF_1OF4);
+        for (const uint8_t byte : frame) {
+            for (uint8_t shift = 0; shift < 8; shift += 2) {
+                stream.push_back(static_cast<uint8_t>(0x02 << (((byte >> shift) & 0x03) * 2)));
             }
+        }
+        stream.push_back(ISO15693_EOF_1OF4);
+    }
 
-            // Read data from FIFO
-            if (bytesInFifo > 0) {
-                status = ReadFifo(data, bytesInFifo);
+    NFCStatus ST25R3911B::decodeIso15693(std::vector<uint8_t>& data)
+    {
+        const std::vector<uint8_t> stream = data;
+        const size_t totalBits = stream.size() * 8;
+        auto halfBits = [&stream](size_t position, uint8_t count) {
+            uint8_t value = 0;
+            for (uint8_t i = 0; i < count; ++i) {
+                value |= static_cast<uint8_t>(((stream[(position + i) / 8] >> ((position + i) % 8)) & 0x01) << i);
             }
+            return value;
+        };
+        // EOF only counts at a byte boundary and when nothing but silence follows
+        auto isEof = [&](size_t position) {
+            if (position + 5 > totalBits || halfBits(position, 5) != ISO15693_EOF_RX) {
+                return false;
+            }
+            for (size_t i = position + 5; i < totalBits; ++i) {
+                if (halfBits(i, 1)) {
+                    return false;
+                }
+            }
+            return true;
+        };
 
-            // Clear interrupts
-            ClearInterrupts(mainIrq, timerNfcIrq, errorWupIrq);
-            return status;
+        data.clear();
+        if (totalBits < 5 || halfBits(0, 5) != ISO15693_SOF_RX) {
+            _errorCounters.hardFraming++;
+            return NFCStatus::FRAMING_ERROR;
+        }
+
+        // Manchester: subcarrier in the first half is a 0, in the second half a 1, in both halves a collision
+        size_t position = 5;
+        uint8_t value = 0;
+        uint8_t bits = 0;
+        bool collision = false;
+        bool eof = false;
+        while (position + 2 <= totalBits) {
+            if (bits == 0 && isEof(position)) {
+                eof = true;
+                break;
+            }
+            uint8_t pair = halfBits(position, 2);
+            position += 2;
+            if (pair == 0x00) {
+                break;
+            }
+            if (pair == 0x03) {
+                collision = true;
+            } else if (pair == 0x02) {
+                value |= static_cast<uint8_t>(1 << bits);
+            }
+            if (++bits == 8) {
+                data.push_back(value);
+                value = 0;
+                bits = 0;
+            }
+        }
+
+        if (collision) {
+            _errorCounters.collision++;
+            return NFCStatus::COLLISION_ERROR;
+        }
+        if (!eof) {
+            _errorCounters.hardFraming++;
+            return NFCStatus::FRAMING_ERROR;
+        }
+        if (data.size() < 3 ||
+            crcIso15693(data.data(), data.size() - 2) != static_cast<uint16_t>(data[data.size() - 2] | (data[data.size() - 1] << 8))) {
+            _errorCounters.crc++;
+            return NFCStatus::CRC_ERROR;
+        }
+
+        data.resize(data.size() - 2);
+        return NFCStatus::OK;
+    }
+
+    uint16_t ST25R3911B::crcIso15693(const uint8_t* data, size_t length)
+    {
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0x8408) : static_cast<uint16_t>(crc >> 1);
+            }
         }
+        return static_cast<uint16_t>(~crc);
+    }
+
+    NFCStatus ST25R3911B::SetNoResponseTimer(uint32_t timeoutUs)
+    {
+        // 64/fc = 4.72 us per step
+        uint32_t steps = (timeoutUs >= 309000) ? 0xFFFF : (timeoutUs * 100 + 471) / 472;
 
-        return NFCStatus::TIMEOUT;
+        return WriteRegisters(::ST25R3911B::REG_TIM_CONF1,
+                              { static_cast<uint8_t>(steps >> 8), static_cast<uint8_t>(steps & 0xFF) });
     }
 
-    NFCStatus ST25R3911B::TransmitReceive(const std::vector<uint8_t>& txData, std::vector<uint8_t>& rxData, uint32_t timeoutMs)
+    // ============================================================================
+    // Signal Quality Operations
+    // ============================================================================
+
+    NFCStatus ST25R3911B::SetReceiverBoost(bool enable)
     {
-        NFCStatus status = Transmit(txData, true);
+        if (enable == _receiverBoosted) {
+            return NFCStatus::OK;
+        }
+
+        NFCStatus status;
+        if (enable) {
+            // Remember the configured receiver settings
+            std::vector<uint8_t> rxConf;
+            status = ReadRegisters(::ST25R3911B::REG_RX_CONF3, rxConf, 2);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            _savedRxConf3 = rxConf[0];
+            _savedRxConf4 = rxConf[1];
+
+            // Maximum first stage gain, no fixed gain reduction
+            status = WriteRegister(::ST25R3911B::REG_RX_CONF3,
+                                   (_savedRxConf3 & ~::ST25R3911B::RX_CONF3_RG1_MASK) | ::ST25R3911B::RX_CONF3_RG1_MAX);
+            if (status == NFCStatus::OK) {
+                status = WriteRegister(::ST25R3911B::REG_RX_CONF4, ::ST25R3911B::RX_CONF4_RG2_NONE);
+            }
+        } else {
+            status = WriteRegister(::ST25R3911B::REG_RX_CONF3, _savedRxConf3);
+            if (status == NFCStatus::OK) {
+                status = WriteRegister(::ST25R3911B::REG_RX_CONF4, _savedRxConf4);
+            }
+        }
+
         if (status != NFCStatus::OK) {
             return status;
         }
 
-        return Receive(rxData, timeoutMs);
+        // Restart the AGC from the new setting
+        status = ExecuteCommand(::ST25R3911B::CMD_RESET_RXGAIN);
+        if (status == NFCStatus::OK) {
+            _receiverBoosted = enable;
+        }
+        return status;
     }
 
     // ============================================================================
@@ -554,11 +1013,12 @@ namespace NFC
             return status;
         }
 
-        // Set default interrupt masks (enable main interrupts)
+        // Set default interrupt masks (enable main, FIFO water level, no-response timer and receive error interrupts)
         status = SetInterruptMasks(
             ::ST25R3911B::IRQ_MAIN_RXS | ::ST25R3911B::IRQ_MAIN_RXE | 
-            ::ST25R3911B::IRQ_MAIN_TXE | ::ST25R3911B::IRQ_MAIN_COL,
-            0x00, 0x00);
+            ::ST25R3911B::IRQ_MAIN_TXE | ::ST25R3911B::IRQ_MAIN_COL | ::ST25R3911B::IRQ_MAIN_FWL,
+            ::ST25R3911B::IRQ_TIMER_NRT,
+            ::ST25R3911B::IRQ_ERR_MASK);
         if (status != NFCStatus::OK) {
             return status;
         }
@@ -577,26 +1037,29 @@ namespace NFC
         switch (protocol) {
             case NFCProtocol::NFC_A:
                 modeValue = ::ST25R3911B::MODE_OM_ISO14443A;
-                // Configure ISO14443A specific settings
-                status = WriteRegister(::ST25R3911B::REG_ISO14443A_NFC, 0x88);
+                // Standard ISO14443A framing: parity generated and checked, no anticollision mode
+                status = WriteRegister(::ST25R3911B::REG_ISO14443A_NFC, 0x00);
                 break;
 
             case NFCProtocol::NFC_B:
                 modeValue = ::ST25R3911B::MODE_OM_ISO14443B;
-                // Configure ISO14443B specific settings
+                // ISO14443-3 framing: SOF 10 etu low / 2 etu high, EOF 10 etu, no extra guard time
                 status = WriteRegister(::ST25R3911B::REG_ISO14443B, 0x00);
                 break;
 
             case NFCProtocol::NFC_F:
                 modeValue = ::ST25R3911B::MODE_OM_FELICA;
-                // Configure FeliCa specific settings
-                status = WriteRegister(::ST25R3911B::REG_BIT_RATE, 0x00);
+                // FeliCa polling runs at 212 kbps, 424 kbps is selected with SetBitRate()
+                status = SetBitRate(NFCBitRate::BR_212);
                 break;
 
             case NFCProtocol::NFC_V:
-                // ISO15693 uses subcarrier mode
+                // ISO15693 uses subcarrier stream mode: fc/32 subcarrier reported per half bit,
+                // 1-of-4 pulse positions sent in 128/fc steps (coding and decoding in the driver)
                 modeValue = ::ST25R3911B::MODE_OM_SUBCARRIER;
-                status = WriteRegister(::ST25R3911B::REG_STREAM_MODE, 0x00);
+                status = WriteRegister(::ST25R3911B::REG_STREAM_MODE,
+                                       ::ST25R3911B::STREAM_SCF_SC424 | ::ST25R3911B::STREAM_SCP_8PULSES |
+                                       ::ST25R3911B::STREAM_STX_106);
                 break;
 
             case NFCProtocol::NFC_P2P:
@@ -606,14 +1069,18 @@ namespace NFC
 
             case NFCProtocol::MIFARE_CLASSIC:
                 modeValue = ::ST25R3911B::MODE_OM_ISO14443A;
-                // MIFARE Classic uses ISO14443A with specific settings
-                status = WriteRegister(::ST25R3911B::REG_ISO14443A_NFC, 0x88);
+                // Plain ISO14443A framing, encrypted frames switch parity per exchange (TransceiveWithParity)
+                status = WriteRegister(::ST25R3911B::REG_ISO14443A_NFC, 0x00);
                 break;
 
             default:
                 return NFCStatus::INVALID_PARAM;
         }
 
+        // Every other protocol starts at 106 kbps (e.g. after FeliCa)
+        if (status == NFCStatus::OK && protocol != NFCProtocol::NFC_F) {
+            status = SetBitRate(NFCBitRate::BR_106);
+        }
         if (status != NFCStatus::OK) {
             return status;
         }
@@ -622,13 +1089,10 @@ namespace NFC
         return ModifyRegister(::ST25R3911B::REG_MODE, ::ST25R3911B::MODE_OM_MASK, modeValue);
     }
 
-    NFCStatus ST25R3911B::waitForInterrupt(uint32_t timeoutMs)
+    NFCStatus ST25R3911B::waitForInterrupt(uint32_t startTick, uint32_t timeoutTicks)
     {
-        uint32_t startTime = xTaskGetTickCount();
-        uint32_t timeoutTicks = pdMS_TO_TICKS(timeoutMs);
-
         while (!_interruptPending) {
-            if ((xTaskGetTickCount() - startTime) >= timeoutTicks) {
+            if ((xTaskGetTickCount() - startTick) >= timeoutTicks) {
                 return NFCStatus::TIMEOUT;
             }
             SafeDelay(1);
@@ -638,6 +1102,68 @@ namespace NFC
         return NFCStatus::OK;
     }
 
+    NFCStatus ST25R3911B::classifyReceiveError(uint8_t errorIrq)
+    {
+        if (errorIrq & ::ST25R3911B::IRQ_ERR_CRC) {
+            _errorCounters.crc++;
+        }
+        if (errorIrq & ::ST25R3911B::IRQ_ERR_PAR) {
+            _errorCounters.parity++;
+        }
+        if (errorIrq & ::ST25R3911B::IRQ_ERR_ERR1) {
+            _errorCounters.hardFraming++;
+        }
+        if (errorIrq & ::ST25R3911B::IRQ_ERR_ERR2) {
+            _errorCounters.softFraming++;
+        }
+
+        // Most severe first: an aborted reception explains any other flag
+        if (errorIrq & ::ST25R3911B::IRQ_ERR_ERR1) {
+            return NFCStatus::FRAMING_ERROR;
+        }
+        if (errorIrq & ::ST25R3911B::IRQ_ERR_PAR) {
+            return NFCStatus::PARITY_ERROR;
+        }
+        if (errorIrq & ::ST25R3911B::IRQ_ERR_CRC) {
+            return NFCStatus::CRC_ERROR;
+        }
+        return NFCStatus::SOFT_FRAMING_ERROR;
+    }
+
+    NFCStatus ST25R3911B::captureSignalQuality(void)
+    {
+        // RSSI display 1/2 and gain reduction state are adjacent: one burst read
+        std::vector<uint8_t> values;
+        NFCStatus status = ReadRegisters(::ST25R3911B::REG_RSSI_DISPLAY1, values, 3);
+        if (status != NFCStatus::OK) {
+            return status;
+        }
+
+        _lastSignal.rssiAm = values[0] & ::ST25R3911B::RSSI_MASK;
+        _lastSignal.rssiPm = values[1] & ::ST25R3911B::RSSI_MASK;
+        _lastSignal.gainReductionAm = (values[2] & ::ST25R3911B::GAIN_RED_AM_MASK) >> ::ST25R3911B::GAIN_RED_AM_SHIFT;
+        _lastSignal.gainReductionPm = values[2] & ::ST25R3911B::GAIN_RED_PM_MASK;
+        _lastSignal.received = true;
+
+        if (_signalCallback) {
+            _signalCallback(_lastSignal);
+        }
+
+        return NFCStatus::OK;
+    }
+
+    void ST25R3911B::reportSignalLoss(void)
+    {
+        if (!_signalCapture) {
+            return;
+        }
+
+        _lastSignal = SignalQuality{0, 0, 0, 0, false};
+        if (_signalCallback) {
+            _signalCallback(_lastSignal);
+        }
+    }
+
     NFCStatus ST25R3911B::convertSpiStatus(SPI::SPIStatus spiStatus)
     {
         switch (spiStatus) {
@@ -0,0 +1,240 @@
+/**
+ * @file    App/Src/tagMemoryCache.cpp
+ * @brief   Tag Memory Image Cache Implementation
+ * @details This file contains the implementation of the per-UID tag memory images.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "tagMemoryCache.h"
+#include <algorithm>
+
+namespace NFC
+{
+    // ============================================================================
+    // Bitmaps
+    // ============================================================================
+
+    /**
+     * @brief Test a unit bit
+     * @param bitmap Bitmap
+     * @param unit Unit index
+     * @return true if the bit is set
+     */
+    static bool testUnit(const std::vector<uint32_t>& bitmap, uint32_t unit)
+    {
+        return unit / 32 < bitmap.size() && (bitmap[unit / 32] & (1UL << (unit % 32)));
+    }
+
+    /**
+     * @brief Set or clear a unit bit
+     * @param bitmap Bitmap (grown by the caller)
+     * @param unit Unit index
+     * @param value Bit value
+     */
+    static void setUnit(std::vector<uint32_t>& bitmap, uint32_t unit, bool value)
+    {
+        if (value) {
+            bitmap[unit / 32] |= 1UL << (unit % 32);
+        } else {
+            bitmap[unit / 32] &= ~(1UL << (unit % 32));
+        }
+    }
+
+    /**
+     * @brief Grow an image to hold a number of units
+     * @param image Tag image
+     * @param units Number of units from address 0
+     */
+    static void growImage(TagMemoryImage& image, uint32_t units)
+    {
+        if (image.bytes.size() < units * image.unitSize) {
+            image.bytes.resize(units * image.unitSize, 0x00);
+            image.valid.resize((units + 31) / 32, 0);
+            image.dirty.resize((units + 31) / 32, 0);
+        }
+    }
+
+    // ============================================================================
+    // TagMemoryCache Implementation
+    // ============================================================================
+
+    TagMemoryCache::TagMemoryCache(void)
+        : _config{true, 2, 2048}
+        , _stats{}
+        , _sequence(0)
+    {
+    }
+
+    NFCStatus TagMemoryCache::Read(const TagInfo& tagInfo, uint16_t unitSize, uint32_t address, uint32_t length,
+                                   const FetchFunction& fetch, std::vector<uint8_t>& data)
+    {
+        if (length == 0 || unitSize == 0) {
+            return fetch(address, length, data);
+        }
+        uint32_t first = address / unitSize;
+        uint32_t last = (address + length - 1) / unitSize;
+        TagMemoryImage* image = ((last + 1) * unitSize <= _config.maxImageSize) ? acquire(tagInfo, unitSize) : nullptr;
+        if (!image) {
+            return fetch(address, length, data);
+        }
+
+        // One fetch from the first to the last unit that is not cached
+        uint32_t missingFirst = last + 1;
+        uint32_t missingLast = 0;
+        for (uint32_t unit = first; unit <= last; unit++) {
+            if (!IsCached(*image, unit * unitSize)) {
+                missingFirst = std::min(missingFirst, unit);
+                missingLast = unit;
+            }
+        }
+        if (missingFirst <= last) {
+            std::vector<uint8_t> fetched;
+            NFCStatus status = fetch(missingFirst * unitSize, (missingLast - missingFirst + 1) * unitSize, fetched);
+            if (status != NFCStatus::OK) {
+                return status;
+            }
+            uint32_t units = std::min<uint32_t>(static_cast<uint32_t>(fetched.size() / unitSize), missingLast - missingFirst + 1);
+            growImage(*image, missingFirst + units);
+            std::copy(fetched.begin(), fetched.begin() + units * unitSize, image->bytes.begin() + missingFirst * unitSize);
+            for (uint32_t unit = missingFirst; unit < missingFirst + units; unit++) {
+                setUnit(image->valid, unit, true);
+                setUnit(image->dirty, unit, false);
+            }
+            _stats.readsFetched++;
+            _stats.bytesFetched += units * unitSize;
+        } else {
+            _stats.readsServed++;
+            _stats.bytesServed += length;
+        }
+
+        // A short fetch (end of memory) ends the data at the first unit not cached
+        uint32_t end = address + length;
+        for (uint32_t unit = first; unit <= last; unit++) {
+            if (!IsCached(*image, unit * unitSize)) {
+                end = std::max(address, unit * unitSize);
+                break;
+            }
+        }
+        data.assign(image->bytes.begin() + address, image->bytes.begin() + end);
+        return NFCStatus::OK;
+    }
+
+    void TagMemoryCache::Write(const TagInfo& tagInfo, uint16_t unitSize, uint32_t address, const uint8_t* bytes, bool confirmed)
+    {
+        if (unitSize == 0 || address % unitSize || address + unitSize > _config.maxImageSize) {
+            return;
+        }
+        TagMemoryImage* image = acquire(tagInfo, unitSize);
+        if (!image) {
+            return;
+        }
+
+        uint32_t unit = address / unitSize;
+        growImage(*image, unit + 1);
+        std::copy(bytes, bytes + unitSize, image->bytes.begin() + address);
+        setUnit(image->valid, unit, confirmed);
+        setUnit(image->dirty, unit, !confirmed);
+        _stats.unitsWritten++;
+    }
+
+    void TagMemoryCache::Remove(const std::vector<uint8_t>& uid)
+    {
+        auto it = std::find_if(_images.begin(), _images.end(), [&uid](const TagMemoryImage& image) {
+            return image.uid == uid;
+        });
+        if (it != _images.end()) {
+            _images.erase(it);
+            _stats.imagesDropped++;
+        }
+    }
+
+    void TagMemoryCache::Retain(NFCProtocol protocol, const std::vector<TagInfo>& tags)
+    {
+        for (auto it = _images.begin(); it != _images.end();) {
+            bool present = std::any_of(tags.begin(), tags.end(), [&it](const TagInfo& tag) {
+                return tag.uid == it->uid;
+            });
+            if (it->protocol == protocol && !present) {
+                it = _images.erase(it);
+                _stats.imagesDropped++;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void TagMemoryCache::Clear(void)
+    {
+        _stats.imagesDropped += static_cast<uint32_t>(_images.size());
+        _images.clear();
+    }
+
+    const TagMemoryImage* TagMemoryCache::Find(const std::vector<uint8_t>& uid) const
+    {
+        for (const TagMemoryImage& image : _images) {
+            if (image.uid == uid) {
+                return &image;
+            }
+        }
+        return nullptr;
+    }
+
+    bool TagMemoryCache::IsCached(const TagMemoryImage& image, uint32_t address)
+    {
+        uint32_t unit = address / image.unitSize;
+        return testUnit(image.valid, unit) && !testUnit(image.dirty, unit);
+    }
+
+    void TagMemoryCache::SetConfig(const TagMemoryConfig& config)
+    {
+        _config = config;
+        if (!_config.enabled) {
+            Clear();
+        }
+        while (_images.size() > _config.maxTags) {
+            auto oldest = std::min_element(_images.begin(), _images.end(), [](const TagMemoryImage& a, const TagMemoryImage& b) {
+                return a.lastUse < b.lastUse;
+            });
+            _images.erase(oldest);
+            _stats.imagesDropped++;
+        }
+    }
+
+    TagMemoryImage* TagMemoryCache::acquire(const TagInfo& tagInfo, uint16_t unitSize)
+    {
+        if (!_config.enabled || _config.maxTags == 0 || tagInfo.uid.empty() ||
+            (tagInfo.protocol != NFCProtocol::NFC_A && tagInfo.protocol != NFCProtocol::NFC_V)) {
+            return nullptr;
+        }
+
+        TagMemoryImage* image = nullptr;
+        for (TagMemoryImage& entry : _images) {
+            if (entry.uid == tagInfo.uid) {
+                image = &entry;
+                break;
+            }
+        }
+        if (!image) {
+            // Replace the least recently used image
+            if (_images.size() >= _config.maxTags) {
+                auto oldest = std::min_element(_images.begin(), _images.end(), [](const TagMemoryImage& a, const TagMemoryImage& b) {
+                    return a.lastUse < b.lastUse;
+                });
+                _images.erase(oldest);
+                _stats.imagesDropped++;
+            }
+            _images.push_back(TagMemoryImage{tagInfo.uid, tagInfo.protocol, unitSize, {}, {}, {}, 0});
+            image = &_images.back();
+        } else if (image->unitSize != unitSize || image->protocol != tagInfo.protocol) {
+            *image = TagMemoryImage{tagInfo.uid, tagInfo.protocol, unitSize, {}, {}, {}, 0};
+        }
+        image->lastUse = ++_sequence;
+        return image;
+    }
+
+} // namespace NFC
@@ -0,0 +1,314 @@
+/**
+ * @file    Host/Inc/st25r3911bEmulator.h
+ * @brief   ST25R3911B Behavioural Emulator Header
+ * @details This file contains a software model of the ST25R3911B that plugs in behind the
+ *          SPI bus interface. It models the register file, direct commands, the 96-byte FIFO
+ *          with water level, the interrupt registers with their masks and the timers. RF
+ *          responses come from attached virtual tag models. Bus traffic is counted so that the
+ *          SPI cost of high-level operations can be measured without hardware.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef INC_ST25R3911B_EMULATOR_H
+#define INC_ST25R3911B_EMULATOR_H
+
+/**
+ * @include necessary headers
+ */
+#include "spiBus.h"
+#include "st25r3911b_registers.h"
+#include "virtualTags.h"
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @namespace NFC
+ * @brief Contains NFC related functions and definitions.
+ */
+namespace NFC
+{
+    /**
+     * @struct BusStatistics
+     * @brief SPI and RF traffic counters of the emulator.
+     */
+    struct BusStatistics
+    {
+        uint32_t spiFrames;                 /**< SPI frames (CS assertions) */
+        uint32_t spiBytes;                  /**< SPI bytes transferred */
+        uint32_t registerReads;             /**< Register bytes read */
+        uint32_t registerWrites;            /**< Register bytes written */
+        uint32_t fifoBytesLoaded;           /**< Bytes loaded into the FIFO */
+        uint32_t fifoBytesRead;             /**< Bytes read from the FIFO */
+        uint32_t directCommands;            /**< Direct commands executed */
+        uint32_t interrupts;                /**< IRQ line assertions */
+        uint32_t rfFramesTransmitted;       /**< Frames sent to the tags */
+        uint32_t rfFramesReceived;          /**< Frames received from the tags */
+        uint32_t rfBytesTransmitted;        /**< Payload bytes sent to the tags */
+        uint32_t rfBytesReceived;           /**< Payload bytes received from the tags */
+        uint32_t rfCollisions;              /**< Frames with a bit collision */
+        uint32_t rfNoResponses;             /**< Frames without tag response */
+        uint32_t rfErrors;                  /**< Responses received with an error flag */
+    };
+
+    /**
+     * @class ST25R3911BEmulator
+     * @brief Behavioural model of the ST25R3911B seen through the SPI bus.
+     * @details Time is virtual: air time and SPI transfer time are accumulated instead of waited for.
+     */
+    class ST25R3911BEmulator : public SPI::SPIBus
+    {
+        public:
+            /**
+             * @brief Constructor
+             * @param spiClockHz SPI clock used for the transfer time estimate
+             */
+            ST25R3911BEmulator(uint32_t spiClockHz = 10000000);
+
+            /**
+             * @brief Destructor
+             */
+            ~ST25R3911BEmulator() override = default;
+
+            // ============================================================================
+            // SPI Bus Interface
+            // ============================================================================
+
+            bool IsInitialized(void) const override { return true; }
+            void SelectSlave(void) override;
+            void DeselectSlave(void) override;
+            SPI::SPIStatus Transmit(const std::vector<uint8_t> &data) override;
+            SPI::SPIStatus TransmitReceive(const std::vector<uint8_t> &txData, std::vector<uint8_t> &rxData) override;
+
+            // ============================================================================
+            // Model Control
+            // ============================================================================
+
+            /**
+             * @brief Set handler called on a rising edge of the IRQ line
+             * @param handler Handler (typically forwards to ST25R3911B::HandleInterrupt)
+             */
+            void SetIrqHandler(std::function<void(void)> handler) { _irqHandler = handler; }
+
+            /**
+             * @brief Get IRQ line state
+             * @return true if an enabled interrupt is pending
+             */
+            bool IsIrqAsserted(void) const { return _irqLine; }
+
+            /**
+             * @brief Place a virtual tag into the field
+             * @param tag Tag model (not owned)
+             */
+            void AttachTag(VirtualTag* tag);
+
+            /**
+             * @brief Remove a virtual tag from the field
+             * @param tag Tag model
+             */
+            void DetachTag(VirtualTag* tag);
+
+            /**
+             * @brief Remove all virtual tags from the field
+             */
+            void DetachAllTags(void);
+
+            /**
+             * @brief Corrupt the next tag response
+             * @param errorIrq Error interrupt flags to report (CRC, parity, soft or hard framing).
+             *                 A hard framing error aborts the reception, the other errors deliver
+             *                 the data together with the error flag.
+             */
+            void InjectReceiveError(uint8_t errorIrq) { _injectedError = errorIrq; }
+
+            /**
+             * @brief Check if the RF field is on
+             * @return true if oscillator and transmitter are enabled
+             */
+            bool IsFieldOn(void) const { return _fieldOn; }
+
+            /**
+             * @brief Read a register without side effects and without counting traffic
+             * @param reg Register address
+             * @return Register value
+             */
+            uint8_t PeekRegister(uint8_t reg) const { return _registers[reg & 0x3F]; }
+
+            /**
+             * @brief Get traffic counters
+             * @return Reference to counters
+             */
+            const BusStatistics& GetStatistics(void) const { return _stats; }
+
+            /**
+             * @brief Reset traffic counters and the elapsed time
+             */
+            void ResetStatistics(void);
+
+            /**
+             * @brief Get virtual time spent on SPI transfers, air time and timers
+             * @return Elapsed time in microseconds
+             */
+            uint64_t GetElapsedUs(void) const { return _elapsedNs / 1000; }
+
+        private:
+            /**
+             * @enum AccessMode
+             * @brief Kind of SPI frame in progress.
+             */
+            enum class AccessMode
+            {
+                NONE = 0,                       /**< Waiting for the address byte */
+                REGISTER_READ,                  /**< Register read (auto-increment) */
+                REGISTER_WRITE,                 /**< Register write (auto-increment) */
+                IGNORE                          /**< Command or invalid access */
+            };
+
+            uint8_t _registers[64];             /**< Register file */
+            std::vector<uint8_t> _fifo;         /**< FIFO contents (front = oldest) */
+            AccessMode _mode;                   /**< Current SPI access mode */
+            uint8_t _address;                   /**< Current register address */
+            bool _selected;                     /**< Chip select asserted */
+
+            std::vector<uint8_t> _txBuffer;     /**< Frame collected for transmission */
+            size_t _txExpected;                 /**< Bytes still expected for a streamed transmission */
+            size_t _txStreamed;                 /**< Bytes streamed since the last water level interrupt */
+            bool _txCrc;                        /**< Streamed transmission uses CRC */
+            std::vector<RfFrame> _slotResponses; /**< Responses in later time slots (delivered on unmask) */
+            uint8_t _slotCoupling;              /**< Coupling of the strongest responder */
+            uint8_t _currentSlot;               /**< Time slot of the frame being received */
+            std::vector<uint8_t> _rxPending;    /**< Received bytes not yet moved into the FIFO */
+            size_t _rxPendingPos;               /**< Next pending byte */
+            bool _rxActive;                     /**< Reception in progress */
+
+            uint8_t _injectedError;             /**< Error flags for the next response (0 = none) */
+            bool _irqLine;                      /**< IRQ line state */
+            bool _fieldOn;                      /**< RF field state */
+            std::vector<VirtualTag*> _tags;     /**< Tags in the field */
+            std::function<void(void)> _irqHandler; /**< IRQ line handler */
+
+            uint32_t _spiClockHz;               /**< SPI clock */
+            uint64_t _elapsedNs;                /**< Virtual time */
+            BusStatistics _stats;               /**< Traffic counters */
+
+            /**
+             * @brief Process one byte of an SPI frame
+             * @param mosi Byte sent by the host
+             * @return Byte returned to the host
+             */
+            uint8_t processByte(uint8_t mosi);
+
+            /**
+             * @brief Read register with side effects (FIFO pop)
+             * @param reg Register address
+             * @return Register value
+             */
+            uint8_t readRegister(uint8_t reg);
+
+            /**
+             * @brief Write register with side effects
+             * @param reg Register address
+             * @param value Value written
+             */
+            void writeRegister(uint8_t reg, uint8_t value);
+
+            /**
+             * @brief Execute direct command
+             * @param cmd Command code
+             */
+            void executeCommand(uint8_t cmd);
+
+            /**
+             * @brief Reset register file, FIFO and interrupts (SET_DEFAULT)
+             */
+            void setDefault(void);
+
+            /**
+             * @brief Start a transmission from the FIFO
+             * @param crc Append CRC
+             */
+            void startTransmission(bool crc);
+
+            /**
+             * @brief Send a complete frame to the tags and start reception
+             * @param frame Frame to send
+             */
+            void transmitFrame(const RfFrame& frame);
+
+            /**
+             * @brief Receive the responses of a time slot
+             * @param slot Time slot (must have at least one queued response)
+             */
+            void receiveSlot(uint8_t slot);
+
+            /**
+             * @brief Let the no-response timer expire (if enabled)
+             */
+            void expireNoResponseTimer(void);
+
+            /**
+             * @brief Move pending received bytes into the FIFO
+             */
+            void fillFifo(void);
+
+            /**
+             * @brief Update the FIFO byte count in the status registers
+             */
+            void updateFifoStatus(void);
+
+            /**
+             * @brief Set interrupt flags and update the IRQ line
+             * @param reg Interrupt register
+             * @param flags Flags to set
+             */
+            void raiseInterrupt(uint8_t reg, uint8_t flags);
+
+            /**
+             * @brief Re-evaluate the IRQ line and call the handler on a rising edge
+             */
+            void updateIrqLine(void);
+
+            /**
+             * @brief Re-evaluate the field state and power tags accordingly
+             */
+            void updateField(void);
+
+            /**
+             * @brief Check if a tag answers in the current operation mode
+             * @param tag Tag model
+             * @return true if the tag technology matches the mode register
+             */
+            bool tagMatchesMode(const VirtualTag* tag) const;
+
+            /**
+             * @brief Check if the subcarrier stream mode (ISO15693) is selected
+             * @return true if the host codes and decodes the frames
+             */
+            bool isStreamMode(void) const;
+
+            /**
+             * @brief Check if ISO14443A frames carry the parity bits in the FIFO data
+             * @param flag ISO14443A_NO_TX_PAR (transmission) or ISO14443A_NO_RX_PAR (reception)
+             * @return true if the parity bit handling is switched off in ISO14443A mode
+             */
+            bool isRawParityMode(uint8_t flag) const;
+
+            /**
+             * @brief Get water level used for FIFO interrupts
+             * @return Water level in bytes
+             */
+            uint8_t waterLevel(void) const;
+
+            /**
+             * @brief Add air time of a frame to the virtual time
+             * @param bytes Payload bytes
+             * @param rx true for tag to reader direction
+             */
+            void addAirTime(size_t bytes, bool rx);
+    };
+
+} // namespace NFC
+
+#endif /* INC_ST25R3911B_EMULATOR_H */
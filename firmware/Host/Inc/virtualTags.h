@@ -0,0 +1,822 @@
+/**
+ * @file    Host/Inc/virtualTags.h
+ * @brief   Virtual NFC Tag Models Header
+ * @details This file contains behavioural models of NFC tags that can be attached to the
+ *          ST25R3911B emulator. The models answer RF frames the way real tags do so that
+ *          the complete driver stack can be exercised without hardware.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef INC_VIRTUAL_TAGS_H
+#define INC_VIRTUAL_TAGS_H
+
+/**
+ * @include necessary headers
+ */
+#include "st25r3911b.h"
+#include "crypto1.h"
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @namespace NFC
+ * @brief Contains NFC related functions and definitions.
+ */
+namespace NFC
+{
+    /**
+     * @struct RfFrame
+     * @brief Frame exchanged over the air between reader and tag.
+     */
+    struct RfFrame
+    {
+        std::vector<uint8_t> data;          /**< Frame payload (without CRC) */
+        uint8_t lastBits;                   /**< Valid bits in last byte (0 = complete byte) */
+        bool crc;                           /**< CRC appended to the payload */
+        uint8_t slot;                       /**< Time slot of a response (FeliCa polling, ISO15693 inventory, 0 = first) */
+        std::vector<uint8_t> parity;        /**< ISO14443A parity bit of each byte (empty = odd parity) */
+    };
+
+    /**
+     * @class VirtualTag
+     * @brief Base class for all virtual tag models.
+     */
+    class VirtualTag
+    {
+        public:
+            /**
+             * @brief Constructor
+             * @param technology RF technology the tag answers to
+             */
+            VirtualTag(NFCProtocol technology) : _technology(technology), _coupling(10) {}
+
+            /**
+             * @brief Destructor
+             */
+            virtual ~VirtualTag() = default;
+
+            /**
+             * @brief Get RF technology of the tag
+             * @return Technology (NFC_A, NFC_B, NFC_F or NFC_V)
+             */
+            NFCProtocol GetTechnology(void) const { return _technology; }
+
+            /**
+             * @brief Set antenna coupling (distance) of the tag
+             * @param coupling Received signal strength in RSSI steps (0 = out of range, 15 = on the antenna)
+             */
+            void SetCoupling(uint8_t coupling) { _coupling = coupling; }
+
+            /**
+             * @brief Get antenna coupling of the tag
+             * @return Received signal strength in RSSI steps
+             */
+            uint8_t GetCoupling(void) const { return _coupling; }
+
+            /**
+             * @brief Called when the reader field is switched on
+             */
+            virtual void PowerOn(void) {}
+
+            /**
+             * @brief Called when the reader field is switched off
+             */
+            virtual void PowerOff(void) {}
+
+            /**
+             * @brief Handle a frame sent by the reader
+             * @param request Frame received from the reader
+             * @param response Frame to send back
+             * @return true if the tag answers, false if it stays silent
+             */
+            virtual bool HandleFrame(const RfFrame& request, RfFrame& response) = 0;
+
+        private:
+            NFCProtocol _technology;            /**< RF technology */
+            uint8_t _coupling;                  /**< Antenna coupling in RSSI steps */
+    };
+
+    /**
+     * @class VirtualTypeATag
+     * @brief ISO14443-3A tag model (REQA/WUPA, anticollision, SELECT, HLTA).
+     * @details Commands received in ACTIVE state are forwarded to handleActive().
+     */
+    class VirtualTypeATag : public VirtualTag
+    {
+        public:
+            /**
+             * @enum State
+             * @brief ISO14443-3A tag states.
+             */
+            enum class State
+            {
+                IDLE = 0,                       /**< Waiting for REQA/WUPA */
+                READY,                          /**< Anticollision in progress */
+                ACTIVE,                         /**< Selected */
+                HALT                            /**< Halted, wakes up on WUPA only */
+            };
+
+            /**
+             * @brief Constructor
+             * @param uid Tag UID (4, 7 or 10 bytes)
+             * @param atqa ATQA (LSB first)
+             * @param sak SAK of the complete UID
+             */
+            VirtualTypeATag(const std::vector<uint8_t>& uid, uint16_t atqa, uint8_t sak);
+
+            /**
+             * @brief Get tag UID
+             * @return UID bytes
+             */
+            const std::vector<uint8_t>& GetUID(void) const { return _uid; }
+
+            /**
+             * @brief Get current ISO14443-3A state
+             * @return Current state
+             */
+            State GetState(void) const { return _state; }
+
+            void PowerOn(void) override;
+            void PowerOff(void) override;
+            bool HandleFrame(const RfFrame& request, RfFrame& response) override;
+
+        protected:
+            /**
+             * @brief Handle a command in ACTIVE state
+             * @param request Frame received from the reader
+             * @param response Frame to send back
+             * @return true if the tag answers, false if it stays silent
+             */
+            virtual bool handleActive(const RfFrame& request, RfFrame& response) = 0;
+
+            /**
+             * @brief Return the tag to IDLE (e.g. after a NAK)
+             */
+            void goIdle(void) { _state = State::IDLE; _cascadeLevel = 0; }
+
+            /**
+             * @brief Halt the tag (e.g. after S(DESELECT)), it wakes up on WUPA only
+             */
+            void goHalt(void) { _state = State::HALT; _cascadeLevel = 0; }
+
+            /**
+             * @brief Build a 4-bit ACK/NAK response
+             * @param response Frame to fill
+             * @param code 4-bit code (0x0A = ACK)
+             */
+            static void setNibbleResponse(RfFrame& response, uint8_t code);
+
+        private:
+            std::vector<uint8_t> _uid;          /**< UID */
+            uint16_t _atqa;                     /**< ATQA */
+            uint8_t _sak;                       /**< SAK of complete UID */
+            State _state;                       /**< Current state */
+            uint8_t _cascadeLevel;              /**< Current cascade level (0-based) */
+
+            /**
+             * @brief Get the 5 bytes (UID part + BCC) of a cascade level
+             * @param level Cascade level (0-based)
+             * @param cl Array to store the cascade level bytes
+             */
+            void getCascadeBytes(uint8_t level, uint8_t cl[5]) const;
+
+            /**
+             * @brief Number of cascade levels of the UID
+             * @return 1, 2 or 3
+             */
+            uint8_t cascadeLevels(void) const;
+
+            /**
+             * @brief Handle ANTICOLLISION / SELECT in READY state
+             * @param request Frame received from the reader
+             * @param response Frame to send back
+             * @return true if the tag answers
+             */
+            bool handleAnticollision(const RfFrame& request, RfFrame& response);
+    };
+
+    /**
+     * @class VirtualType2Tag
+     * @brief NFC Forum Type 2 tag model (NTAG21x command set).
+     */
+    class VirtualType2Tag : public VirtualTypeATag
+    {
+        public:
+            /**
+             * @enum Model
+             * @brief Emulated NTAG product.
+             */
+            enum class Model
+            {
+                NTAG213 = 0,                    /**< 45 pages, 144 bytes user memory */
+                NTAG215,                        /**< 135 pages, 504 bytes user memory */
+                NTAG216                         /**< 231 pages, 888 bytes user memory */
+            };
+
+            /**
+             * @brief Constructor
+             * @param uid 7-byte UID
+             * @param model Emulated product
+             */
+            VirtualType2Tag(const std::vector<uint8_t>& uid, Model model);
+
+            /**
+             * @brief Get complete tag memory
+             * @return Memory image (4 bytes per page)
+             */
+            const std::vector<uint8_t>& GetMemory(void) const { return _memory; }
+
+            /**
+             * @brief Overwrite tag memory starting at a page (no access checks)
+             * @param page First page
+             * @param data Data to store
+             */
+            void SetMemory(uint16_t page, const std::vector<uint8_t>& data);
+
+            /**
+             * @brief Get total number of pages
+             * @return Page count
+             */
+            uint16_t GetPageCount(void) const { return static_cast<uint16_t>(_memory.size() / 4); }
+
+            /**
+             * @brief Get number of successful page writes since construction
+             * @return Page write count
+             */
+            uint32_t GetPageWrites(void) const { return _pageWrites; }
+
+        protected:
+            bool handleActive(const RfFrame& request, RfFrame& response) override;
+
+        private:
+            Model _model;                       /**< Emulated product */
+            std::vector<uint8_t> _memory;       /**< Tag memory */
+            uint32_t _pageWrites;               /**< Successful page writes */
+    };
+
+    /**
+     * @class VirtualMifareClassicTag
+     * @brief MIFARE Classic 1K tag model (Crypto1 authentication, encrypted READ, WRITE and HALT).
+     * @details Each sector trailer holds key A, the access bits and key B. Access conditions are
+     *          not evaluated: after authentication with either key every block of the sector
+     *          but the manufacturer block can be read and written. Key A reads as zeros.
+     */
+    class VirtualMifareClassicTag : public VirtualTypeATag
+    {
+        public:
+            /** @brief Number of 16-byte blocks (16 sectors of 4 blocks) */
+            static constexpr uint8_t BLOCK_COUNT = 64;
+
+            /**
+             * @brief Constructor
+             * @details All keys are FF FF FF FF FF FF (transport configuration).
+             * @param uid 4-byte UID
+             */
+            VirtualMifareClassicTag(const std::vector<uint8_t>& uid);
+
+            /**
+             * @brief Get complete tag memory
+             * @return Memory image (16 bytes per block, trailers with keys)
+             */
+            const std::vector<uint8_t>& GetMemory(void) const { return _memory; }
+
+            /**
+             * @brief Overwrite tag memory starting at a block (no access checks)
+             * @param block First block
+             * @param data Data to store
+             */
+            void SetMemory(uint8_t block, const std::vector<uint8_t>& data);
+
+            /**
+             * @brief Get number of successful authentications since construction
+             * @return Authentication count (first and nested)
+             */
+            uint32_t GetAuthentications(void) const { return _authentications; }
+
+            /**
+             * @brief Get number of blocks read since construction
+             * @return Block read count
+             */
+            uint32_t GetBlockReads(void) const { return _blockReads; }
+
+            /**
+             * @brief Get number of successful block writes since construction
+             * @return Block write count
+             */
+            uint32_t GetBlockWrites(void) const { return _blockWrites; }
+
+            bool HandleFrame(const RfFrame& request, RfFrame& response) override;
+
+        protected:
+            bool handleActive(const RfFrame& request, RfFrame& response) override;
+
+        private:
+            /**
+             * @enum CryptoState
+             * @brief Authentication progress.
+             */
+            enum class CryptoState
+            {
+                NONE = 0,                       /**< Not authenticated, commands are plain */
+                CHALLENGE,                      /**< Nonce sent, waiting for the reader answer */
+                AUTHENTICATED                   /**< Commands and responses are encrypted */
+            };
+
+            std::vector<uint8_t> _memory;       /**< Tag memory */
+            Crypto1 _crypto;                    /**< Cipher state of the session */
+            CryptoState _cryptoState;           /**< Authentication progress */
+            uint8_t _sector;                    /**< Sector of the last authentication */
+            uint32_t _nonce;                    /**< Last tag nonce */
+            int16_t _pendingWrite;              /**< Block of an acknowledged WRITE (-1 = none) */
+            uint32_t _authentications;          /**< Successful authentications */
+            uint32_t _blockReads;               /**< Blocks read */
+            uint32_t _blockWrites;              /**< Successful block writes */
+
+            /**
+             * @brief Answer AUTH with a tag nonce
+             * @param block Block to authenticate
+             * @param keyB true for key B
+             * @param nested true if the nonce is encrypted (AUTH within a session)
+             * @param response Frame to send back
+             * @return true if the tag answers
+             */
+            bool startAuthentication(uint8_t block, bool keyB, bool nested, RfFrame& response);
+
+            /**
+             * @brief Check the reader answer {nr}{ar} and answer with {at}
+             * @param request Frame received from the reader
+             * @param response Frame to send back
+             * @return true if the tag answers
+             */
+            bool finishAuthentication(const RfFrame& request, RfFrame& response);
+
+            /**
+             * @brief Decrypt a command of the session and check its parity bits and CRC
+             * @param request Frame received from the reader
+             * @param plain Vector to store the command without CRC
+             * @return true if the command is valid
+             */
+            bool decryptCommand(const RfFrame& request, std::vector<uint8_t>& plain);
+
+            /**
+             * @brief Encrypt a response with its parity bits
+             * @param plain Response
+             * @param crc Append CRC_A before encryption
+             * @param response Frame to fill
+             */
+            void encryptResponse(const std::vector<uint8_t>& plain, bool crc, RfFrame& response);
+
+            /**
+             * @brief Encrypt a 4-bit ACK/NAK
+             * @param code 4-bit code (0x0A = ACK)
+             * @param response Frame to fill
+             */
+            void encryptNibble(uint8_t code, RfFrame& response);
+
+            /**
+             * @brief End the session and return to IDLE
+             */
+            void abortSession(void);
+    };
+
+    /**
+     * @class VirtualTypeBTag
+     * @brief ISO14443-3B tag model (REQB/WUPB with slots, Slot-MARKER, ATTRIB, HLTB).
+     * @details Frames received in ACTIVE state are forwarded to handleActive(), S(DESELECT)
+     *          halts the tag.
+     */
+    class VirtualTypeBTag : public VirtualTag
+    {
+        public:
+            /**
+             * @enum State
+             * @brief ISO14443-3B tag states.
+             */
+            enum class State
+            {
+                IDLE = 0,                       /**< Waiting for REQB/WUPB */
+                READY_REQUESTED,                /**< Waiting for the Slot-MARKER of the chosen slot */
+                READY_DECLARED,                 /**< ATQB sent, waiting for ATTRIB */
+                ACTIVE,                         /**< Selected by ATTRIB */
+                HALT                            /**< Halted, wakes up on WUPB only */
+            };
+
+            /**
+             * @brief Constructor
+             * @param pupi 4-byte PUPI
+             * @param appData 4-byte application data
+             * @param protocolInfo 3-byte protocol info (bit rates, FSCI / protocol type, FWI / ADC / FO)
+             */
+            VirtualTypeBTag(const std::vector<uint8_t>& pupi,
+                            const std::vector<uint8_t>& appData = { 0x00, 0x00, 0x00, 0x00 },
+                            const std::vector<uint8_t>& protocolInfo = { 0x00, 0x81, 0x40 });
+
+            /**
+             * @brief Get tag PUPI
+             * @return PUPI bytes
+             */
+            const std::vector<uint8_t>& GetPUPI(void) const { return _pupi; }
+
+            /**
+             * @brief Get current ISO14443-3B state
+             * @return Current state
+             */
+            State GetState(void) const { return _state; }
+
+            void PowerOn(void) override;
+            void PowerOff(void) override;
+            bool HandleFrame(const RfFrame& request, RfFrame& response) override;
+
+        protected:
+            /**
+             * @brief Handle a frame in ACTIVE state
+             * @param request Frame received from the reader
+             * @param response Frame to send back
+             * @return true if the tag answers, false if it stays silent
+             */
+            virtual bool handleActive(const RfFrame& /* request */, RfFrame& /* response */) { return false; }
+
+            /**
+             * @brief Called when the tag is selected by ATTRIB
+             * @param fsdi Maximum frame size code of the reader (ATTRIB Param 2)
+             */
+            virtual void onAttrib(uint8_t /* fsdi */) {}
+
+        private:
+            std::vector<uint8_t> _pupi;         /**< PUPI */
+            std::vector<uint8_t> _appData;      /**< Application data */
+            std::vector<uint8_t> _protocolInfo; /**< Protocol info */
+            State _state;                       /**< Current state */
+            uint8_t _slot;                      /**< Slot chosen for the current REQB/WUPB (1-based) */
+            uint32_t _random;                   /**< Slot number generator state */
+
+            /**
+             * @brief Build the ATQB
+             * @param response Frame to fill
+             */
+            void setAtqb(RfFrame& response) const;
+    };
+
+    /**
+     * @class VirtualIsoDepLayer
+     * @brief ISO14443-4 block protocol of a card (I/R/S blocks, chaining, WTX, DESELECT).
+     * @details Complete APDUs are passed to the handler, responses longer than the reader
+     *          frame size are chained. The layer is shared by the Type A and Type B models.
+     */
+    class VirtualIsoDepLayer
+    {
+        public:
+            /**
+             * @brief APDU handler
+             * @param command Complete command APDU
+             * @param response Response APDU to fill (including status word)
+             */
+            using ApduHandler = std::function<void(const std::vector<uint8_t>& command, std::vector<uint8_t>& response)>;
+
+            /**
+             * @brief Constructor
+             * @param handler APDU handler
+             */
+            VirtualIsoDepLayer(ApduHandler handler);
+
+            /**
+             * @brief Start a new session after RATS or ATTRIB
+             * @param fsdi Maximum frame size code of the reader
+             */
+            void Activate(uint8_t fsdi);
+
+            /**
+             * @brief End the session (power loss, DESELECT)
+             */
+            void Deactivate(void) { _active = false; }
+
+            /**
+             * @brief Check if a session is open
+             * @return true after RATS or ATTRIB until DESELECT
+             */
+            bool IsActive(void) const { return _active; }
+
+            /**
+             * @brief Ask for a waiting time extension before every response APDU
+             * @param wtxm Multiplier requested with S(WTX) (0 = never)
+             */
+            void SetWaitingTimeExtension(uint8_t wtxm) { _wtxm = wtxm; }
+
+            /**
+             * @brief Get number of chained I-blocks received from the reader
+             * @return Block count
+             */
+            uint32_t GetChainedBlocksReceived(void) const { return _chainedReceived; }
+
+            /**
+             * @brief Get number of chained I-blocks sent to the reader
+             * @return Block count
+             */
+            uint32_t GetChainedBlocksSent(void) const { return _chainedSent; }
+
+            /**
+             * @brief Get number of blocks sent again on request of the reader
+             * @return Block count
+             */
+            uint32_t GetRetransmissions(void) const { return _retransmissions; }
+
+            /**
+             * @brief Handle a block received from the reader
+             * @param block Block (PCB and INF, without CRC)
+             * @param response Block to send back
+             * @param deselected Set to true if the block was S(DESELECT)
+             * @return true if the card answers
+             */
+            bool HandleBlock(const std::vector<uint8_t>& block, std::vector<uint8_t>& response, bool& deselected);
+
+        private:
+            ApduHandler _handler;               /**< APDU handler */
+            bool _active;                       /**< Session open */
+            uint16_t _fsd;                      /**< Maximum frame size of the reader */
+            uint8_t _blockNumber;               /**< Current block number */
+            uint8_t _wtxm;                      /**< WTX multiplier (0 = no WTX) */
+            bool _wtxPending;                   /**< S(WTX) sent, waiting for the reply */
+            std::vector<uint8_t> _command;      /**< Command APDU being received */
+            std::vector<uint8_t> _response;     /**< Response APDU being sent */
+            size_t _responsePos;                /**< Next response byte to send */
+            std::vector<uint8_t> _lastBlock;    /**< Last block sent (for retransmission) */
+            uint32_t _chainedReceived;          /**< Chained blocks received */
+            uint32_t _chainedSent;              /**< Chained blocks sent */
+            uint32_t _retransmissions;          /**< Blocks sent again */
+
+            /**
+             * @brief Send the next part of the response APDU
+             * @param response Block to fill
+             */
+            void nextResponseBlock(std::vector<uint8_t>& response);
+    };
+
+    /**
+     * @class VirtualIsoDepTag
+     * @brief ISO14443-4 Type A card model (SAK 0x20, RATS/ATS, block protocol).
+     * @details Complete APDUs are forwarded to handleApdu().
+     */
+    class VirtualIsoDepTag : public VirtualTypeATag
+    {
+        public:
+            /**
+             * @brief Constructor
+             * @param uid Card UID (4 or 7 bytes)
+             * @param fsci Maximum frame size code of the card (8 = 256 bytes)
+             * @param fwi Frame waiting time integer
+             * @param historicalBytes Historical bytes of the ATS
+             */
+            VirtualIsoDepTag(const std::vector<uint8_t>& uid, uint8_t fsci = 8, uint8_t fwi = 4,
+                             const std::vector<uint8_t>& historicalBytes = {});
+
+            /**
+             * @brief Get the block protocol layer
+             * @return Layer (for WTX configuration and counters)
+             */
+            VirtualIsoDepLayer& GetLayer(void) { return _layer; }
+
+            void PowerOn(void) override;
+
+        protected:
+            bool handleActive(const RfFrame& request, RfFrame& response) override;
+
+            /**
+             * @brief Handle a command APDU
+             * @param command Command APDU
+             * @param response Response APDU to fill (including status word)
+             */
+            virtual void handleApdu(const std::vector<uint8_t>& command, std::vector<uint8_t>& response);
+
+        private:
+            std::vector<uint8_t> _ats;          /**< Answer to select */
+            VirtualIsoDepLayer _layer;          /**< Block protocol */
+    };
+
+    /**
+     * @class VirtualIsoDepBTag
+     * @brief ISO14443-4 Type B card model (block protocol after ATTRIB).
+     * @details Complete APDUs are forwarded to handleApdu().
+     */
+    class VirtualIsoDepBTag : public VirtualTypeBTag
+    {
+        public:
+            /**
+             * @brief Constructor
+             * @param pupi 4-byte PUPI
+             * @param appData 4-byte application data
+             * @param protocolInfo 3-byte protocol info (must announce ISO14443-4 support)
+             */
+            VirtualIsoDepBTag(const std::vector<uint8_t>& pupi,
+                              const std::vector<uint8_t>& appData = { 0x00, 0x00, 0x00, 0x00 },
+                              const std::vector<uint8_t>& protocolInfo = { 0x00, 0x81, 0x40 });
+
+            /**
+             * @brief Get the block protocol layer
+             * @return Layer (for WTX configuration and counters)
+             */
+            VirtualIsoDepLayer& GetLayer(void) { return _layer; }
+
+            void PowerOn(void) override;
+
+        protected:
+            bool handleActive(const RfFrame& request, RfFrame& response) override;
+            void onAttrib(uint8_t fsdi) override { _layer.Activate(fsdi); }
+
+            /**
+             * @brief Handle a command APDU
+             * @param command Command APDU
+             * @param response Response APDU to fill (including status word)
+             */
+            virtual void handleApdu(const std::vector<uint8_t>& command, std::vector<uint8_t>& response);
+
+        private:
+            VirtualIsoDepLayer _layer;          /**< Block protocol */
+    };
+
+    /**
+     * @class VirtualType4Tag
+     * @brief NFC Forum Type 4 tag model (NDEF Tag Application with CC and NDEF file).
+     */
+    class VirtualType4Tag : public VirtualIsoDepTag
+    {
+        public:
+            /**
+             * @brief Constructor
+             * @param uid 7-byte UID
+             * @param ndefFileSize NDEF file size (including the 2-byte length field)
+             * @param maxReadSize MLe announced in the CC
+             * @param maxWriteSize MLc announced in the CC
+             */
+            VirtualType4Tag(const std::vector<uint8_t>& uid, uint16_t ndefFileSize = 2048,
+                            uint16_t maxReadSize = 0x00FF, uint16_t maxWriteSize = 0x00FF);
+
+            /**
+             * @brief Get NDEF file contents
+             * @return NDEF file (length field followed by the message)
+             */
+            const std::vector<uint8_t>& GetNdefFile(void) const { return _ndefFile; }
+
+            /**
+             * @brief Overwrite the NDEF file starting at an offset (no access checks)
+             * @param offset File offset
+             * @param data Data to store
+             */
+            void SetNdefFile(uint16_t offset, const std::vector<uint8_t>& data);
+
+            /**
+             * @brief Get number of READ BINARY commands since construction
+             * @return Command count
+             */
+            uint32_t GetReadCount(void) const { return _readCount; }
+
+            /**
+             * @brief Get number of UPDATE BINARY commands since construction
+             * @return Command count
+             */
+            uint32_t GetUpdateCount(void) const { return _updateCount; }
+
+            void PowerOn(void) override;
+
+        protected:
+            void handleApdu(const std::vector<uint8_t>& command, std::vector<uint8_t>& response) override;
+
+        private:
+            std::vector<uint8_t> _cc;           /**< Capability container file */
+            std::vector<uint8_t> _ndefFile;     /**< NDEF file */
+            uint16_t _maxReadSize;              /**< MLe */
+            uint16_t _maxWriteSize;             /**< MLc */
+            bool _applicationSelected;          /**< NDEF Tag Application selected */
+            std::vector<uint8_t>* _selectedFile; /**< Selected file (nullptr = none) */
+            uint32_t _readCount;                /**< READ BINARY commands */
+            uint32_t _updateCount;              /**< UPDATE BINARY commands */
+    };
+
+    /**
+     * @class VirtualFelicaTag
+     * @brief FeliCa card model (SENSF_REQ polling with time slots).
+     */
+    class VirtualFelicaTag : public VirtualTag
+    {
+        public:
+            /**
+             * @brief Constructor
+             * @param idm 8-byte IDm
+             * @param pmm 8-byte PMm
+             * @param systemCode System code (e.g. 0x12FC for NFC Forum Type 3)
+             */
+            VirtualFelicaTag(const std::vector<uint8_t>& idm,
+                             const std::vector<uint8_t>& pmm = { 0x01, 0x20, 0x22, 0x04, 0x27, 0x67, 0x4E, 0xFF },
+                             uint16_t systemCode = 0x12FC);
+
+            /**
+             * @brief Get card IDm
+             * @return IDm bytes
+             */
+            const std::vector<uint8_t>& GetIDm(void) const { return _idm; }
+
+            bool HandleFrame(const RfFrame& request, RfFrame& response) override;
+
+        private:
+            std::vector<uint8_t> _idm;          /**< IDm */
+            std::vector<uint8_t> _pmm;          /**< PMm */
+            uint16_t _systemCode;               /**< System code */
+            uint32_t _random;                   /**< Time slot generator state */
+    };
+
+    /**
+     * @class VirtualType5Tag
+     * @brief ISO15693 / NFC Forum Type 5 tag model (16-slot INVENTORY, STAY QUIET, block commands).
+     * @details Memories above 256 blocks are reached with the extended commands (2-byte block
+     *          numbers); GET SYSTEM INFORMATION then leaves out the memory size.
+     */
+    class VirtualType5Tag : public VirtualTag
+    {
+        public:
+            /**
+             * @brief Constructor
+             * @param uid 8-byte UID as reported by the reader (0xE0 first)
+             * @param blockCount Number of memory blocks
+             * @param blockSize Block size in bytes
+             * @param dsfid Data storage format identifier
+             */
+            VirtualType5Tag(const std::vector<uint8_t>& uid, uint16_t blockCount = 80, uint8_t blockSize = 4, uint8_t dsfid = 0x00);
+
+            /**
+             * @brief Get tag UID
+             * @return UID bytes (0xE0 first)
+             */
+            const std::vector<uint8_t>& GetUID(void) const { return _uid; }
+
+            /**
+             * @brief Get complete tag memory
+             * @return Memory image (blockSize bytes per block)
+             */
+            const std::vector<uint8_t>& GetMemory(void) const { return _memory; }
+
+            /**
+             * @brief Overwrite tag memory starting at a block (no access checks)
+             * @param block First block
+             * @param data Data to store
+             */
+            void SetMemory(uint16_t block, const std::vector<uint8_t>& data);
+
+            /**
+             * @brief Get number of successful block writes since construction
+             * @return Block write count
+             */
+            uint32_t GetBlockWrites(void) const { return _blockWrites; }
+
+            /**
+             * @brief Get number of answered read commands since construction
+             * @return Read command count (single and multiple block reads)
+             */
+            uint32_t GetReadCommands(void) const { return _readCommands; }
+
+            /**
+             * @brief Limit the blocks of one READ MULTIPLE BLOCKS
+             * @param blocks Largest block count accepted (0 = command not supported)
+             */
+            void SetReadMultipleLimit(uint16_t blocks) { _readMultipleLimit = blocks; }
+
+            /**
+             * @brief Check if the tag was sent to the quiet state
+             * @return true if only addressed requests are answered
+             */
+            bool IsQuiet(void) const { return _quiet; }
+
+            void PowerOn(void) override { _quiet = false; }
+            bool HandleFrame(const RfFrame& request, RfFrame& response) override;
+
+        private:
+            std::vector<uint8_t> _uid;          /**< UID (0xE0 first) */
+            uint64_t _uidValue;                 /**< UID as sent over the air (LSB first) */
+            uint8_t _blockSize;                 /**< Block size in bytes */
+            uint8_t _dsfid;                     /**< Data storage format identifier */
+            std::vector<uint8_t> _memory;       /**< Tag memory */
+            bool _quiet;                        /**< Quiet state */
+            uint32_t _blockWrites;              /**< Successful block writes */
+            uint32_t _readCommands;             /**< Answered read commands */
+            uint16_t _readMultipleLimit;        /**< Largest READ MULTIPLE BLOCKS (0 = not supported) */
+
+            /**
+             * @brief Answer an INVENTORY request
+             * @param request Frame received from the reader
+             * @param response Frame to send back (slot set from the UID bits after the mask)
+             * @return true if the UID matches the mask
+             */
+            bool handleInventory(const RfFrame& request, RfFrame& response);
+
+            /**
+             * @brief Build an error response
+             * @param response Frame to fill
+             * @param code ISO15693 error code
+             */
+            static void setError(RfFrame& response, uint8_t code);
+    };
+
+} // namespace NFC
+
+#endif /* INC_VIRTUAL_TAGS_H */
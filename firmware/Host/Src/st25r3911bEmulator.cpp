@@ -0,0 +1,984 @@
+/**
+ * @file    Host/Src/st25r3911bEmulator.cpp
+ * @brief   ST25R3911B Behavioural Emulator Implementation
+ * @details This file contains the implementation of the ST25R3911B software model.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "st25r3911bEmulator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace NFC
+{
+    // ============================================================================
+    // Model Constants
+    // ============================================================================
+
+    /** @brief Duration of one bit at 106 kbps in nanoseconds (128/fc) */
+    static constexpr uint32_t BIT_TIME_106_NS = 9440;
+    /** @brief Frame delay time between reader and tag frame in nanoseconds */
+    static constexpr uint32_t FRAME_DELAY_NS = 86000;
+    /** @brief No-response timer step in nanoseconds (64/fc) */
+    static constexpr uint32_t NRT_STEP_NS = 4720;
+    /** @brief FeliCa time slot in nanoseconds (256 * 64/fc) */
+    static constexpr uint32_t SLOT_TIME_NS = 1208000;
+    /** @brief ISO15693 pulse position slot (128/fc), one stream bit sent by the reader */
+    static constexpr uint32_t PULSE_TIME_15693_NS = 9440;
+    /** @brief ISO15693 half bit of a tag response at the high data rate (256/fc) */
+    static constexpr uint32_t HALF_BIT_15693_NS = 18880;
+    /** @brief ISO15693 response delay t1 in nanoseconds (4352/fc) */
+    static constexpr uint32_t FRAME_DELAY_15693_NS = 320900;
+    /** @brief ISO15693 reader start of frame in the stream (1-of-4) */
+    static constexpr uint8_t ISO15693_SOF_1OF4 = 0x21;
+    /** @brief ISO15693 reader end of frame in the stream */
+    static constexpr uint8_t ISO15693_EOF_1OF4 = 0x04;
+    /** @brief ISO15693 tag start of frame in the subcarrier stream (5 half bits, LSB first) */
+    static constexpr uint8_t ISO15693_SOF_RX = 0x17;
+    /** @brief ISO15693 tag end of frame in the subcarrier stream (5 half bits, LSB first) */
+    static constexpr uint8_t ISO15693_EOF_RX = 0x1D;
+    /** @brief Wake-up timer step in nanoseconds */
+    static constexpr uint32_t WUT_STEP_NS = 10000000;
+    /** @brief Lowest coupling the receiver demodulates with the configured gain */
+    static constexpr uint8_t MIN_COUPLING_NORMAL = 2;
+    /** @brief Lowest coupling the receiver demodulates with maximum gain */
+    static constexpr uint8_t MIN_COUPLING_BOOSTED = 1;
+    /** @brief Coupling above which the AGC starts to reduce the gain */
+    static constexpr uint8_t AGC_COUPLING = 12;
+
+    // ============================================================================
+    // ISO15693 Stream Coding
+    // ============================================================================
+
+    /**
+     * @brief Calculate the ISO15693 CRC (ISO/IEC 13239)
+     * @param data Data to protect
+     * @param length Number of bytes
+     * @return CRC (sent LSB first)
+     */
+    static uint16_t crcIso15693(const uint8_t* data, size_t length)
+    {
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0x8408) : static_cast<uint16_t>(crc >> 1);
+            }
+        }
+        return static_cast<uint16_t>(~crc);
+    }
+
+    /**
+     * @brief Decode a 1-of-4 coded reader frame and check its CRC
+     * @param stream Stream loaded by the host (SOF, one byte per bit pair, EOF)
+     * @param data Vector to store the payload without CRC
+     * @return true if the frame is valid
+     */
+    static bool decodeIso15693Request(const std::vector<uint8_t>& stream, std::vector<uint8_t>& data)
+    {
+        data.clear();
+        if (stream.size() < 2 || stream.front() != ISO15693_SOF_1OF4 || stream.back() != ISO15693_EOF_1OF4 ||
+            (stream.size() - 2) % 4 != 0) {
+            return false;
+        }
+
+        for (size_t i = 1; i + 1 < stream.size(); i += 4) {
+            uint8_t value = 0;
+            for (uint8_t pair = 0; pair < 4; ++pair) {
+                uint8_t symbol;
+                switch (stream[i + pair]) {
+                    case 0x02: symbol = 0; break;
+                    case 0x08: symbol = 1; break;
+                    case 0x20: symbol = 2; break;
+                    case 0x80: symbol = 3; break;
+                    default: return false;
+                }
+                value |= static_cast<uint8_t>(symbol << (pair * 2));
+            }
+            data.push_back(value);
+        }
+
+        if (data.size() < 3 ||
+            crcIso15693(data.data(), data.size() - 2) != static_cast<uint16_t>(data[data.size() - 2] | (data[data.size() - 1] << 8))) {
+            return false;
+        }
+        data.resize(data.size() - 2);
+        return true;
+    }
+
+    /**
+     * @brief Code a tag response as the subcarrier stream reported by the receiver
+     * @param data Response payload (CRC is appended)
+     * @return Stream of half bits, LSB first (SOF, Manchester data, EOF)
+     */
+    static std::vector<uint8_t> encodeIso15693Response(const std::vector<uint8_t>& data)
+    {
+        std::vector<uint8_t> frame = data;
+        uint16_t crc = crcIso15693(frame.data(), frame.size());
+        frame.push_back(static_cast<uint8_t>(crc & 0xFF));
+        frame.push_back(static_cast<uint8_t>(crc >> 8));
+
+        std::vector<uint8_t> stream;
+        size_t position = 0;
+        auto append = [&stream, &position](uint8_t value, uint8_t count) {
+            for (uint8_t i = 0; i < count; ++i, ++position) {
+                if (position / 8 >= stream.size()) {
+                    stream.push_back(0x00);
+                }
+                stream[position / 8] |= static_cast<uint8_t>(((value >> i) & 0x01) << (position % 8));
+            }
+        };
+
+        append(ISO15693_SOF_RX, 5);
+        for (const uint8_t byte : frame) {
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                // Logic 0: subcarrier in the first half bit, logic 1: in the second half bit
+                append(((byte >> bit) & 0x01) ? 0x02 : 0x01, 2);
+            }
+        }
+        append(ISO15693_EOF_RX, 5);
+        return stream;
+    }
+
+    // ============================================================================
+    // ISO14443A Parity Framing
+    // ============================================================================
+
+    /**
+     * @brief Calculate the ISO14443A CRC (CRC_A)
+     * @param data Data to protect
+     * @param length Number of bytes
+     * @return CRC (sent LSB first)
+     */
+    static uint16_t crcIso14443A(const uint8_t* data, size_t length)
+    {
+        uint16_t crc = 0x6363;
+        for (size_t i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0x8408) : static_cast<uint16_t>(crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief Odd parity bit of a byte
+     * @param value Byte
+     * @return Parity bit
+     */
+    static uint8_t oddParity(uint8_t value)
+    {
+        value ^= static_cast<uint8_t>(value >> 4);
+        value ^= static_cast<uint8_t>(value >> 2);
+        value ^= static_cast<uint8_t>(value >> 1);
+        return static_cast<uint8_t>((value & 0x01) ^ 0x01);
+    }
+
+    /**
+     * @brief Split a reader frame sent without parity generation into bytes and parity bits
+     * @param stream FIFO data (8 data bits and a parity bit per byte, LSB first)
+     * @param lastBits Valid bits in the last FIFO byte (0 = complete byte)
+     * @param frame Frame to store the bytes and parity bits (a trailing fragment is dropped)
+     */
+    static void unpackParityFrame(const std::vector<uint8_t>& stream, uint8_t lastBits, RfFrame& frame)
+    {
+        size_t bits = stream.size() * 8 - (lastBits ? 8 - lastBits : 0);
+        frame.data.clear();
+        frame.parity.clear();
+        for (size_t position = 0; position + 9 <= bits; position += 9) {
+            uint8_t value = 0;
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                value |= static_cast<uint8_t>(((stream[(position + bit) / 8] >> ((position + bit) % 8)) & 0x01) << bit);
+            }
+            frame.data.push_back(value);
+            frame.parity.push_back((stream[(position + 8) / 8] >> ((position + 8) % 8)) & 0x01);
+        }
+        frame.lastBits = 0;
+    }
+
+    /**
+     * @brief Code a tag response as received with parity checking off
+     * @param frame Response (CRC appended with odd parity, a short frame is sent without parity)
+     * @param lastBits Valid bits in the last stream byte (0 = complete byte)
+     * @return Stream of data and parity bits, LSB first
+     */
+    static std::vector<uint8_t> packParityFrame(const RfFrame& frame, uint8_t& lastBits)
+    {
+        std::vector<uint8_t> bytes = frame.data;
+        std::vector<uint8_t> parity(bytes.size(), 0x00);
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            parity[i] = (i < frame.parity.size()) ? (frame.parity[i] & 0x01) : oddParity(bytes[i]);
+        }
+        if (frame.crc && frame.lastBits == 0) {
+            uint16_t crc = crcIso14443A(frame.data.data(), frame.data.size());
+            for (const uint8_t byte : { static_cast<uint8_t>(crc & 0xFF), static_cast<uint8_t>(crc >> 8) }) {
+                bytes.push_back(byte);
+                parity.push_back(oddParity(byte));
+            }
+        }
+
+        std::vector<uint8_t> stream;
+        size_t position = 0;
+        auto append = [&stream, &position](uint16_t value, uint8_t count) {
+            for (uint8_t i = 0; i < count; ++i, ++position) {
+                if (position / 8 >= stream.size()) {
+                    stream.push_back(0x00);
+                }
+                stream[position / 8] |= static_cast<uint8_t>(((value >> i) & 0x01) << (position % 8));
+            }
+        };
+
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            if (frame.lastBits && i + 1 == bytes.size()) {
+                append(bytes[i], frame.lastBits);
+            } else {
+                append(static_cast<uint16_t>(bytes[i] | (parity[i] << 8)), 9);
+            }
+        }
+        lastBits = static_cast<uint8_t>(position % 8);
+        return stream;
+    }
+
+    // ============================================================================
+    // Constructor
+    // ============================================================================
+
+    ST25R3911BEmulator::ST25R3911BEmulator(uint32_t spiClockHz)
+        : _mode(AccessMode::NONE)
+        , _address(0)
+        , _selected(false)
+        , _txExpected(0)
+        , _txStreamed(0)
+        , _txCrc(false)
+        , _slotCoupling(0)
+        , _currentSlot(0)
+        , _rxPendingPos(0)
+        , _rxActive(false)
+        , _injectedError(0)
+        , _irqLine(false)
+        , _fieldOn(false)
+        , _spiClockHz(spiClockHz)
+        , _elapsedNs(0)
+    {
+        setDefault();
+        ResetStatistics();
+    }
+
+    // ============================================================================
+    // SPI Bus Interface
+    // ============================================================================
+
+    void ST25R3911BEmulator::SelectSlave(void)
+    {
+        _selected = true;
+        _mode = AccessMode::NONE;
+        _stats.spiFrames++;
+    }
+
+    void ST25R3911BEmulator::DeselectSlave(void)
+    {
+        _selected = false;
+        _mode = AccessMode::NONE;
+    }
+
+    SPI::SPIStatus ST25R3911BEmulator::Transmit(const std::vector<uint8_t> &data)
+    {
+        if (!_selected || data.empty()) {
+            return SPI::SPIStatus::INVALID_PARAM;
+        }
+
+        for (const uint8_t byte : data) {
+            processByte(byte);
+        }
+        return SPI::SPIStatus::OK;
+    }
+
+    SPI::SPIStatus ST25R3911BEmulator::TransmitReceive(const std::vector<uint8_t> &txData, std::vector<uint8_t> &rxData)
+    {
+        if (!_selected || txData.empty()) {
+            return SPI::SPIStatus::INVALID_PARAM;
+        }
+
+        rxData.clear();
+        rxData.reserve(txData.size());
+        for (const uint8_t byte : txData) {
+            rxData.push_back(processByte(byte));
+        }
+        return SPI::SPIStatus::OK;
+    }
+
+    // ============================================================================
+    // Model Control
+    // ============================================================================
+
+    void ST25R3911BEmulator::AttachTag(VirtualTag* tag)
+    {
+        if (!tag || std::find(_tags.begin(), _tags.end(), tag) != _tags.end()) {
+            return;
+        }
+
+        _tags.push_back(tag);
+        if (_fieldOn) {
+            tag->PowerOn();
+        }
+    }
+
+    void ST25R3911BEmulator::DetachTag(VirtualTag* tag)
+    {
+        auto it = std::find(_tags.begin(), _tags.end(), tag);
+        if (it != _tags.end()) {
+            (*it)->PowerOff();
+            _tags.erase(it);
+        }
+    }
+
+    void ST25R3911BEmulator::DetachAllTags(void)
+    {
+        for (VirtualTag* tag : _tags) {
+            tag->PowerOff();
+        }
+        _tags.clear();
+    }
+
+    void ST25R3911BEmulator::ResetStatistics(void)
+    {
+        std::memset(&_stats, 0, sizeof(_stats));
+        _elapsedNs = 0;
+    }
+
+    // ============================================================================
+    // SPI Protocol
+    // ============================================================================
+
+    uint8_t ST25R3911BEmulator::processByte(uint8_t mosi)
+    {
+        _stats.spiBytes++;
+        _elapsedNs += (8ULL * 1000000000ULL) / _spiClockHz;
+
+        switch (_mode) {
+            case AccessMode::NONE:
+                if (mosi >= ::ST25R3911B::SPI_CMD_DIRECT) {
+                    _mode = AccessMode::IGNORE;
+                    executeCommand(mosi);
+                } else if (mosi & 0x80) {
+                    _mode = AccessMode::IGNORE;
+                } else if (mosi & ::ST25R3911B::SPI_CMD_READ) {
+                    _mode = AccessMode::REGISTER_READ;
+                    _address = mosi & 0x3F;
+                } else {
+                    _mode = AccessMode::REGISTER_WRITE;
+                    _address = mosi & 0x3F;
+                }
+                return 0x00;
+
+            case AccessMode::REGISTER_READ: {
+                uint8_t value = readRegister(_address);
+                // FIFO data is read continuously, all other registers auto-increment
+                if (_address != ::ST25R3911B::REG_FIFO_DATA) {
+                    _address = (_address + 1) & 0x3F;
+                }
+                return value;
+            }
+
+            case AccessMode::REGISTER_WRITE:
+                writeRegister(_address, mosi);
+                if (_address != ::ST25R3911B::REG_FIFO_LOAD) {
+                    _address = (_address + 1) & 0x3F;
+                }
+                return 0x00;
+
+            case AccessMode::IGNORE:
+            default:
+                return 0x00;
+        }
+    }
+
+    uint8_t ST25R3911BEmulator::readRegister(uint8_t reg)
+    {
+        if (reg == ::ST25R3911B::REG_FIFO_DATA) {
+            if (_fifo.empty()) {
+                _registers[::ST25R3911B::REG_FIFO_RX_STATUS2] |= ::ST25R3911B::FIFO_STATUS2_UNF;
+                return 0x00;
+            }
+
+            uint8_t value = _fifo.front();
+            _fifo.erase(_fifo.begin());
+            _stats.fifoBytesRead++;
+            fillFifo();
+            return value;
+        }
+
+        _stats.registerReads++;
+        return _registers[reg];
+    }
+
+    void ST25R3911BEmulator::writeRegister(uint8_t reg, uint8_t value)
+    {
+        switch (reg) {
+            case ::ST25R3911B::REG_FIFO_LOAD:
+                _stats.fifoBytesLoaded++;
+                if (_txExpected > 0) {
+                    // Streamed transmission: data goes straight to the air
+                    _txBuffer.push_back(value);
+                    if (--_txExpected > 0 &&
+                        ++_txStreamed == static_cast<size_t>(::ST25R3911B::FIFO_SIZE - ::ST25R3911B::FIFO_TX_WATER_LEVEL)) {
+                        // FIFO drained to the water level again: request the next portion
+                        _txStreamed = 0;
+                        raiseInterrupt(::ST25R3911B::REG_IRQ_MAIN, ::ST25R3911B::IRQ_MAIN_FWL);
+                    } else if (_txExpected == 0) {
+                        RfFrame frame;
+                        frame.data = _txBuffer;
+                        frame.lastBits = _registers[::ST25R3911B::REG_NUM_TX_BYTES2] & ::ST25R3911B::NUM_TX_BYTES2_NBTX_MASK;
+                        frame.crc = _txCrc;
+                        frame.slot = 0;
+                        transmitFrame(frame);
+                    }
+                } else if (_fifo.size() < ::ST25R3911B::FIFO_SIZE) {
+                    _fifo.push_back(value);
+                    updateFifoStatus();
+                } else {
+                    _registers[::ST25R3911B::REG_FIFO_RX_STATUS2] |= ::ST25R3911B::FIFO_STATUS2_OVR;
+                    raiseInterrupt(::ST25R3911B::REG_IRQ_MAIN, ::ST25R3911B::IRQ_MAIN_EOF);
+                }
+                return;
+
+            case ::ST25R3911B::REG_IRQ_MAIN:
+            case ::ST25R3911B::REG_IRQ_TIMER_NFC:
+            case ::ST25R3911B::REG_IRQ_ERROR_WUP:
+            case ::ST25R3911B::REG_IRQ_TARGET:
+                // Interrupt flags are cleared by writing 1
+                _stats.registerWrites++;
+                _registers[reg] &= static_cast<uint8_t>(~value);
+                updateIrqLine();
+                return;
+
+            case ::ST25R3911B::REG_IC_IDENTITY:
+            case ::ST25R3911B::REG_FIFO_RX_STATUS1:
+            case ::ST25R3911B::REG_FIFO_RX_STATUS2:
+            case ::ST25R3911B::REG_COLLISION_DISPLAY:
+            case ::ST25R3911B::REG_RSSI_DISPLAY1:
+            case ::ST25R3911B::REG_RSSI_DISPLAY2:
+            case ::ST25R3911B::REG_GAIN_RED_STATE:
+                // Read-only display registers
+                _stats.registerWrites++;
+                return;
+
+            default:
+                _stats.registerWrites++;
+                _registers[reg] = value;
+                break;
+        }
+
+        if (reg == ::ST25R3911B::REG_IRQ_MASK_MAIN || reg == ::ST25R3911B::REG_IRQ_MASK_TIMER_NFC ||
+            reg == ::ST25R3911B::REG_IRQ_MASK_ERROR_WUP || reg == ::ST25R3911B::REG_IRQ_MASK_TARGET) {
+            updateIrqLine();
+        } else if (reg == ::ST25R3911B::REG_MODE || reg == ::ST25R3911B::REG_OP_CONTROL) {
+            updateField();
+        }
+    }
+
+    // ============================================================================
+    // Direct Commands
+    // ============================================================================
+
+    void ST25R3911BEmulator::executeCommand(uint8_t cmd)
+    {
+        _stats.directCommands++;
+
+        switch (cmd) {
+            case ::ST25R3911B::CMD_SET_DEFAULT:
+                setDefault();
+                break;
+
+            case ::ST25R3911B::CMD_CLEAR_FIFO:
+                _fifo.clear();
+                _rxPending.clear();
+                _rxPendingPos = 0;
+                _rxActive = false;
+                _txExpected = 0;
+                updateFifoStatus();
+                _registers[::ST25R3911B::REG_FIFO_RX_STATUS2] &=
+                    static_cast<uint8_t>(~(::ST25R3911B::FIFO_STATUS2_OVR | ::ST25R3911B::FIFO_STATUS2_UNF));
+                break;
+
+            case ::ST25R3911B::CMD_TRANSMIT_WITH_CRC:
+                startTransmission(true);
+                break;
+
+            case ::ST25R3911B::CMD_TRANSMIT_WITHOUT_CRC:
+                startTransmission(false);
+                break;
+
+            case ::ST25R3911B::CMD_TRANSMIT_REQA:
+            case ::ST25R3911B::CMD_TRANSMIT_WUPA: {
+                RfFrame frame;
+                frame.data = { static_cast<uint8_t>((cmd == ::ST25R3911B::CMD_TRANSMIT_REQA) ? 0x26 : 0x52) };
+                frame.lastBits = 7;
+                frame.crc = false;
+                frame.slot = 0;
+                transmitFrame(frame);
+                break;
+            }
+
+            case ::ST25R3911B::CMD_UNMASK_RECEIVE_DATA:
+                // Receiver enabled again after a frame: answers of the earliest later time slot
+                if (_slotResponses.empty()) {
+                    expireNoResponseTimer();
+                } else {
+                    receiveSlot(std::min_element(_slotResponses.begin(), _slotResponses.end(),
+                        [](const RfFrame& a, const RfFrame& b) { return a.slot < b.slot; })->slot);
+                }
+                break;
+
+            case ::ST25R3911B::CMD_START_GP_TIMER:
+            case ::ST25R3911B::CMD_START_NO_RESPONSE_TIMER: {
+                // Timers run in virtual time and expire immediately
+                uint16_t steps = static_cast<uint16_t>((_registers[::ST25R3911B::REG_TIM_CONF1] << 8) |
+                                                       _registers[::ST25R3911B::REG_TIM_CONF2]);
+                _elapsedNs += static_cast<uint64_t>(steps) * NRT_STEP_NS;
+                raiseInterrupt(::ST25R3911B::REG_IRQ_TIMER_NFC,
+                               (cmd == ::ST25R3911B::CMD_START_GP_TIMER) ? ::ST25R3911B::IRQ_TIMER_GPT
+                                                                         : ::ST25R3911B::IRQ_TIMER_NRT);
+                break;
+            }
+
+            case ::ST25R3911B::CMD_START_MASK_RECEIVE_TIMER:
+                raiseInterrupt(::ST25R3911B::REG_IRQ_TIMER_NFC, ::ST25R3911B::IRQ_TIMER_MRT);
+                break;
+
+            case ::ST25R3911B::CMD_START_WUP_TIMER:
+                _elapsedNs += static_cast<uint64_t>(_registers[::ST25R3911B::REG_WUP_TIMER_CONTROL1]) * WUT_STEP_NS;
+                raiseInterrupt(::ST25R3911B::REG_IRQ_TIMER_NFC, ::ST25R3911B::IRQ_TIMER_WUT);
+                break;
+
+            case ::ST25R3911B::CMD_MEASURE_AMPLITUDE:
+            case ::ST25R3911B::CMD_MEASURE_PHASE:
+            case ::ST25R3911B::CMD_MEASURE_CAPACITANCE:
+            case ::ST25R3911B::CMD_MEASURE_VDD:
+            case ::ST25R3911B::CMD_CALIBRATE_ANTENNA:
+            case ::ST25R3911B::CMD_ADJUST_REGULATORS:
+                // Measurements complete with the direct command interrupt
+                raiseInterrupt(::ST25R3911B::REG_IRQ_TIMER_NFC, ::ST25R3911B::IRQ_TIMER_DCT);
+                break;
+
+            case ::ST25R3911B::CMD_CLEAR_RSSI:
+                _registers[::ST25R3911B::REG_RSSI_DISPLAY1] = 0x00;
+                _registers[::ST25R3911B::REG_RSSI_DISPLAY2] = 0x00;
+                break;
+
+            default:
+                // Remaining commands have no observable effect in the model
+                break;
+        }
+    }
+
+    void ST25R3911BEmulator::setDefault(void)
+    {
+        std::memset(_registers, 0, sizeof(_registers));
+        _registers[::ST25R3911B::REG_IC_IDENTITY] = ::ST25R3911B::IC_IDENTITY_VALUE;
+
+        _fifo.clear();
+        _txBuffer.clear();
+        _txExpected = 0;
+        _rxPending.clear();
+        _rxPendingPos = 0;
+        _rxActive = false;
+
+        updateField();
+        updateIrqLine();
+    }
+
+    // ============================================================================
+    // RF Transfer
+    // ============================================================================
+
+    void ST25R3911BEmulator::startTransmission(bool crc)
+    {
+        uint16_t fullBytes = static_cast<uint16_t>((_registers[::ST25R3911B::REG_NUM_TX_BYTES1] << 5) |
+                                                   (_registers[::ST25R3911B::REG_NUM_TX_BYTES2] >> ::ST25R3911B::NUM_TX_BYTES2_SHIFT));
+        uint8_t lastBits = _registers[::ST25R3911B::REG_NUM_TX_BYTES2] & ::ST25R3911B::NUM_TX_BYTES2_NBTX_MASK;
+        size_t frameLength = fullBytes + (lastBits ? 1 : 0);
+
+        // Without an explicit length the complete FIFO is sent
+        if (frameLength == 0) {
+            frameLength = _fifo.size();
+            lastBits = 0;
+        }
+
+        if (frameLength == 0) {
+            return;
+        }
+
+        _txBuffer.assign(_fifo.begin(), _fifo.begin() + std::min(frameLength, _fifo.size()));
+        _fifo.erase(_fifo.begin(), _fifo.begin() + _txBuffer.size());
+        updateFifoStatus();
+
+        if (_txBuffer.size() < frameLength) {
+            // Frame longer than the FIFO content: request more data via water level interrupt
+            _txExpected = frameLength - _txBuffer.size();
+            _txStreamed = 0;
+            _txCrc = crc;
+            raiseInterrupt(::ST25R3911B::REG_IRQ_MAIN, ::ST25R3911B::IRQ_MAIN_FWL);
+            return;
+        }
+
+        RfFrame frame;
+        frame.data = _txBuffer;
+        frame.lastBits = lastBits;
+        frame.crc = crc;
+        frame.slot = 0;
+        transmitFrame(frame);
+    }
+
+    void ST25R3911BEmulator::transmitFrame(const RfFrame& frame)
+    {
+        _stats.rfFramesTransmitted++;
+        _txBuffer.clear();
+        _txExpected = 0;
+
+        // ISO14443A without parity generation: the host sends the parity bits in the data
+        RfFrame request = frame;
+        if (isRawParityMode(::ST25R3911B::ISO14443A_NO_TX_PAR)) {
+            unpackParityFrame(frame.data, frame.lastBits, request);
+        }
+        addAirTime(request.data.size() + (frame.crc ? 2 : 0), false);
+        raiseInterrupt(::ST25R3911B::REG_IRQ_MAIN, ::ST25R3911B::IRQ_MAIN_TXE);
+
+        // ISO15693: the host sends the coded stream, a lone EOF closes the current inventory slot
+        if (isStreamMode()) {
+            if (frame.data.size() == 1 && frame.data[0] == ISO15693_EOF_1OF4) {
+                _currentSlot++;
+                bool answered = std::any_of(_slotResponses.begin(), _slotResponses.end(),
+                    [this](const RfFrame& r) { return r.slot == _currentSlot; });
+                if (answered) {
+                    receiveSlot(_currentSlot);
+                } else {
+                    expireNoResponseTimer();
+                }
+                return;
+            }
+            request.crc = true;
+            request.slot = 0;
+            if (!decodeIso15693Request(frame.data, request.data)) {
+                // Corrupted request: no tag answers
+                _slotResponses.clear();
+                expireNoResponseTimer();
+                return;
+            }
+        }
+        _stats.rfBytesTransmitted += static_cast<uint32_t>(request.data.size());
+
+        // Collect the answers of all powered tags speaking the current technology;
+        // answers of weakly coupled tags are lost unless the receiver gain is at maximum
+        bool boosted = ((_registers[::ST25R3911B::REG_RX_CONF3] & ::ST25R3911B::RX_CONF3_RG1_MASK) == ::ST25R3911B::RX_CONF3_RG1_MAX);
+        uint8_t minCoupling = boosted ? MIN_COUPLING_BOOSTED : MIN_COUPLING_NORMAL;
+        _slotResponses.clear();
+        _slotCoupling = 0;
+        _currentSlot = 0;
+        if (_fieldOn) {
+            for (VirtualTag* tag : _tags) {
+                if (!tagMatchesMode(tag)) {
+                    continue;
+                }
+                RfFrame response;
+                response.lastBits = 0;
+                response.crc = false;
+                response.slot = 0;
+                if (tag->HandleFrame(request, response) && tag->GetCoupling() >= minCoupling) {
+                    _slotResponses.push_back(response);
+                    _slotCoupling = std::max(_slotCoupling, tag->GetCoupling());
+                }
+            }
+        }
+
+        if (_slotResponses.empty()) {
+            expireNoResponseTimer();
+            return;
+        }
+
+        // ISO15693 slots are switched by the reader, FeliCa answers follow in the earliest slot
+        uint8_t slot = std::min_element(_slotResponses.begin(), _slotResponses.end(),
+            [](const RfFrame& a, const RfFrame& b) { return a.slot < b.slot; })->slot;
+        if (isStreamMode() && slot != 0) {
+            expireNoResponseTimer();
+            return;
+        }
+        receiveSlot(slot);
+    }
+
+    void ST25R3911BEmulator::expireNoResponseTimer(void)
+    {
+        _stats.rfNoResponses++;
+        uint16_t steps = static_cast<uint16_t>((_registers[::ST25R3911B::REG_TIM_CONF1] << 8) |
+                                               _registers[::ST25R3911B::REG_TIM_CONF2]);
+        if (steps != 0) {
+            _elapsedNs += static_cast<uint64_t>(steps) * NRT_STEP_NS;
+            raiseInterrupt(::ST25R3911B::REG_IRQ_TIMER_NFC, ::ST25R3911B::IRQ_TIMER_NRT);
+        }
+    }
+
+    void ST25R3911BEmulator::receiveSlot(uint8_t slot)
+    {
+        // Answers in the same time slot overlap, later slots wait until the receiver is unmasked again
+        std::vector<RfFrame> responses;
+        for (auto it = _slotResponses.begin(); it != _slotResponses.end();) {
+            if (it->slot == slot) {
+                responses.push_back(*it);
+                it = _slotResponses.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        _elapsedNs += static_cast<uint64_t>(slot - _currentSlot) * SLOT_TIME_NS;
+        _currentSlot = slot;
+        uint8_t coupling = _slotCoupling;
+
+        // Stream mode: the receiver reports the subcarrier, overlapping answers show up as
+        // Manchester bits with subcarrier in both halves
+        size_t payloadBytes = responses[0].data.size();
+        bool stream = isStreamMode();
+        if (stream) {
+            for (RfFrame& response : responses) {
+                response.data = encodeIso15693Response(response.data);
+            }
+        }
+
+        // Overlapping answers: OR the bit streams and report the first differing bit
+        RfFrame received = responses[0];
+        bool collision = false;
+        uint16_t collisionBit = 0;
+        for (size_t r = 1; r < responses.size(); ++r) {
+            const RfFrame& other = responses[r];
+            size_t length = std::max(received.data.size(), other.data.size());
+            for (size_t i = 0; i < length; ++i) {
+                uint8_t a = (i < received.data.size()) ? received.data[i] : 0x00;
+                uint8_t b = (i < other.data.size()) ? other.data[i] : 0x00;
+                if (a != b) {
+                    for (uint8_t bit = 0; bit < 8; ++bit) {
+                        if (((a ^ b) >> bit) & 0x01) {
+                            uint16_t position = static_cast<uint16_t>(i * 8 + bit);
+                            if (!collision || position < collisionBit) {
+                                collisionBit = position;
+                            }
+                            collision = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (other.data.size() > received.data.size()) {
+                received.data.resize(other.data.size(), 0x00);
+            }
+            for (size_t i = 0; i < other.data.size(); ++i) {
+                received.data[i] |= other.data[i];
+            }
+        }
+
+        _stats.rfFramesReceived++;
+        _stats.rfBytesReceived += static_cast<uint32_t>(stream ? payloadBytes : received.data.size());
+        addAirTime(received.data.size() + ((received.crc && !stream) ? 2 : 0), true);
+
+        if (collision && stream) {
+            _stats.rfCollisions++;
+        } else if (collision && (_registers[::ST25R3911B::REG_MODE] & ::ST25R3911B::MODE_OM_MASK) != ::ST25R3911B::MODE_OM_ISO14443A) {
+            // Only ISO14443A framing shows bit collisions, overlapping frames of the other technologies fail the CRC
+            _stats.rfCollisions++;
+            _injectedError |= ::ST25R3911B::IRQ_ERR_CRC;
+        } else if (collision) {
+            _stats.rfCollisions++;
+            uint8_t collByte = static_cast<uint8_t>(std::min<uint16_t>(collisionBit / 8, 0x0F));
+            _registers[::ST25R3911B::REG_COLLISION_DISPLAY] =
+                static_cast<uint8_t>((collByte << ::ST25R3911B::COLL_BYTE_SHIFT) |
+                                     ((collisionBit % 8) << ::ST25R3911B::COLL_BIT_SHIFT));
+            raiseInterrupt(::ST25R3911B::REG_IRQ_MAIN, ::ST25R3911B::IRQ_MAIN_COL);
+        }
+
+        // Parity checking off: the FIFO receives the parity bits (and the CRC) with the data,
+        // otherwise a frame with other than odd parity (encrypted) fails the parity check
+        uint8_t lastBits = received.lastBits;
+        if (isRawParityMode(::ST25R3911B::ISO14443A_NO_RX_PAR)) {
+            received.data = packParityFrame(received, lastBits);
+        } else {
+            for (size_t i = 0; i < received.parity.size() && i < received.data.size(); ++i) {
+                if ((received.parity[i] & 0x01) != oddParity(received.data[i])) {
+                    _injectedError |= ::ST25R3911B::IRQ_ERR_PAR;
+                    break;
+                }
+            }
+        }
+
+        // Peak RSSI of the strongest responder, AGC reduces the gain on strong signals
+        uint8_t rssi = std::min(coupling, ::ST25R3911B::RSSI_MAX);
+        uint8_t reduction = (rssi > AGC_COUPLING) ? static_cast<uint8_t>(rssi - AGC_COUPLING) : 0;
+        _registers[::ST25R3911B::REG_RSSI_DISPLAY1] = rssi;
+        _registers[::ST25R3911B::REG_RSSI_DISPLAY2] = (rssi > 0) ? static_cast<uint8_t>(rssi - 1) : 0;
+        _registers[::ST25R3911B::REG_GAIN_RED_STATE] =
+            static_cast<uint8_t>((reduction << ::ST25R3911B::GAIN_RED_AM_SHIFT) | reduction);
+
+        // Start reception: the FIFO is filled as the host drains it
+        raiseInterrupt(::ST25R3911B::REG_IRQ_MAIN, ::ST25R3911B::IRQ_MAIN_RXS);
+
+        if (_injectedError != 0) {
+            uint8_t error = _injectedError;
+            _injectedError = 0;
+            _stats.rfErrors++;
+            raiseInterrupt(::ST25R3911B::REG_IRQ_ERROR_WUP, error);
+            if (error & ::ST25R3911B::IRQ_ERR_ERR1) {
+                // Reception aborted, nothing reaches the FIFO
+                return;
+            }
+        }
+        _rxPending = received.data;
+        _rxPendingPos = 0;
+        _rxActive = true;
+        _registers[::ST25R3911B::REG_FIFO_RX_STATUS2] =
+            static_cast<uint8_t>((_registers[::ST25R3911B::REG_FIFO_RX_STATUS2] & ~::ST25R3911B::FIFO_STATUS2_LB_MASK) |
+                                 ((lastBits << ::ST25R3911B::FIFO_STATUS2_LB_SHIFT) & ::ST25R3911B::FIFO_STATUS2_LB_MASK));
+        fillFifo();
+    }
+
+    void ST25R3911BEmulator::fillFifo(void)
+    {
+        if (!_rxActive) {
+            updateFifoStatus();
+            return;
+        }
+
+        while (_rxPendingPos < _rxPending.size() && _fifo.size() < ::ST25R3911B::FIFO_SIZE) {
+            _fifo.push_back(_rxPending[_rxPendingPos++]);
+        }
+        updateFifoStatus();
+
+        if (_rxPendingPos >= _rxPending.size()) {
+            _rxActive = false;
+            _rxPending.clear();
+            _rxPendingPos = 0;
+            raiseInterrupt(::ST25R3911B::REG_IRQ_MAIN, ::ST25R3911B::IRQ_MAIN_RXE);
+        } else if (_fifo.size() >= waterLevel() &&
+                   !(_registers[::ST25R3911B::REG_IRQ_MAIN] & ::ST25R3911B::IRQ_MAIN_FWL)) {
+            raiseInterrupt(::ST25R3911B::REG_IRQ_MAIN, ::ST25R3911B::IRQ_MAIN_FWL);
+        }
+    }
+
+    void ST25R3911BEmulator::updateFifoStatus(void)
+    {
+        uint8_t count = static_cast<uint8_t>(_fifo.size());
+        _registers[::ST25R3911B::REG_FIFO_RX_STATUS1] = count & 0x7F;
+        if (count & 0x80) {
+            _registers[::ST25R3911B::REG_FIFO_RX_STATUS2] |= ::ST25R3911B::FIFO_STATUS2_B7;
+        } else {
+            _registers[::ST25R3911B::REG_FIFO_RX_STATUS2] &= static_cast<uint8_t>(~::ST25R3911B::FIFO_STATUS2_B7);
+        }
+    }
+
+    // ============================================================================
+    // Interrupts, Field and Timing
+    // ============================================================================
+
+    void ST25R3911BEmulator::raiseInterrupt(uint8_t reg, uint8_t flags)
+    {
+        _registers[reg] |= flags;
+        updateIrqLine();
+    }
+
+    void ST25R3911BEmulator::updateIrqLine(void)
+    {
+        // A set mask bit enables the corresponding interrupt
+        bool asserted =
+            (_registers[::ST25R3911B::REG_IRQ_MAIN] & _registers[::ST25R3911B::REG_IRQ_MASK_MAIN]) ||
+            (_registers[::ST25R3911B::REG_IRQ_TIMER_NFC] & _registers[::ST25R3911B::REG_IRQ_MASK_TIMER_NFC]) ||
+            (_registers[::ST25R3911B::REG_IRQ_ERROR_WUP] & _registers[::ST25R3911B::REG_IRQ_MASK_ERROR_WUP]) ||
+            (_registers[::ST25R3911B::REG_IRQ_TARGET] & _registers[::ST25R3911B::REG_IRQ_MASK_TARGET]);
+
+        bool risingEdge = asserted && !_irqLine;
+        _irqLine = asserted;
+
+        if (risingEdge) {
+            _stats.interrupts++;
+            if (_irqHandler) {
+                _irqHandler();
+            }
+        }
+    }
+
+    void ST25R3911BEmulator::updateField(void)
+    {
+        bool fieldOn = (_registers[::ST25R3911B::REG_MODE] & ::ST25R3911B::MODE_TR_EN) &&
+                       (_registers[::ST25R3911B::REG_OP_CONTROL] & ::ST25R3911B::OP_CONTROL_EN);
+        if (fieldOn == _fieldOn) {
+            return;
+        }
+
+        _fieldOn = fieldOn;
+        for (VirtualTag* tag : _tags) {
+            if (_fieldOn) {
+                tag->PowerOn();
+            } else {
+                tag->PowerOff();
+            }
+        }
+    }
+
+    bool ST25R3911BEmulator::tagMatchesMode(const VirtualTag* tag) const
+    {
+        switch (_registers[::ST25R3911B::REG_MODE] & ::ST25R3911B::MODE_OM_MASK) {
+            case ::ST25R3911B::MODE_OM_ISO14443A:
+                return tag->GetTechnology() == NFCProtocol::NFC_A;
+            case ::ST25R3911B::MODE_OM_ISO14443B:
+                return tag->GetTechnology() == NFCProtocol::NFC_B;
+            case ::ST25R3911B::MODE_OM_FELICA:
+                return tag->GetTechnology() == NFCProtocol::NFC_F;
+            case ::ST25R3911B::MODE_OM_SUBCARRIER:
+                return tag->GetTechnology() == NFCProtocol::NFC_V;
+            default:
+                return false;
+        }
+    }
+
+    bool ST25R3911BEmulator::isStreamMode(void) const
+    {
+        return (_registers[::ST25R3911B::REG_MODE] & ::ST25R3911B::MODE_OM_MASK) == ::ST25R3911B::MODE_OM_SUBCARRIER;
+    }
+
+    bool ST25R3911BEmulator::isRawParityMode(uint8_t flag) const
+    {
+        return (_registers[::ST25R3911B::REG_MODE] & ::ST25R3911B::MODE_OM_MASK) == ::ST25R3911B::MODE_OM_ISO14443A &&
+               (_registers[::ST25R3911B::REG_ISO14443A_NFC] & flag);
+    }
+
+    uint8_t ST25R3911BEmulator::waterLevel(void) const
+    {
+        uint8_t level = _registers[::ST25R3911B::REG_IO_CONF1];
+        return (level > 0 && level < ::ST25R3911B::FIFO_SIZE) ? level : ::ST25R3911B::FIFO_WATER_LEVEL;
+    }
+
+    void ST25R3911BEmulator::addAirTime(size_t bytes, bool rx)
+    {
+        if (isStreamMode()) {
+            // One stream bit per pulse position (reader) or half bit (tag)
+            _elapsedNs += static_cast<uint64_t>(bytes) * 8 * (rx ? HALF_BIT_15693_NS : PULSE_TIME_15693_NS);
+            if (!rx) {
+                _elapsedNs += FRAME_DELAY_15693_NS;
+            }
+            return;
+        }
+
+        // Bit rate register: TX rate in the high nibble, RX rate in the low nibble (106 kbps << n)
+        uint8_t rate = _registers[::ST25R3911B::REG_BIT_RATE];
+        uint8_t shift = rx ? (rate & 0x03) : ((rate >> 4) & 0x03);
+        uint64_t bitTime = BIT_TIME_106_NS >> shift;
+
+        // 8 data bits plus parity per byte, start and end of frame
+        _elapsedNs += (static_cast<uint64_t>(bytes) * 9 + 2) * bitTime;
+        if (!rx) {
+            _elapsedNs += FRAME_DELAY_NS;
+        }
+    }
+
+} // namespace NFC
@@ -0,0 +1,1367 @@
+/**
+ * @file    Host/Src/virtualTags.cpp
+ * @brief   Virtual NFC Tag Models Implementation
+ * @details This file contains the implementation of the virtual tag models used with the ST25R3911B emulator.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "virtualTags.h"
+#include <algorithm>
+
+namespace NFC
+{
+    // ============================================================================
+    // VirtualTypeATag Implementation
+    // ============================================================================
+
+    VirtualTypeATag::VirtualTypeATag(const std::vector<uint8_t>& uid, uint16_t atqa, uint8_t sak)
+        : VirtualTag(NFCProtocol::NFC_A)
+        , _uid(uid)
+        , _atqa(atqa)
+        , _sak(sak)
+        , _state(State::IDLE)
+        , _cascadeLevel(0)
+    {
+    }
+
+    void VirtualTypeATag::PowerOn(void)
+    {
+        goIdle();
+    }
+
+    void VirtualTypeATag::PowerOff(void)
+    {
+        goIdle();
+    }
+
+    bool VirtualTypeATag::HandleFrame(const RfFrame& request, RfFrame& response)
+    {
+        if (request.data.empty()) {
+            return false;
+        }
+
+        // REQA / WUPA are 7-bit short frames
+        bool shortFrame = (request.data.size() == 1 && request.lastBits == 7 && !request.crc);
+        if (shortFrame) {
+            bool reqa = (request.data[0] == 0x26);
+            bool wupa = (request.data[0] == 0x52);
+            if ((reqa && _state == State::IDLE) ||
+                (wupa && (_state == State::IDLE || _state == State::HALT))) {
+                _state = State::READY;
+                _cascadeLevel = 0;
+                response.data = { static_cast<uint8_t>(_atqa & 0xFF), static_cast<uint8_t>(_atqa >> 8) };
+                response.lastBits = 0;
+                response.crc = false;
+                return true;
+            }
+            if (_state != State::HALT) {
+                goIdle();
+            }
+            return false;
+        }
+
+        switch (_state) {
+            case State::READY:
+                return handleAnticollision(request, response);
+
+            case State::ACTIVE:
+                // HLTA
+                if (request.crc && request.data.size() == 2 && request.data[0] == 0x50 && request.data[1] == 0x00) {
+                    _state = State::HALT;
+                    return false;
+                }
+                return handleActive(request, response);
+
+            case State::IDLE:
+            case State::HALT:
+            default:
+                return false;
+        }
+    }
+
+    void VirtualTypeATag::setNibbleResponse(RfFrame& response, uint8_t code)
+    {
+        response.data = { static_cast<uint8_t>(code & 0x0F) };
+        response.lastBits = 4;
+        response.crc = false;
+    }
+
+    uint8_t VirtualTypeATag::cascadeLevels(void) const
+    {
+        if (_uid.size() <= 4) {
+            return 1;
+        }
+        return (_uid.size() <= 7) ? 2 : 3;
+    }
+
+    void VirtualTypeATag::getCascadeBytes(uint8_t level, uint8_t cl[5]) const
+    {
+        uint8_t levels = cascadeLevels();
+        size_t offset = static_cast<size_t>(level) * 3;
+
+        if (level + 1 < levels) {
+            // Incomplete UID: cascade tag followed by 3 UID bytes
+            cl[0] = 0x88;
+            cl[1] = _uid[offset];
+            cl[2] = _uid[offset + 1];
+            cl[3] = _uid[offset + 2];
+        } else {
+            for (size_t i = 0; i < 4; ++i) {
+                cl[i] = _uid[offset + i];
+            }
+        }
+        cl[4] = cl[0] ^ cl[1] ^ cl[2] ^ cl[3];
+    }
+
+    bool VirtualTypeATag::handleAnticollision(const RfFrame& request, RfFrame& response)
+    {
+        static const uint8_t selCodes[3] = { 0x93, 0x95, 0x97 };
+
+        if (request.data.size() < 2 || request.data[0] != selCodes[_cascadeLevel]) {
+            goIdle();
+            return false;
+        }
+
+        uint8_t cl[5];
+        getCascadeBytes(_cascadeLevel, cl);
+        uint8_t nvb = request.data[1];
+
+        // SELECT: NVB = 0x70 with the complete cascade level and CRC
+        if (nvb == 0x70) {
+            if (!request.crc || request.data.size() != 7 ||
+                !std::equal(cl, cl + 5, request.data.begin() + 2)) {
+                return false;
+            }
+
+            if (_cascadeLevel + 1 < cascadeLevels()) {
+                _cascadeLevel++;
+                response.data = { 0x04 };   // Cascade bit: UID not complete
+            } else {
+                _state = State::ACTIVE;
+                response.data = { _sak };
+            }
+            response.lastBits = 0;
+            response.crc = true;
+            return true;
+        }
+
+        // ANTICOLLISION: NVB holds the number of valid bytes (high nibble) and bits (low nibble)
+        uint8_t knownBytes = static_cast<uint8_t>((nvb >> 4) - 2);
+        uint8_t knownBits = nvb & 0x0F;
+        size_t expectedLength = 2 + knownBytes + (knownBits ? 1 : 0);
+
+        if (request.crc || knownBytes > 4 || knownBits > 7 ||
+            request.data.size() != expectedLength || request.lastBits != knownBits) {
+            return false;
+        }
+
+        // Compare the bits the reader already knows
+        uint16_t totalKnown = static_cast<uint16_t>(knownBytes * 8 + knownBits);
+        for (uint16_t bit = 0; bit < totalKnown; ++bit) {
+            uint8_t sent = (request.data[2 + bit / 8] >> (bit % 8)) & 0x01;
+            uint8_t own = (cl[bit / 8] >> (bit % 8)) & 0x01;
+            if (sent != own) {
+                return false;
+            }
+        }
+
+        // Answer with the remaining bits, starting with the split byte
+        response.data.assign(cl + knownBytes, cl + 5);
+        response.data[0] &= static_cast<uint8_t>(0xFF << knownBits);
+        response.lastBits = 0;
+        response.crc = false;
+        return true;
+    }
+
+    // ============================================================================
+    // VirtualType2Tag Implementation
+    // ============================================================================
+
+    VirtualType2Tag::VirtualType2Tag(const std::vector<uint8_t>& uid, Model model)
+        : VirtualTypeATag(uid, 0x0044, 0x00)
+        , _model(model)
+        , _pageWrites(0)
+    {
+        uint16_t pages;
+        uint8_t ccSize;
+        switch (_model) {
+            case Model::NTAG215:
+                pages = 135;
+                ccSize = 0x3E;
+                break;
+            case Model::NTAG216:
+                pages = 231;
+                ccSize = 0x6D;
+                break;
+            case Model::NTAG213:
+            default:
+                pages = 45;
+                ccSize = 0x12;
+                break;
+        }
+
+        _memory.assign(static_cast<size_t>(pages) * 4, 0x00);
+
+        // Pages 0-2: UID, check bytes and static lock bytes
+        std::vector<uint8_t> id = uid;
+        id.resize(7, 0x00);
+        _memory[0] = id[0];
+        _memory[1] = id[1];
+        _memory[2] = id[2];
+        _memory[3] = 0x88 ^ id[0] ^ id[1] ^ id[2];
+        _memory[4] = id[3];
+        _memory[5] = id[4];
+        _memory[6] = id[5];
+        _memory[7] = id[6];
+        _memory[8] = id[3] ^ id[4] ^ id[5] ^ id[6];
+        _memory[9] = 0x48;
+
+        // Page 3: Capability container
+        _memory[12] = 0xE1;
+        _memory[13] = 0x10;
+        _memory[14] = ccSize;
+        _memory[15] = 0x00;
+
+        // Page 4: Empty NDEF TLV followed by terminator
+        _memory[16] = 0x03;
+        _memory[17] = 0x00;
+        _memory[18] = 0xFE;
+    }
+
+    void VirtualType2Tag::SetMemory(uint16_t page, const std::vector<uint8_t>& data)
+    {
+        size_t offset = static_cast<size_t>(page) * 4;
+        for (size_t i = 0; i < data.size() && offset + i < _memory.size(); ++i) {
+            _memory[offset + i] = data[i];
+        }
+    }
+
+    bool VirtualType2Tag::handleActive(const RfFrame& request, RfFrame& response)
+    {
+        const std::vector<uint8_t>& cmd = request.data;
+        uint16_t pages = GetPageCount();
+
+        if (!request.crc || cmd.empty()) {
+            return false;
+        }
+
+        switch (cmd[0]) {
+            case 0x30: { // READ: 4 pages, rolls over at the end of memory
+                if (cmd.size() != 2 || cmd[1] >= pages) {
+                    break;
+                }
+                response.data.clear();
+                for (uint16_t i = 0; i < 16; ++i) {
+                    response.data.push_back(_memory[(static_cast<size_t>(cmd[1]) * 4 + i) % _memory.size()]);
+                }
+                response.lastBits = 0;
+                response.crc = true;
+                return true;
+            }
+
+            case 0x3A: { // FAST_READ: start page, end page
+                if (cmd.size() != 3 || cmd[1] > cmd[2] || cmd[2] >= pages) {
+                    break;
+                }
+                response.data.assign(_memory.begin() + cmd[1] * 4, _memory.begin() + (cmd[2] + 1) * 4);
+                response.lastBits = 0;
+                response.crc = true;
+                return true;
+            }
+
+            case 0xA2: { // WRITE: page + 4 data bytes
+                if (cmd.size() != 6 || cmd[1] < 2 || cmd[1] >= pages) {
+                    break;
+                }
+                size_t offset = static_cast<size_t>(cmd[1]) * 4;
+                if (cmd[1] == 2) {
+                    // Only the static lock bytes are writable (OR-ed)
+                    _memory[offset + 2] |= cmd[4];
+                    _memory[offset + 3] |= cmd[5];
+                } else if (cmd[1] == 3) {
+                    // Capability container is one-time programmable (OR-ed)
+                    for (size_t i = 0; i < 4; ++i) {
+                        _memory[offset + i] |= cmd[2 + i];
+                    }
+                } else {
+                    std::copy(cmd.begin() + 2, cmd.end(), _memory.begin() + offset);
+                }
+                _pageWrites++;
+                setNibbleResponse(response, 0x0A);
+                return true;
+            }
+
+            case 0x60: { // GET_VERSION
+                if (cmd.size() != 1) {
+                    break;
+                }
+                uint8_t storage = (_model == Model::NTAG215) ? 0x11 : (_model == Model::NTAG216) ? 0x13 : 0x0F;
+                response.data = { 0x00, 0x04, 0x04, 0x02, 0x01, 0x00, storage, 0x03 };
+                response.lastBits = 0;
+                response.crc = true;
+                return true;
+            }
+
+            case 0x3C: { // READ_SIG: 32-byte originality signature
+                if (cmd.size() != 2) {
+                    break;
+                }
+                response.data.resize(32);
+                for (size_t i = 0; i < response.data.size(); ++i) {
+                    response.data[i] = static_cast<uint8_t>(GetUID()[i % GetUID().size()] ^ (i * 0x1D));
+                }
+                response.lastBits = 0;
+                response.crc = true;
+                return true;
+            }
+
+            default:
+                break;
+        }
+
+        // Invalid command or argument: NAK and fall back to IDLE
+        setNibbleResponse(response, 0x00);
+        goIdle();
+        return true;
+    }
+
+    // ============================================================================
+    // VirtualMifareClassicTag Implementation
+    // ============================================================================
+
+    /**
+     * @brief Calculate the ISO14443A CRC (CRC_A)
+     * @param data Data to protect
+     * @param length Number of bytes
+     * @return CRC (sent LSB first)
+     */
+    static uint16_t crcIso14443A(const uint8_t* data, size_t length)
+    {
+        uint16_t crc = 0x6363;
+        for (size_t i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0x8408) : static_cast<uint16_t>(crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    VirtualMifareClassicTag::VirtualMifareClassicTag(const std::vector<uint8_t>& uid)
+        : VirtualTypeATag(uid, 0x0004, 0x08)
+        , _cryptoState(CryptoState::NONE)
+        , _sector(0)
+        , _nonce(0x01200145)
+        , _pendingWrite(-1)
+        , _authentications(0)
+        , _blockReads(0)
+        , _blockWrites(0)
+    {
+        _memory.assign(static_cast<size_t>(BLOCK_COUNT) * 16, 0x00);
+
+        // Block 0: UID, BCC, SAK, ATQA and manufacturer data
+        std::vector<uint8_t> id = uid;
+        id.resize(4, 0x00);
+        std::copy(id.begin(), id.end(), _memory.begin());
+        _memory[4] = id[0] ^ id[1] ^ id[2] ^ id[3];
+        _memory[5] = 0x08;
+        _memory[6] = 0x04;
+        _memory[7] = 0x00;
+
+        // Sector trailers: key A, access bits (transport configuration), key B
+        static const uint8_t trailer[16] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x07,
+                                             0x80, 0x69, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+        for (uint8_t block = 3; block < BLOCK_COUNT; block += 4) {
+            std::copy(trailer, trailer + 16, _memory.begin() + static_cast<size_t>(block) * 16);
+        }
+    }
+
+    void VirtualMifareClassicTag::SetMemory(uint8_t block, const std::vector<uint8_t>& data)
+    {
+        size_t offset = static_cast<size_t>(block) * 16;
+        for (size_t i = 0; i < data.size() && offset + i < _memory.size(); ++i) {
+            _memory[offset + i] = data[i];
+        }
+    }
+
+    bool VirtualMifareClassicTag::HandleFrame(const RfFrame& request, RfFrame& response)
+    {
+        // The session ends when the tag leaves the ACTIVE state (HLTA, field reset, REQA)
+        if (GetState() != State::ACTIVE) {
+            _cryptoState = CryptoState::NONE;
+            _pendingWrite = -1;
+        }
+        return VirtualTypeATag::HandleFrame(request, response);
+    }
+
+    bool VirtualMifareClassicTag::handleActive(const RfFrame& request, RfFrame& response)
+    {
+        if (_cryptoState == CryptoState::NONE) {
+            // Plain AUTH only, also accepted with the parity bits and the CRC in the data
+            std::vector<uint8_t> cmd = request.data;
+            bool valid = request.crc && request.parity.empty();
+            if (!request.parity.empty() && request.parity.size() == cmd.size() && cmd.size() > 2) {
+                valid = crcIso14443A(cmd.data(), cmd.size() - 2) == static_cast<uint16_t>(cmd[cmd.size() - 2] | (cmd[cmd.size() - 1] << 8));
+                for (size_t i = 0; i < cmd.size(); ++i) {
+                    valid = valid && (request.parity[i] & 0x01) == Crypto1::OddParity(cmd[i]);
+                }
+                cmd.resize(cmd.size() - 2);
+            }
+            if (valid && cmd.size() == 2 && (cmd[0] == 0x60 || cmd[0] == 0x61)) {
+                return startAuthentication(cmd[1], cmd[0] == 0x61, false, response);
+            }
+            setNibbleResponse(response, 0x04);
+            abortSession();
+            return true;
+        }
+
+        if (_cryptoState == CryptoState::CHALLENGE) {
+            return finishAuthentication(request, response);
+        }
+
+        std::vector<uint8_t> cmd;
+        if (!decryptCommand(request, cmd)) {
+            // Transmission error in the session: encrypted NAK
+            encryptNibble(0x01, response);
+            abortSession();
+            return true;
+        }
+
+        if (_pendingWrite >= 0) {
+            // Second WRITE phase: 16 data bytes
+            uint8_t block = static_cast<uint8_t>(_pendingWrite);
+            _pendingWrite = -1;
+            if (cmd.size() != 16) {
+                encryptNibble(0x04, response);
+                abortSession();
+                return true;
+            }
+            std::copy(cmd.begin(), cmd.end(), _memory.begin() + static_cast<size_t>(block) * 16);
+            _blockWrites++;
+            encryptNibble(0x0A, response);
+            return true;
+        }
+
+        uint8_t block = (cmd.size() == 2) ? cmd[1] : 0xFF;
+        bool inSector = (block < BLOCK_COUNT && block / 4 == _sector);
+        switch (cmd.empty() ? 0x00 : cmd[0]) {
+            case 0x30: { // READ: one block of the authenticated sector
+                if (!inSector) {
+                    break;
+                }
+                std::vector<uint8_t> data(_memory.begin() + static_cast<size_t>(block) * 16,
+                                          _memory.begin() + static_cast<size_t>(block + 1) * 16);
+                if (block % 4 == 3) {
+                    std::fill(data.begin(), data.begin() + 6, 0x00);
+                }
+                _blockReads++;
+                encryptResponse(data, true, response);
+                return true;
+            }
+
+            case 0xA0: { // WRITE: ACK, then the data
+                if (!inSector || block == 0) {
+                    break;
+                }
+                _pendingWrite = block;
+                encryptNibble(0x0A, response);
+                return true;
+            }
+
+            case 0x60:
+            case 0x61: { // Nested AUTH
+                if (cmd.size() != 2) {
+                    break;
+                }
+                return startAuthentication(cmd[1], cmd[0] == 0x61, true, response);
+            }
+
+            case 0x50: { // HALT
+                if (cmd.size() != 2 || cmd[1] != 0x00) {
+                    break;
+                }
+                _cryptoState = CryptoState::NONE;
+                goHalt();
+                return false;
+            }
+
+            default:
+                break;
+        }
+
+        // Invalid command or block outside the sector: NAK and fall back to IDLE
+        encryptNibble(0x04, response);
+        abortSession();
+        return true;
+    }
+
+    bool VirtualMifareClassicTag::startAuthentication(uint8_t block, bool keyB, bool nested, RfFrame& response)
+    {
+        if (block >= BLOCK_COUNT) {
+            abortSession();
+            return false;
+        }
+
+        uint64_t key = 0;
+        size_t trailer = static_cast<size_t>(block / 4 * 4 + 3) * 16 + (keyB ? 10 : 0);
+        for (size_t i = 0; i < 6; ++i) {
+            key = (key << 8) | _memory[trailer + i];
+        }
+
+        // New nonce of the 16-bit generator, the cipher starts over with the sector key
+        _nonce = Crypto1::NonceSuccessor(_nonce, 160 + (_authentications & 0x3F));
+        _sector = block / 4;
+        _crypto.Init(key);
+
+        const std::vector<uint8_t>& uid = GetUID();
+        response.data.clear();
+        response.parity.clear();
+        for (int i = 0; i < 4; ++i) {
+            uint8_t nonceByte = static_cast<uint8_t>(_nonce >> (24 - 8 * i));
+            uint8_t keystream = _crypto.Byte(static_cast<uint8_t>(uid[i] ^ nonceByte), false);
+            if (nested) {
+                // Nonce encrypted with the keystream of the new key, parity bits too
+                response.data.push_back(static_cast<uint8_t>(nonceByte ^ keystream));
+                response.parity.push_back(_crypto.Peek() ^ Crypto1::OddParity(nonceByte));
+            } else {
+                response.data.push_back(nonceByte);
+            }
+        }
+        response.lastBits = 0;
+        response.crc = false;
+        _cryptoState = CryptoState::CHALLENGE;
+        return true;
+    }
+
+    bool VirtualMifareClassicTag::finishAuthentication(const RfFrame& request, RfFrame& response)
+    {
+        if (request.data.size() != 8 || request.parity.size() != 8) {
+            abortSession();
+            return false;
+        }
+
+        // {nr} is shifted into the cipher, {ar} must be the successor of nt
+        uint32_t answer = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            uint8_t plain = (i < 4) ? static_cast<uint8_t>(request.data[i] ^ _crypto.Byte(request.data[i], true))
+                                    : static_cast<uint8_t>(request.data[i] ^ _crypto.Byte(0x00, false));
+            if ((request.parity[i] & 0x01) != (_crypto.Peek() ^ Crypto1::OddParity(plain))) {
+                abortSession();
+                return false;
+            }
+            if (i >= 4) {
+                answer = (answer << 8) | plain;
+            }
+        }
+        if (answer != Crypto1::NonceSuccessor(_nonce, 64)) {
+            abortSession();
+            return false;
+        }
+
+        uint32_t tagAnswer = Crypto1::NonceSuccessor(_nonce, 96);
+        encryptResponse({ static_cast<uint8_t>(tagAnswer >> 24), static_cast<uint8_t>(tagAnswer >> 16),
+                          static_cast<uint8_t>(tagAnswer >> 8), static_cast<uint8_t>(tagAnswer) }, false, response);
+        _cryptoState = CryptoState::AUTHENTICATED;
+        _authentications++;
+        return true;
+    }
+
+    bool VirtualMifareClassicTag::decryptCommand(const RfFrame& request, std::vector<uint8_t>& plain)
+    {
+        if (request.parity.size() != request.data.size() || request.data.size() < 3) {
+            return false;
+        }
+
+        plain.clear();
+        bool parityValid = true;
+        for (size_t i = 0; i < request.data.size(); ++i) {
+            uint8_t value = static_cast<uint8_t>(request.data[i] ^ _crypto.Byte(0x00, false));
+            parityValid = parityValid && ((request.parity[i] & 0x01) == (_crypto.Peek() ^ Crypto1::OddParity(value)));
+            plain.push_back(value);
+        }
+
+        uint16_t crc = crcIso14443A(plain.data(), plain.size() - 2);
+        if (!parityValid || crc != static_cast<uint16_t>(plain[plain.size() - 2] | (plain[plain.size() - 1] << 8))) {
+            return false;
+        }
+        plain.resize(plain.size() - 2);
+        return true;
+    }
+
+    void VirtualMifareClassicTag::encryptResponse(const std::vector<uint8_t>& plain, bool crc, RfFrame& response)
+    {
+        std::vector<uint8_t> bytes = plain;
+        if (crc) {
+            uint16_t value = crcIso14443A(plain.data(), plain.size());
+            bytes.push_back(static_cast<uint8_t>(value & 0xFF));
+            bytes.push_back(static_cast<uint8_t>(value >> 8));
+        }
+
+        response.data.clear();
+        response.parity.clear();
+        for (const uint8_t byte : bytes) {
+            response.data.push_back(static_cast<uint8_t>(byte ^ _crypto.Byte(0x00, false)));
+            response.parity.push_back(_crypto.Peek() ^ Crypto1::OddParity(byte));
+        }
+        response.lastBits = 0;
+        response.crc = false;
+    }
+
+    void VirtualMifareClassicTag::encryptNibble(uint8_t code, RfFrame& response)
+    {
+        uint8_t value = 0;
+        for (uint8_t bit = 0; bit < 4; ++bit) {
+            value |= static_cast<uint8_t>((((code >> bit) & 0x01) ^ _crypto.Bit(0, false)) << bit);
+        }
+        setNibbleResponse(response, value);
+        response.parity.clear();
+    }
+
+    void VirtualMifareClassicTag::abortSession(void)
+    {
+        _cryptoState = CryptoState::NONE;
+        _pendingWrite = -1;
+        goIdle();
+    }
+
+    // ============================================================================
+    // VirtualTypeBTag Implementation
+    // ============================================================================
+
+    VirtualTypeBTag::VirtualTypeBTag(const std::vector<uint8_t>& pupi, const std::vector<uint8_t>& appData,
+                                     const std::vector<uint8_t>& protocolInfo)
+        : VirtualTag(NFCProtocol::NFC_B)
+        , _pupi(pupi)
+        , _appData(appData)
+        , _protocolInfo(protocolInfo)
+        , _state(State::IDLE)
+        , _slot(0)
+        , _random(0x2545F491)
+    {
+        _pupi.resize(4, 0x00);
+        _appData.resize(4, 0x00);
+        _protocolInfo.resize(3, 0x00);
+
+        // Different PUPIs draw different slot sequences
+        for (uint8_t byte : _pupi) {
+            _random = (_random ^ byte) * 0x01000193;
+        }
+    }
+
+    void VirtualTypeBTag::PowerOn(void)
+    {
+        _state = State::IDLE;
+    }
+
+    void VirtualTypeBTag::PowerOff(void)
+    {
+        _state = State::IDLE;
+    }
+
+    void VirtualTypeBTag::setAtqb(RfFrame& response) const
+    {
+        response.data = { 0x50 };
+        response.data.insert(response.data.end(), _pupi.begin(), _pupi.end());
+        response.data.insert(response.data.end(), _appData.begin(), _appData.end());
+        response.data.insert(response.data.end(), _protocolInfo.begin(), _protocolInfo.end());
+        response.lastBits = 0;
+        response.crc = true;
+    }
+
+    bool VirtualTypeBTag::HandleFrame(const RfFrame& request, RfFrame& response)
+    {
+        const std::vector<uint8_t>& cmd = request.data;
+        if (!request.crc || cmd.empty()) {
+            return false;
+        }
+
+        bool ready = (_state == State::READY_REQUESTED || _state == State::READY_DECLARED);
+
+        // REQB / WUPB: APf, AFI (0x00 = all families), PARAM (WUPB flag, N)
+        if (cmd.size() == 3 && cmd[0] == 0x05) {
+            bool wakeUp = (cmd[2] & 0x08) != 0;
+            if (cmd[1] != 0x00 || _state == State::ACTIVE || (_state == State::HALT && !wakeUp)) {
+                return false;
+            }
+
+            // Random slot out of 2^N (N > 4 is RFU)
+            uint8_t slots = static_cast<uint8_t>(1 << std::min<uint8_t>(cmd[2] & 0x07, 4));
+            _random ^= _random << 13;
+            _random ^= _random >> 17;
+            _random ^= _random << 5;
+            _slot = static_cast<uint8_t>(_random % slots + 1);
+            if (_slot > 1) {
+                _state = State::READY_REQUESTED;
+                return false;
+            }
+            _state = State::READY_DECLARED;
+            setAtqb(response);
+            return true;
+        }
+
+        // Slot-MARKER: APn = (slot - 1) << 4 | 0x05
+        if (cmd.size() == 1 && (cmd[0] & 0x0F) == 0x05 && (cmd[0] >> 4) != 0) {
+            if (_state != State::READY_REQUESTED || _slot != (cmd[0] >> 4) + 1) {
+                return false;
+            }
+            _state = State::READY_DECLARED;
+            setAtqb(response);
+            return true;
+        }
+
+        // ATTRIB: 0x1D, PUPI, Param 1-4
+        if (cmd.size() >= 9 && cmd[0] == 0x1D) {
+            if (!ready || !std::equal(_pupi.begin(), _pupi.end(), cmd.begin() + 1)) {
+                return false;
+            }
+            _state = State::ACTIVE;
+            onAttrib(cmd[6] & 0x0F);
+            response.data = { static_cast<uint8_t>(cmd[8] & 0x0F) };   // MBLI 0, CID
+            response.lastBits = 0;
+            response.crc = true;
+            return true;
+        }
+
+        // HLTB: 0x50, PUPI
+        if (cmd.size() == 5 && cmd[0] == 0x50) {
+            if (!ready || !std::equal(_pupi.begin(), _pupi.end(), cmd.begin() + 1)) {
+                return false;
+            }
+            _state = State::HALT;
+            response.data = { 0x00 };
+            response.lastBits = 0;
+            response.crc = true;
+            return true;
+        }
+
+        if (_state != State::ACTIVE) {
+            return false;
+        }
+
+        // S(DESELECT)
+        if (cmd.size() == 1 && cmd[0] == 0xC2) {
+            _state = State::HALT;
+            response.data = { 0xC2 };
+            response.lastBits = 0;
+            response.crc = true;
+            return true;
+        }
+        return handleActive(request, response);
+    }
+
+    // ============================================================================
+    // VirtualIsoDepLayer Implementation
+    // ============================================================================
+
+    /** @brief Frame sizes indexed by FSDI / FSCI (codes above 8 mean 256) */
+    static const uint16_t ISO_DEP_FRAME_SIZES[] = { 16, 24, 32, 40, 48, 64, 96, 128, 256 };
+
+    VirtualIsoDepLayer::VirtualIsoDepLayer(ApduHandler handler)
+        : _handler(handler)
+        , _active(false)
+        , _fsd(256)
+        , _blockNumber(1)
+        , _wtxm(0)
+        , _wtxPending(false)
+        , _responsePos(0)
+        , _chainedReceived(0)
+        , _chainedSent(0)
+        , _retransmissions(0)
+    {
+    }
+
+    void VirtualIsoDepLayer::Activate(uint8_t fsdi)
+    {
+        _active = true;
+        _fsd = ISO_DEP_FRAME_SIZES[std::min<uint8_t>(fsdi, 8)];
+        _blockNumber = 1;
+        _wtxPending = false;
+        _command.clear();
+        _response.clear();
+        _responsePos = 0;
+        _lastBlock.clear();
+    }
+
+    bool VirtualIsoDepLayer::HandleBlock(const std::vector<uint8_t>& block, std::vector<uint8_t>& response, bool& deselected)
+    {
+        deselected = false;
+        if (!_active || block.empty()) {
+            return false;
+        }
+        uint8_t pcb = block[0];
+
+        // I-block: the block number follows the reader
+        if ((pcb & 0xE2) == 0x02) {
+            _blockNumber = pcb & 0x01;
+            _wtxPending = false;
+            _command.insert(_command.end(), block.begin() + 1, block.end());
+            if (pcb & 0x10) {
+                _chainedReceived++;
+                response = { static_cast<uint8_t>(0xA2 | _blockNumber) };
+            } else {
+                _response.clear();
+                _responsePos = 0;
+                _handler(_command, _response);
+                _command.clear();
+                if (_wtxm) {
+                    _wtxPending = true;
+                    response = { 0xF2, _wtxm };
+                } else {
+                    nextResponseBlock(response);
+                }
+            }
+            _lastBlock = response;
+            return true;
+        }
+
+        // R-block: same block number = last block lost, R(NAK) otherwise = presence check
+        if ((pcb & 0xE6) == 0xA2) {
+            if ((pcb & 0x01) == _blockNumber) {
+                _retransmissions++;
+                response = _lastBlock;
+                return !response.empty();
+            }
+            if (pcb & 0x10) {
+                response = { static_cast<uint8_t>(0xA2 | _blockNumber) };
+                return true;
+            }
+            if (_responsePos >= _response.size()) {
+                return false;
+            }
+            _blockNumber ^= 1;
+            nextResponseBlock(response);
+            _lastBlock = response;
+            return true;
+        }
+
+        // S(DESELECT)
+        if (block.size() == 1 && pcb == 0xC2) {
+            _active = false;
+            deselected = true;
+            response = { 0xC2 };
+            return true;
+        }
+
+        // S(WTX) reply: the response APDU is ready now
+        if (block.size() == 2 && pcb == 0xF2 && _wtxPending) {
+            _wtxPending = false;
+            nextResponseBlock(response);
+            _lastBlock = response;
+            return true;
+        }
+        return false;
+    }
+
+    void VirtualIsoDepLayer::nextResponseBlock(std::vector<uint8_t>& response)
+    {
+        size_t chunk = std::min(static_cast<size_t>(_fsd - 3), _response.size() - _responsePos);
+        bool chaining = (_responsePos + chunk) < _response.size();
+
+        response.assign(1, static_cast<uint8_t>(0x02 | _blockNumber | (chaining ? 0x10 : 0x00)));
+        response.insert(response.end(), _response.begin() + _responsePos, _response.begin() + _responsePos + chunk);
+        _responsePos += chunk;
+        if (chaining) {
+            _chainedSent++;
+        }
+    }
+
+    // ============================================================================
+    // VirtualIsoDepTag Implementation
+    // ============================================================================
+
+    VirtualIsoDepTag::VirtualIsoDepTag(const std::vector<uint8_t>& uid, uint8_t fsci, uint8_t fwi,
+                                       const std::vector<uint8_t>& historicalBytes)
+        : VirtualTypeATag(uid, (uid.size() == 4) ? 0x0004 : 0x0044, 0x20)
+        , _layer([this](const std::vector<uint8_t>& command, std::vector<uint8_t>& response) {
+              handleApdu(command, response);
+          })
+    {
+        // TL, T0 (TA, TB, TC present, FSCI), TA (106 kbps only), TB (FWI, SFGI 0), TC (no NAD, no CID)
+        _ats = { 0x00, static_cast<uint8_t>(0x70 | (fsci & 0x0F)), 0x00, static_cast<uint8_t>((fwi & 0x0F) << 4), 0x00 };
+        _ats.insert(_ats.end(), historicalBytes.begin(), historicalBytes.end());
+        _ats[0] = static_cast<uint8_t>(_ats.size());
+    }
+
+    void VirtualIsoDepTag::PowerOn(void)
+    {
+        VirtualTypeATag::PowerOn();
+        _layer.Deactivate();
+    }
+
+    bool VirtualIsoDepTag::handleActive(const RfFrame& request, RfFrame& response)
+    {
+        const std::vector<uint8_t>& cmd = request.data;
+        if (!request.crc || cmd.empty()) {
+            return false;
+        }
+
+        response.lastBits = 0;
+        response.crc = true;
+
+        // RATS: 0xE0, FSDI / CID
+        if (cmd.size() == 2 && cmd[0] == 0xE0) {
+            _layer.Activate(cmd[1] >> 4);
+            response.data = _ats;
+            return true;
+        }
+
+        bool deselected = false;
+        if (!_layer.HandleBlock(cmd, response.data, deselected)) {
+            return false;
+        }
+        if (deselected) {
+            goHalt();
+        }
+        return true;
+    }
+
+    void VirtualIsoDepTag::handleApdu(const std::vector<uint8_t>& /* command */, std::vector<uint8_t>& response)
+    {
+        // INS not supported
+        response = { 0x6D, 0x00 };
+    }
+
+    // ============================================================================
+    // VirtualIsoDepBTag Implementation
+    // ============================================================================
+
+    VirtualIsoDepBTag::VirtualIsoDepBTag(const std::vector<uint8_t>& pupi, const std::vector<uint8_t>& appData,
+                                         const std::vector<uint8_t>& protocolInfo)
+        : VirtualTypeBTag(pupi, appData, protocolInfo)
+        , _layer([this](const std::vector<uint8_t>& command, std::vector<uint8_t>& response) {
+              handleApdu(command, response);
+          })
+    {
+    }
+
+    void VirtualIsoDepBTag::PowerOn(void)
+    {
+        VirtualTypeBTag::PowerOn();
+        _layer.Deactivate();
+    }
+
+    bool VirtualIsoDepBTag::handleActive(const RfFrame& request, RfFrame& response)
+    {
+        bool deselected = false;
+        if (!_layer.HandleBlock(request.data, response.data, deselected)) {
+            return false;
+        }
+        response.lastBits = 0;
+        response.crc = true;
+        return true;
+    }
+
+    void VirtualIsoDepBTag::handleApdu(const std::vector<uint8_t>& /* command */, std::vector<uint8_t>& response)
+    {
+        // INS not supported
+        response = { 0x6D, 0x00 };
+    }
+
+    // ============================================================================
+    // VirtualType4Tag Implementation
+    // ============================================================================
+
+    /** @brief NDEF Tag Application identifier */
+    static const uint8_t ndefApplicationId[] = { 0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01 };
+
+    VirtualType4Tag::VirtualType4Tag(const std::vector<uint8_t>& uid, uint16_t ndefFileSize,
+                                     uint16_t maxReadSize, uint16_t maxWriteSize)
+        : VirtualIsoDepTag(uid)
+        , _ndefFile(ndefFileSize, 0x00)
+        , _maxReadSize(maxReadSize)
+        , _maxWriteSize(maxWriteSize)
+        , _applicationSelected(false)
+        , _selectedFile(nullptr)
+        , _readCount(0)
+        , _updateCount(0)
+    {
+        // CCLEN, mapping version 2.0, MLe, MLc, NDEF File Control TLV (file E104, size, free read and write)
+        _cc = { 0x00, 0x0F, 0x20,
+                static_cast<uint8_t>(maxReadSize >> 8), static_cast<uint8_t>(maxReadSize),
+                static_cast<uint8_t>(maxWriteSize >> 8), static_cast<uint8_t>(maxWriteSize),
+                0x04, 0x06, 0xE1, 0x04,
+                static_cast<uint8_t>(ndefFileSize >> 8), static_cast<uint8_t>(ndefFileSize),
+                0x00, 0x00 };
+    }
+
+    void VirtualType4Tag::SetNdefFile(uint16_t offset, const std::vector<uint8_t>& data)
+    {
+        for (size_t i = 0; i < data.size() && offset + i < _ndefFile.size(); ++i) {
+            _ndefFile[offset + i] = data[i];
+        }
+    }
+
+    void VirtualType4Tag::PowerOn(void)
+    {
+        VirtualIsoDepTag::PowerOn();
+        _applicationSelected = false;
+        _selectedFile = nullptr;
+    }
+
+    void VirtualType4Tag::handleApdu(const std::vector<uint8_t>& command, std::vector<uint8_t>& response)
+    {
+        if (command.size() < 4 || command[0] != 0x00) {
+            response = { 0x6E, 0x00 };          // CLA not supported
+            return;
+        }
+        uint8_t ins = command[1];
+        uint16_t p1p2 = static_cast<uint16_t>((command[2] << 8) | command[3]);
+        size_t lc = (command.size() > 5) ? command[4] : 0;
+        if (command.size() > 5 && command.size() < 5 + lc) {
+            response = { 0x67, 0x00 };          // Wrong length
+            return;
+        }
+
+        switch (ins) {
+            case 0xA4:
+                if (command[2] == 0x04) {
+                    // SELECT by name
+                    _selectedFile = nullptr;
+                    _applicationSelected = (lc == sizeof(ndefApplicationId) &&
+                                            std::equal(ndefApplicationId, ndefApplicationId + lc, command.begin() + 5));
+                    response = _applicationSelected ? std::vector<uint8_t>{ 0x90, 0x00 } : std::vector<uint8_t>{ 0x6A, 0x82 };
+                    return;
+                }
+                if (command[2] == 0x00 && _applicationSelected && lc == 2) {
+                    // SELECT by file identifier
+                    uint16_t fileId = static_cast<uint16_t>((command[5] << 8) | command[6]);
+                    _selectedFile = (fileId == 0xE103) ? &_cc : (fileId == 0xE104) ? &_ndefFile : nullptr;
+                    response = _selectedFile ? std::vector<uint8_t>{ 0x90, 0x00 } : std::vector<uint8_t>{ 0x6A, 0x82 };
+                    return;
+                }
+                response = { 0x6A, 0x82 };      // File or application not found
+                return;
+
+            case 0xB0: {
+                // READ BINARY: offset in P1-P2, Le (0x00 = 256)
+                if (!_selectedFile) {
+                    response = { 0x69, 0x86 };  // No current EF
+                    return;
+                }
+                size_t le = (command.size() == 5) ? (command[4] ? command[4] : 256) : 256;
+                if (le > _maxReadSize) {
+                    response = { 0x67, 0x00 };
+                    return;
+                }
+                if (p1p2 >= _selectedFile->size()) {
+                    response = { 0x6B, 0x00 };  // Offset outside the file
+                    return;
+                }
+                size_t count = std::min(le, _selectedFile->size() - p1p2);
+                _readCount++;
+                response.assign(_selectedFile->begin() + p1p2, _selectedFile->begin() + p1p2 + count);
+                response.insert(response.end(), { 0x90, 0x00 });
+                return;
+            }
+
+            case 0xD6:
+                // UPDATE BINARY: offset in P1-P2, Lc, data (NDEF file only)
+                if (_selectedFile != &_ndefFile) {
+                    response = { 0x69, 0x82 };  // Security status not satisfied
+                    return;
+                }
+                if (lc == 0 || lc > _maxWriteSize) {
+                    response = { 0x67, 0x00 };
+                    return;
+                }
+                if (p1p2 + lc > _ndefFile.size()) {
+                    response = { 0x6B, 0x00 };
+                    return;
+                }
+                _updateCount++;
+                std::copy(command.begin() + 5, command.begin() + 5 + lc, _ndefFile.begin() + p1p2);
+                response = { 0x90, 0x00 };
+                return;
+
+            default:
+                response = { 0x6D, 0x00 };      // INS not supported
+                return;
+        }
+    }
+
+    // ============================================================================
+    // VirtualFelicaTag Implementation
+    // ============================================================================
+
+    VirtualFelicaTag::VirtualFelicaTag(const std::vector<uint8_t>& idm, const std::vector<uint8_t>& pmm, uint16_t systemCode)
+        : VirtualTag(NFCProtocol::NFC_F)
+        , _idm(idm)
+        , _pmm(pmm)
+        , _systemCode(systemCode)
+        , _random(0x2545F491)
+    {
+        _idm.resize(8, 0x00);
+        _pmm.resize(8, 0x00);
+
+        // Different IDms draw different slot sequences
+        for (uint8_t byte : _idm) {
+            _random = (_random ^ byte) * 0x01000193;
+        }
+    }
+
+    bool VirtualFelicaTag::HandleFrame(const RfFrame& request, RfFrame& response)
+    {
+        // SENSF_REQ: length, 0x00, system code, request code, TSN
+        const std::vector<uint8_t>& cmd = request.data;
+        if (!request.crc || cmd.size() != 6 || cmd[0] != 0x06 || cmd[1] != 0x00) {
+            return false;
+        }
+
+        // 0xFF in either system code byte is a wildcard
+        if ((cmd[2] != 0xFF && cmd[2] != (_systemCode >> 8)) || (cmd[3] != 0xFF && cmd[3] != (_systemCode & 0xFF))) {
+            return false;
+        }
+
+        // SENSF_RES: length, 0x01, IDm, PMm, request data (system code if requested)
+        response.data = { 0x12, 0x01 };
+        response.data.insert(response.data.end(), _idm.begin(), _idm.end());
+        response.data.insert(response.data.end(), _pmm.begin(), _pmm.end());
+        if (cmd[4] == 0x01) {
+            response.data.push_back(static_cast<uint8_t>(_systemCode >> 8));
+            response.data.push_back(static_cast<uint8_t>(_systemCode & 0xFF));
+        }
+        response.data[0] = static_cast<uint8_t>(response.data.size());
+        response.lastBits = 0;
+        response.crc = true;
+
+        // Random time slot out of TSN + 1
+        _random ^= _random << 13;
+        _random ^= _random >> 17;
+        _random ^= _random << 5;
+        response.slot = static_cast<uint8_t>(_random % (static_cast<uint32_t>(cmd[5]) + 1));
+        return true;
+    }
+
+    // ============================================================================
+    // VirtualType5Tag Implementation
+    // ============================================================================
+
+    VirtualType5Tag::VirtualType5Tag(const std::vector<uint8_t>& uid, uint16_t blockCount, uint8_t blockSize, uint8_t dsfid)
+        : VirtualTag(NFCProtocol::NFC_V)
+        , _uid(uid)
+        , _uidValue(0)
+        , _blockSize(blockSize ? blockSize : 4)
+        , _dsfid(dsfid)
+        , _quiet(false)
+        , _blockWrites(0)
+        , _readCommands(0)
+        , _readMultipleLimit(0xFFFF)
+    {
+        _uid.resize(8, 0x00);
+        for (uint8_t byte : _uid) {
+            _uidValue = (_uidValue << 8) | byte;
+        }
+        _memory.assign(static_cast<size_t>(blockCount ? blockCount : 1) * _blockSize, 0x00);
+    }
+
+    void VirtualType5Tag::SetMemory(uint16_t block, const std::vector<uint8_t>& data)
+    {
+        size_t offset = static_cast<size_t>(block) * _blockSize;
+        for (size_t i = 0; i < data.size() && offset + i < _memory.size(); ++i) {
+            _memory[offset + i] = data[i];
+        }
+    }
+
+    bool VirtualType5Tag::HandleFrame(const RfFrame& request, RfFrame& response)
+    {
+        const std::vector<uint8_t>& cmd = request.data;
+        if (!request.crc || cmd.size() < 2) {
+            return false;
+        }
+
+        uint8_t flags = cmd[0];
+        if (flags & 0x04) {
+            return (cmd[1] == 0x01) && !_quiet && handleInventory(request, response);
+        }
+
+        // Addressed requests carry the UID (LSB first), quiet tags answer nothing else
+        // EXTENDED GET SYSTEM INFORMATION has its parameter byte before the UID
+        size_t index = (cmd[1] == 0x3B) ? 3 : 2;
+        if (flags & 0x20) {
+            if (cmd.size() < index + 8) {
+                return false;
+            }
+            for (uint8_t i = 0; i < 8; ++i) {
+                if (cmd[index + i] != static_cast<uint8_t>(_uidValue >> (8 * i))) {
+                    return false;
+                }
+            }
+            index += 8;
+        } else if (_quiet) {
+            return false;
+        }
+
+        uint32_t blocks = static_cast<uint32_t>(_memory.size() / _blockSize);
+        response.lastBits = 0;
+        response.crc = true;
+        response.slot = 0;
+
+        switch (cmd[1]) {
+            case 0x02:
+                // STAY QUIET (addressed only, no answer)
+                if (flags & 0x20) {
+                    _quiet = true;
+                }
+                return false;
+
+            case 0x20:
+            case 0x23:
+            case 0x30:
+            case 0x33: {
+                // READ SINGLE BLOCK / READ MULTIPLE BLOCKS, extended: 2-byte block number and count
+                bool extended = (cmd[1] & 0x10) != 0;
+                bool multiple = (cmd[1] & 0x03) == 0x03;
+                size_t width = extended ? 2 : 1;
+                if (multiple && _readMultipleLimit == 0) {
+                    setError(response, 0x01);
+                    return true;
+                }
+                if (cmd.size() != index + width * (multiple ? 2 : 1)) {
+                    setError(response, 0x0F);
+                    return true;
+                }
+                uint32_t first = extended ? static_cast<uint32_t>(cmd[index] | (cmd[index + 1] << 8)) : cmd[index];
+                uint32_t count = 1;
+                if (multiple) {
+                    count = (extended ? static_cast<uint32_t>(cmd[index + 2] | (cmd[index + 3] << 8)) : cmd[index + 1]) + 1;
+                }
+                if (multiple && count > _readMultipleLimit) {
+                    setError(response, 0x0F);
+                    return true;
+                }
+                if (first + count > blocks) {
+                    setError(response, 0x10);
+                    return true;
+                }
+                _readCommands++;
+                response.data = { 0x00 };
+                response.data.insert(response.data.end(),
+                                     _memory.begin() + static_cast<size_t>(first) * _blockSize,
+                                     _memory.begin() + static_cast<size_t>(first + count) * _blockSize);
+                return true;
+            }
+
+            case 0x21:
+            case 0x31: {
+                // WRITE SINGLE BLOCK, extended: 2-byte block number
+                size_t width = (cmd[1] == 0x31) ? 2 : 1;
+                if (cmd.size() != index + width + _blockSize) {
+                    setError(response, 0x0F);
+                    return true;
+                }
+                uint32_t block = (width == 2) ? static_cast<uint32_t>(cmd[index] | (cmd[index + 1] << 8)) : cmd[index];
+                if (block >= blocks) {
+                    setError(response, 0x10);
+                    return true;
+                }
+                std::copy(cmd.begin() + index + width, cmd.end(), _memory.begin() + static_cast<size_t>(block) * _blockSize);
+                _blockWrites++;
+                response.data = { 0x00 };
+                return true;
+            }
+
+            case 0x2B:
+                // GET SYSTEM INFORMATION: DSFID, AFI and IC reference, memory size only up to 256 blocks
+                response.data = { 0x00, static_cast<uint8_t>((blocks > 256) ? 0x0B : 0x0F) };
+                for (uint8_t i = 0; i < 8; ++i) {
+                    response.data.push_back(static_cast<uint8_t>(_uidValue >> (8 * i)));
+                }
+                response.data.push_back(_dsfid);
+                response.data.push_back(0x00);
+                if (blocks <= 256) {
+                    response.data.push_back(static_cast<uint8_t>(blocks - 1));
+                    response.data.push_back(static_cast<uint8_t>((_blockSize - 1) & 0x1F));
+                }
+                response.data.push_back(0x01);
+                return true;
+
+            case 0x3B: {
+                // EXTENDED GET SYSTEM INFORMATION: requested DSFID, AFI, memory size and IC reference
+                if (cmd.size() != index) {
+                    setError(response, 0x0F);
+                    return true;
+                }
+                uint8_t info = cmd[2] & 0x0F;
+                response.data = { 0x00, info };
+                for (uint8_t i = 0; i < 8; ++i) {
+                    response.data.push_back(static_cast<uint8_t>(_uidValue >> (8 * i)));
+                }
+                if (info & 0x01) {
+                    response.data.push_back(_dsfid);
+                }
+                if (info & 0x02) {
+                    response.data.push_back(0x00);
+                }
+                if (info & 0x04) {
+                    response.data.push_back(static_cast<uint8_t>(blocks - 1));
+                    response.data.push_back(static_cast<uint8_t>((blocks - 1) >> 8));
+                    response.data.push_back(static_cast<uint8_t>(_blockSize - 1));
+                }
+                if (info & 0x08) {
+                    response.data.push_back(0x01);
+                }
+                return true;
+            }
+
+            default:
+                setError(response, 0x01);
+                return true;
+        }
+    }
+
+    bool VirtualType5Tag::handleInventory(const RfFrame& request, RfFrame& response)
+    {
+        // INVENTORY: flags, 0x01, [AFI], mask length, mask (LSB first)
+        const std::vector<uint8_t>& cmd = request.data;
+        bool oneSlot = (cmd[0] & 0x20) != 0;
+        size_t index = 2;
+        if (cmd[0] & 0x10) {
+            // AFI 0 selects all tags, this model has no AFI set
+            if (cmd.size() < 3 || cmd[2] != 0x00) {
+                return false;
+            }
+            index = 3;
+        }
+        if (cmd.size() <= index) {
+            return false;
+        }
+
+        uint8_t maskLength = cmd[index];
+        size_t maskBytes = (maskLength + 7) / 8;
+        if (maskLength > 64 || (!oneSlot && maskLength > 60) || cmd.size() != index + 1 + maskBytes) {
+            return false;
+        }
+
+        uint64_t mask = 0;
+        for (size_t i = 0; i < maskBytes; ++i) {
+            mask |= static_cast<uint64_t>(cmd[index + 1 + i]) << (8 * i);
+        }
+        uint64_t compare = (maskLength == 64) ? ~0ULL : ((1ULL << maskLength) - 1);
+        if ((_uidValue & compare) != (mask & compare)) {
+            return false;
+        }
+
+        response.data = { 0x00, _dsfid };
+        for (uint8_t i = 0; i < 8; ++i) {
+            response.data.push_back(static_cast<uint8_t>(_uidValue >> (8 * i)));
+        }
+        response.lastBits = 0;
+        response.crc = true;
+        response.slot = oneSlot ? 0 : static_cast<uint8_t>((_uidValue >> maskLength) & 0x0F);
+        return true;
+    }
+
+    void VirtualType5Tag::setError(RfFrame& response, uint8_t code)
+    {
+        response.data = { 0x01, code };
+        response.lastBits = 0;
+        response.crc = true;
+        response.slot = 0;
+    }
+
+} // namespace NFC
@@ -0,0 +1,36 @@
+/**
+ * @file    Host/Stubs/FreeRTOS.h
+ * @brief   FreeRTOS Host Stub Header
+ * @details This file contains the FreeRTOS types and macros used by the NFC stack, for the
+ *          single-threaded host build. Time is the virtual tick count of task.h.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+/**
+ * @include necessary headers
+ */
+#include <cstdint>
+#include <cstddef>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdFALSE                 ((BaseType_t)0)
+#define pdTRUE                  ((BaseType_t)1)
+#define pdFAIL                  pdFALSE
+#define pdPASS                  pdTRUE
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS      ((TickType_t)1)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define configASSERT(x)         ((void)0)
+
+/** @brief CMSIS no-operation intrinsic of the target busy waits */
+#define __NOP()                 ((void)0)
+
+#endif /* HOST_FREERTOS_H */
@@ -0,0 +1,153 @@
+/**
+ * @file    Host/Stubs/freertosStubs.cpp
+ * @brief   FreeRTOS Host Stub Implementation
+ * @details This file contains the single-threaded FreeRTOS stand-ins of the host build.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/** @brief Virtual tick count (1 ms per tick) */
+static TickType_t tickCount = 0;
+
+/** @brief Non-null handle for created objects */
+static int handleStorage;
+
+// ============================================================================
+// Tasks
+// ============================================================================
+
+TickType_t xTaskGetTickCount(void)
+{
+    return tickCount;
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return tickCount;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    tickCount += ticks;
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+    // Delays advance the virtual time instead of busy waiting
+    return taskSCHEDULER_RUNNING;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint16_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* handle)
+{
+    (void)function;
+    (void)name;
+    (void)stackDepth;
+    (void)parameters;
+    (void)priority;
+    if (handle) {
+        *handle = &handleStorage;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait)
+{
+    (void)clearOnExit;
+    (void)ticksToWait;
+    return 0;
+}
+
+void xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken)
+{
+    (void)task;
+    if (higherPriorityTaskWoken) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    (void)task;
+    return 0;
+}
+
+// ============================================================================
+// Queues and Semaphores
+// ============================================================================
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    (void)length;
+    (void)itemSize;
+    return &handleStorage;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    (void)queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait)
+{
+    (void)queue;
+    (void)item;
+    (void)ticksToWait;
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait)
+{
+    (void)queue;
+    (void)item;
+    (void)ticksToWait;
+    return pdFAIL;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    (void)queue;
+    return 0;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return &handleStorage;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    (void)semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    (void)semaphore;
+    (void)ticksToWait;
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    (void)semaphore;
+    return pdPASS;
+}
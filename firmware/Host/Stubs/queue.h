@@ -0,0 +1,27 @@
+/**
+ * @file    Host/Stubs/queue.h
+ * @brief   FreeRTOS Queue Host Stub Header
+ * @details This file contains the queue API used by the NFC stack. Queues accept every item
+ *          and are always empty: without a scheduler nothing runs on the receiving side.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef HOST_QUEUE_H
+#define HOST_QUEUE_H
+
+/**
+ * @include necessary headers
+ */
+#include "FreeRTOS.h"
+
+typedef void* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+#endif /* HOST_QUEUE_H */
@@ -0,0 +1,26 @@
+/**
+ * @file    Host/Stubs/semphr.h
+ * @brief   FreeRTOS Semaphore Host Stub Header
+ * @details This file contains the mutex API used by the NFC stack. The host build is
+ *          single-threaded, taking a mutex always succeeds.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef HOST_SEMPHR_H
+#define HOST_SEMPHR_H
+
+/**
+ * @include necessary headers
+ */
+#include "queue.h"
+
+typedef void* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+#endif /* HOST_SEMPHR_H */
@@ -0,0 +1,41 @@
+/**
+ * @file    Host/Stubs/task.h
+ * @brief   FreeRTOS Task Host Stub Header
+ * @details This file contains the task API used by the NFC stack. There is no scheduler:
+ *          tasks are never started, and vTaskDelay() advances a virtual tick count instead of
+ *          blocking, so timeouts and poll periods run in simulated time.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef HOST_TASK_H
+#define HOST_TASK_H
+
+/**
+ * @include necessary headers
+ */
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define tskIDLE_PRIORITY            ((UBaseType_t)0)
+#define taskSCHEDULER_NOT_STARTED   ((BaseType_t)1)
+#define taskSCHEDULER_RUNNING       ((BaseType_t)2)
+#define taskYIELD()                 ((void)0)
+#define portYIELD_FROM_ISR(x)       ((void)(x))
+
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+void vTaskDelay(TickType_t ticks);
+BaseType_t xTaskGetSchedulerState(void);
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint16_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* handle);
+void vTaskDelete(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+void xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+#endif /* HOST_TASK_H */
@@ -0,0 +1,156 @@
+/**
+ * @file    Host/Tests/hostTest.h
+ * @brief   Host Test Bench Header
+ * @details This file contains the bench shared by the host tests: the emulator wired to the
+ *          driver and the NFC manager, discovery helpers in virtual time, and check macros
+ *          that report the failing line and let the test run on.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/**
+ * @include necessary headers
+ */
+#include "st25r3911bEmulator.h"
+#include "virtualTags.h"
+#include "nfcClass.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <cstdio>
+
+/** @brief Number of failed checks */
+static int testFailures = 0;
+
+/** @brief Check a condition */
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);      \
+            testFailures++;                                                                \
+        }                                                                                  \
+    } while (0)
+
+/** @brief Check two integral values for equality */
+#define CHECK_EQ(actual, expected)                                                         \
+    do {                                                                                   \
+        long long actualValue = static_cast<long long>(actual);                            \
+        long long expectedValue = static_cast<long long>(expected);                        \
+        if (actualValue != expectedValue) {                                                \
+            std::printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual,  \
+                        actualValue, expectedValue);                                       \
+            testFailures++;                                                                \
+        }                                                                                  \
+    } while (0)
+
+/** @brief Check an NFCStatus */
+#define CHECK_STATUS(status, expected) CHECK_EQ(static_cast<int>(status), static_cast<int>(expected))
+
+namespace NFC
+{
+    /**
+     * @class HostBench
+     * @brief Emulated ST25R3911B with driver and NFC manager.
+     */
+    class HostBench
+    {
+        public:
+            ST25R3911BEmulator emulator;    /**< Controller model */
+            ST25R3911B driver;              /**< Driver under test */
+            NFCManager manager;             /**< Manager under test */
+
+            /**
+             * @brief Constructor (manager initialized, field off)
+             */
+            HostBench(void)
+                : emulator()
+                , driver(config(&emulator))
+                , manager(&driver)
+            {
+                emulator.SetIrqHandler([this]() { driver.HandleInterrupt(); });
+                manager.Initialize();
+            }
+
+            /**
+             * @brief Run discovery until a tag is detected
+             * @param protocols Bit mask of NFCProtocol values to poll
+             * @param tagInfo Detected tag
+             * @param timeoutMs Virtual time limit
+             * @return true if a tag was detected
+             */
+            bool Detect(uint32_t protocols, TagInfo& tagInfo, uint32_t timeoutMs = 2000)
+            {
+                bool detected = false;
+                manager.StartTagDetection(protocols, [&](const TagInfo& tag) { tagInfo = tag; detected = true; });
+                Run(timeoutMs, [&]() { return detected; });
+                return detected;
+            }
+
+            /**
+             * @brief Run discovery steps in virtual time
+             * @param timeoutMs Virtual time limit
+             * @param done Condition that ends the run early
+             */
+            template <typename Condition>
+            void Run(uint32_t timeoutMs, Condition done)
+            {
+                TickType_t end = xTaskGetTickCount() + timeoutMs;
+                while (!done() && xTaskGetTickCount() < end) {
+                    vTaskDelay(manager.RunDiscovery());
+                }
+            }
+
+            /**
+             * @brief Reset the traffic counters of the emulator
+             */
+            void ResetTraffic(void) { emulator.ResetStatistics(); }
+
+            /**
+             * @brief Get RF frames sent since the last ResetTraffic()
+             * @return Frame count
+             */
+            uint32_t Frames(void) const { return emulator.GetStatistics().rfFramesTransmitted; }
+
+        private:
+            /**
+             * @brief Build the driver configuration
+             * @param bus Emulator as SPI bus
+             * @return Configuration
+             */
+            static NFCConfig config(SPI::SPIBus* bus)
+            {
+                NFCConfig cfg{};
+                cfg.spiMaster = bus;
+                cfg.defaultProtocol = NFCProtocol::NFC_A;
+                cfg.timeoutMs = 100;
+                return cfg;
+            }
+    };
+
+    /**
+     * @brief Bit of a protocol in the detection mask
+     * @param protocol Protocol
+     * @return Mask bit
+     */
+    inline uint32_t ProtocolBit(NFCProtocol protocol)
+    {
+        return 1UL << static_cast<uint32_t>(protocol);
+    }
+
+} // namespace NFC
+
+/**
+ * @brief Report the test result
+ * @param name Test name
+ * @return Process exit code
+ */
+static inline int TestResult(const char* name)
+{
+    std::printf("%s: %s (%d failed checks)\n", name, testFailures ? "FAILED" : "passed", testFailures);
+    return testFailures ? 1 : 0;
+}
+
+#endif /* HOST_TEST_H */
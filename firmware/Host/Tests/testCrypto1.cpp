@@ -0,0 +1,83 @@
+/**
+ * @file    Host/Tests/testCrypto1.cpp
+ * @brief   Crypto1 Known-Answer Host Test
+ * @details Checks the cipher and the nonce generator against a published authentication
+ *          trace (default key, UID 9C599B32), without the emulator: the keystream that
+ *          encrypts the reader nonce, and the answers suc64(nt) and suc96(nt) recovered from
+ *          the encrypted reader and tag tokens.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+#include "crypto1.h"
+
+using namespace NFC;
+
+/**
+ * @brief Published trace of a first authentication with key FF FF FF FF FF FF
+ */
+static const uint64_t traceKey = 0xFFFFFFFFFFFFULL;
+static const uint32_t traceUid = 0x9C599B32;
+static const uint32_t traceNt = 0x82A4166C;     /**< Tag nonce (plain) */
+static const uint32_t traceNrEnc = 0xA1E458CE;  /**< Reader nonce (encrypted) */
+static const uint32_t traceArEnc = 0x6EEA41E0;  /**< Reader answer suc64(nt) (encrypted) */
+static const uint32_t traceAtEnc = 0x5CADF439;  /**< Tag answer suc96(nt) (encrypted) */
+
+int main(void)
+{
+    // Nonce generator: 16-bit LFSR over the 32-bit nonce
+    CHECK_EQ(Crypto1::NonceSuccessor(traceNt, 64), 0x8D65734B);
+    CHECK_EQ(Crypto1::NonceSuccessor(traceNt, 96), 0x9A427B20);
+    CHECK_EQ(Crypto1::NonceSuccessor(Crypto1::NonceSuccessor(traceNt, 32), 32), 0x8D65734B);
+    CHECK_EQ(Crypto1::NonceSuccessor(traceNt, 0), traceNt);
+
+    // Tag side: uid ^ nt loaded, the encrypted reader nonce is shifted in decrypted
+    Crypto1 tag;
+    tag.Init(traceKey);
+    tag.Word(traceUid ^ traceNt, false);
+    uint32_t ks1 = tag.Word(traceNrEnc, true);
+    CHECK_EQ(ks1, 0x4E0E4414);
+    CHECK_EQ(traceArEnc ^ tag.Word(0, false), Crypto1::NonceSuccessor(traceNt, 64));
+    CHECK_EQ(traceAtEnc ^ tag.Word(0, false), Crypto1::NonceSuccessor(traceNt, 96));
+
+    // Reader side: the plain reader nonce gives the same keystream
+    Crypto1 reader;
+    reader.Init(traceKey);
+    reader.Word(traceUid ^ traceNt, false);
+    uint32_t nr = traceNrEnc ^ ks1;
+    CHECK_EQ(nr, 0xEFEA1CDA);
+    CHECK_EQ(reader.Word(nr, false), ks1);
+    CHECK_EQ(reader.Word(0, false), 0xE38F32AB);
+    CHECK_EQ(reader.Word(0, false), 0xC6EF8F19);
+
+    // Key byte and bit order: first key byte in the LFSR first, each byte LSB first
+    Crypto1 cipher;
+    cipher.Init(0xA0A1A2A3A4A5ULL);
+    CHECK_EQ(cipher.Word(traceUid ^ 0x01020304, false), 0x7AFD99B7);
+    CHECK_EQ(cipher.Word(0x11223344, false), 0xD0255B0A);
+    CHECK_EQ(cipher.Word(0, false), 0x270F0AAC);
+
+    // Word is four bytes, most significant first; Peek is the next keystream bit
+    Crypto1 bytes;
+    bytes.Init(0xA0A1A2A3A4A5ULL);
+    uint32_t word = 0;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        word |= static_cast<uint32_t>(bytes.Byte(static_cast<uint8_t>((traceUid ^ 0x01020304) >> shift), false)) << shift;
+    }
+    CHECK_EQ(word, 0x7AFD99B7);
+    uint8_t next = bytes.Peek();
+    CHECK_EQ(bytes.Bit(0, false), next);
+
+    // ISO14443A odd parity
+    CHECK_EQ(Crypto1::OddParity(0x00), 1);
+    CHECK_EQ(Crypto1::OddParity(0x01), 0);
+    CHECK_EQ(Crypto1::OddParity(0xFF), 1);
+    CHECK_EQ(Crypto1::OddParity(0x93), 1);
+
+    return TestResult("testCrypto1");
+}
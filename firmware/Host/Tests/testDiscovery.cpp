@@ -0,0 +1,357 @@
+/**
+ * @file    Host/Tests/testDiscovery.cpp
+ * @brief   Discovery State Machine Host Test
+ * @details Poll cycles in an empty field, detection and activation of a tag, the periodic
+ *          presence check and the return to polling once the tag has left. Round-robin
+ *          polling of A/B/F/V with back-off of silent technologies and most recently seen
+ *          first ordering. Field duty cycle between poll cycles and fast polling after activity.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+
+using namespace NFC;
+
+/**
+ * @struct PollFrame
+ * @brief Frame seen by a probe.
+ */
+struct PollFrame
+{
+    uint32_t cycle;                         /**< Poll cycle (cycles that poll at least one technology) */
+    TickType_t tick;                        /**< Time of the frame */
+    NFCProtocol technology;                 /**< Technology of the probe */
+};
+
+/**
+ * @struct PollLog
+ * @brief Frames seen by the probes of all technologies.
+ */
+struct PollLog
+{
+    const DiscoveryStats* stats;            /**< Discovery statistics of the bench */
+    std::vector<PollFrame> frames;          /**< Frames in the order they were sent */
+};
+
+/**
+ * @class PollProbe
+ * @brief Tag that logs the frames of its technology and optionally answers with a fixed frame.
+ */
+class PollProbe : public VirtualTag
+{
+    public:
+        PollProbe(NFCProtocol technology, PollLog& log, const std::vector<uint8_t>& answer = {})
+            : VirtualTag(technology), _log(log), _answer(answer) {}
+
+        bool HandleFrame(const RfFrame& /* request */, RfFrame& response) override
+        {
+            _log.frames.push_back(PollFrame{ _log.stats->pollCycles, xTaskGetTickCount(), GetTechnology() });
+            if (_answer.empty()) {
+                return false;
+            }
+            response.data = _answer;
+            response.crc = true;
+            return true;
+        }
+
+    private:
+        PollLog& _log;                      /**< Shared frame log */
+        std::vector<uint8_t> _answer;       /**< Answer (empty = silent) */
+};
+
+/**
+ * @brief Get the technologies polled in a cycle
+ * @param log Frame log
+ * @param cycle Poll cycle
+ * @return Technologies in poll order
+ */
+static std::vector<NFCProtocol> polledIn(const PollLog& log, uint32_t cycle)
+{
+    std::vector<NFCProtocol> technologies;
+    for (const PollFrame& frame : log.frames) {
+        if (frame.cycle == cycle) {
+            technologies.push_back(frame.technology);
+        }
+    }
+    return technologies;
+}
+
+/**
+ * @brief Get the times a technology was polled
+ * @param log Frame log
+ * @param technology Technology
+ * @return Ticks of the polls
+ */
+static std::vector<TickType_t> pollTicks(const PollLog& log, NFCProtocol technology)
+{
+    std::vector<TickType_t> ticks;
+    for (const PollFrame& frame : log.frames) {
+        if (frame.technology == technology) {
+            ticks.push_back(frame.tick);
+        }
+    }
+    return ticks;
+}
+
+/**
+ * @brief Round-robin polling of all technologies
+ */
+static void testRoundRobin(void)
+{
+    HostBench bench;
+    PollLog log{ &bench.manager.GetDiscoveryStats(), {} };
+    PollProbe probeA(NFCProtocol::NFC_A, log);
+    PollProbe probeB(NFCProtocol::NFC_B, log);
+    PollProbe probeF(NFCProtocol::NFC_F, log);
+    PollProbe probeV(NFCProtocol::NFC_V, log);
+    for (VirtualTag* probe : std::initializer_list<VirtualTag*>{ &probeA, &probeB, &probeF, &probeV }) {
+        bench.emulator.AttachTag(probe);
+    }
+
+    // Without back-off every cycle polls A, B, F and V, in that order while none has answered
+    DiscoveryConfig config = bench.manager.GetDiscoveryConfig();
+    config.maxBackoffCycles = 0;
+    bench.manager.SetDiscoveryConfig(config);
+    uint32_t all = ProtocolBit(NFCProtocol::NFC_A) | ProtocolBit(NFCProtocol::NFC_B) |
+                   ProtocolBit(NFCProtocol::NFC_F) | ProtocolBit(NFCProtocol::NFC_V);
+    int detections = 0;
+    TagInfo detected{};
+    bench.manager.StartTagDetection(all, [&](const TagInfo& tag) { detected = tag; detections++; });
+    const DiscoveryStats& stats = bench.manager.GetDiscoveryStats();
+    bench.Run(10000, [&]() { return stats.pollCycles > 3; });
+    std::vector<NFCProtocol> initialOrder = { NFCProtocol::NFC_A, NFCProtocol::NFC_B, NFCProtocol::NFC_F, NFCProtocol::NFC_V };
+    CHECK(polledIn(log, 1) == initialOrder);
+    CHECK(polledIn(log, 3) == initialOrder);
+    CHECK_EQ(detections, 0);
+
+    // An NFC-V tag answers the INVENTORY: reported from the poll response
+    PollProbe tagV(NFCProtocol::NFC_V, log, { 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0xE0 });
+    bench.emulator.AttachTag(&tagV);
+    bench.Run(10000, [&]() { return detections > 0; });
+    CHECK_EQ(detections, 1);
+    CHECK_STATUS(detected.protocol, NFCProtocol::NFC_V);
+    CHECK_EQ(bench.manager.GetTechnologyStats(NFCProtocol::NFC_V).answers, 1);
+
+    // Once it has left, the most recently seen technology is polled first
+    bench.emulator.DetachTag(&tagV);
+    bench.Run(10000, [&]() { return !bench.manager.HasCurrentTag(); });
+    uint32_t cycle = stats.pollCycles + 1;
+    bench.Run(10000, [&]() { return stats.pollCycles > cycle + 2; });
+    std::vector<NFCProtocol> seenFirst = { NFCProtocol::NFC_V, NFCProtocol::NFC_A, NFCProtocol::NFC_B, NFCProtocol::NFC_F };
+    CHECK(polledIn(log, cycle) == seenFirst);
+    CHECK(polledIn(log, cycle + 2) == seenFirst);
+    bench.manager.StopTagDetection();
+
+    // With back-off a silent technology is skipped for 1, 3, 7, 7, ... poll periods (once the
+    // fast polling after the removal has ended)
+    config.maxBackoffCycles = 7;
+    bench.manager.SetDiscoveryConfig(config);
+    vTaskDelay(config.activityHoldMs);
+    log.frames.clear();
+    bench.emulator.DetachAllTags();
+    bench.emulator.AttachTag(&probeA);
+    bench.emulator.AttachTag(&probeB);
+    bench.manager.StartTagDetection(ProtocolBit(NFCProtocol::NFC_A) | ProtocolBit(NFCProtocol::NFC_B), [](const TagInfo&) {});
+    bench.Run(60 * config.pollPeriodMs, []() { return false; });
+    std::vector<TickType_t> ticks = pollTicks(log, NFCProtocol::NFC_A);
+    CHECK(ticks.size() >= 6);
+    if (ticks.size() >= 6) {
+        // Skipped periods are empty: the gaps grow by the skipped poll periods only
+        TickType_t first = ticks[1] - ticks[0];
+        CHECK_EQ(ticks[2] - ticks[1] - first, 2 * config.pollPeriodMs);
+        CHECK_EQ(ticks[3] - ticks[2] - first, 6 * config.pollPeriodMs);
+        CHECK_EQ(ticks[4] - ticks[3] - first, 6 * config.pollPeriodMs);
+        CHECK_EQ(ticks[5] - ticks[4] - first, 6 * config.pollPeriodMs);
+    }
+    CHECK_EQ(pollTicks(log, NFCProtocol::NFC_B).size(), ticks.size());
+    CHECK_EQ(bench.manager.GetTechnologyStats(NFCProtocol::NFC_A).skipCycles, 7);
+    CHECK_EQ(bench.manager.GetTechnologyStats(NFCProtocol::NFC_B).skipCycles, 7);
+
+    // A single requested technology is never backed off
+    bench.manager.StopTagDetection();
+    log.frames.clear();
+    bench.manager.StartTagDetection(ProtocolBit(NFCProtocol::NFC_B), [](const TagInfo&) {});
+    bench.Run(20 * config.pollPeriodMs, []() { return false; });
+    CHECK(pollTicks(log, NFCProtocol::NFC_B).size() >= 19);
+}
+
+/**
+ * @brief Get the gaps between the polls of a technology in a time window
+ * @param log Frame log
+ * @param technology Technology
+ * @param from First tick of the window
+ * @param to End of the window
+ * @return Gaps in ticks between consecutive polls within the window
+ */
+static std::vector<TickType_t> pollGaps(const PollLog& log, NFCProtocol technology, TickType_t from, TickType_t to)
+{
+    std::vector<TickType_t> ticks = pollTicks(log, technology);
+    std::vector<TickType_t> gaps;
+    for (size_t i = 1; i < ticks.size(); i++) {
+        if (ticks[i - 1] >= from && ticks[i] < to) {
+            gaps.push_back(ticks[i] - ticks[i - 1]);
+        }
+    }
+    return gaps;
+}
+
+/**
+ * @brief Field duty cycle between poll cycles and fast polling after activity
+ */
+static void testDutyCycle(void)
+{
+    HostBench bench;
+    PollLog log{ &bench.manager.GetDiscoveryStats(), {} };
+    PollProbe probeA(NFCProtocol::NFC_A, log);
+    PollProbe probeB(NFCProtocol::NFC_B, log);
+    PollProbe probeF(NFCProtocol::NFC_F, log);
+    PollProbe probeV(NFCProtocol::NFC_V, log);
+    for (VirtualTag* probe : std::initializer_list<VirtualTag*>{ &probeA, &probeB, &probeF, &probeV }) {
+        bench.emulator.AttachTag(probe);
+    }
+    DiscoveryConfig config = bench.manager.GetDiscoveryConfig();
+    config.maxBackoffCycles = 0;
+    bench.manager.SetDiscoveryConfig(config);
+    uint32_t all = ProtocolBit(NFCProtocol::NFC_A) | ProtocolBit(NFCProtocol::NFC_B) |
+                   ProtocolBit(NFCProtocol::NFC_F) | ProtocolBit(NFCProtocol::NFC_V);
+    const DiscoveryStats& stats = bench.manager.GetDiscoveryStats();
+    int detections = 0;
+    bench.manager.StartTagDetection(all, [&](const TagInfo&) { detections++; });
+
+    // Four technologies keep the field on longer than a quarter of the poll period: the off
+    // time is stretched to three times the on time
+    bench.Run(1000, []() { return false; });
+    uint32_t cycles = stats.pollCycles;
+    bench.Run(1000, [&]() { return stats.pollCycles > cycles; });
+    cycles = stats.pollCycles;
+    uint32_t fieldOnMs = stats.fieldOnTimeMs;
+    TickType_t start = xTaskGetTickCount();
+    bench.Run(5000, [&]() { return stats.pollCycles == cycles + 30; });
+    TickType_t end = xTaskGetTickCount();
+    uint32_t onTimeMs = (stats.fieldOnTimeMs - fieldOnMs) / (stats.pollCycles - cycles);
+    CHECK(3 * onTimeMs > config.pollPeriodMs && 3 * onTimeMs < config.maxPollPeriodMs);
+    std::vector<TickType_t> gaps = pollGaps(log, NFCProtocol::NFC_A, start, end);
+    CHECK_EQ(gaps.size(), 29);
+    for (TickType_t gap : gaps) {
+        CHECK_EQ(gap, 4 * onTimeMs);
+    }
+    uint32_t dutyPercent = (stats.fieldOnTimeMs - fieldOnMs) * 100 / (end - start);
+    CHECK_EQ(dutyPercent, config.fieldDutyPercent);
+
+    // The stretched off time is bounded by maxPollPeriodMs
+    config.maxPollPeriodMs = 110;
+    bench.manager.SetDiscoveryConfig(config);
+    bench.Run(1000, []() { return false; });
+    start = xTaskGetTickCount();
+    bench.Run(2000, []() { return false; });
+    gaps = pollGaps(log, NFCProtocol::NFC_A, start, xTaskGetTickCount());
+    CHECK(!gaps.empty());
+    for (TickType_t gap : gaps) {
+        CHECK_EQ(gap, onTimeMs + config.maxPollPeriodMs);
+    }
+
+    // Without a duty cycle limit the off time is the poll period
+    config.fieldDutyPercent = 100;
+    bench.manager.SetDiscoveryConfig(config);
+    bench.Run(1000, []() { return false; });
+    start = xTaskGetTickCount();
+    bench.Run(2000, []() { return false; });
+    gaps = pollGaps(log, NFCProtocol::NFC_A, start, xTaskGetTickCount());
+    CHECK(!gaps.empty());
+    for (TickType_t gap : gaps) {
+        CHECK_EQ(gap, onTimeMs + config.pollPeriodMs);
+    }
+    config.fieldDutyPercent = 25;
+    config.maxPollPeriodMs = 500;
+    bench.manager.SetDiscoveryConfig(config);
+
+    // After a tag has left, cycles follow every activePollPeriodMs for activityHoldMs
+    PollProbe tagV(NFCProtocol::NFC_V, log, { 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0xE0 });
+    bench.emulator.AttachTag(&tagV);
+    bench.Run(10000, [&]() { return detections > 0; });
+    CHECK_EQ(detections, 1);
+    bench.emulator.DetachTag(&tagV);
+    bench.Run(10000, [&]() { return !bench.manager.HasCurrentTag(); });
+    TickType_t removed = xTaskGetTickCount();
+    bench.Run(config.activityHoldMs + 2000, []() { return false; });
+    gaps = pollGaps(log, NFCProtocol::NFC_A, removed, removed + config.activityHoldMs);
+    CHECK(gaps.size() >= config.activityHoldMs / (onTimeMs + config.activePollPeriodMs) - 1);
+    for (TickType_t gap : gaps) {
+        CHECK_EQ(gap, onTimeMs + config.activePollPeriodMs);
+    }
+
+    // Then the duty cycle limit applies again
+    gaps = pollGaps(log, NFCProtocol::NFC_A, removed + config.activityHoldMs + 4 * onTimeMs, xTaskGetTickCount());
+    CHECK(!gaps.empty());
+    for (TickType_t gap : gaps) {
+        CHECK_EQ(gap, 4 * onTimeMs);
+    }
+    bench.manager.StopTagDetection();
+}
+
+int main(void)
+{
+    HostBench bench;
+    const DiscoveryStats& stats = bench.manager.GetDiscoveryStats();
+    int detections = 0;
+    TagInfo detected{};
+
+    // Empty field: one REQA per poll cycle, nothing reported
+    bench.manager.StartTagDetection(ProtocolBit(NFCProtocol::NFC_A), [&](const TagInfo& tag) {
+        detected = tag;
+        detections++;
+    });
+    bench.ResetTraffic();
+    bench.Run(1000, []() { return false; });
+    CHECK_EQ(stats.pollCycles, 10);
+    CHECK_EQ(bench.Frames(), 10);
+    CHECK_EQ(detections, 0);
+    CHECK(!bench.manager.HasCurrentTag());
+
+    // Steps never block beyond the poll period
+    for (int i = 0; i < 20; i++) {
+        uint32_t delayMs = bench.manager.RunDiscovery();
+        CHECK(delayMs <= bench.manager.GetDiscoveryConfig().pollPeriodMs);
+        vTaskDelay(delayMs);
+    }
+
+    // A tag enters the field: REQA, anticollision, SELECT, callback
+    VirtualType2Tag tag({ 0x11, 0x22, 0x33, 0x44 }, VirtualType2Tag::Model::NTAG213);
+    bench.emulator.AttachTag(&tag);
+    bench.Run(1000, [&]() { return detections > 0; });
+    CHECK_EQ(detections, 1);
+    CHECK(detected.uid == std::vector<uint8_t>({ 0x11, 0x22, 0x33, 0x44 }));
+    CHECK(bench.manager.HasCurrentTag());
+    CHECK_EQ(stats.tagsDiscovered, 1);
+    CHECK(stats.lastLatencyMs <= bench.manager.GetDiscoveryConfig().pollPeriodMs);
+    CHECK(stats.minLatencyMs <= stats.maxLatencyMs);
+
+    // While it stays, the tag is checked periodically but reported once
+    bench.Run(1000, []() { return false; });
+    CHECK_STATUS(bench.manager.GetDiscoveryState(), DiscoveryState::PRESENCE_CHECK);
+    CHECK_EQ(detections, 1);
+    CHECK_EQ(stats.tagsRemoved, 0);
+
+    // The tag leaves: removed after the tolerated failures, polling resumes
+    bench.emulator.DetachTag(&tag);
+    bench.Run(2000, [&]() { return stats.tagsRemoved > 0; });
+    CHECK_EQ(stats.tagsRemoved, 1);
+    CHECK(!bench.manager.HasCurrentTag());
+    uint32_t cycles = stats.pollCycles;
+    bench.Run(500, []() { return false; });
+    CHECK(stats.pollCycles > cycles);
+
+    // Stopped detection leaves the state machine idle
+    bench.manager.StopTagDetection();
+    CHECK_STATUS(bench.manager.GetDiscoveryState(), DiscoveryState::IDLE);
+
+    testRoundRobin();
+    testDutyCycle();
+
+    return TestResult("testDiscovery");
+}
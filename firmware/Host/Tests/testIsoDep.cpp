@@ -0,0 +1,120 @@
+/**
+ * @file    Host/Tests/testIsoDep.cpp
+ * @brief   ISO14443-4 / Type 4 Host Test
+ * @details RATS activation, chained APDU exchanges with error recovery, the presence check of
+ *          an activated tag and an NDEF round trip on a Type 4 tag.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+
+using namespace NFC;
+
+/**
+ * @class EchoTag
+ * @brief ISO-DEP tag answering every APDU with a fixed-length pattern and 90 00.
+ */
+class EchoTag : public VirtualIsoDepTag
+{
+    public:
+        using VirtualIsoDepTag::VirtualIsoDepTag;
+
+        size_t responseLength = 0;          /**< Pattern bytes before the status word */
+        std::vector<uint8_t> lastCommand;   /**< Last complete command APDU */
+
+    protected:
+        void handleApdu(const std::vector<uint8_t>& command, std::vector<uint8_t>& response) override
+        {
+            lastCommand = command;
+            response.clear();
+            for (size_t i = 0; i < responseLength; i++) {
+                response.push_back(static_cast<uint8_t>(i * 7));
+            }
+            response.push_back(0x90);
+            response.push_back(0x00);
+        }
+};
+
+int main(void)
+{
+    HostBench bench;
+    EchoTag echo({ 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 }, 8, 6, { 0x80, 0x01 });
+    bench.emulator.AttachTag(&echo);
+
+    // Activation: RATS after SELECT, frame size from the ATS
+    TagInfo tagInfo{};
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_A), tagInfo));
+    IsoDep* isoDep = bench.manager.GetIsoDep();
+    CHECK(isoDep->IsActive());
+    CHECK_EQ(isoDep->GetParameters().fsc, 256);
+    CHECK_EQ(isoDep->GetParameters().fwi, 6);
+
+    // 600-byte command and 700-byte response: chained in both directions
+    std::vector<uint8_t> command(600);
+    for (size_t i = 0; i < command.size(); i++) {
+        command[i] = static_cast<uint8_t>(i ^ 0x5A);
+    }
+    static uint8_t response[1024];
+    size_t responseLength = 0;
+    echo.responseLength = 700;
+    bench.ResetTraffic();
+    CHECK_STATUS(isoDep->Exchange(command.data(), command.size(), response, sizeof(response), responseLength), NFCStatus::OK);
+    CHECK_EQ(responseLength, 702);
+    CHECK(echo.lastCommand == command);
+    bool match = true;
+    for (size_t i = 0; i < 700; i++) {
+        match = match && response[i] == static_cast<uint8_t>(i * 7);
+    }
+    CHECK(match);
+    CHECK_EQ(isoDep->GetStatistics().chainedBlocksSent, 2);
+    CHECK_EQ(isoDep->GetStatistics().chainedBlocksReceived, 2);
+    CHECK_EQ(bench.Frames(), 5);
+
+    // A corrupted response block is recovered with R(NAK)
+    echo.responseLength = 10;
+    bench.emulator.InjectReceiveError(::ST25R3911B::IRQ_ERR_CRC);
+    CHECK_STATUS(isoDep->Exchange(command.data(), 5, response, sizeof(response), responseLength), NFCStatus::OK);
+    CHECK_EQ(responseLength, 12);
+    CHECK_EQ(isoDep->GetStatistics().retransmissions, 1);
+
+    // Presence check keeps the session: one R(NAK)/R(ACK) exchange
+    bench.ResetTraffic();
+    CHECK_STATUS(bench.manager.CheckPresence(), NFCStatus::OK);
+    CHECK(isoDep->IsActive());
+    CHECK_EQ(bench.Frames(), 1);
+
+    bench.manager.StopTagDetection();
+
+    // Type 4 NDEF: capability container, text round trip
+    bench.emulator.DetachAllTags();
+    VirtualType4Tag type4({ 0x04, 0x21, 0x22, 0x33, 0x44, 0x55, 0x66 }, 1024, 0x003B, 0x0034);
+    bench.emulator.AttachTag(&type4);
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_A), tagInfo));
+    TagReader* reader = bench.manager.GetTagReader();
+    TagWriter* writer = bench.manager.GetTagWriter();
+    Type4CapabilityContainer cc{};
+    CHECK_STATUS(reader->ReadType4Capability(cc), NFCStatus::OK);
+    CHECK_EQ(cc.maxReadSize, 0x003B);
+    CHECK_EQ(cc.maxWriteSize, 0x0034);
+    CHECK_EQ(cc.ndefFileSize, 1024);
+    std::string text(300, 'x');
+    for (size_t i = 0; i < text.size(); i++) {
+        text[i] = static_cast<char>('a' + i % 26);
+    }
+    std::string readText, language;
+    bench.ResetTraffic();
+    CHECK_STATUS(writer->WriteText(tagInfo, text, "de"), NFCStatus::OK);
+    CHECK_EQ(bench.Frames(), 11);
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadText(tagInfo, readText, language), NFCStatus::OK);
+    CHECK(readText == text);
+    CHECK(language == "de");
+    CHECK_EQ(bench.Frames(), 10);
+
+    return TestResult("testIsoDep");
+}
@@ -0,0 +1,166 @@
+/**
+ * @file    Host/Tests/testMifareClassic.cpp
+ * @brief   MIFARE Classic Host Test
+ * @details Crypto1 authentication, encrypted block reads within one sector session, nested
+ *          authentication, block and trailer writes, wrong keys and the sector-ordered card
+ *          dump.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+#include <algorithm>
+
+using namespace NFC;
+
+/**
+ * @brief Test pattern of a data block
+ * @param block Block number
+ * @return 16 bytes
+ */
+static std::vector<uint8_t> pattern(uint8_t block)
+{
+    std::vector<uint8_t> data(16);
+    for (uint8_t i = 0; i < 16; i++) {
+        data[i] = static_cast<uint8_t>(block * 16 + i);
+    }
+    return data;
+}
+
+int main(void)
+{
+    HostBench bench;
+    VirtualMifareClassicTag tag({ 0x9C, 0x59, 0x9B, 0x32 });
+    for (uint8_t block = 1; block < VirtualMifareClassicTag::BLOCK_COUNT; block++) {
+        if (block % 4 != 3) {
+            tag.SetMemory(block, pattern(block));
+        }
+    }
+    bench.emulator.AttachTag(&tag);
+
+    TagInfo tagInfo{};
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_A), tagInfo));
+    CHECK_STATUS(tagInfo.protocol, NFCProtocol::MIFARE_CLASSIC);
+    CHECK_EQ(tagInfo.sak, 0x08);
+    CHECK_EQ(tagInfo.dataSize, 1024);
+    MifareClassic* classic = bench.manager.GetMifareClassic();
+    TagReader* reader = bench.manager.GetTagReader();
+    TagWriter* writer = bench.manager.GetTagWriter();
+
+    // First authentication (AUTH, token RB, token AB) and the READ
+    std::vector<uint8_t> data;
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 5, 16, data), NFCStatus::OK);
+    CHECK(data == pattern(5));
+    CHECK_EQ(bench.Frames(), 3);
+    CHECK_EQ(tag.GetAuthentications(), 1);
+
+    // Same sector: no authentication
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 6, 16, data), NFCStatus::OK);
+    CHECK(data == pattern(6));
+    CHECK_EQ(bench.Frames(), 1);
+
+    // Sector trailer: key A reads as zeros, access bits and key B in clear
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 7, 16, data), NFCStatus::OK);
+    CHECK(data == std::vector<uint8_t>({ 0, 0, 0, 0, 0, 0, 0xFF, 0x07, 0x80, 0x69, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }));
+
+    // Next sector: nested authentication within the session
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 9, 16, data), NFCStatus::OK);
+    CHECK(data == pattern(9));
+    CHECK_EQ(bench.Frames(), 3);
+    CHECK_EQ(classic->GetStatistics().nestedAuthentications, 1);
+
+    // Write: WRITE and data phase, both acknowledged
+    std::vector<uint8_t> update(16, 0xA5);
+    bench.ResetTraffic();
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 10, update), NFCStatus::OK);
+    CHECK_EQ(bench.Frames(), 2);
+    CHECK(std::vector<uint8_t>(tag.GetMemory().begin() + 160, tag.GetMemory().begin() + 176) == update);
+    tag.SetMemory(10, pattern(10));
+
+    // Block 0 and sector trailers are refused before anything reaches the card
+    std::vector<uint8_t> trailer(tag.GetMemory().begin() + 48, tag.GetMemory().begin() + 64);
+    bench.ResetTraffic();
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 2, std::vector<uint8_t>(32, 0x5A)), NFCStatus::INVALID_PARAM);
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 0, update), NFCStatus::INVALID_PARAM);
+    CHECK_EQ(bench.Frames(), 0);
+    CHECK(std::vector<uint8_t>(tag.GetMemory().begin() + 48, tag.GetMemory().begin() + 64) == trailer);
+
+    // Trailer write: inconsistent access bits are refused, a new key A takes effect
+    static const uint8_t transportKey[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    static const uint8_t newKey[6] = { 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 };
+    static const uint8_t access[4] = { 0xFF, 0x07, 0x80, 0x69 };
+    static const uint8_t badAccess[4] = { 0xFF, 0x07, 0x88, 0x69 };
+    CHECK_STATUS(classic->WriteSectorTrailer(tagInfo, 4, newKey, badAccess, transportKey), NFCStatus::INVALID_PARAM);
+    CHECK_STATUS(classic->WriteSectorTrailer(tagInfo, 4, newKey, access, transportKey), NFCStatus::OK);
+    CHECK(std::equal(newKey, newKey + 6, tag.GetMemory().begin() + 19 * 16));
+    classic->SetKeyFunction([](const TagInfo&, uint8_t sector, MifareKey& key) {
+        if (sector == 4) {
+            std::copy(newKey, newKey + 6, key.bytes);
+        }
+    });
+    // Leave sector 4 so that it is authenticated again, now with the new key
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 0, 16, data), NFCStatus::OK);
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 17, 16, data), NFCStatus::OK);
+    CHECK(data == pattern(17));
+    CHECK_STATUS(classic->WriteSectorTrailer(tagInfo, 4, transportKey, access, transportKey), NFCStatus::OK);
+    classic->SetKeyFunction(nullptr);
+
+    // Wrong key: the card does not answer the reader token, the sector stays closed
+    classic->SetKeyFunction([](const TagInfo&, uint8_t sector, MifareKey& key) {
+        if (sector == 3) {
+            key.bytes[0] = 0x00;
+        }
+    });
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 12, 16, data), NFCStatus::AUTH_ERROR);
+    CHECK(classic->GetStatistics().authenticationFailures > 0);
+
+    // Dump: the wrong-key sector is reported missing, all others are read
+    std::vector<uint8_t> memory;
+    uint64_t sectorsRead = 0;
+    CHECK_STATUS(classic->Dump(tagInfo, memory, sectorsRead), NFCStatus::AUTH_ERROR);
+    CHECK_EQ(sectorsRead, 0xFFF7);
+    classic->SetKeyFunction(nullptr);
+
+    // Full 1K dump: the open sector first, then one nested authentication per sector and
+    // 64 reads, within 200 ms of air and SPI time
+    classic->ResetStatistics();
+    bench.ResetTraffic();
+    CHECK_STATUS(classic->Dump(tagInfo, memory, sectorsRead), NFCStatus::OK);
+    CHECK_EQ(sectorsRead, 0xFFFF);
+    CHECK_EQ(memory.size(), 1024);
+    bool match = true;
+    for (uint8_t block = 1; block < 64; block++) {
+        if (block % 4 != 3) {
+            match = match && std::vector<uint8_t>(memory.begin() + block * 16, memory.begin() + block * 16 + 16) == pattern(block);
+        }
+    }
+    CHECK(match);
+    CHECK_EQ(classic->GetStatistics().authentications + classic->GetStatistics().nestedAuthentications, 15);
+    CHECK_EQ(classic->GetStatistics().blocksRead, 64);
+    CHECK_EQ(bench.Frames(), 94);
+    CHECK(bench.emulator.GetElapsedUs() < 200000);
+
+    // A run of blocks across a sector boundary: one nested authentication per sector
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 13, 64, data), NFCStatus::OK);
+    CHECK(data.size() == 64 && std::vector<uint8_t>(data.begin(), data.begin() + 16) == pattern(13));
+    CHECK(data.size() == 64 && std::vector<uint8_t>(data.begin() + 48, data.end()) == pattern(16));
+    CHECK_EQ(bench.Frames(), 8);
+    std::vector<uint8_t> sector;
+    CHECK_STATUS(classic->ReadSector(tagInfo, 4, sector), NFCStatus::OK);
+    CHECK(sector.size() == 64 && std::vector<uint8_t>(sector.begin() + 16, sector.begin() + 32) == pattern(17));
+
+    // Card removed: the dump ends at the first sector
+    bench.emulator.DetachAllTags();
+    CHECK_STATUS(classic->Dump(tagInfo, memory, sectorsRead), NFCStatus::NO_TAG_FOUND);
+    CHECK_EQ(sectorsRead, 0);
+
+    return TestResult("testMifareClassic");
+}
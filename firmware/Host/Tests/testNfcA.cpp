@@ -0,0 +1,384 @@
+/**
+ * @file    Host/Tests/testNfcA.cpp
+ * @brief   ISO14443A / Type 2 Host Test
+ * @details REQA at driver level against an NTAG213 model, with the SPI cost of one short frame,
+ *          discovery and model identification of a 7-byte UID, FAST_READ and READ dumps, an
+ *          NDEF text behind control TLVs, differential and verified writes, anticollision of
+ *          colliding 7- and 10-byte UIDs, multi-tag inventory, a tear-safe NDEF update
+ *          interrupted by the tag leaving and verified writes repeating unacknowledged pages.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+#include <algorithm>
+
+using namespace NFC;
+
+/**
+ * @class TearingTag
+ * @brief Type 2 tag that leaves the field after a number of page writes.
+ */
+class TearingTag : public VirtualType2Tag
+{
+    public:
+        using VirtualType2Tag::VirtualType2Tag;
+
+        uint32_t tearAfter = 0;             /**< Page writes after which the tag is gone (0 = never) */
+
+        bool HandleFrame(const RfFrame& request, RfFrame& response) override
+        {
+            if (tearAfter != 0 && GetPageWrites() >= tearAfter) {
+                return false;
+            }
+            return VirtualType2Tag::HandleFrame(request, response);
+        }
+};
+
+/**
+ * @brief Tear-safe NDEF update: length cleared first and committed last
+ */
+static void testTearSafe(void)
+{
+    HostBench bench;
+    TearingTag tag({ 0x04, 0x41, 0x22, 0x33, 0x44, 0x55, 0x66 }, VirtualType2Tag::Model::NTAG215);
+    bench.emulator.AttachTag(&tag);
+    TagInfo tagInfo{};
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_A), tagInfo));
+    TagReader* reader = bench.manager.GetTagReader();
+    TagWriter* writer = bench.manager.GetTagWriter();
+    CHECK(writer->GetWriteConfig().tearSafe);
+
+    // A blank tag gets the message directly
+    std::string first(100, 'a');
+    uint32_t pageWrites = tag.GetPageWrites();
+    CHECK_STATUS(writer->WriteText(tagInfo, first), NFCStatus::OK);
+    // NDEF TLV from page 4: type, 1-byte length, message, Terminator TLV
+    uint32_t messagePages = (2 + tag.GetMemory()[17] + 1 + 3) / 4;
+    CHECK_EQ(tag.GetPageWrites() - pageWrites, messagePages);
+
+    // Replacing it costs one extra write: cleared length first, committed last
+    std::string second(100, 'b');
+    pageWrites = tag.GetPageWrites();
+    CHECK_STATUS(writer->WriteText(tagInfo, second), NFCStatus::OK);
+    CHECK_EQ(tag.GetPageWrites() - pageWrites, messagePages + 1);
+
+    // The tag leaves halfway through the body: the old message is not mixed with the new one
+    tag.tearAfter = tag.GetPageWrites() + messagePages / 2;
+    CHECK(writer->WriteText(tagInfo, std::string(100, 'c')) != NFCStatus::OK);
+    CHECK_EQ(tag.GetPageWrites(), tag.tearAfter);
+    tag.tearAfter = 0;
+    bench.manager.StopTagDetection();
+    bench.driver.SetField(NFCField::OFF);
+    bench.manager.ClearUidCache();
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_A), tagInfo));
+    NDEFMessage message;
+    CHECK_STATUS(reader->ReadNDEF(tagInfo, message), NFCStatus::INTERRUPTED_WRITE);
+    bench.manager.StopTagDetection();
+}
+
+/**
+ * @class NakTag
+ * @brief Type 2 tag that answers a number of page writes with a NAK.
+ */
+class NakTag : public VirtualType2Tag
+{
+    public:
+        using VirtualType2Tag::VirtualType2Tag;
+
+        uint32_t nakWrites = 0;             /**< Page writes still to be rejected */
+
+    protected:
+        bool handleActive(const RfFrame& request, RfFrame& response) override
+        {
+            if (nakWrites != 0 && !request.data.empty() && request.data[0] == 0xA2) {
+                // NAK 0x1 (CRC or parity error), the tag falls back to IDLE
+                nakWrites--;
+                setNibbleResponse(response, 0x01);
+                goIdle();
+                return true;
+            }
+            return VirtualType2Tag::handleActive(request, response);
+        }
+};
+
+/**
+ * @brief Verified writes repeat the pages that were not acknowledged, after reselecting the tag
+ */
+static void testWriteRetry(void)
+{
+    HostBench bench;
+    NakTag tag({ 0x04, 0x51, 0x22, 0x33, 0x44, 0x55, 0x66 }, VirtualType2Tag::Model::NTAG213);
+    bench.emulator.AttachTag(&tag);
+    TagInfo tagInfo{};
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_A), tagInfo));
+    TagWriter* writer = bench.manager.GetTagWriter();
+    WriteConfig writeConfig = writer->GetWriteConfig();
+    writeConfig.verify = true;
+    writer->SetWriteConfig(writeConfig);
+
+    // Corrupted ACK of the first page: the page reads back correctly but is written once more.
+    // Write, reselection (HLTA, WUPA, 2 cascade levels), 3 writes, FAST_READ, retry, READ.
+    std::vector<uint8_t> pages(16);
+    for (size_t i = 0; i < pages.size(); i++) {
+        pages[i] = static_cast<uint8_t>(0x30 + i);
+    }
+    uint32_t pageWrites = tag.GetPageWrites();
+    writer->ResetWriteStats();
+    bench.ResetTraffic();
+    bench.emulator.InjectReceiveError(::ST25R3911B::IRQ_ERR_PAR);
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 16, pages), NFCStatus::OK);
+    CHECK(std::equal(pages.begin(), pages.end(), tag.GetMemory().begin() + 16));
+    CHECK_EQ(tag.GetPageWrites() - pageWrites, 5);
+    CHECK_EQ(writer->GetWriteStats().unitsWritten, 4);
+    CHECK_EQ(writer->GetWriteStats().unitsRetried, 1);
+    CHECK_EQ(writer->GetWriteStats().unitsVerified, 4);
+    CHECK_EQ(writer->GetWriteStats().verifyErrors, 0);
+    CHECK_EQ(bench.Frames(), 11);
+
+    // NAK of the second page: the tag is reselected, the page written again
+    for (uint8_t& byte : pages) {
+        byte ^= 0xFF;
+    }
+    tag.nakWrites = 1;
+    pageWrites = tag.GetPageWrites();
+    writer->ResetWriteStats();
+    bench.ResetTraffic();
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 20, pages), NFCStatus::OK);
+    CHECK(std::equal(pages.begin(), pages.end(), tag.GetMemory().begin() + 20));
+    CHECK_EQ(tag.GetPageWrites() - pageWrites, 4);
+    CHECK_EQ(writer->GetWriteStats().unitsRetried, 1);
+    CHECK_EQ(writer->GetWriteStats().unitsVerified, 4);
+    CHECK_EQ(bench.Frames(), 11);
+
+    // A page rejected on every attempt fails verification after the retries
+    tag.nakWrites = 1 + writeConfig.retries;
+    writer->ResetWriteStats();
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 40, { 0x01, 0x02, 0x03, 0x04 }), NFCStatus::VERIFY_ERROR);
+    CHECK_EQ(writer->GetWriteStats().unitsRetried, writeConfig.retries);
+    CHECK_EQ(writer->GetWriteStats().verifyErrors, 1);
+
+    // Without verification a NAK ends the write
+    writeConfig.verify = false;
+    writer->SetWriteConfig(writeConfig);
+    tag.nakWrites = 1;
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 40, { 0x01, 0x02, 0x03, 0x04 }), NFCStatus::ERROR);
+    bench.manager.StopTagDetection();
+}
+
+int main(void)
+{
+    HostBench bench;
+    VirtualType2Tag tag({ 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 }, VirtualType2Tag::Model::NTAG213);
+    bench.emulator.AttachTag(&tag);
+
+    // REQA at driver level: SPI cost of one short frame
+    CHECK_STATUS(bench.driver.SetField(NFCField::ON), NFCStatus::OK);
+    bench.ResetTraffic();
+    CHECK_STATUS(bench.driver.ExecuteCommand(::ST25R3911B::CMD_TRANSMIT_REQA), NFCStatus::OK);
+    std::vector<uint8_t> atqa;
+    CHECK_STATUS(bench.driver.Receive(atqa, 10), NFCStatus::OK);
+    CHECK(atqa == std::vector<uint8_t>({ 0x44, 0x00 }));
+    CHECK_EQ(bench.emulator.GetStatistics().spiFrames, 7);
+    CHECK_EQ(bench.emulator.GetStatistics().spiBytes, 20);
+    CHECK_EQ(bench.emulator.GetStatistics().interrupts, 1);
+    CHECK_EQ(bench.Frames(), 1);
+
+    // Without a tag in the field the frame times out
+    bench.emulator.DetachTag(&tag);
+    CHECK_STATUS(bench.driver.ExecuteCommand(::ST25R3911B::CMD_TRANSMIT_REQA), NFCStatus::OK);
+    CHECK_STATUS(bench.driver.Receive(atqa, 10), NFCStatus::TIMEOUT);
+    bench.driver.SetField(NFCField::OFF);
+    bench.emulator.AttachTag(&tag);
+
+    // Discovery: anticollision over two cascade levels, GET_VERSION and READ_SIG
+    TagInfo tagInfo{};
+    bench.ResetTraffic();
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_A), tagInfo));
+    CHECK_STATUS(tagInfo.protocol, NFCProtocol::NFC_A);
+    CHECK(tagInfo.uid == std::vector<uint8_t>({ 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 }));
+    CHECK_EQ(tagInfo.sak, 0x00);
+    CHECK_EQ(static_cast<int>(tagInfo.model), static_cast<int>(TagModel::NTAG213));
+    CHECK_EQ(tagInfo.dataSize, 144);
+    CHECK_EQ(bench.Frames(), 7);
+    TagModelInfo modelInfo{};
+    CHECK(bench.manager.GetTagModel(tagInfo.uid, modelInfo));
+    CHECK_EQ(modelInfo.pageCount, 45);
+    CHECK_EQ(modelInfo.userSize, 144);
+    CHECK_EQ(modelInfo.version.size(), 8);
+    CHECK_EQ(modelInfo.signature.size(), 32);
+
+    // Header and user memory with FAST_READ: 40 pages in one frame, beyond the FIFO size
+    std::vector<uint8_t> image;
+    for (int i = 0; i < 144; i++) {
+        image.push_back(static_cast<uint8_t>(i * 7));
+    }
+    tag.SetMemory(4, image);
+    TagReader* reader = bench.manager.GetTagReader();
+    std::vector<uint8_t> data;
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 0, 160, data), NFCStatus::OK);
+    CHECK_EQ(data.size(), 160);
+    CHECK(std::equal(data.begin(), data.end(), tag.GetMemory().begin()));
+    CHECK_EQ(bench.Frames(), 1);
+
+    // Unaligned range: page numbers, not 16-byte block numbers. Served by the memory cache
+    // while the tag is present.
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 18, 30, data), NFCStatus::OK);
+    CHECK(data.size() == 30 && std::equal(data.begin(), data.end(), tag.GetMemory().begin() + 18));
+    CHECK_EQ(bench.Frames(), 0);
+    bench.manager.GetMemoryCache()->Clear();
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 18, 30, data), NFCStatus::OK);
+    CHECK(data.size() == 30 && std::equal(data.begin(), data.end(), tag.GetMemory().begin() + 18));
+    CHECK_EQ(bench.Frames(), 1);
+
+    // Unidentified tags are read with READ, 4 pages per frame
+    TagInfo unknown = tagInfo;
+    unknown.model = TagModel::UNKNOWN;
+    bench.manager.GetMemoryCache()->Clear();
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(unknown, 0, 160, data), NFCStatus::OK);
+    CHECK(data.size() == 160 && std::equal(data.begin(), data.end(), tag.GetMemory().begin()));
+    CHECK_EQ(bench.Frames(), 10);
+
+    // NDEF behind a Lock Control TLV and a NULL TLV: the write keeps the control TLV and fills
+    // the cache, the cold read gets CC and TLV headers in one frame and the rest of the
+    // message in another
+    tag.SetMemory(4, { 0x01, 0x03, 0xA0, 0x0C, 0x34, 0x00, 0x03, 0x00, 0xFE });
+    bench.manager.GetMemoryCache()->Clear();
+    TagWriter* writer = bench.manager.GetTagWriter();
+    std::string text = "{\"material\":\"PETG\",\"weight\":1000}";
+    std::string readText, language;
+    CHECK_STATUS(writer->WriteText(tagInfo, text), NFCStatus::OK);
+    const std::vector<uint8_t>& memory = tag.GetMemory();
+    CHECK(std::vector<uint8_t>(memory.begin() + 16, memory.begin() + 22) == std::vector<uint8_t>({ 0x01, 0x03, 0xA0, 0x0C, 0x34, 0x00 }));
+    CHECK_EQ(memory[22], 0x03);
+    CHECK_EQ(memory[24 + memory[23]], 0xFE);
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadText(tagInfo, readText, language), NFCStatus::OK);
+    CHECK(readText == text);
+    CHECK_EQ(bench.Frames(), 0);
+    bench.manager.GetMemoryCache()->Clear();
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadText(tagInfo, readText, language), NFCStatus::OK);
+    CHECK(readText == text);
+    CHECK(language == "en");
+    CHECK_EQ(bench.Frames(), 2);
+
+    // Differential write: the NDEF TLV spans 12 pages, a same-length update of the weight only
+    // rewrites the changed page(s). Most of the comparison comes from the cache, one read
+    // fetches the rest (the tear-safe update would clear and commit the length as well).
+    WriteConfig writeConfig = writer->GetWriteConfig();
+    writeConfig.differential = true;
+    writeConfig.tearSafe = false;
+    writer->SetWriteConfig(writeConfig);
+    writer->ResetWriteStats();
+    uint32_t pageWrites = tag.GetPageWrites();
+    bench.ResetTraffic();
+    CHECK_STATUS(writer->WriteText(tagInfo, "{\"material\":\"PETG\",\"weight\":0750}"), NFCStatus::OK);
+    uint32_t written = tag.GetPageWrites() - pageWrites;
+    CHECK(written >= 1 && written <= 2);
+    CHECK_EQ(writer->GetWriteStats().unitsWritten, written);
+    CHECK_EQ(writer->GetWriteStats().unitsSkipped, 12 - written);
+    CHECK_EQ(bench.Frames(), 1 + written);
+    CHECK_STATUS(reader->ReadText(tagInfo, readText, language), NFCStatus::OK);
+    CHECK(readText == "{\"material\":\"PETG\",\"weight\":0750}");
+    writeConfig.differential = false;
+
+    // Verified write: 16 pages read back with one FAST_READ
+    std::vector<uint8_t> pages(64);
+    for (size_t i = 0; i < pages.size(); i++) {
+        pages[i] = static_cast<uint8_t>(0xC0 + i);
+    }
+    writeConfig.verify = true;
+    writer->SetWriteConfig(writeConfig);
+    writer->ResetWriteStats();
+    bench.ResetTraffic();
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 32, pages), NFCStatus::OK);
+    CHECK(std::equal(pages.begin(), pages.end(), tag.GetMemory().begin() + 32));
+    CHECK_EQ(writer->GetWriteStats().unitsWritten, 16);
+    CHECK_EQ(writer->GetWriteStats().unitsVerified, 16);
+    CHECK_EQ(writer->GetWriteStats().unitsRetried, 0);
+    CHECK_EQ(bench.Frames(), 17);
+    writeConfig.verify = false;
+    writeConfig.tearSafe = true;
+    writer->SetWriteConfig(writeConfig);
+    bench.manager.StopTagDetection();
+
+    // Presented again: the model comes from the cache, no GET_VERSION or READ_SIG
+    bench.manager.ClearUidCache();
+    bench.driver.SetField(NFCField::OFF);
+    bench.ResetTraffic();
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_A), tagInfo));
+    CHECK_EQ(static_cast<int>(tagInfo.model), static_cast<int>(TagModel::NTAG213));
+    CHECK_EQ(bench.Frames(), 5);
+    bench.manager.StopTagDetection();
+
+    // Colliding 7- and 10-byte UIDs: the branch with a 1 at the first differing bit wins
+    VirtualType2Tag longUid({ 0x04, 0x91, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99 }, VirtualType2Tag::Model::NTAG213);
+    bench.emulator.AttachTag(&longUid);
+    bench.driver.SetField(NFCField::OFF);
+    bench.driver.SetField(NFCField::ON);
+    bench.ResetTraffic();
+    CHECK_STATUS(bench.driver.ExecuteCommand(::ST25R3911B::CMD_TRANSMIT_REQA), NFCStatus::OK);
+    CHECK_STATUS(bench.driver.Receive(atqa, 10), NFCStatus::OK);
+    TagInfo first{};
+    CHECK_STATUS(reader->Anticollision(first), NFCStatus::OK);
+    CHECK(first.uid == std::vector<uint8_t>({ 0x04, 0x91, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99 }));
+    CHECK(bench.emulator.GetStatistics().rfCollisions > 0);
+
+    // HLTA the selected tag, the other one is resolved next
+    std::vector<uint8_t> response;
+    bench.driver.TransmitReceive({ 0x50, 0x00 }, response, 1);
+    CHECK_STATUS(bench.driver.ExecuteCommand(::ST25R3911B::CMD_TRANSMIT_REQA), NFCStatus::OK);
+    CHECK_STATUS(bench.driver.Receive(atqa, 10), NFCStatus::OK);
+    TagInfo second{};
+    CHECK_STATUS(reader->Anticollision(second), NFCStatus::OK);
+    CHECK(second.uid == tag.GetUID());
+
+    // A known UID is selected again after HLTA and WUPA, without anticollision
+    bench.driver.TransmitReceive({ 0x50, 0x00 }, response, 1);
+    CHECK_STATUS(bench.driver.ExecuteCommand(::ST25R3911B::CMD_TRANSMIT_WUPA), NFCStatus::OK);
+    CHECK_STATUS(bench.driver.Receive(atqa, 10), NFCStatus::OK);
+    uint8_t sak = 0xFF;
+    CHECK_STATUS(reader->Select(second.uid, sak), NFCStatus::OK);
+    CHECK_EQ(sak, 0x00);
+
+    // Inventory: three tags resolved in one field session, each halted after its session
+    VirtualType2Tag third({ 0x04, 0x31, 0x22, 0x33, 0x44, 0x55, 0x67 }, VirtualType2Tag::Model::NTAG216);
+    bench.emulator.AttachTag(&third);
+    std::vector<TagInfo> tags;
+    int sessions = 0;
+    bench.ResetTraffic();
+    CHECK_STATUS(bench.manager.RunInventory(tags, [&](const TagInfo&) { sessions++; }), NFCStatus::OK);
+    CHECK_EQ(tags.size(), 3);
+    CHECK_EQ(sessions, 3);
+    CHECK(bench.emulator.GetStatistics().rfCollisions > 0);
+    CHECK_EQ(bench.Frames(), 27);
+
+    // Inventory mode of the discovery: the callback gets the tag list of each cycle
+    DiscoveryConfig config = bench.manager.GetDiscoveryConfig();
+    config.inventory = true;
+    bench.manager.SetDiscoveryConfig(config);
+    std::vector<TagInfo> cycleTags;
+    bench.manager.SetInventoryCallback([&](const std::vector<TagInfo>& found) { cycleTags = found; });
+    sessions = 0;
+    bench.manager.StartTagDetection(ProtocolBit(NFCProtocol::NFC_A), [&](const TagInfo&) { sessions++; });
+    bench.Run(2000, [&]() { return !cycleTags.empty(); });
+    CHECK_EQ(cycleTags.size(), 3);
+    CHECK_EQ(sessions, 3);
+    CHECK_EQ(bench.manager.GetInventoryStats().lastCycleTags, 3);
+    CHECK(bench.manager.GetInventoryStats().tagsPerSecond > 0);
+    bench.manager.StopTagDetection();
+
+    testTearSafe();
+    testWriteRetry();
+
+    return TestResult("testNfcA");
+}
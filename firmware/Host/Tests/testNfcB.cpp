@@ -0,0 +1,74 @@
+/**
+ * @file    Host/Tests/testNfcB.cpp
+ * @brief   ISO14443B Host Test
+ * @details Discovery and ATTRIB activation of a single Type B tag, then slotted anticollision
+ *          of three tags in the field.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+#include <set>
+
+using namespace NFC;
+
+int main(void)
+{
+    HostBench bench;
+    VirtualTypeBTag first({ 0x11, 0x22, 0x33, 0x44 });
+    VirtualTypeBTag second({ 0x55, 0x66, 0x77, 0x88 }, { 0x01, 0x02, 0x03, 0x04 });
+    VirtualTypeBTag third({ 0x99, 0xAA, 0xBB, 0xCC });
+    bench.emulator.AttachTag(&first);
+
+    // Single tag: REQB, ATTRIB
+    TagInfo tagInfo{};
+    bench.ResetTraffic();
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_B), tagInfo));
+    CHECK_STATUS(tagInfo.protocol, NFCProtocol::NFC_B);
+    CHECK(tagInfo.uid == first.GetPUPI());
+    CHECK_EQ(tagInfo.protocolInfo.size(), 3);
+    CHECK(first.GetState() == VirtualTypeBTag::State::ACTIVE);
+    CHECK_EQ(bench.Frames(), 2);
+    CHECK_EQ(bench.emulator.GetStatistics().rfCollisions, 0);
+    bench.manager.StopTagDetection();
+
+    // Three tags: one is resolved through the time slots and activated, taking it out of the
+    // field brings up the next one
+    bench.emulator.DetachTag(&first);
+    bench.Run(2000, [&]() { return !bench.manager.HasCurrentTag(); });
+    CHECK(!bench.manager.HasCurrentTag());
+    VirtualTypeBTag* tags[] = { &first, &second, &third };
+    for (VirtualTypeBTag* tag : tags) {
+        bench.emulator.AttachTag(tag);
+    }
+    std::set<std::vector<uint8_t>> pupis;
+    std::vector<uint8_t> appData;
+    TagInfo detected{};
+    bench.manager.StartTagDetection(ProtocolBit(NFCProtocol::NFC_B), [&](const TagInfo& tag) {
+        pupis.insert(tag.uid);
+        detected = tag;
+        if (tag.uid == second.GetPUPI()) {
+            appData = tag.appData;
+        }
+    });
+    bench.ResetTraffic();
+    for (size_t count = 1; count <= 3; count++) {
+        bench.Run(2000, [&]() { return pupis.size() == count; });
+        CHECK_EQ(pupis.size(), count);
+        for (VirtualTypeBTag* tag : tags) {
+            if (tag->GetPUPI() == detected.uid) {
+                bench.emulator.DetachTag(tag);
+            }
+        }
+        bench.Run(2000, [&]() { return !bench.manager.HasCurrentTag(); });
+    }
+    CHECK(appData == std::vector<uint8_t>({ 0x01, 0x02, 0x03, 0x04 }));
+    CHECK(bench.emulator.GetStatistics().rfCollisions > 0);
+    CHECK_EQ(bench.Frames(), 43);
+
+    return TestResult("testNfcB");
+}
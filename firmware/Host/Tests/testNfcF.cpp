@@ -0,0 +1,64 @@
+/**
+ * @file    Host/Tests/testNfcF.cpp
+ * @brief   FeliCa Host Test
+ * @details Time-slot polling of several cards, system code filtering and discovery of a
+ *          single card.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+
+using namespace NFC;
+
+int main(void)
+{
+    HostBench bench;
+    VirtualFelicaTag first({ 0x01, 0x2E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 });
+    VirtualFelicaTag second({ 0x01, 0x2E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 });
+    VirtualFelicaTag third({ 0x01, 0x2E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 }, {}, 0x0003);
+    bench.emulator.AttachTag(&first);
+    bench.emulator.AttachTag(&second);
+    bench.emulator.AttachTag(&third);
+
+    // 16 time slots: a single SENSF_REQ collects every card
+    CHECK_STATUS(bench.driver.SetField(NFCField::ON), NFCStatus::OK);
+    FelicaConfig config = bench.manager.GetFelicaConfig();
+    config.timeSlots = 16;
+    bench.manager.SetFelicaConfig(config);
+    std::vector<TagInfo> cards;
+    bench.ResetTraffic();
+    CHECK_STATUS(bench.manager.PollFelica(cards), NFCStatus::OK);
+    CHECK_EQ(cards.size(), 3);
+    CHECK_EQ(bench.Frames(), 1);
+
+    // System code filter with request code: only the matching card answers, with its system code
+    config.systemCode = 0x0003;
+    config.requestCode = 1;
+    bench.manager.SetFelicaConfig(config);
+    cards.clear();
+    CHECK_STATUS(bench.manager.PollFelica(cards), NFCStatus::OK);
+    CHECK_EQ(cards.size(), 1);
+    CHECK(!cards.empty() && cards[0].uid == third.GetIDm());
+    CHECK(!cards.empty() && cards[0].protocolInfo == std::vector<uint8_t>({ 0x00, 0x03 }));
+    config.systemCode = 0xFFFF;
+    config.requestCode = 0;
+    bench.manager.SetFelicaConfig(config);
+    bench.driver.SetField(NFCField::OFF);
+
+    // Discovery of a single card
+    bench.emulator.DetachAllTags();
+    bench.emulator.AttachTag(&second);
+    TagInfo tagInfo{};
+    bench.ResetTraffic();
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_F), tagInfo));
+    CHECK_STATUS(tagInfo.protocol, NFCProtocol::NFC_F);
+    CHECK(tagInfo.uid == second.GetIDm());
+    CHECK_EQ(bench.Frames(), 1);
+
+    return TestResult("testNfcF");
+}
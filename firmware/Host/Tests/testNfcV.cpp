@@ -0,0 +1,93 @@
+/**
+ * @file    Host/Tests/testNfcV.cpp
+ * @brief   ISO15693 / Type 5 Host Test
+ * @details 16-slot inventory of several tags, READ MULTIPLE BLOCKS dumps, partial writes and
+ *          an NDEF round trip on a formatted tag.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+#include <algorithm>
+
+using namespace NFC;
+
+int main(void)
+{
+    HostBench bench;
+    std::vector<VirtualType5Tag> tags;
+    tags.reserve(6);
+    for (uint8_t i = 0; i < 6; i++) {
+        tags.emplace_back(std::vector<uint8_t>({ 0xE0, 0x04, 0x01, 0x50, 0x11, 0x22, i, static_cast<uint8_t>(i * 37 + 5) }), 80, 4, i);
+    }
+    for (VirtualType5Tag& tag : tags) {
+        bench.emulator.AttachTag(&tag);
+    }
+
+    // Inventory: collided slots are resolved with longer masks
+    CHECK_STATUS(bench.driver.SetField(NFCField::ON), NFCStatus::OK);
+    std::vector<TagInfo> found;
+    bench.ResetTraffic();
+    CHECK_STATUS(bench.manager.PollVicinity(found), NFCStatus::OK);
+    CHECK_EQ(found.size(), 6);
+    for (const TagInfo& tagInfo : found) {
+        CHECK(std::any_of(tags.begin(), tags.end(), [&](const VirtualType5Tag& tag) { return tag.GetUID() == tagInfo.uid; }));
+    }
+    CHECK_EQ(bench.Frames(), 16);
+
+    // Single tag: 1 KB dump with READ MULTIPLE BLOCKS
+    bench.emulator.DetachAllTags();
+    VirtualType5Tag big({ 0xE0, 0x04, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 }, 256, 4);
+    std::vector<uint8_t> image(1024);
+    for (size_t i = 0; i < image.size(); i++) {
+        image[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+    big.SetMemory(0, image);
+    bench.emulator.AttachTag(&big);
+    found.clear();
+    CHECK_STATUS(bench.manager.PollVicinity(found), NFCStatus::OK);
+    CHECK_EQ(found.size(), 1);
+    if (found.empty()) {
+        return TestResult("testNfcV");
+    }
+    TagInfo tagInfo = found[0];
+    TagReader* reader = bench.manager.GetTagReader();
+    std::vector<uint8_t> data;
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadRawData(tagInfo, 0, 1024, data), NFCStatus::OK);
+    CHECK(data == image);
+    CHECK_EQ(bench.Frames(), 4);
+
+    // Unaligned write: only the touched blocks are written, their neighbours kept
+    TagWriter* writer = bench.manager.GetTagWriter();
+    std::vector<uint8_t> update = { 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x11 };
+    uint32_t writes = big.GetBlockWrites();
+    CHECK_STATUS(writer->WriteRawData(tagInfo, 6, update), NFCStatus::OK);
+    CHECK_EQ(big.GetBlockWrites() - writes, 3);
+    CHECK(std::equal(update.begin(), update.end(), big.GetMemory().begin() + 6));
+    CHECK(big.GetMemory()[5] == image[5] && big.GetMemory()[13] == image[13]);
+
+    // NDEF text on a formatted tag: 4-byte CC (MLEN 127, MBREAD), empty NDEF TLV, Terminator TLV
+    tagInfo.blockSize = 4;
+    tagInfo.dataSize = 1024;
+    std::string text = "{\"material\":\"PLA\",\"weight\":750}";
+    std::string readText, language;
+    CHECK_STATUS(writer->FormatTag(tagInfo), NFCStatus::OK);
+    CHECK(std::equal(big.GetMemory().begin(), big.GetMemory().begin() + 7, std::vector<uint8_t>({ 0xE1, 0x40, 0x7F, 0x01, 0x03, 0x00, 0xFE }).begin()));
+    CHECK_STATUS(writer->WriteText(tagInfo, text), NFCStatus::OK);
+    Type5CapabilityContainer cc{};
+    CHECK_STATUS(reader->ReadType5Capability(tagInfo, cc), NFCStatus::OK);
+    CHECK_EQ(cc.areaSize, 1016);
+    CHECK(cc.multipleBlockRead);
+    bench.manager.GetMemoryCache()->Clear();
+    bench.ResetTraffic();
+    CHECK_STATUS(reader->ReadText(tagInfo, readText, language), NFCStatus::OK);
+    CHECK(readText == text);
+    CHECK_EQ(bench.Frames(), 1);
+
+    return TestResult("testNfcV");
+}
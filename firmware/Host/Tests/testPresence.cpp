@@ -0,0 +1,142 @@
+/**
+ * @file    Host/Tests/testPresence.cpp
+ * @brief   Presence Check Host Test
+ * @details RF cost of the periodic presence check per tag type, and a tag leaving the field
+ *          while it is present: one removal callback (after the UID cache TTL), and
+ *          CheckPresence() fails without RF traffic so that write commands end early with
+ *          NO_TAG_FOUND.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+
+using namespace NFC;
+
+/**
+ * @class PlainTypeATag
+ * @brief ISO14443-3A tag without a command set (re-activated by the presence check).
+ */
+class PlainTypeATag : public VirtualTypeATag
+{
+    public:
+        using VirtualTypeATag::VirtualTypeATag;
+
+    protected:
+        bool handleActive(const RfFrame& /* request */, RfFrame& /* response */) override { return false; }
+};
+
+/**
+ * @brief Detect a tag, measure one presence check, then remove the tag
+ * @param tag Tag model
+ * @param protocols Protocols to poll
+ * @param checkFrames Expected RF frames of one successful presence check
+ * @param removalFrames Expected RF frames of the failing check (including retries)
+ */
+static void checkPresenceAndRemoval(VirtualTag& tag, uint32_t protocols, uint32_t checkFrames, uint32_t removalFrames)
+{
+    HostBench bench;
+    const DiscoveryStats& stats = bench.manager.GetDiscoveryStats();
+    int removals = 0;
+    TagInfo removed{};
+    bench.manager.SetRemovalCallback([&](const TagInfo& tagInfo) { removed = tagInfo; removals++; });
+
+    bench.emulator.AttachTag(&tag);
+    TagInfo tagInfo{};
+    CHECK(bench.Detect(protocols, tagInfo));
+
+    // Periodic checks while the tag stays
+    uint32_t checks = stats.presenceChecks;
+    bench.ResetTraffic();
+    bench.Run(2000, [&]() { return stats.presenceChecks == checks + 1; });
+    CHECK_EQ(bench.Frames(), checkFrames);
+    bench.ResetTraffic();
+    bench.Run(1000, []() { return false; });
+    CHECK_EQ(stats.presenceChecks, checks + 6);
+    CHECK_EQ(bench.Frames(), 5 * checkFrames);
+    CHECK_EQ(removals, 0);
+
+    // The tag leaves: one failing check with its retries, polling resumes
+    bench.emulator.DetachTag(&tag);
+    checks = stats.presenceChecks;
+    bench.ResetTraffic();
+    bench.Run(2000, [&]() { return !bench.manager.HasCurrentTag(); });
+    CHECK(!bench.manager.HasCurrentTag());
+    CHECK_EQ(stats.presenceChecks, checks + 1);
+    CHECK_EQ(bench.Frames(), removalFrames);
+
+    // One removal event once the UID cache TTL has passed
+    uint32_t ttlMs = bench.manager.GetUidCacheConfig().ttlMs;
+    TickType_t lost = xTaskGetTickCount();
+    bench.Run(2 * ttlMs, [&]() { return removals > 0; });
+    CHECK_EQ(removals, 1);
+    CHECK(xTaskGetTickCount() - lost >= ttlMs - bench.manager.GetDiscoveryConfig().presencePeriodMs);
+    CHECK(removed.uid == tagInfo.uid);
+
+    // Write commands check presence first: no tag, no RF traffic
+    bench.ResetTraffic();
+    CHECK_STATUS(bench.manager.CheckPresence(), NFCStatus::NO_TAG_FOUND);
+    CHECK_EQ(bench.Frames(), 0);
+
+    // Polling resumes, the event is not repeated
+    bench.Run(1000, []() { return false; });
+    CHECK_EQ(removals, 1);
+    CHECK_EQ(stats.tagsRemoved, 1);
+}
+
+/**
+ * @brief Presence check of one NFC-V tag among several
+ */
+static void checkCrowdedTypeV(void)
+{
+    HostBench bench;
+    const DiscoveryStats& stats = bench.manager.GetDiscoveryStats();
+    VirtualType5Tag first({ 0xE0, 0x04, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 }, 64, 4);
+    VirtualType5Tag second({ 0xE0, 0x04, 0x01, 0x02, 0x03, 0x04, 0x05, 0x16 }, 64, 4);
+    bench.emulator.AttachTag(&first);
+    bench.emulator.AttachTag(&second);
+    TagInfo tagInfo{};
+    CHECK(bench.Detect(ProtocolBit(NFCProtocol::NFC_V), tagInfo));
+
+    // The other tag does not answer the masked INVENTORY: no 16-slot round per check
+    uint32_t checks = stats.presenceChecks;
+    bench.ResetTraffic();
+    bench.Run(2000, [&]() { return stats.presenceChecks == checks + 1; });
+    CHECK_EQ(bench.Frames(), 1);
+    CHECK_EQ(bench.emulator.GetStatistics().rfCollisions, 0);
+    CHECK(bench.manager.HasCurrentTag());
+}
+
+int main(void)
+{
+    // Type 2: READ of page 0, the tag stays selected; a lost tag costs the READ and two
+    // re-activations (HLTA, WUPA)
+    VirtualType2Tag type2({ 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 }, VirtualType2Tag::Model::NTAG213);
+    checkPresenceAndRemoval(type2, ProtocolBit(NFCProtocol::NFC_A), 1, 5);
+
+    // Other NFC-A tags: HLTA, WUPA, SELECT
+    PlainTypeATag classic({ 0x11, 0x22, 0x33, 0x44 }, 0x0004, 0x08);
+    checkPresenceAndRemoval(classic, ProtocolBit(NFCProtocol::NFC_A), 3, 6);
+
+    // ISO-DEP (A and B): a single R(NAK)/R(ACK) exchange keeps the session; a lost tag costs
+    // the R(NAK) and two re-activations (S(DESELECT), wake-up)
+    VirtualIsoDepTag isoDepA({ 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 });
+    checkPresenceAndRemoval(isoDepA, ProtocolBit(NFCProtocol::NFC_A), 1, 5);
+    VirtualIsoDepBTag isoDepB({ 0x11, 0x22, 0x33, 0x44 });
+    checkPresenceAndRemoval(isoDepB, ProtocolBit(NFCProtocol::NFC_B), 1, 5);
+
+    // FeliCa: one SENSF_REQ over all time slots; a lost card is re-polled twice
+    VirtualFelicaTag felica({ 0x01, 0x2E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 });
+    checkPresenceAndRemoval(felica, ProtocolBit(NFCProtocol::NFC_F), 1, 3);
+
+    // NFC-V: single slot INVENTORY masked with the UID, also while other tags are in the field
+    VirtualType5Tag typeV({ 0xE0, 0x04, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 }, 64, 4);
+    checkPresenceAndRemoval(typeV, ProtocolBit(NFCProtocol::NFC_V), 1, 3);
+    checkCrowdedTypeV();
+
+    return TestResult("testPresence");
+}
@@ -0,0 +1,96 @@
+/**
+ * @file    Host/Tests/testReceiveErrors.cpp
+ * @brief   Receive Error Host Test
+ * @details Each receive error interrupt maps to its own status and counter, and the driver
+ *          returns as soon as the chip flags the error instead of waiting for the timeout.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+
+using namespace NFC;
+
+/** @brief Receive timeout of the exchanges in milliseconds */
+static constexpr uint32_t RECEIVE_TIMEOUT_MS = 50;
+
+/**
+ * @brief Send REQA with an injected receive error
+ * @param bench Test bench
+ * @param errorIrq Error interrupt flags to inject (0 = none)
+ * @return Receive status
+ */
+static NFCStatus reqaWithError(HostBench& bench, uint8_t errorIrq)
+{
+    // Field reset: the tag answers REQA only when IDLE
+    bench.driver.SetField(NFCField::OFF);
+    bench.driver.SetField(NFCField::ON);
+    bench.emulator.InjectReceiveError(errorIrq);
+
+    std::vector<uint8_t> atqa;
+    TickType_t start = xTaskGetTickCount();
+    bench.driver.ExecuteCommand(::ST25R3911B::CMD_TRANSMIT_REQA);
+    NFCStatus status = bench.driver.Receive(atqa, RECEIVE_TIMEOUT_MS);
+
+    // Errors fail fast, only a missing answer waits for the timeout
+    if (status != NFCStatus::TIMEOUT) {
+        CHECK(xTaskGetTickCount() - start < RECEIVE_TIMEOUT_MS);
+    }
+    return status;
+}
+
+int main(void)
+{
+    HostBench bench;
+    VirtualType2Tag tag({ 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 }, VirtualType2Tag::Model::NTAG213);
+    bench.emulator.AttachTag(&tag);
+    const ErrorCounters& counters = bench.driver.GetErrorCounters();
+
+    // One status and one counter per error class
+    CHECK_STATUS(reqaWithError(bench, ::ST25R3911B::IRQ_ERR_CRC), NFCStatus::CRC_ERROR);
+    CHECK_EQ(counters.crc, 1);
+    CHECK_STATUS(reqaWithError(bench, ::ST25R3911B::IRQ_ERR_PAR), NFCStatus::PARITY_ERROR);
+    CHECK_EQ(counters.parity, 1);
+    CHECK_STATUS(reqaWithError(bench, ::ST25R3911B::IRQ_ERR_ERR1), NFCStatus::FRAMING_ERROR);
+    CHECK_EQ(counters.hardFraming, 1);
+    CHECK_STATUS(reqaWithError(bench, ::ST25R3911B::IRQ_ERR_ERR2), NFCStatus::SOFT_FRAMING_ERROR);
+    CHECK_EQ(counters.softFraming, 1);
+    CHECK_EQ(bench.emulator.GetStatistics().rfErrors, 4);
+
+    // Several flags: every class is counted, the most severe one is returned
+    CHECK_STATUS(reqaWithError(bench, ::ST25R3911B::IRQ_ERR_CRC | ::ST25R3911B::IRQ_ERR_PAR), NFCStatus::PARITY_ERROR);
+    CHECK_STATUS(reqaWithError(bench, ::ST25R3911B::IRQ_ERR_MASK), NFCStatus::FRAMING_ERROR);
+    CHECK_EQ(counters.crc, 3);
+    CHECK_EQ(counters.parity, 3);
+    CHECK_EQ(counters.hardFraming, 2);
+    CHECK_EQ(counters.softFraming, 2);
+
+    // A clean frame after the errors
+    CHECK_STATUS(reqaWithError(bench, 0), NFCStatus::OK);
+    CHECK_EQ(counters.timeout, 0);
+    CHECK_EQ(counters.collision, 0);
+
+    // Two tags answer the anticollision frame with different UIDs
+    VirtualType2Tag second({ 0x04, 0x21, 0x22, 0x33, 0x44, 0x55, 0x66 }, VirtualType2Tag::Model::NTAG213);
+    bench.emulator.AttachTag(&second);
+    CHECK_STATUS(reqaWithError(bench, 0), NFCStatus::OK);
+    std::vector<uint8_t> response;
+    CHECK_STATUS(bench.driver.Transmit({ 0x93, 0x20 }, false), NFCStatus::OK);
+    CHECK_STATUS(bench.driver.Receive(response, RECEIVE_TIMEOUT_MS), NFCStatus::COLLISION_ERROR);
+    CHECK_EQ(counters.collision, 1);
+
+    // No tag: the no-response timer ends the wait
+    bench.emulator.DetachAllTags();
+    CHECK_STATUS(reqaWithError(bench, 0), NFCStatus::TIMEOUT);
+    CHECK_EQ(counters.timeout, 1);
+
+    bench.driver.ResetErrorCounters();
+    CHECK_EQ(counters.crc + counters.parity + counters.hardFraming + counters.softFraming, 0);
+    CHECK_EQ(counters.collision + counters.timeout, 0);
+
+    return TestResult("testReceiveErrors");
+}
@@ -0,0 +1,127 @@
+/**
+ * @file    Host/Tests/testSignal.cpp
+ * @brief   Signal Quality Host Test
+ * @details Rolling RSSI statistics of the active tag, the receiver boost hysteresis as the
+ *          antenna coupling of the tag changes and the accounting of lost responses.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+
+using namespace NFC;
+
+/**
+ * @brief Send REQA frames, each after a field reset so the tags are IDLE again
+ * @param bench Test bench
+ * @param count Number of frames
+ * @return Number of frames answered
+ */
+static int sendReqa(HostBench& bench, int count)
+{
+    int answered = 0;
+    for (int i = 0; i < count; i++) {
+        std::vector<uint8_t> atqa;
+        bench.driver.SetField(NFCField::OFF);
+        bench.driver.SetField(NFCField::ON);
+        bench.driver.ExecuteCommand(::ST25R3911B::CMD_TRANSMIT_REQA);
+        if (bench.driver.Receive(atqa, 5) == NFCStatus::OK) {
+            answered++;
+        }
+    }
+    return answered;
+}
+
+int main(void)
+{
+    HostBench bench;
+    std::vector<uint8_t> uid = { 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+    VirtualType2Tag tag(uid, VirtualType2Tag::Model::NTAG213);
+    bench.emulator.AttachTag(&tag);
+    bench.manager.SetField(NFCField::ON);
+    bench.manager.SetSignalPolicy(SignalPolicy{ true, 6, 9, 4, 3 });
+    bench.manager.SetActiveTag(uid);
+
+    // Rolling statistics of a tag at a steady distance
+    SignalStats stats{};
+    SignalStats unchanged{};
+    tag.SetCoupling(10);
+    CHECK_EQ(sendReqa(bench, 8), 8);
+    CHECK(bench.manager.GetSignalStats(uid, stats));
+    CHECK_EQ(stats.frames, 8);
+    CHECK_EQ(stats.lostFrames, 0);
+    CHECK_EQ(stats.weakFrames, 0);
+    CHECK_EQ(stats.lastRssi, 10);
+    CHECK_EQ(stats.minRssi, 10);
+    CHECK_EQ(stats.maxRssi, 10);
+    CHECK_EQ(stats.averageRssi >> 4, 10);
+    CHECK(!bench.driver.IsReceiverBoosted());
+
+    // Tag moves away: the average falls below weakRssi and the receiver is boosted
+    tag.SetCoupling(3);
+    CHECK_EQ(sendReqa(bench, 8), 8);
+    CHECK(bench.manager.GetSignalStats(uid, stats));
+    CHECK_EQ(stats.weakFrames, 8);
+    CHECK_EQ(stats.minRssi, 3);
+    CHECK(bench.driver.IsReceiverBoosted());
+
+    // Between the thresholds the boost is kept
+    tag.SetCoupling(8);
+    sendReqa(bench, 12);
+    CHECK(bench.manager.GetSignalStats(uid, stats));
+    CHECK_EQ(stats.averageRssi >> 4, 7);
+    CHECK(bench.driver.IsReceiverBoosted());
+
+    // Once the average reaches strongRssi the saved receiver configuration is restored
+    tag.SetCoupling(10);
+    sendReqa(bench, 12);
+    CHECK(bench.manager.GetSignalStats(uid, stats));
+    CHECK(stats.averageRssi >> 4 >= 9);
+    CHECK(!bench.driver.IsReceiverBoosted());
+    CHECK_EQ(stats.maxRssi, 10);
+    CHECK_EQ(stats.frames, 40);
+
+    // A tag too weak for the normal gain is only heard once the receiver is boosted.
+    // Lost frames carry no RSSI and leave the average alone; a run of lostLimit boosts.
+    uint16_t average = stats.averageRssi;
+    tag.SetCoupling(1);
+    CHECK_EQ(sendReqa(bench, 1), 0);
+    CHECK(!bench.driver.IsReceiverBoosted());
+    CHECK(bench.manager.GetSignalStats(uid, stats));
+    CHECK_EQ(stats.lostFrames, 1);
+    CHECK_EQ(stats.averageRssi, average);
+    sendReqa(bench, 2);
+    CHECK(bench.driver.IsReceiverBoosted());
+    CHECK(bench.manager.GetSignalStats(uid, stats));
+    CHECK_EQ(stats.lostFrames, 3);
+    CHECK_EQ(stats.consecutiveLost, 3);
+    CHECK_EQ(stats.averageRssi, average);
+    CHECK_EQ(sendReqa(bench, 2), 2);
+    CHECK(bench.manager.GetSignalStats(uid, stats));
+    CHECK_EQ(stats.lastRssi, 1);
+    CHECK_EQ(stats.consecutiveLost, 0);
+    CHECK_EQ(stats.averageRssi >> 4, 1);
+    CHECK(bench.driver.IsReceiverBoosted());
+
+    // Empty polling and inventory slots are not lost responses
+    std::vector<TagInfo> found;
+    CHECK_STATUS(bench.manager.PollFelica(found), NFCStatus::TIMEOUT);
+    CHECK_STATUS(bench.manager.PollVicinity(found), NFCStatus::TIMEOUT);
+    CHECK(bench.manager.GetSignalStats(uid, unchanged));
+    CHECK_EQ(unchanged.lostFrames, stats.lostFrames);
+    CHECK_EQ(unchanged.consecutiveLost, 0);
+    bench.driver.SetProtocol(NFCProtocol::NFC_A);
+
+    // Frames of other tags are not accounted to this one
+    bench.manager.SetActiveTag({});
+    sendReqa(bench, 2);
+    CHECK(bench.manager.GetSignalStats(uid, unchanged));
+    CHECK_EQ(unchanged.frames, stats.frames);
+    CHECK(!bench.manager.GetSignalStats({ 0x01, 0x02, 0x03, 0x04 }, unchanged));
+
+    return TestResult("testSignal");
+}
@@ -0,0 +1,164 @@
+/**
+ * @file    Host/Tests/testUidCache.cpp
+ * @brief   UID Cache Host Test
+ * @details De-duplication of detections: a tag that bounces out of the field and back within
+ *          the TTL is reported once, each sighting in inventory mode gets one session, and a
+ *          full cache evicts the least recently seen tag with a removal event.
+ * @author  MootSeeker
+ *
+ * @copyright (c) 2025 Cascalio Studio - All Rights Reserved
+ */
+
+/**
+ * @include necessary headers
+ */
+#include "hostTest.h"
+#include <algorithm>
+#include <memory>
+
+using namespace NFC;
+
+/**
+ * @struct Events
+ * @brief Detection and removal callbacks seen by a test.
+ */
+struct Events
+{
+    std::vector<std::vector<uint8_t>> detected;     /**< UIDs passed to the detection callback */
+    std::vector<std::vector<uint8_t>> removed;      /**< UIDs passed to the removal callback */
+};
+
+/**
+ * @brief Tag leaving and re-entering the field
+ */
+static void testBounce(void)
+{
+    HostBench bench;
+    Events events;
+    bench.manager.SetRemovalCallback([&](const TagInfo& tag) { events.removed.push_back(tag.uid); });
+    uint32_t ttlMs = bench.manager.GetUidCacheConfig().ttlMs;
+    CHECK(bench.manager.GetUidCacheConfig().enabled);
+
+    VirtualType2Tag tag({ 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 }, VirtualType2Tag::Model::NTAG213);
+    bench.emulator.AttachTag(&tag);
+    bench.manager.StartTagDetection(ProtocolBit(NFCProtocol::NFC_A), [&](const TagInfo& found) {
+        events.detected.push_back(found.uid);
+    });
+    bench.Run(1000, [&]() { return !events.detected.empty(); });
+    CHECK_EQ(events.detected.size(), 1);
+
+    // Out of the field for less than the TTL: re-activated silently
+    bench.emulator.DetachTag(&tag);
+    bench.Run(1000, [&]() { return !bench.manager.HasCurrentTag(); });
+    CHECK(!bench.manager.HasCurrentTag());
+    bench.Run(ttlMs / 2, []() { return false; });
+    bench.emulator.AttachTag(&tag);
+    bench.Run(ttlMs, [&]() { return bench.manager.HasCurrentTag(); });
+    CHECK(bench.manager.HasCurrentTag());
+    CHECK_EQ(events.detected.size(), 1);
+    CHECK_EQ(events.removed.size(), 0);
+    CHECK_EQ(bench.manager.GetUidCache().size(), 1);
+    CHECK_EQ(bench.manager.GetUidCache()[0].sightings, 2);
+
+    // Present beyond the TTL: the activated tag does not expire
+    bench.Run(3 * ttlMs, []() { return false; });
+    CHECK_EQ(events.removed.size(), 0);
+
+    // Gone for good: one removal after the TTL
+    bench.emulator.DetachTag(&tag);
+    bench.Run(3 * ttlMs, []() { return false; });
+    CHECK_EQ(events.removed.size(), 1);
+    CHECK(bench.manager.GetUidCache().empty());
+
+    // Back after the TTL: a new detection
+    bench.emulator.AttachTag(&tag);
+    bench.Run(1000, [&]() { return events.detected.size() > 1; });
+    CHECK_EQ(events.detected.size(), 2);
+    CHECK_EQ(events.removed.size(), 1);
+    bench.manager.StopTagDetection();
+
+    // Without the cache every loss is a removal and every return a detection
+    bench.manager.SetUidCacheConfig(UidCacheConfig{ false, ttlMs });
+    bench.manager.StartTagDetection(ProtocolBit(NFCProtocol::NFC_A), [&](const TagInfo& found) {
+        events.detected.push_back(found.uid);
+    });
+    bench.Run(1000, [&]() { return events.detected.size() > 2; });
+    bench.emulator.DetachTag(&tag);
+    bench.Run(1000, [&]() { return events.removed.size() > 1; });
+    bench.emulator.AttachTag(&tag);
+    bench.Run(1000, [&]() { return events.detected.size() > 3; });
+    CHECK_EQ(events.detected.size(), 4);
+    CHECK_EQ(events.removed.size(), 2);
+}
+
+/**
+ * @brief Inventory cycles with a full cache
+ */
+static void testInventoryEviction(void)
+{
+    HostBench bench;
+    Events events;
+    bench.manager.SetRemovalCallback([&](const TagInfo& tag) { events.removed.push_back(tag.uid); });
+    DiscoveryConfig config = bench.manager.GetDiscoveryConfig();
+    config.inventory = true;
+    config.maxInventoryTags = 16;
+    bench.manager.SetDiscoveryConfig(config);
+    size_t cycleTags = 0;
+    uint32_t cycles = 0;
+    bench.manager.SetInventoryCallback([&](const std::vector<TagInfo>& tags) { cycleTags = tags.size(); cycles++; });
+
+    std::vector<std::unique_ptr<VirtualType2Tag>> tags;
+    for (uint8_t i = 0; i < 9; i++) {
+        tags.emplace_back(new VirtualType2Tag({ 0x04, static_cast<uint8_t>(0x10 + i), 0x22, 0x33, 0x44, 0x55, 0x66 },
+                                              VirtualType2Tag::Model::NTAG213));
+    }
+    for (size_t i = 0; i < 8; i++) {
+        bench.emulator.AttachTag(tags[i].get());
+    }
+
+    // Eight tags fill the cache: one session each, however many cycles see them
+    bench.manager.StartTagDetection(ProtocolBit(NFCProtocol::NFC_A), [&](const TagInfo& found) {
+        events.detected.push_back(found.uid);
+    });
+    bench.Run(5000, [&]() { return cycles >= 4; });
+    CHECK_EQ(cycleTags, 8);
+    CHECK_EQ(events.detected.size(), 8);
+    CHECK_EQ(events.removed.size(), 0);
+    CHECK_EQ(bench.manager.GetUidCache().size(), 8);
+
+    // The ninth tag evicts the least recently seen one, which is still in the field; that tag
+    // is seen again and reported as new, evicting the next one
+    bench.emulator.AttachTag(tags[8].get());
+    uint32_t start = cycles;
+    bench.Run(5000, [&]() { return cycles > start; });
+    CHECK_EQ(cycleTags, 9);
+    CHECK(!events.removed.empty());
+    if (!events.removed.empty()) {
+        const std::vector<uint8_t>& evicted = events.removed.front();
+        CHECK(evicted != tags[8]->GetUID());
+        CHECK(std::find(events.detected.begin() + 8, events.detected.end(), tags[8]->GetUID()) != events.detected.end());
+        CHECK(std::find(events.detected.begin() + 8, events.detected.end(), evicted) != events.detected.end());
+    }
+    CHECK_EQ(events.removed.size(), events.detected.size() - 8);
+    CHECK_EQ(bench.manager.GetUidCache().size(), 8);
+
+    // Back to eight tags: the cache settles, no further events
+    bench.emulator.DetachTag(tags[8].get());
+    bench.Run(3 * bench.manager.GetUidCacheConfig().ttlMs, []() { return false; });
+    size_t detections = events.detected.size();
+    size_t removals = events.removed.size();
+    start = cycles;
+    bench.Run(5000, [&]() { return cycles > start + 3; });
+    CHECK_EQ(cycleTags, 8);
+    CHECK_EQ(events.detected.size(), detections);
+    CHECK_EQ(events.removed.size(), removals);
+    bench.manager.StopTagDetection();
+}
+
+int main(void)
+{
+    testBounce();
+    testInventoryEviction();
+
+    return TestResult("testUidCache");
+}